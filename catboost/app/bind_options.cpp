@@ -295,6 +295,18 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             (*plainJsonPtr)["profile_log"] = name;
         });
 
+    parser.AddLongOption("profile-trace", "file to write trace of training phases in Chrome trace format (CPU only)")
+        .RequiredArgument("file")
+        .Handler1T<TString>([plainJsonPtr](const TString& name) {
+            (*plainJsonPtr)["profile_trace"] = name;
+        });
+
+    parser.AddLongOption("profile-hardware-counters", "add cycles and LLC misses to profile trace events (Linux only)")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["profile_hardware_counters"] = true;
+        });
+
     parser.AddLongOption("trace-log", "path for trace log")
         .RequiredArgument("file")
         .Handler1T<TString>([](const TString& name) {
@@ -667,6 +679,24 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
                 (*plainJsonPtr)["dev_score_calc_obj_block_size"] = size;
             });
 
+    parser.AddLongOption("dev-leafwise-scoring",
+                         "CPU only. Keep documents ordered by tree leaves in score calculation. "
+                         "Used only for learning speed tuning, applicable only for Plain boosting "
+                         "without groups and pairwise losses. Can affect results due to numerical accuracy differences.")
+            .NoArgument()
+            .Handler0([plainJsonPtr]() {
+                (*plainJsonPtr)["dev_leafwise_scoring"] = true;
+            });
+
+    parser.AddLongOption("dev-leaf-quantile-precision",
+                         "CPU only. Estimate leaf quantiles for Exact leaf estimation method from residual histograms "
+                         "with this relative bin width instead of sorting. 0 means exact quantiles. "
+                         "Should be 0 or a real value in [1e-4, 1) interval. Used only for learning speed tuning.")
+            .RequiredArgument("float")
+            .Handler1T<float>([plainJsonPtr](float precision) {
+                (*plainJsonPtr)["dev_leaf_quantile_precision"] = precision;
+            });
+
     parser.AddLongOption("dev-efb-max-buckets",
                          "CPU only. Maximum bucket count in exclusive features bundle. "
                          "Should be in an integer between 0 and 65536. "
@@ -1048,6 +1078,12 @@ static void BindSystemParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
                 (*plainJsonPtr)["used_ram_limit"] = param;
             });
 
+    parser.AddLongOption("dev-numa-mode", "CPU only. Pin worker threads to NUMA nodes and shard documents between nodes")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["dev_numa_mode"] = true;
+        });
+
     parser
             .AddLongOption("gpu-ram-part")
             .RequiredArgument("double")
@@ -0,0 +1,116 @@
+#include "modes.h"
+
+#include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/options/analytical_mode_params.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/options/load_options.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+#include <util/system/info.h>
+
+
+using namespace NCB;
+
+
+struct TQuantizeParams {
+    NCB::TPathWithScheme PoolPath;
+    NCatboostOptions::TDsvPoolFormatParams DsvPoolFormatParams;
+    TMaybe<TString> BordersFile;
+    NCatboostOptions::TBinarizationOptions BinarizationOptions{EBorderSelectionType::GreedyLogSum, 254, ENanMode::Min};
+    TVector<TString> ClassNames;
+    ui32 BlockSize = 0;
+    TString OutputFileName;
+    int ThreadCount = NSystemInfo::CachedNumberOfCpus();
+
+    void BindParserOpts(NLastGetopt::TOpts& parser) {
+        BindDsvPoolFormatParams(&parser, &DsvPoolFormatParams);
+        parser.AddLongOption('f', "learn-set", "pool to quantize")
+            .RequiredArgument("[SCHEME://]PATH")
+            .Required()
+            .Handler1T<TStringBuf>([&](const TStringBuf& pathWithScheme) {
+                PoolPath = TPathWithScheme(pathWithScheme, "dsv");
+            });
+        parser.AddLongOption('o', "output-path", "quantized pool file path")
+            .RequiredArgument("PATH")
+            .DefaultValue("pool.quantized")
+            .StoreResult(&OutputFileName);
+        parser.AddLongOption("input-borders-file", "borders file in matrixnet format, "
+            "borders of other features are calculated on a sample of the pool")
+            .RequiredArgument("PATH")
+            .Handler1T<TString>([&](const TString& bordersFile) {
+                BordersFile = bordersFile;
+            });
+        parser.AddLongOption("border-count", "count of borders per float feature")
+            .RequiredArgument("INT")
+            .Handler1T<ui32>([&](ui32 borderCount) {
+                BinarizationOptions.BorderCount = borderCount;
+            });
+        parser.AddLongOption("feature-border-type", "border selection type")
+            .RequiredArgument("border-type")
+            .Handler1T<TString>([&](const TString& borderType) {
+                BinarizationOptions.BorderSelectionType = FromString<EBorderSelectionType>(borderType);
+            });
+        parser.AddLongOption("nan-mode", "processing of nan values of float features: Min, Max or Forbidden")
+            .RequiredArgument("{Min,Max,Forbidden}")
+            .Handler1T<TString>([&](const TString& nanMode) {
+                BinarizationOptions.NanMode = FromString<ENanMode>(nanMode);
+            });
+        parser.AddLongOption("class-names", "names for classes.")
+            .RequiredArgument("comma separated list of names")
+            .Handler1T<TString>([&](const TString& namesLine) {
+                for (const auto& t : StringSplitter(namesLine).Split(',').SkipEmpty()) {
+                    ClassNames.push_back(TString(t.Token()));
+                }
+                CB_ENSURE(!ClassNames.empty(), "Empty class names list" << namesLine);
+            });
+        parser.AddLongOption("block-size", "count of objects in the blocks the pool is read and quantized by")
+            .RequiredArgument("INT")
+            .DefaultValue("150000")
+            .StoreResult(&BlockSize);
+        parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
+            .RequiredArgument("INT")
+            .StoreResult(&ThreadCount);
+    }
+};
+
+
+int mode_quantize(int argc, const char* argv[]) {
+    TQuantizeParams params;
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    {
+        NLastGetopt::TOptsParseResult parseResult(&parser, argc, argv);
+        Y_UNUSED(parseResult);
+    }
+
+    NCatboostOptions::ValidatePoolParams(params.PoolPath, params.DsvPoolFormatParams);
+    params.BinarizationOptions.Validate();
+    CB_ENSURE(params.BlockSize > 0, "Block size must be positive");
+    CB_ENSURE(params.ThreadCount > 0, "Thread count must be positive");
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    ConvertDsvPoolToQuantizedPool(
+        params.PoolPath,
+        params.DsvPoolFormatParams,
+        params.BordersFile,
+        params.BinarizationOptions,
+        params.ClassNames,
+        params.BlockSize,
+        params.OutputFileName,
+        &localExecutor
+    );
+    return 0;
+}
@@ -9,3 +9,4 @@ int mode_run_worker(int argc, const char* argv[]);
 int mode_roc(int argc, const char* argv[]);
 int mode_model_sum(int argc, const char* argv[]);
 int mode_model_based_eval(int argc, const char* argv[]);
+int mode_quantize(int argc, const char* argv[]);
@@ -200,6 +200,155 @@ TVector<TVector<double>> ApplyModelMulti(
     return approxes;
 }
 
+static NModelEvaluation::EPredictionType GetEvaluatorPredictionType(const EPredictionType predictionType) {
+    switch (predictionType) {
+        case EPredictionType::Probability:
+            return NModelEvaluation::EPredictionType::Probability;
+        case EPredictionType::Class:
+            return NModelEvaluation::EPredictionType::Class;
+        case EPredictionType::RawFormulaVal:
+        case EPredictionType::InternalRawFormulaVal:
+            return NModelEvaluation::EPredictionType::RawFormulaVal;
+        default:
+            Y_UNREACHABLE();
+    }
+}
+
+template <class T>
+static void CheckDenseMatrix(const TDenseMatrixRef<T>& matrix, TStringBuf matrixName) {
+    CB_ENSURE(
+        matrix.Data.size() == matrix.ObjectCount * matrix.FeatureCount,
+        matrixName << " data size " << matrix.Data.size() << " does not match its shape "
+        << matrix.ObjectCount << "x" << matrix.FeatureCount
+    );
+}
+
+// fills per-row refs for row-major matrix or per-column refs for column-major one
+template <class T>
+static void GetDenseMatrixRefs(
+    const TDenseMatrixRef<T>& matrix,
+    size_t objectBegin,
+    size_t objectEnd,
+    TVector<TConstArrayRef<T>>* refs
+) {
+    refs->clear();
+    if (matrix.FeatureCount == 0) {
+        return;
+    }
+    if (matrix.IsColumnMajor) {
+        refs->reserve(matrix.FeatureCount);
+        for (size_t featureIdx = 0; featureIdx < matrix.FeatureCount; ++featureIdx) {
+            refs->push_back(
+                MakeArrayRef(matrix.Data.data() + featureIdx * matrix.ObjectCount + objectBegin, objectEnd - objectBegin)
+            );
+        }
+    } else {
+        refs->reserve(objectEnd - objectBegin);
+        for (size_t objectIdx = objectBegin; objectIdx < objectEnd; ++objectIdx) {
+            refs->push_back(MakeArrayRef(matrix.Data.data() + objectIdx * matrix.FeatureCount, matrix.FeatureCount));
+        }
+    }
+}
+
+void ApplyModelToDenseMatrix(
+    const TFullModel& model,
+    const TDenseMatrixRef<float>& floatFeatures,
+    const TDenseMatrixRef<int>& hashedCatFeatures,
+    const EPredictionType predictionType,
+    int begin, /*= 0*/
+    int end,   /*= 0*/
+    TLocalExecutor* executor,
+    TArrayRef<double> results)
+{
+    CheckDenseMatrix(floatFeatures, "Float features matrix");
+    CheckDenseMatrix(hashedCatFeatures, "Categorical features matrix");
+    const bool hasFloatFeatures = floatFeatures.FeatureCount != 0;
+    const bool hasCatFeatures = hashedCatFeatures.FeatureCount != 0;
+    CB_ENSURE(hasFloatFeatures || hasCatFeatures, "No features provided");
+    if (hasFloatFeatures && hasCatFeatures) {
+        CB_ENSURE(
+            floatFeatures.ObjectCount == hashedCatFeatures.ObjectCount,
+            "Float and categorical features matrices have different object counts: "
+            << floatFeatures.ObjectCount << " and " << hashedCatFeatures.ObjectCount
+        );
+        CB_ENSURE(
+            floatFeatures.IsColumnMajor == hashedCatFeatures.IsColumnMajor,
+            "Float and categorical features matrices must have the same memory order"
+        );
+    }
+    const bool isColumnMajor = hasFloatFeatures ? floatFeatures.IsColumnMajor : hashedCatFeatures.IsColumnMajor;
+    const size_t objectCount = hasFloatFeatures ? floatFeatures.ObjectCount : hashedCatFeatures.ObjectCount;
+
+    const auto evaluatorPredictionType = GetEvaluatorPredictionType(predictionType);
+    const size_t resultDimension =
+        evaluatorPredictionType == NModelEvaluation::EPredictionType::Class ? 1 : model.GetDimensionsCount();
+    CB_ENSURE(
+        results.size() == objectCount * resultDimension,
+        "`results` size is insufficient: " << LabeledOutput(results.size(), objectCount * resultDimension)
+    );
+    if (objectCount == 0) {
+        return;
+    }
+
+    end = end == 0 ? model.GetTreeCount() : Min<int>(end, model.GetTreeCount());
+    auto evaluator = model.GetCurrentEvaluator()->Clone();
+    evaluator->SetPredictionType(evaluatorPredictionType);
+
+    const int executorThreadCount = executor ? executor->GetThreadCount() : 0;
+    auto blockParams = GetBlockParams(executorThreadCount, SafeIntegerCast<int>(objectCount), begin, end);
+
+    const auto applyOnBlock = [&](int blockId) {
+        const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+        if (blockFirstIdx >= blockLastIdx) {
+            return;
+        }
+        TVector<TConstArrayRef<float>> floatRefs;
+        TVector<TConstArrayRef<int>> catRefs;
+        GetDenseMatrixRefs(floatFeatures, blockFirstIdx, blockLastIdx, &floatRefs);
+        GetDenseMatrixRefs(hashedCatFeatures, blockFirstIdx, blockLastIdx, &catRefs);
+        auto blockResults = results.Slice(
+            blockFirstIdx * resultDimension,
+            (blockLastIdx - blockFirstIdx) * resultDimension);
+        if (isColumnMajor) {
+            evaluator->CalcTransposed(floatRefs, catRefs, begin, end, blockResults);
+        } else {
+            evaluator->Calc(floatRefs, catRefs, begin, end, blockResults);
+        }
+    };
+    if (executor) {
+        executor->ExecRangeWithThrow(applyOnBlock, 0, blockParams.GetBlockCount(), TLocalExecutor::WAIT_COMPLETE);
+    } else {
+        applyOnBlock(0);
+    }
+}
+
+void ApplyModelToDenseMatrix(
+    const TFullModel& model,
+    const TDenseMatrixRef<float>& floatFeatures,
+    const TDenseMatrixRef<int>& hashedCatFeatures,
+    bool verbose,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results)
+{
+    CB_ENSURE(threadCount > 0);
+    TSetLoggingVerboseOrSilent inThisScope(verbose);
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(threadCount - 1);
+    ApplyModelToDenseMatrix(
+        model,
+        floatFeatures,
+        hashedCatFeatures,
+        predictionType,
+        begin,
+        end,
+        &executor,
+        results);
+}
+
 void TModelCalcerOnPool::ApplyModelMulti(
     const EPredictionType predictionType,
     int begin,
@@ -9,6 +9,7 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 
@@ -46,6 +47,44 @@ TVector<TVector<double>> ApplyModelMulti(
     int end = 0,
     int threadCount = 1);
 
+namespace NCB {
+    template <class T>
+    struct TDenseMatrixRef {
+        TConstArrayRef<T> Data;
+        size_t ObjectCount = 0;
+        size_t FeatureCount = 0;
+        bool IsColumnMajor = false; // Data[featureIdx * ObjectCount + objectIdx] (F-contiguous) if true
+    };
+}
+
+/*
+ * Fast path for dense feature matrices: evaluates model directly on the matrix
+ * without creating TDataProvider.
+ * hashedCatFeatures contain values hashed by CalcCatFeatureHash.
+ * results must be preallocated by caller, layout is [objectIdx][dimension] ([objectIdx] for Class),
+ * values are in internal approx dimensions order (no external labels remapping).
+ */
+void ApplyModelToDenseMatrix(
+    const TFullModel& model,
+    const NCB::TDenseMatrixRef<float>& floatFeatures,
+    const NCB::TDenseMatrixRef<int>& hashedCatFeatures,
+    const EPredictionType predictionType,
+    int begin, /*= 0*/
+    int end,   /*= 0*/
+    NPar::TLocalExecutor* executor,
+    TArrayRef<double> results);
+
+void ApplyModelToDenseMatrix(
+    const TFullModel& model,
+    const NCB::TDenseMatrixRef<float>& floatFeatures,
+    const NCB::TDenseMatrixRef<int>& hashedCatFeatures,
+    bool verbose,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results);
+
 /*
  * Tradeoff memory for speed
  * Don't use if you need to compute model only once and on all features
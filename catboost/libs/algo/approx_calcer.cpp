@@ -49,25 +49,52 @@ inline void UpdateApproxKernel(const double* leafDeltas, const TIndexType* indic
 }
 
 template <bool StoreExpApprox>
-inline void UpdateApproxBlock(
-    const NPar::TLocalExecutor::TExecRangeParams& params,
+inline void UpdateApproxRange(
     const double* leafDeltas,
     const TIndexType* indices,
-    int blockIdx,
+    int begin,
+    int end,
     double* deltasDimension
 ) {
-    const int blockStart = blockIdx * params.GetBlockSize();
-    const int nextBlockStart = Min<ui64>(blockStart + params.GetBlockSize(), params.LastId);
     constexpr int VectorWidth = 4;
     int doc;
-    for (doc = blockStart; doc + VectorWidth <= nextBlockStart; doc += VectorWidth) {
+    for (doc = begin; doc + VectorWidth <= end; doc += VectorWidth) {
         UpdateApproxKernel<StoreExpApprox, VectorWidth>(leafDeltas, indices + doc, deltasDimension + doc);
     }
-    for (; doc < nextBlockStart; ++doc) {
+    for (; doc < end; ++doc) {
         deltasDimension[doc] = UpdateApprox<StoreExpApprox>(deltasDimension[doc], leafDeltas[indices[doc]]);
     }
 }
 
+template <bool StoreExpApprox>
+inline void UpdateApproxBlock(
+    const NPar::TLocalExecutor::TExecRangeParams& params,
+    const double* leafDeltas,
+    const TIndexType* indices,
+    int blockIdx,
+    double* deltasDimension
+) {
+    const int blockStart = blockIdx * params.GetBlockSize();
+    const int nextBlockStart = Min<ui64>(blockStart + params.GetBlockSize(), params.LastId);
+    UpdateApproxRange<StoreExpApprox>(leafDeltas, indices, blockStart, nextBlockStart, deltasDimension);
+}
+
+// leafDeltas are already exponentiated if storeExpApprox
+static void UpdateApproxRange(
+    bool storeExpApprox,
+    TConstArrayRef<double> leafDeltas,
+    TConstArrayRef<TIndexType> indices,
+    int begin,
+    int end,
+    double* point
+) {
+    if (storeExpApprox) {
+        UpdateApproxRange</*StoreExpApprox*/true>(leafDeltas.data(), indices.data(), begin, end, point);
+    } else {
+        UpdateApproxRange</*StoreExpApprox*/false>(leafDeltas.data(), indices.data(), begin, end, point);
+    }
+}
+
 void UpdateApproxDeltas(
     bool storeExpApprox,
     const TVector<TIndexType>& indices,
@@ -172,7 +199,12 @@ static void CalcLeafDers(
     ELeavesEstimation estimationMethod,
     NPar::TLocalExecutor* localExecutor,
     TArrayRef<TSum> leafDers,
-    TArrayRef<TDers> weightedDers
+    TArrayRef<TDers> weightedDers,
+    // if not empty, point (approxes or approxesDelta) is updated by these leaf deltas
+    //  right before derivatives calculation, in the same pass
+    TConstArrayRef<double> pendingLeafDeltas = {},
+    bool storeExpApprox = false,
+    double* point = nullptr
 ) {
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, sampleCount);
     blockParams.SetBlockCount(CB_THREAD_LIMIT);
@@ -208,6 +240,16 @@ static void CalcLeafDers(
                  innerBlockStart += innerBlockSize
             ) {
                 const int innerCount = Min(nextBlockStart - innerBlockStart, innerBlockSize);
+                if (!pendingLeafDeltas.empty()) {
+                    UpdateApproxRange(
+                        storeExpApprox,
+                        pendingLeafDeltas,
+                        indices,
+                        innerBlockStart,
+                        innerBlockStart + innerCount,
+                        point
+                    );
+                }
                 error.CalcDersRange(
                     0,
                     innerCount,
@@ -428,6 +470,96 @@ void CalcLeafDeltasSimple(
     }
 }
 
+void CalcLeafDeltasWithFusedApproxUpdate(
+    int iterationCount,
+    int leafCount,
+    TConstArrayRef<TIndexType> indices,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TConstArrayRef<double> approxes,
+    int derDocCount,
+    const IDerCalcer& error,
+    ELeavesEstimation estimationMethod,
+    const std::function<void(const TVector<TSum>&, TVector<double>*)>& calcLeafDeltas,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<double> point,
+    TVector<double>* sumLeafDeltas
+) {
+    Y_ASSERT(error.GetErrorType() == EErrorType::PerObjectError);
+    Y_ASSERT(estimationMethod != ELeavesEstimation::Exact);
+    const bool storeExpApprox = error.GetIsExpApprox();
+    const int pointDocCount = point.size();
+    Y_ASSERT(derDocCount <= pointDocCount);
+
+    TVector<TDers> weightedDers;
+    weightedDers.yresize(APPROX_BLOCK_SIZE * CB_THREAD_LIMIT);
+    TVector<TSum> leafDers(leafCount, TSum());
+    TVector<double> leafDeltas(leafCount);
+    // exponentiated if storeExpApprox, documents after derDocCount are updated only at the end
+    TVector<TVector<double>> iterationsLeafDeltas;
+    for (int iterationIdx = 0; iterationIdx < iterationCount; ++iterationIdx) {
+        for (auto& leafDer : leafDers) {
+            leafDer.SetZeroDers();
+        }
+        CalcLeafDers(
+            indices,
+            targets,
+            weights,
+            approxes.empty() ? TConstArrayRef<double>(point) : approxes,
+            approxes.empty() ? TConstArrayRef<double>() : TConstArrayRef<double>(point),
+            error,
+            derDocCount,
+            /*recalcLeafWeights*/ iterationIdx == 0,
+            estimationMethod,
+            localExecutor,
+            leafDers,
+            weightedDers,
+            iterationIdx == 0 ? TConstArrayRef<double>() : TConstArrayRef<double>(iterationsLeafDeltas.back()),
+            storeExpApprox,
+            point.data()
+        );
+        calcLeafDeltas(leafDers, &leafDeltas);
+        if (sumLeafDeltas != nullptr) {
+            AddElementwise(leafDeltas, sumLeafDeltas);
+        }
+        iterationsLeafDeltas.push_back(leafDeltas);
+        ExpApproxIf(storeExpApprox, iterationsLeafDeltas.back());
+    }
+    if (iterationsLeafDeltas.empty()) {
+        return;
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, pointDocCount);
+    blockParams.SetBlockSize(1000);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const int blockStart = blockIdx * blockParams.GetBlockSize();
+            const int nextBlockStart = Min(blockStart + blockParams.GetBlockSize(), pointDocCount);
+            UpdateApproxRange(
+                storeExpApprox,
+                iterationsLeafDeltas.back(),
+                indices,
+                blockStart,
+                Min(nextBlockStart, derDocCount),
+                point.data()
+            );
+            for (const auto& iterationLeafDeltas : iterationsLeafDeltas) {
+                UpdateApproxRange(
+                    storeExpApprox,
+                    iterationLeafDeltas,
+                    indices,
+                    Max(blockStart, derDocCount),
+                    nextBlockStart,
+                    point.data()
+                );
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
+
 static void CalcMonotonicLeafDeltasSimple(
     const TVector<TSum>& leafDers,
     const ELeavesEstimation& estimationMethod,
@@ -702,6 +834,110 @@ static double CalcSampleQuantile(
     return 0;
 }
 
+// Leaf quantiles from per-leaf residual histograms with binCount equal bins between leaf residual min and max,
+// the result differs from the exact weighted quantile by at most (max - min) / binCount.
+static void CalcQuantileLeafDeltasFromHistograms(
+    const size_t leafCount,
+    const TVector<TIndexType>& indices,
+    const TQuantileError& error,
+    const size_t sampleCount,
+    TConstArrayRef<double> approxes,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    const int binCount,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<double>* leafDeltas
+) {
+    Y_ASSERT(binCount > 0);
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, sampleCount);
+    blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    const int blockCount = blockParams.GetBlockCount();
+    const auto forEachBlockSample = [&] (int blockId, const auto& body) {
+        const size_t blockEnd = Min<size_t>((size_t)(blockId + 1) * blockParams.GetBlockSize(), sampleCount);
+        for (size_t i = (size_t)blockId * blockParams.GetBlockSize(); i < blockEnd; ++i) {
+            Y_ASSERT(indices[i] < leafCount);
+            body(indices[i], targets[i] - approxes[i], weights[i]);
+        }
+    };
+
+    TVector<TVector<double>> blockLeafMins(blockCount, TVector<double>(leafCount, Max<double>()));
+    TVector<TVector<double>> blockLeafMaxs(blockCount, TVector<double>(leafCount, -Max<double>()));
+    localExecutor->ExecRange(
+        [&] (int blockId) {
+            auto& leafMins = blockLeafMins[blockId];
+            auto& leafMaxs = blockLeafMaxs[blockId];
+            forEachBlockSample(blockId, [&] (TIndexType leaf, double residual, float /*weight*/) {
+                leafMins[leaf] = Min(leafMins[leaf], residual);
+                leafMaxs[leaf] = Max(leafMaxs[leaf], residual);
+            });
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    TVector<double>& leafMins = blockLeafMins[0];
+    TVector<double>& leafMaxs = blockLeafMaxs[0];
+    TVector<double> leafBinScales(leafCount, 0.0);
+    for (size_t leaf : xrange(leafCount)) {
+        for (int blockId : xrange(1, blockCount)) {
+            leafMins[leaf] = Min(leafMins[leaf], blockLeafMins[blockId][leaf]);
+            leafMaxs[leaf] = Max(leafMaxs[leaf], blockLeafMaxs[blockId][leaf]);
+        }
+        if (leafMaxs[leaf] > leafMins[leaf]) {
+            leafBinScales[leaf] = binCount / (leafMaxs[leaf] - leafMins[leaf]);
+        }
+    }
+
+    TVector<TVector<double>> blockHistograms(blockCount, TVector<double>(leafCount * binCount, 0.0));
+    localExecutor->ExecRange(
+        [&] (int blockId) {
+            auto& histograms = blockHistograms[blockId];
+            forEachBlockSample(blockId, [&] (TIndexType leaf, double residual, float weight) {
+                const int bin = Min<int>((residual - leafMins[leaf]) * leafBinScales[leaf], binCount - 1);
+                histograms[leaf * binCount + bin] += weight;
+            });
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    Y_ASSERT(leafCount == leafDeltas->size());
+    NPar::ParallelFor(*localExecutor, 0, leafCount, [&] (int leaf) {
+        double& leafDelta = (*leafDeltas)[leaf];
+        if (leafMins[leaf] > leafMaxs[leaf]) { // empty leaf
+            leafDelta = 0;
+            return;
+        }
+        const TArrayRef<double> histogram(blockHistograms[0].data() + leaf * binCount, binCount);
+        for (int blockId : xrange(1, blockCount)) {
+            const double* blockHistogram = blockHistograms[blockId].data() + leaf * binCount;
+            for (int bin : xrange(binCount)) {
+                histogram[bin] += blockHistogram[bin];
+            }
+        }
+        const double sumWeight = Accumulate(histogram.begin(), histogram.end(), 0.0);
+        const double position = sumWeight * error.Alpha;
+        if (position <= 0) {
+            leafDelta = leafMins[leaf] - error.Delta;
+            return;
+        }
+        if (position >= sumWeight) {
+            leafDelta = leafMaxs[leaf] + error.Delta;
+            return;
+        }
+        const double binWidth = (leafMaxs[leaf] - leafMins[leaf]) / binCount;
+        double sum = 0;
+        int bin = 0;
+        while (bin + 1 < binCount && sum + histogram[bin] < position) {
+            sum += histogram[bin];
+            ++bin;
+        }
+        const double binFraction = histogram[bin] > 0 ? Min(1.0, (position - sum) / histogram[bin]) : 0.0;
+        leafDelta = leafMins[leaf] + (bin + binFraction) * binWidth;
+    });
+}
+
 static void CalcQuantileLeafDeltas(
     const size_t leafCount,
     const TVector<TIndexType>& indices,
@@ -710,8 +946,33 @@ static void CalcQuantileLeafDeltas(
     TConstArrayRef<double> approxes,
     TConstArrayRef<float> targets,
     TConstArrayRef<float> weights,
+    const float precision,
+    NPar::TLocalExecutor* localExecutor,
     TVector<double>* leafDeltas
 ) {
+    // sorting is cheap enough for small samples
+    constexpr size_t MinSampleCountForQuantileHistograms = 100000;
+    // histograms are not smaller than the samples they are built from for larger bin counts
+    const double binCount = precision > 0 ? ceil(1.0 / precision) : 0.0;
+    if (precision > 0
+        && sampleCount >= MinSampleCountForQuantileHistograms
+        && binCount * leafCount <= sampleCount)
+    {
+        CalcQuantileLeafDeltasFromHistograms(
+            leafCount,
+            indices,
+            error,
+            sampleCount,
+            approxes,
+            targets,
+            weights,
+            (int)binCount,
+            localExecutor,
+            leafDeltas
+        );
+        return;
+    }
+
     TVector<TVector<double>> leafSamples(leafCount);
     TVector<TVector<double>> leafWeights(leafCount);
 
@@ -769,6 +1030,31 @@ static void CalcApproxDeltaSimple(
             TVector<TVector<ui32>>()
     );
 
+    const auto leafDeltasCalcerFunc = [&] (const TVector<TSum>& sumDers, TVector<double>* leafDeltas) {
+        if (treeHasMonotonicConstraints) {
+            const double scaledL2Regularizer = (
+                ctx->Params.ObliviousTreeOptions->L2Reg * (fold.GetSumWeight() / fold.GetLearnSampleCount())
+            );
+            CalcMonotonicLeafDeltasSimple(
+                sumDers,
+                estimationMethod,
+                scaledL2Regularizer,
+                /*curLeafValues*/TVector<double>(leafCount),
+                leafMonotonicLinearOrders,
+                leafDeltas
+            );
+        } else {
+            CalcLeafDeltasSimple(
+                sumDers,
+                pairwiseBuckets,
+                ctx->Params,
+                bt.BodySumWeight,
+                bt.BodyFinish,
+                leafDeltas
+            );
+        }
+    };
+
     const auto leafUpdaterFunc = [&] (
         bool recalcLeafWeights,
         const TVector<TVector<double>>& approxDeltas,
@@ -787,6 +1073,8 @@ static void CalcApproxDeltaSimple(
                 bt.Approx[0],
                 fold.LearnTarget,
                 MakeConstArrayRef(fold.SampleWeights),
+                treeLearnerOptions.DevLeafQuantilePrecision,
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]
             );
 
@@ -811,28 +1099,7 @@ static void CalcApproxDeltaSimple(
             &pairwiseBuckets,
             &weightedDers
         );
-        if (treeHasMonotonicConstraints) {
-            const double scaledL2Regularizer = (
-                ctx->Params.ObliviousTreeOptions->L2Reg * (fold.GetSumWeight() / fold.GetLearnSampleCount())
-            );
-            CalcMonotonicLeafDeltasSimple(
-                leafDers,
-                estimationMethod,
-                scaledL2Regularizer,
-                /*curLeafValues*/TVector<double>(leafCount),
-                leafMonotonicLinearOrders,
-                &(*leafDeltas)[0]
-            );
-        } else {
-            CalcLeafDeltasSimple(
-                leafDers,
-                pairwiseBuckets,
-                ctx->Params,
-                bt.BodySumWeight,
-                bt.BodyFinish,
-                &(*leafDeltas)[0]
-            );
-        }
+        leafDeltasCalcerFunc(leafDers, &(*leafDeltas)[0]);
     };
 
     const float l2Regularizer = treeLearnerOptions.L2Reg;
@@ -903,6 +1170,32 @@ static void CalcApproxDeltaSimple(
         CopyApprox(src, dst, ctx->LocalExecutor);
     };
 
+    const bool fuseApproxUpdates = (
+        !haveBacktrackingObjective &&
+        gradientIterations > 1 &&
+        error.GetErrorType() == EErrorType::PerObjectError &&
+        estimationMethod != ELeavesEstimation::Exact &&
+        !ctx->Params.BoostingOptions->ApproxOnFullHistory
+    );
+    if (fuseApproxUpdates) {
+        CalcLeafDeltasWithFusedApproxUpdate(
+            gradientIterations,
+            leafCount,
+            indices,
+            fold.LearnTarget,
+            fold.GetLearnWeights(),
+            bt.Approx[0],
+            bt.BodyFinish,
+            error,
+            estimationMethod,
+            leafDeltasCalcerFunc,
+            ctx->LocalExecutor,
+            MakeArrayRef((*approxDeltas)[0].data(), bt.TailFinish),
+            sumLeafDeltas == nullptr ? nullptr : &(*sumLeafDeltas)[0]
+        );
+        return;
+    }
+
     GradientWalker(
         /*isTrivialWalker*/!haveBacktrackingObjective,
         gradientIterations,
@@ -954,6 +1247,31 @@ static void CalcLeafValuesSimple(
     CopyApprox(bt.Approx, &approxes, ctx->LocalExecutor);
     TVector<TSum> leafDers(leafCount, TSum()); // iteration scratch space
     TArray2D<double> pairwiseBuckets; // iteration scratch space
+    const auto leafDeltasCalcerFunc = [&] (const TVector<TSum>& sumDers, TVector<double>* leafDeltas) {
+        if (treeHasMonotonicConstraints) {
+            const double scaledL2Regularizer = (
+                ctx->Params.ObliviousTreeOptions->L2Reg * (fold.GetSumWeight() / fold.GetLearnSampleCount())
+            );
+            CalcMonotonicLeafDeltasSimple(
+                sumDers,
+                estimationMethod,
+                scaledL2Regularizer,
+                (*sumLeafDeltas)[0],
+                leafMonotonicLinearOrders,
+                leafDeltas
+            );
+        } else {
+            CalcLeafDeltasSimple(
+                sumDers,
+                pairwiseBuckets,
+                ctx->Params,
+                fold.GetSumWeight(),
+                fold.GetLearnSampleCount(),
+                leafDeltas
+            );
+        }
+    };
+
     const auto leafUpdaterFunc = [&] (
         bool recalcLeafWeights,
         const TVector<TVector<double>>& approxes,
@@ -972,6 +1290,8 @@ static void CalcLeafValuesSimple(
                 bt.Approx[0],
                 fold.LearnTarget,
                 MakeConstArrayRef(fold.SampleWeights),
+                learnerOptions.DevLeafQuantilePrecision,
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]
             );
             return;
@@ -996,28 +1316,7 @@ static void CalcLeafValuesSimple(
             &weightedDers
         );
 
-        if (treeHasMonotonicConstraints) {
-            const double scaledL2Regularizer = (
-                ctx->Params.ObliviousTreeOptions->L2Reg * (fold.GetSumWeight() / fold.GetLearnSampleCount())
-            );
-            CalcMonotonicLeafDeltasSimple(
-                leafDers,
-                estimationMethod,
-                scaledL2Regularizer,
-                (*sumLeafDeltas)[0],
-                leafMonotonicLinearOrders,
-                &(*leafDeltas)[0]
-            );
-        } else {
-            CalcLeafDeltasSimple(
-                leafDers,
-                pairwiseBuckets,
-                ctx->Params,
-                fold.GetSumWeight(),
-                fold.GetLearnSampleCount(),
-                &(*leafDeltas)[0]
-            );
-        }
+        leafDeltasCalcerFunc(leafDers, &(*leafDeltas)[0]);
     };
 
     const auto approxUpdaterFunc = [&] (
@@ -1058,6 +1357,35 @@ static void CalcLeafValuesSimple(
         CopyApprox(src, dst, ctx->LocalExecutor);
     };
 
+    const bool fuseApproxUpdates = (
+        !haveBacktrackingObjective &&
+        gradientIterations > 1 &&
+        error.GetErrorType() == EErrorType::PerObjectError &&
+        estimationMethod != ELeavesEstimation::Exact
+    );
+    if (fuseApproxUpdates) {
+        CalcLeafDeltasWithFusedApproxUpdate(
+            gradientIterations,
+            leafCount,
+            indices,
+            fold.LearnTarget,
+            fold.GetLearnWeights(),
+            /*approxes*/ {},
+            fold.GetLearnSampleCount(),
+            error,
+            estimationMethod,
+            [&] (const TVector<TSum>& sumDers, TVector<double>* leafDeltas) {
+                // keep random numbers sequence the same as for leafUpdaterFunc
+                ctx->LearnProgress->Rand.GenRand();
+                leafDeltasCalcerFunc(sumDers, leafDeltas);
+            },
+            &localExecutor,
+            MakeArrayRef(approxes[0].data(), fold.GetLearnSampleCount()),
+            &(*sumLeafDeltas)[0]
+        );
+        return;
+    }
+
     GradientWalker(
         /*isTrivialWalker*/!haveBacktrackingObjective,
         gradientIterations,
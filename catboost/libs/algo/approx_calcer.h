@@ -6,6 +6,10 @@
 #include <catboost/libs/options/enum_helpers.h>
 #include <catboost/libs/options/restrictions.h>
 
+#include <util/generic/array_ref.h>
+
+#include <functional>
+
 
 class IDerCalcer;
 class TLearnContext;
@@ -59,6 +63,26 @@ void CalcLeafDeltasSimple(
     TVector<double>* leafDeltas
 );
 
+// Leaf estimation iterations without backtracking for per-object errors, with one pass over documents per iteration:
+// approx update by the previous iteration leaf deltas is done in the same blocks as derivatives calculation.
+// point is approxes delta if approxes are not empty (updated for all point documents, derivatives are calculated
+// for the first derDocCount ones), approxes otherwise.
+void CalcLeafDeltasWithFusedApproxUpdate(
+    int iterationCount,
+    int leafCount,
+    TConstArrayRef<TIndexType> indices,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TConstArrayRef<double> approxes,
+    int derDocCount,
+    const IDerCalcer& error,
+    ELeavesEstimation estimationMethod,
+    const std::function<void(const TVector<TSum>&, TVector<double>*)>& calcLeafDeltas,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<double> point,
+    TVector<double>* sumLeafDeltas // can be nullptr
+);
+
 void CalcLeafValues(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
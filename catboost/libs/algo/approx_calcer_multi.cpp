@@ -11,6 +11,8 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <type_traits>
+
 inline static void AddDerNewtonMulti(
     const IDerCalcer& error,
     const TVector<double>& approx,
@@ -217,6 +219,79 @@ void CalcApproxDeltaMulti(
     );
 }
 
+// MultiClass derivatives for compile-time approx dimension: approxes are gathered into an interleaved
+// [rowIdx][dimensionIdx] block and derivatives and hessians are kept on the stack
+template <int ApproxDimension>
+static void AddMultiClassDersRange(
+    TConstArrayRef<TIndexType> leafIndices,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TVector<double>> approx, // [dimensionIdx][columnIdx]
+    TConstArrayRef<TVector<double>> approxDeltas, // [dimensionIdx][columnIdx]
+    int rowBegin,
+    int rowEnd,
+    bool isUpdateWeight,
+    TArrayRef<TSumMulti> leafDers // [dimensionIdx]
+) {
+    constexpr int Der2Size = ApproxDimension * (ApproxDimension + 1) / 2;
+    constexpr int UnrollMaxCount = 16;
+    const bool useHessian = !leafDers[0].SumDer2.Data.empty();
+    double curApprox[UnrollMaxCount][ApproxDimension];
+    double curDer[ApproxDimension];
+    double curDer2[Der2Size];
+    for (int columnIdx = rowBegin; columnIdx < rowEnd; columnIdx += UnrollMaxCount) {
+        const int unrollCount = Min(UnrollMaxCount, rowEnd - columnIdx);
+        for (int dim = 0; dim < ApproxDimension; ++dim) {
+            const double* approxPtr = approx[dim].data() + columnIdx;
+            if (approxDeltas.empty()) {
+                for (int unrollIdx : xrange(unrollCount)) {
+                    curApprox[unrollIdx][dim] = approxPtr[unrollIdx];
+                }
+            } else {
+                const double* approxDeltaPtr = approxDeltas[dim].data() + columnIdx;
+                for (int unrollIdx : xrange(unrollCount)) {
+                    curApprox[unrollIdx][dim] = approxPtr[unrollIdx] + approxDeltaPtr[unrollIdx];
+                }
+            }
+        }
+        for (int unrollIdx : xrange(unrollCount)) {
+            const float curWeight = weight.empty() ? 1 : weight[columnIdx + unrollIdx];
+            TMultiClassError::CalcDersMultiFixed<ApproxDimension>(
+                curApprox[unrollIdx],
+                target[columnIdx + unrollIdx],
+                curWeight,
+                curDer,
+                useHessian ? curDer2 : nullptr);
+            TSumMulti& curLeafDers = leafDers[leafIndices[columnIdx + unrollIdx]];
+            double* sumDer = curLeafDers.SumDer.data();
+            for (int dim = 0; dim < ApproxDimension; ++dim) {
+                sumDer[dim] += curDer[dim];
+            }
+            if (useHessian) {
+                double* sumDer2 = curLeafDers.SumDer2.Data.data();
+                for (int idx = 0; idx < Der2Size; ++idx) {
+                    sumDer2[idx] += curDer2[idx];
+                }
+            } else if (isUpdateWeight) {
+                curLeafDers.SumWeights += curWeight;
+            }
+        }
+    }
+}
+
+// calls func with std::integral_constant<int, approxDimension> if approxDimension is in [MinDimension, MaxDimension]
+template <int MinDimension, int MaxDimension, typename TFunc>
+static bool DispatchFixedApproxDimension(int approxDimension, TFunc&& func) {
+    if (approxDimension == MinDimension) {
+        func(std::integral_constant<int, MinDimension>());
+        return true;
+    }
+    if constexpr(MinDimension < MaxDimension) {
+        return DispatchFixedApproxDimension<MinDimension + 1, MaxDimension>(approxDimension, func);
+    }
+    return false;
+}
+
 static void AddDersRangeMulti(
     TConstArrayRef<TIndexType> leafIndices,
     TConstArrayRef<float> target,
@@ -224,12 +299,33 @@ static void AddDersRangeMulti(
     TConstArrayRef<TVector<double>> approx, // [dimensionIdx][columnIdx]
     TConstArrayRef<TVector<double>> approxDeltas, // [dimensionIdx][columnIdx]
     const IDerCalcer& error,
+    bool isMultiClassError, // error is TMultiClassError, its derivatives can be calculated inline
     int rowBegin,
     int rowEnd,
     bool isUpdateWeight,
     TArrayRef<TSumMulti> leafDers // [dimensionIdx]
 ) {
     const int approxDimension = approx.size();
+    if (isMultiClassError) {
+        const bool isFixedDimension = DispatchFixedApproxDimension<3, 16>(
+            approxDimension,
+            [&] (auto fixedApproxDimension) {
+                AddMultiClassDersRange<decltype(fixedApproxDimension)::value>(
+                    leafIndices,
+                    target,
+                    weight,
+                    approx,
+                    approxDeltas,
+                    rowBegin,
+                    rowEnd,
+                    isUpdateWeight,
+                    leafDers);
+            }
+        );
+        if (isFixedDimension) {
+            return;
+        }
+    }
     const bool useHessian = !leafDers[0].SumDer2.Data.empty();
     THessianInfo curDer2(useHessian * approxDimension, error.GetHessianType());
     TVector<double> curDer(approxDimension);
@@ -269,6 +365,7 @@ void CalcLeafDersMulti(
     for (auto& curLeafDers : *leafDers) {
         curLeafDers.SetZeroDers();
     }
+    const bool isMultiClassError = dynamic_cast<const TMultiClassError*>(&error) != nullptr;
     NCB::MapMerge(
         localExecutor,
         NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(sampleCount), /*blockSize*/1000),
@@ -282,6 +379,7 @@ void CalcLeafDersMulti(
                 approx, // [dimensionIdx][rowIdx]
                 approxDeltas, // [dimensionIdx][rowIdx]
                 error,
+                isMultiClassError,
                 partIndexRange.Begin,
                 partIndexRange.End,
                 isUpdateWeight,
@@ -1,5 +1,6 @@
 #include "calc_score_cache.h"
 
+#include <catboost/libs/helpers/numa.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/options/oblivious_tree_options.h>
 
@@ -8,6 +9,8 @@
 #include <util/generic/ymath.h>
 #include <util/system/guard.h>
 
+#include <functional>
+
 
 using namespace NCB;
 
@@ -248,7 +251,8 @@ void TCalcScoreFold::Create(
     const TVector<TFold>& folds,
     bool isPairwiseScoring,
     int defaultCalcStatsObjBlockSize,
-    float sampleRate
+    float sampleRate,
+    bool partitionDocsByLeaves
 ) {
     BernoulliSampleRate = sampleRate;
     Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
@@ -285,6 +289,15 @@ void TCalcScoreFold::Create(
         }
     }
     DefaultCalcStatsObjBlockSize = defaultCalcStatsObjBlockSize;
+    LeafwisePartitioned = partitionDocsByLeaves
+        && (BodyTailCount == 1)
+        && (GetMaxBodyFinish(folds, 0) == DocCount)
+        && (GetMaxTailFinish(folds, 0) == DocCount)
+        && !HasPairwiseWeights
+        && !IsPairwiseScoring
+        && (LearnQueriesInfo.size() <= 1);
+    LeafBitCount = 0;
+    LeafDocRanges.assign(1, NCB::TIndexRange<int>(0, DocCount));
 }
 
 template <typename TSrcRef, typename TGetElementFunc, typename TDstRef>
@@ -440,8 +453,10 @@ void TCalcScoreFold::SelectSmallestSplitSide(
     DocCount = dstBlocks.Total;
     LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().yresize(DocCount);
     ClearBodyTail();
+    ClearSparseColumnsData();
     BodyTailCount = fold.GetBodyTailCount();
-    localExecutor->ExecRange(
+    NCB::ExecDocBlocks(
+        localExecutor,
         [&](int blockIdx) {
             int ignored;
             const auto srcBlock = srcBlocks.Slices[blockIdx];
@@ -465,13 +480,102 @@ void TCalcScoreFold::SelectSmallestSplitSide(
             );
             SelectBlockFromFold(fold, srcBlock, dstBlock);
         },
-        0,
-        blockCount,
-        NPar::TLocalExecutor::WAIT_COMPLETE
+        blockCount
     );
+    LeafwisePartitioned = fold.LeafwisePartitioned;
+    if (LeafwisePartitioned) {
+        SelectLeafwiseDataFromFold(curDepth, fold, srcBlocks, dstBlocks, blockCount, localExecutor);
+    }
     SetPermutationBlockSizeAndCalcStatsRanges(FoldPermutationBlockSizeNotSet, FoldPermutationBlockSizeNotSet);
 }
 
+void TCalcScoreFold::SelectLeafwiseDataFromFold(
+    int curDepth,
+    const TCalcScoreFold& fold,
+    const TVectorSlicing& srcBlocks,
+    const TVectorSlicing& dstBlocks,
+    int blockCount,
+    NPar::TLocalExecutor* localExecutor
+) {
+    // selected docs of each leaf of the split side remain contiguous and in the same order of leaves
+    const TIndexType splitWeight = 1 << (curDepth - 1);
+    TVector<int> srcLeavesByBegin;
+    for (int srcLeaf : xrange(fold.LeafDocRanges.ysize())) {
+        if (bool(srcLeaf & splitWeight) == SmallestSplitSideValue) {
+            srcLeavesByBegin.push_back(srcLeaf);
+        }
+    }
+    SortBy(srcLeavesByBegin, [&] (int srcLeaf) { return fold.LeafDocRanges[srcLeaf].Begin; });
+    LeafBitCount = Max(fold.LeafBitCount, curDepth);
+    LeafDocRanges.assign(size_t(1) << LeafBitCount, NCB::TIndexRange<int>(DocCount, DocCount));
+    int leafBegin = 0;
+    for (int srcLeaf : srcLeavesByBegin) {
+        const int leafEnd = leafBegin + fold.LeafDocRanges[srcLeaf].GetSize();
+        LeafDocRanges[srcLeaf | splitWeight] = NCB::TIndexRange<int>(leafBegin, leafEnd);
+        leafBegin = leafEnd;
+    }
+    Y_ASSERT(leafBegin == DocCount);
+
+    // bins already gathered by the source fold are selected as other docs data
+    ResetLeafwiseBins();
+    TVector<std::pair<const TLeafwiseBins*, TLeafwiseBins*>> binsToCopy;
+    for (const auto& [column, srcBins] : fold.LeafwiseBins) {
+        if (srcBins->IsCalculated) {
+            TLeafwiseBins& dstBins = GetLeafwiseBinsHolder(column);
+            dstBins.ValueSize = srcBins->ValueSize;
+            dstBins.Data.yresize(size_t(DocCount) * dstBins.ValueSize);
+            dstBins.IsCalculated = true;
+            binsToCopy.emplace_back(srcBins.Get(), &dstBins);
+        }
+    }
+    if (binsToCopy.empty()) {
+        return;
+    }
+    const auto copyBins = [&] (TSlice srcBlock, TSlice dstBlock, const auto* srcData, auto* dstData) {
+        int ignored;
+        SetElements(
+            srcBlock.GetConstRef(Control),
+            srcBlock.GetConstRef(MakeArrayRef(srcData, fold.DocCount)),
+            GetElement<std::remove_cv_t<std::remove_pointer_t<decltype(srcData)>>>,
+            MakeArrayRef(dstData + dstBlock.Offset, dstBlock.Size),
+            &ignored
+        );
+    };
+    NCB::ExecDocBlocks(
+        localExecutor,
+        [&](int blockIdx) {
+            const auto srcBlock = srcBlocks.Slices[blockIdx];
+            const auto dstBlock = dstBlocks.Slices[blockIdx];
+            for (const auto& [srcBins, dstBins] : binsToCopy) {
+                switch (srcBins->ValueSize) {
+                    case 1:
+                        copyBins(srcBlock, dstBlock, srcBins->Data.data(), dstBins->Data.data());
+                        break;
+                    case 2:
+                        copyBins(
+                            srcBlock,
+                            dstBlock,
+                            reinterpret_cast<const ui16*>(srcBins->Data.data()),
+                            reinterpret_cast<ui16*>(dstBins->Data.data())
+                        );
+                        break;
+                    case 4:
+                        copyBins(
+                            srcBlock,
+                            dstBlock,
+                            reinterpret_cast<const ui32*>(srcBins->Data.data()),
+                            reinterpret_cast<ui32*>(dstBins->Data.data())
+                        );
+                        break;
+                    default:
+                        Y_FAIL("Unexpected bins value size");
+                }
+            }
+        },
+        blockCount
+    );
+}
+
 void TCalcScoreFold::Sample(
     const TFold& fold,
     ESamplingUnit samplingUnit,
@@ -504,8 +608,12 @@ void TCalcScoreFold::Sample(
     DocCount = dstBlocks.Total;
     LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().yresize(DocCount);
     ClearBodyTail();
+    ClearSparseColumnsData();
     BodyTailCount = fold.BodyTailArr.ysize();
-    localExecutor->ExecRange(
+    // arrays are first touched here (they are yresize'd in Create), so with NUMA placement
+    //  their pages are placed on the nodes that process the same doc blocks later
+    NCB::ExecDocBlocks(
+        localExecutor,
         [&](int blockIdx) {
             const auto srcBlock = srcBlocks.Slices[blockIdx];
             const auto srcControlRef = srcBlock.GetConstRef(Control);
@@ -527,18 +635,44 @@ void TCalcScoreFold::Sample(
             );
             SelectBlockFromFold(fold, srcBlock, dstBlock);
         },
-        0,
-        blockCount,
-        NPar::TLocalExecutor::WAIT_COMPLETE
-    );
-    SetPermutationBlockSizeAndCalcStatsRanges(
-        (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize :
-            FoldPermutationBlockSizeNotSet,
-        (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet
+        blockCount
     );
+    if (LeafwisePartitioned) {
+        ResetLeafwiseBins();
+        LeafBitCount = 0;
+        LeafDocRanges.assign(1, NCB::TIndexRange<int>(0, DocCount));
+        PartitionDocsByLeaves(localExecutor);
+        // bins are accessed through LeafwiseBins, other data is permuted, so that there are no permutation blocks
+        SetPermutationBlockSizeAndCalcStatsRanges(FoldPermutationBlockSizeNotSet, FoldPermutationBlockSizeNotSet);
+    } else {
+        SetPermutationBlockSizeAndCalcStatsRanges(
+            (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize :
+                FoldPermutationBlockSizeNotSet,
+            (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet
+        );
+    }
 }
 
 void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    if (LeafwisePartitioned) {
+        // docs are not in fold order, so take their indices by positions in fold
+        NPar::TLocalExecutor::TExecRangeParams docBlockParams(0, DocCount);
+        docBlockParams.SetBlockSize(2000);
+        const TIndexType* srcIndicesData = indices.data();
+        const ui32* indexInFoldData = GetDataPtr(IndexInFold);
+        TIndexType* dstIndicesData = GetDataPtr(Indices);
+        localExecutor->ExecRange(
+            [=](int doc) {
+                dstIndicesData[doc] = srcIndicesData[indexInFoldData[doc]];
+            },
+            docBlockParams,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        ClearSparseColumnsData();
+        PartitionDocsByLeaves(localExecutor);
+        return;
+    }
+
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, indices.ysize());
     blockParams.SetBlockSize(2000);
     const int blockCount = blockParams.GetBlockCount();
@@ -553,7 +687,10 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
     }
 
     DocCount = dstBlocks.Total;
-    localExecutor->ExecRange(
+    LeafStatsLeafCount = 0;
+    // doc blocks are sharded between NUMA nodes as in Sample
+    NCB::ExecDocBlocks(
+        localExecutor,
         [&](int blockIdx) {
             const auto srcBlock = srcBlocks.Slices[blockIdx];
             const auto dstBlock = dstBlocks.Slices[blockIdx];
@@ -567,9 +704,7 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
                 &ignored
             );
         },
-        0,
-        blockCount,
-        NPar::TLocalExecutor::WAIT_COMPLETE
+        blockCount
     );
 }
 
@@ -593,6 +728,120 @@ const NCB::IIndexRangesGenerator<int>& TCalcScoreFold::GetCalcStatsIndexRanges()
     return *CalcStatsIndexRanges;
 }
 
+NCB::TIndexRange<int> TCalcScoreFold::GetLeafDocRange(int leaf) const {
+    Y_ASSERT(LeafwisePartitioned);
+    if (leaf >= LeafDocRanges.ysize()) {
+        return NCB::TIndexRange<int>(DocCount, DocCount);
+    }
+    return LeafDocRanges[leaf];
+}
+
+TCalcScoreFold::TLeafwiseBins& TCalcScoreFold::GetLeafwiseBinsHolder(const void* column) const {
+    TLeafwiseBins* bins;
+    with_lock(LeafwiseBinsLock) {
+        auto& binsHolder = LeafwiseBins[column];
+        if (!binsHolder) {
+            binsHolder = MakeHolder<TLeafwiseBins>();
+        }
+        bins = binsHolder.Get();
+    }
+    return *bins;
+}
+
+void TCalcScoreFold::ResetLeafwiseBins() {
+    // buffers are kept for reuse after next Sample
+    for (auto& [column, bins] : LeafwiseBins) {
+        bins->IsCalculated = false;
+    }
+}
+
+TConstArrayRef<ui32> TCalcScoreFold::GetFoldIndexByObjectIdx(
+    const NCB::TFeaturesArraySubsetIndexing& objectsFeaturesArraySubsetIndexing
+) const {
+    with_lock(SparseColumnsDataLock) {
+        if (!HasFoldIndexByObjectIdx) {
+            TVector<ui32> objectIdxBySrcIdx;
+            objectsFeaturesArraySubsetIndexing.ForEach(
+                [&] (ui32 objectIdx, ui32 srcIdx) {
+                    if (srcIdx >= objectIdxBySrcIdx.size()) {
+                        objectIdxBySrcIdx.resize(srcIdx + 1, NotInFold);
+                    }
+                    objectIdxBySrcIdx[srcIdx] = objectIdx;
+                }
+            );
+
+            FoldIndexByObjectIdx.assign(objectsFeaturesArraySubsetIndexing.Size(), NotInFold);
+            const auto& docInFeaturesArrays = LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>();
+            for (int doc : xrange(DocCount)) {
+                FoldIndexByObjectIdx[objectIdxBySrcIdx[docInFeaturesArrays[doc]]] = doc;
+            }
+            HasFoldIndexByObjectIdx = true;
+        }
+    }
+    return FoldIndexByObjectIdx;
+}
+
+TConstArrayRef<TVector<TBucketStats>> TCalcScoreFold::GetLeafStats(
+    int leafCount,
+    bool isPlainMode,
+    NPar::TLocalExecutor* localExecutor
+) const {
+    with_lock(SparseColumnsDataLock) {
+        if ((LeafStatsLeafCount != leafCount) || (LeafStatsIsPlainMode != isPlainMode)) {
+            const int bodyTailDimCount = BodyTailCount * ApproxDimension;
+
+            const int blockSize = Max(1, CeilDiv(DocCount, localExecutor->GetThreadCount() + 1));
+            const int blockCount = Max(1, CeilDiv(DocCount, blockSize));
+
+            // [blockIdx][bodyTailIdx * approxDimension + dim][leaf]
+            TVector<TVector<TVector<TBucketStats>>> blockLeafStats(
+                blockCount,
+                TVector<TVector<TBucketStats>>(
+                    bodyTailDimCount,
+                    TVector<TBucketStats>(leafCount, TBucketStats{0, 0, 0, 0})
+                )
+            );
+            localExecutor->ExecRange(
+                [&] (int blockIdx) {
+                    const int blockBegin = blockIdx * blockSize;
+                    const int blockEnd = Min(blockBegin + blockSize, DocCount);
+                    for (int bodyTailIdx : xrange(BodyTailCount)) {
+                        const int tailFinish = Min(BodyTailArr[bodyTailIdx].TailFinish, blockEnd);
+                        for (int dim : xrange(ApproxDimension)) {
+                            auto& leafStats = blockLeafStats[blockIdx][bodyTailIdx * ApproxDimension + dim];
+                            for (int doc : xrange(blockBegin, Max(blockBegin, tailFinish))) {
+                                leafStats[Indices[doc]].Add(GetDocStats(bodyTailIdx, dim, isPlainMode, doc));
+                            }
+                        }
+                    }
+                },
+                0,
+                blockCount,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+
+            LeafStats = std::move(blockLeafStats[0]);
+            for (int blockIdx : xrange(1, blockCount)) {
+                for (int bodyTailDimIdx : xrange(bodyTailDimCount)) {
+                    for (int leaf : xrange(leafCount)) {
+                        LeafStats[bodyTailDimIdx][leaf].Add(blockLeafStats[blockIdx][bodyTailDimIdx][leaf]);
+                    }
+                }
+            }
+            LeafStatsLeafCount = leafCount;
+            LeafStatsIsPlainMode = isPlainMode;
+        }
+    }
+    return LeafStats;
+}
+
+void TCalcScoreFold::ClearSparseColumnsData() {
+    FoldIndexByObjectIdx.clear();
+    HasFoldIndexByObjectIdx = false;
+    LeafStats.clear();
+    LeafStatsLeafCount = 0;
+}
+
 void TCalcScoreFold::SetSmallestSideControl(
     int curDepth,
     int docCount,
@@ -821,6 +1070,235 @@ void TCalcScoreFold::SetPermutationBlockSizeAndCalcStatsRanges(
     }
 }
 
+using TDocSwap = std::pair<ui32, ui32>;
+using TDocsDataSwapper = std::function<void(TConstArrayRef<TDocSwap>)>;
+
+template <typename TData>
+static void SwapDocs(TConstArrayRef<TDocSwap> swaps, TData* data) {
+    for (const auto& swap : swaps) {
+        DoSwap(data[swap.first], data[swap.second]);
+    }
+}
+
+void TCalcScoreFold::PartitionDocsByLeaves(NPar::TLocalExecutor* localExecutor) {
+    Y_ASSERT(LeafwisePartitioned);
+    const TIndexType* indicesData = GetDataPtr(Indices);
+    const TIndexType maxIndex = DocCount ? *MaxElement(indicesData, indicesData + DocCount) : 0;
+    while ((TIndexType(1) << LeafBitCount) <= maxIndex) {
+        PartitionDocsByLeafBit(LeafBitCount, localExecutor);
+        ++LeafBitCount;
+    }
+}
+
+/* Docs of each leaf range are split into blocks that are partitioned in place in parallel, recording the swaps.
+ * Then docs with the bit set that remain before the split point of the leaf are swapped with docs without
+ * the bit after it, in parallel by chunks. Recorded swaps are applied to the rest of docs data.
+ */
+void TCalcScoreFold::PartitionDocsByLeafBit(int bit, NPar::TLocalExecutor* localExecutor) {
+    constexpr int PartitionBlockSize = 16384;
+
+    const int leafCount = LeafDocRanges.ysize();
+    Y_ASSERT(leafCount == (1 << bit));
+    const TIndexType bitMask = TIndexType(1) << bit;
+    TIndexType* indicesData = GetDataPtr(Indices);
+
+    struct TBlock {
+        NCB::TIndexRange<int> DocRange;
+        int LeftCount = 0; // docs without the bit
+        TVector<TDocSwap> Swaps;
+    };
+    TVector<TBlock> blocks;
+    TVector<int> leafBlocksBegin(leafCount + 1);
+    for (int leaf : xrange(leafCount)) {
+        leafBlocksBegin[leaf] = blocks.ysize();
+        const auto leafRange = LeafDocRanges[leaf];
+        for (int blockBegin = leafRange.Begin; blockBegin < leafRange.End; blockBegin += PartitionBlockSize) {
+            blocks.emplace_back();
+            blocks.back().DocRange = NCB::TIndexRange<int>(
+                blockBegin,
+                Min(blockBegin + PartitionBlockSize, leafRange.End)
+            );
+        }
+    }
+    leafBlocksBegin[leafCount] = blocks.ysize();
+
+    const auto execRange = [&] (int count, const auto& body) {
+        if (count == 0) {
+            return;
+        }
+        NPar::TLocalExecutor::TExecRangeParams params(0, count);
+        params.SetBlockCount(Min(count, 4 * (localExecutor->GetThreadCount() + 1)));
+        localExecutor->ExecRange(body, params, NPar::TLocalExecutor::WAIT_COMPLETE);
+    };
+
+    execRange(
+        blocks.ysize(),
+        [&] (int blockIdx) {
+            auto& block = blocks[blockIdx];
+            int left = block.DocRange.Begin;
+            int right = block.DocRange.End - 1;
+            while (true) {
+                while ((left <= right) && !(indicesData[left] & bitMask)) {
+                    ++left;
+                }
+                while ((left <= right) && (indicesData[right] & bitMask)) {
+                    --right;
+                }
+                if (left >= right) {
+                    break;
+                }
+                DoSwap(indicesData[left], indicesData[right]);
+                block.Swaps.emplace_back(left, right);
+                ++left;
+                --right;
+            }
+            block.LeftCount = left - block.DocRange.Begin;
+        }
+    );
+
+    // misplaced docs of leaves that have been partitioned by several blocks
+    struct TFixUp {
+        TVector<NCB::TIndexRange<int>> WithBit; // before the split point
+        TVector<NCB::TIndexRange<int>> WithoutBit; // after the split point
+        TVector<int> WithBitOffsets;
+        TVector<int> WithoutBitOffsets;
+    };
+    struct TFixUpChunk {
+        int FixUpIdx = 0;
+        NCB::TIndexRange<int> SwapRange;
+        TVector<TDocSwap> Swaps;
+    };
+    TVector<TFixUp> fixUps;
+    TVector<TFixUpChunk> fixUpChunks;
+    TVector<int> leafSplitPoints(leafCount);
+    for (int leaf : xrange(leafCount)) {
+        const auto leafRange = LeafDocRanges[leaf];
+        int splitPoint = leafRange.Begin;
+        for (int blockIdx : xrange(leafBlocksBegin[leaf], leafBlocksBegin[leaf + 1])) {
+            splitPoint += blocks[blockIdx].LeftCount;
+        }
+        leafSplitPoints[leaf] = splitPoint;
+        if (leafBlocksBegin[leaf + 1] - leafBlocksBegin[leaf] < 2) {
+            continue;
+        }
+        TFixUp fixUp;
+        int swapCount = 0;
+        int withoutBitCount = 0;
+        for (int blockIdx : xrange(leafBlocksBegin[leaf], leafBlocksBegin[leaf + 1])) {
+            const auto& block = blocks[blockIdx];
+            const int blockSplitPoint = block.DocRange.Begin + block.LeftCount;
+            if (blockSplitPoint < Min(block.DocRange.End, splitPoint)) {
+                fixUp.WithBitOffsets.push_back(swapCount);
+                fixUp.WithBit.emplace_back(blockSplitPoint, Min(block.DocRange.End, splitPoint));
+                swapCount += fixUp.WithBit.back().GetSize();
+            }
+            if (Max(block.DocRange.Begin, splitPoint) < blockSplitPoint) {
+                fixUp.WithoutBitOffsets.push_back(withoutBitCount);
+                fixUp.WithoutBit.emplace_back(Max(block.DocRange.Begin, splitPoint), blockSplitPoint);
+                withoutBitCount += fixUp.WithoutBit.back().GetSize();
+            }
+        }
+        Y_ASSERT(swapCount == withoutBitCount);
+        if (swapCount == 0) {
+            continue;
+        }
+        for (int chunkBegin = 0; chunkBegin < swapCount; chunkBegin += PartitionBlockSize) {
+            fixUpChunks.emplace_back();
+            fixUpChunks.back().FixUpIdx = fixUps.ysize();
+            fixUpChunks.back().SwapRange = NCB::TIndexRange<int>(
+                chunkBegin,
+                Min(chunkBegin + PartitionBlockSize, swapCount)
+            );
+        }
+        fixUps.push_back(std::move(fixUp));
+    }
+
+    execRange(
+        fixUpChunks.ysize(),
+        [&] (int chunkIdx) {
+            auto& chunk = fixUpChunks[chunkIdx];
+            const auto& fixUp = fixUps[chunk.FixUpIdx];
+            const auto getFirstDoc = [&] (const auto& ranges, const auto& offsets, int* rangeIdx) {
+                *rangeIdx = UpperBound(offsets.begin(), offsets.end(), chunk.SwapRange.Begin) - offsets.begin() - 1;
+                return ranges[*rangeIdx].Begin + chunk.SwapRange.Begin - offsets[*rangeIdx];
+            };
+            int withBitIdx;
+            int withoutBitIdx;
+            int withBitDoc = getFirstDoc(fixUp.WithBit, fixUp.WithBitOffsets, &withBitIdx);
+            int withoutBitDoc = getFirstDoc(fixUp.WithoutBit, fixUp.WithoutBitOffsets, &withoutBitIdx);
+            chunk.Swaps.yresize(chunk.SwapRange.GetSize());
+            for (auto& swap : chunk.Swaps) {
+                if (withBitDoc == fixUp.WithBit[withBitIdx].End) {
+                    withBitDoc = fixUp.WithBit[++withBitIdx].Begin;
+                }
+                if (withoutBitDoc == fixUp.WithoutBit[withoutBitIdx].End) {
+                    withoutBitDoc = fixUp.WithoutBit[++withoutBitIdx].Begin;
+                }
+                Y_ASSERT((indicesData[withBitDoc] & bitMask) && !(indicesData[withoutBitDoc] & bitMask));
+                DoSwap(indicesData[withBitDoc], indicesData[withoutBitDoc]);
+                swap = TDocSwap(withBitDoc++, withoutBitDoc++);
+            }
+        }
+    );
+
+    TVector<TDocsDataSwapper> docsDataSwappers;
+    const auto addDocsData = [&] (auto* data) {
+        docsDataSwappers.push_back([data] (TConstArrayRef<TDocSwap> swaps) { SwapDocs(swaps, data); });
+    };
+    addDocsData(GetDataPtr(IndexInFold));
+    addDocsData(LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data());
+    addDocsData(GetDataPtr(LearnWeights));
+    addDocsData(GetDataPtr(SampleWeights));
+    auto& bodyTail = BodyTailArr[0];
+    Y_ASSERT((bodyTail.BodyFinish == DocCount) && (bodyTail.TailFinish == DocCount));
+    for (int dim : xrange(ApproxDimension)) {
+        addDocsData(GetDataPtr(bodyTail.WeightedDerivatives[dim]));
+        addDocsData(GetDataPtr(bodyTail.SampleWeightedDerivatives[dim]));
+    }
+    for (auto& [column, bins] : LeafwiseBins) {
+        if (!bins->IsCalculated) {
+            continue;
+        }
+        switch (bins->ValueSize) {
+            case 1:
+                addDocsData(bins->Data.data());
+                break;
+            case 2:
+                addDocsData(reinterpret_cast<ui16*>(bins->Data.data()));
+                break;
+            case 4:
+                addDocsData(reinterpret_cast<ui32*>(bins->Data.data()));
+                break;
+            default:
+                Y_FAIL("Unexpected bins value size");
+        }
+    }
+    execRange(
+        blocks.ysize(),
+        [&] (int blockIdx) {
+            for (const auto& swapDocsData : docsDataSwappers) {
+                swapDocsData(blocks[blockIdx].Swaps);
+            }
+        }
+    );
+    execRange(
+        fixUpChunks.ysize(),
+        [&] (int chunkIdx) {
+            for (const auto& swapDocsData : docsDataSwappers) {
+                swapDocsData(fixUpChunks[chunkIdx].Swaps);
+            }
+        }
+    );
+
+    LeafDocRanges.yresize(2 * leafCount);
+    for (int leaf : xrange(leafCount)) {
+        const auto leafRange = LeafDocRanges[leaf];
+        LeafDocRanges[leaf] = NCB::TIndexRange<int>(leafRange.Begin, leafSplitPoints[leaf]);
+        LeafDocRanges[leaf | bitMask] = NCB::TIndexRange<int>(leafSplitPoints[leaf], leafRange.End);
+    }
+    ClearSparseColumnsData();
+}
+
 void TStats3D::Add(const TStats3D& stats3D) {
     CB_ENSURE(
         stats3D.BucketCount == BucketCount
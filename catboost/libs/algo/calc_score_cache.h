@@ -10,10 +10,12 @@
 #include <catboost/libs/options/restrictions.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
 #include <util/generic/ptr.h>
 #include <util/memory/pool.h>
 #include <util/system/atomic.h>
 #include <util/system/info.h>
+#include <util/system/guard.h>
 #include <util/system/spinlock.h>
 
 
@@ -233,7 +235,8 @@ public:
         const TVector<TFold>& folds,
         bool isPairwiseScoring,
         int defaultCalcStatsObjBlockSize,
-        float sampleRate = 1.0f
+        float sampleRate = 1.0f,
+        bool partitionDocsByLeaves = false
     );
     void SelectSmallestSplitSide(
         int curDepth,
@@ -256,9 +259,64 @@ public:
 
     bool HasQueryInfo() const;
 
+    /* Docs (and all their data, including bins of dense columns) are kept partitioned by leaves, so docs of
+     * each leaf form a contiguous range. Docs are partitioned in place after each split, order of docs
+     * within leaves is not preserved.
+     * Supported only for plain boosting without queries and pairwise weights, ignored otherwise.
+     */
+    bool IsLeafwisePartitioned() const { return LeafwisePartitioned; }
+
+    // only for leafwise partitioned folds
+    NCB::TIndexRange<int> GetLeafDocRange(int leaf) const;
+
+    /* Only for leafwise partitioned folds.
+     * Bins of dense column by docs of this fold. Gathered from srcBins (indexed by features arrays indices)
+     * on first use after Sample, then partitioned in place together with other docs data. Thread-safe.
+     */
+    template <class TBin>
+    const TBin* GetLeafwiseBins(const void* column, const TBin* srcBins) const;
+
     // for data with queries - query indices, object indices otherwise
     const NCB::IIndexRangesGenerator<int>& GetCalcStatsIndexRanges() const;
 
+    static constexpr ui32 NotInFold = Max<ui32>();
+
+    /* Used for sparse columns that are indexed by objects of learn data.
+     * [objectIdx] -> doc index in this fold or NotInFold
+     * objectsFeaturesArraySubsetIndexing - features arrays indexing of learn objects data
+     * Calculated on first use after Sample or SelectSmallestSplitSide, thread-safe.
+     */
+    TConstArrayRef<ui32> GetFoldIndexByObjectIdx(
+        const NCB::TFeaturesArraySubsetIndexing& objectsFeaturesArraySubsetIndexing
+    ) const;
+
+    /* Sums of doc stats over leaves for current Indices, as they would be accumulated by CalcStats
+     * for a split with one bucket: [bodyTailIdx * approxDimension + dim][leaf]
+     * Calculated in parallel by blocks of docs on first use after each change of Indices, thread-safe.
+     */
+    TConstArrayRef<TVector<TBucketStats>> GetLeafStats(
+        int leafCount,
+        bool isPlainMode,
+        NPar::TLocalExecutor* localExecutor
+    ) const;
+
+    // stats that doc adds to its bucket in CalcStats
+    inline TBucketStats GetDocStats(int bodyTailIdx, int dim, bool isPlainMode, int doc) const {
+        const TBodyTail& bt = BodyTailArr[bodyTailIdx];
+        if (doc >= bt.TailFinish) {
+            return TBucketStats{0, 0, 0, 0};
+        }
+        const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+        if (isPlainMode || (doc >= bt.BodyFinish)) {
+            const float sampleWeight = hasPairwiseWeights ?
+                bt.SamplePairwiseWeights[doc] : SampleWeights[doc];
+            return TBucketStats{bt.SampleWeightedDerivatives[dim][doc], sampleWeight, 0, 0};
+        }
+        const float* weightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.PairwiseWeights) : GetDataPtr(LearnWeights);
+        return TBucketStats{0, 0, bt.WeightedDerivatives[dim][doc], weightsData ? weightsData[doc] : 1.0};
+    }
+
 private:
     using TSlice = TVectorSlicing::TSlice;
 
@@ -269,6 +327,8 @@ private:
         }
     }
 
+    void ClearSparseColumnsData();
+
     template <typename TFoldType>
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
     void SetSmallestSideControl(
@@ -300,6 +360,30 @@ private:
         int ctrDataPermutationBlockSize
     );
 
+    struct TLeafwiseBins {
+        TAdaptiveLock Lock;
+        bool IsCalculated = false;
+        ui32 ValueSize = 0;
+        TVector<ui8> Data; // [doc * ValueSize]
+    };
+
+    TLeafwiseBins& GetLeafwiseBinsHolder(const void* column) const;
+    void ResetLeafwiseBins();
+    void SelectLeafwiseDataFromFold(
+        int curDepth,
+        const TCalcScoreFold& fold,
+        const TVectorSlicing& srcBlocks,
+        const TVectorSlicing& dstBlocks,
+        int blockCount,
+        NPar::TLocalExecutor* localExecutor
+    );
+
+    /* Partitions docs in place by bits of current Indices that have not been partitioned by yet,
+     * so docs with the same Indices form contiguous ranges.
+     */
+    void PartitionDocsByLeaves(NPar::TLocalExecutor* localExecutor);
+    void PartitionDocsByLeafBit(int bit, NPar::TLocalExecutor* localExecutor);
+
 public:
     TUnsizedVector<TIndexType> Indices;
 
@@ -332,11 +416,46 @@ private:
     bool HasPairwiseWeights;
     bool IsPairwiseScoring;
     int DefaultCalcStatsObjBlockSize;
+    bool LeafwisePartitioned = false;
+    // for leafwise partitioned folds
+    int LeafBitCount = 0; // docs are partitioned by lower LeafBitCount bits of Indices
+    TVector<NCB::TIndexRange<int>> LeafDocRanges; // [leaf]
+
+    mutable TAdaptiveLock LeafwiseBinsLock;
+    mutable THashMap<const void*, THolder<TLeafwiseBins>> LeafwiseBins; // [column]
 
     THolder<NCB::IIndexRangesGenerator<int>> CalcStatsIndexRanges;
+
+    // lazily calculated data for sparse columns
+    mutable TAdaptiveLock SparseColumnsDataLock;
+    mutable TVector<ui32> FoldIndexByObjectIdx;
+    mutable bool HasFoldIndexByObjectIdx = false;
+    mutable TVector<TVector<TBucketStats>> LeafStats;
+    mutable int LeafStatsLeafCount = 0; // 0 if LeafStats are not calculated
+    mutable bool LeafStatsIsPlainMode = false;
 };
 
 
+template <class TBin>
+const TBin* TCalcScoreFold::GetLeafwiseBins(const void* column, const TBin* srcBins) const {
+    Y_ASSERT(LeafwisePartitioned);
+    TLeafwiseBins& bins = GetLeafwiseBinsHolder(column);
+    with_lock(bins.Lock) {
+        if (!bins.IsCalculated) {
+            const ui32* srcIndices = LearnPermutationFeaturesSubset.Get<NCB::TIndexedSubset<ui32>>().data();
+            bins.ValueSize = sizeof(TBin);
+            bins.Data.yresize(size_t(DocCount) * sizeof(TBin));
+            TBin* dstBins = reinterpret_cast<TBin*>(bins.Data.data());
+            for (int doc = 0; doc < DocCount; ++doc) {
+                dstBins[doc] = srcBins[srcIndices[doc]];
+            }
+            bins.IsCalculated = true;
+        }
+    }
+    return reinterpret_cast<const TBin*>(bins.Data.data());
+}
+
+
 struct TStats3D {
     TVector<TBucketStats> Stats; // [bodyTail & approxDim][leaf][bucket]
     int BucketCount = 0;
@@ -90,6 +90,12 @@ static void InitPermutationData(
             std::move(learnPermutationFeaturesSubset)
         );
     }
+
+    if (learnData.ObjectsData->HasSparseData()) {
+        fold->InvertedLearnPermutation = InvertPermutation(
+            fold->LearnPermutation->GetObjectsIndexing().Get<TIndexedSubset<ui32>>()
+        );
+    }
 }
 
 
@@ -109,6 +115,7 @@ TFold TFold::BuildDynamicFold(
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
     TFold ff;
+    ff.ProjectionHashCache = MakeHolder<TProjectionHashCache>();
     ff.SampleWeights.resize(learnSampleCount, 1);
 
     InitPermutationData(learnData, shuffle, permuteBlockSize, rand, &ff);
@@ -219,6 +226,7 @@ TFold TFold::BuildPlainFold(
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
     TFold ff;
+    ff.ProjectionHashCache = MakeHolder<TProjectionHashCache>();
     ff.SampleWeights.resize(learnSampleCount, 1);
 
     InitPermutationData(learnData, shuffle, permuteBlockSize, rand, &ff);
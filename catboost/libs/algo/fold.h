@@ -1,5 +1,6 @@
 #pragma once
 
+#include "index_hash_calcer.h"
 #include "online_ctr.h"
 #include "projection.h"
 #include "target_classifier.h"
@@ -172,6 +173,12 @@ public:
     NCB::TFeaturesArraySubsetIndexing LearnPermutationFeaturesSubset
         = NCB::TFeaturesArraySubsetIndexing(NCB::TIndexedSubset<ui32>());
 
+    /* [objectIdx] -> doc index in this fold's learn permutation
+     * used to update indices from non-default values of sparse columns,
+     * calculated only if learn objects data has sparse columns
+     */
+    TVector<ui32> InvertedLearnPermutation;
+
     /* begin of subset of data in features buckets arrays, used only for permutation block index calculation
      * if (PermutationBlockSize != 1) && (PermutationBlockSize != learnSampleCount))
      */
@@ -184,6 +191,9 @@ public:
     TVector<int> TargetClassesCount;
     ui32 PermutationBlockSize = FoldPermutationBlockSizeNotSet;
 
+    // hashes of projections for online CTRs in this fold's documents order, used by ComputeOnlineCTRs
+    THolder<TProjectionHashCache> ProjectionHashCache;
+
 private:
     TVector<float> LearnWeights;  // Initial document weights. Empty if no weights present.
     double SumWeight;
@@ -4,6 +4,7 @@
 #include "helpers.h"
 #include "index_calcer.h"
 #include "learn_context.h"
+#include "pairwise_scoring.h"
 #include "scoring.h"
 #include "split.h"
 #include "tensor_search_helpers.h"
@@ -17,12 +18,14 @@
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 
 #include <library/fast_log/fast_log.h>
 
 #include <util/generic/cast.h>
 #include <util/generic/xrange.h>
 #include <util/string/builder.h>
+#include <util/system/info.h>
 #include <util/system/mem_info.h>
 
 
@@ -482,11 +485,15 @@ static void ForEachCtrCandidate(
 }
 
 
+/* Projection hash caches of folds are not counted as used memory,
+ * they get memory left under memoryLimit after the online CTRs of the candidates.
+ */
 static void SelectCtrsToDropAfterCalc(
     size_t memoryLimit,
     int sampleCount,
     int threadCount,
     const std::function<bool(const TProjection&)>& isInCache,
+    TConstArrayRef<TProjectionHashCache*> hashCaches,
     TCandidateList* candList) {
 
     size_t maxMemoryForOneCtr = 0;
@@ -502,8 +509,14 @@ static void SelectCtrsToDropAfterCalc(
         },
         candList);
 
-    auto currentMemoryUsage = NMemInfo::GetMemInfo().RSS;
-    if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit) {
+    size_t hashCachesSize = 0;
+    for (const auto* hashCache : hashCaches) {
+        hashCachesSize += hashCache->GetSizeInBytes();
+    }
+    const size_t rss = NMemInfo::GetMemInfo().RSS;
+    auto currentMemoryUsage = rss - Min(rss, hashCachesSize);
+    size_t neededMemory = currentMemoryUsage + fullNeededMemoryForCtrs;
+    if (neededMemory > memoryLimit) {
         CATBOOST_DEBUG_LOG << "Needed more memory then allowed, will drop some ctrs after score calculation"
             << Endl;
         const float GB = (ui64)1024 * 1024 * 1024;
@@ -527,6 +540,15 @@ static void SelectCtrsToDropAfterCalc(
                 }
             },
             candList);
+        neededMemory = currentNonDroppableMemory + maxMemForOtherThreadsApprox;
+    }
+
+    if (!hashCaches.empty()) {
+        const size_t hashCachesLimit = Min<ui64>(memoryLimit, NSystemInfo::TotalMemorySize());
+        const size_t freeMemory = hashCachesLimit > neededMemory ? hashCachesLimit - neededMemory : 0;
+        for (auto* hashCache : hashCaches) {
+            hashCache->SetMaxSizeInBytes(freeMemory / hashCaches.size());
+        }
     }
 }
 
@@ -539,7 +561,11 @@ static void CalcBestScore(
     TFold* fold,
     TLearnContext* ctx) {
 
-    const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    const int depth = currentTree.GetDepth();
+    if (IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
+        SortPairsByLeaves(ctx->SampledDocs.Indices, 1 << depth, &pairs);
+    }
     TCandidateList& candList = candidatesContext->CandidateList;
     const auto& monotonicConstraints = ctx->Params.ObliviousTreeOptions->MonotoneConstraints.Get();
     const TVector<int> currTreeMonotonicConstraints = (
@@ -547,7 +573,14 @@ static void CalcBestScore(
         ? TVector<int>()
         : GetTreeMonotoneConstraints(currentTree, monotonicConstraints)
     );
-    ctx->LocalExecutor->ExecRange(
+    const int sampledDocCount = ctx->SampledDocs.GetDocCount();
+    // rough estimate of memory read per candidate: leaf index, bucket, derivatives and weight for each doc
+    const i64 bytesPerDoc
+        = sizeof(TIndexType) + sizeof(ui32) + (sizeof(double) * ctx->LearnProgress->ApproxDimension) + sizeof(float);
+
+    // candidates cost differs a lot (e.g. CTRs that have to be computed, exclusive bundles of different
+    // width), so both candidates levels use work stealing instead of static partition
+    ctx->LocalExecutor->ExecRangeWithWorkStealing(
         [&](int id) {
             auto& candidate = candList[id];
 
@@ -565,8 +598,22 @@ static void CalcBestScore(
                 }
             }
             TVector<TVector<double>> allScores(candidate.Candidates.size());
-            ctx->LocalExecutor->ExecRange(
+            ctx->LocalExecutor->ExecRangeWithWorkStealing(
                 [&](int oneCandidate) {
+                    NCB::TProfileTraceScope trace("Calc stats and scores", "scoring");
+                    trace.AddArg("depth", depth)
+                        .AddArg("docs", sampledDocCount)
+                        .AddArg("bytes", bytesPerDoc * sampledDocCount);
+                    // to compare stats calculation time of bundles with the time of their features before bundling
+                    const auto& oneSplitEnsemble = candidate.Candidates[oneCandidate].SplitEnsemble;
+                    if (trace.IsEnabled() && (oneSplitEnsemble.Type == ESplitEnsembleType::ExclusiveBundle)) {
+                        const auto bundleIdx = oneSplitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx;
+                        trace.AddArg(
+                            "bundle_parts",
+                            data.Learn->ObjectsData->GetExclusiveFeatureBundlesMetaData()[bundleIdx].Parts.size()
+                        );
+                    }
+
                     THolder<IScoreCalcer> scoreCalcer;
                     if (IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
                         scoreCalcer.Reset(new TPairwiseScoreCalcer);
@@ -758,22 +805,40 @@ void GreedyTensorSearch(
 
         auto isInCache =
             [&fold](const TProjection& proj) -> bool { return fold->GetCtrRef(proj).Feature.empty(); };
+        TVector<TProjectionHashCache*> hashCaches;
+        for (auto& learnFold : ctx->LearnProgress->Folds) {
+            if (learnFold.ProjectionHashCache) {
+                hashCaches.push_back(learnFold.ProjectionHashCache.Get());
+            }
+        }
+        if (ctx->LearnProgress->AveragingFold.ProjectionHashCache) {
+            hashCaches.push_back(ctx->LearnProgress->AveragingFold.ProjectionHashCache.Get());
+        }
         auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
         SelectCtrsToDropAfterCalc(
             cpuUsedRamLimit,
             learnSampleCount + testSampleCount,
             ctx->Params.SystemOptions->NumThreads,
             isInCache,
+            hashCaches,
             &candidatesContext.CandidateList);
 
         CheckInterrupted(); // check after long-lasting operation
 
         if (!isSamplingPerTree) {  // sampling per tree level
+            NCB::TProfileTraceScope trace("Bootstrap");
+            trace.AddArg("depth", curDepth);
             DoBootstrap(indices, fold, ctx);
         }
         profile.AddOperation(TStringBuilder() << "Bootstrap, depth " << curDepth);
 
-        CalcScores(data, currentSplitTree, modelLength, &candidatesContext, fold, ctx);
+        {
+            NCB::TProfileTraceScope trace("Calc scores");
+            trace.AddArg("depth", curDepth)
+                .AddArg("docs", ctx->SampledDocs.GetDocCount())
+                .AddArg("candidates", candidatesContext.CandidateList.ysize());
+            CalcScores(data, currentSplitTree, modelLength, &candidatesContext, fold, ctx);
+        }
 
         size_t maxFeatureValueCount = 1;
         for (const auto& candidate : candidatesContext.CandidateList) {
@@ -790,6 +855,9 @@ void GreedyTensorSearch(
         CheckInterrupted(); // check after long-lasting operation
         profile.AddOperation(TStringBuilder() << "Calc scores " << curDepth);
 
+        NCB::TProfileTraceScope selectBestSplitTrace("Select best split");
+        selectBestSplitTrace.AddArg("depth", curDepth);
+
         double bestScore = MINIMAL_SCORE;
         const TCandidateInfo* bestSplitCandidate = nullptr;
         SelectBestCandidate(*ctx, candidatesContext, maxFeatureValueCount, fold, &bestScore, &bestSplitCandidate);
@@ -82,45 +82,84 @@ inline void UpdateIndicesForSplit(
     }
 }
 
+/* Sparse columns are not made dense: all docs are updated with the default value result in blocks of docs,
+ * then the result is corrected for the docs with non-default values in blocks of objects.
+ * docByObjectIdx - [objectIdx] -> index in indices, empty if it is an identity mapping
+ */
 template <typename T, EFeatureValuesType FeatureValuesType, class TCmpOp>
 inline void ScheduleUpdateIndicesForSplit(
     const TIndexedSubset<ui32>& columnsIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     const TTypedFeatureValuesHolder<T, FeatureValuesType>& column,
     TCmpOp cmpOp,
     int level,
     TIndexType* indices,
-    TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks) {
+    TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks,
+    TVector<std::function<void(TIndexRange<ui32>)>>* updateNonDefaultBlockCallbacks) {
 
-    if (const auto* columnData
-            = dynamic_cast<const TCompressedValuesHolderImpl<T, FeatureValuesType>*>(&column))
+    if (const auto* sparseColumnData
+            = dynamic_cast<const TSparseCompressedValuesHolderImpl<T, FeatureValuesType>*>(&column))
     {
-        const auto* columnsIndexingPtr = &columnsIndexing;
-        const TCompressedArray* compressedArray = columnData->GetCompressedData().GetSrc();
-
-        updateBlockCallbacks->push_back(
-            [columnsIndexingPtr,
-             cmpOp,
-             level,
-             indices,
-             compressedArray]
-                (TIndexRange<ui32> indexRange) {
-
-                NCB::DispatchBitsPerKeyToDataType(
-                    *compressedArray,
-                    "UpdateIndicesForSplit",
-                    [=] (const auto* histogram) {
-                        UpdateIndicesForSplit(
-                            columnsIndexingPtr->data(),
-                            histogram,
-                            indexRange,
-                            cmpOp,
-                            level,
-                            indices);
+        const auto* sparseData = &sparseColumnData->GetData();
+        const bool defaultValueIsTrue = cmpOp(sparseData->GetDefaultValue());
+
+        if (defaultValueIsTrue) {
+            updateBlockCallbacks->push_back(
+                [level, indices] (TIndexRange<ui32> indexRange) {
+                    for (auto doc : indexRange.Iter()) {
+                        indices[doc] += level;
+                    }
+                });
+        }
+        updateNonDefaultBlockCallbacks->push_back(
+            [sparseData, docByObjectIdx, cmpOp, defaultValueIsTrue, level, indices]
+                (TIndexRange<ui32> objectIndexRange) {
+
+                sparseData->ForEachNonDefaultInRange(
+                    objectIndexRange.Begin,
+                    objectIndexRange.End,
+                    [&] (ui32 objectIdx, auto value) {
+                        if (cmpOp(value) == defaultValueIsTrue) {
+                            return;
+                        }
+                        const ui32 doc = docByObjectIdx.empty() ? objectIdx : docByObjectIdx[objectIdx];
+                        if (defaultValueIsTrue) {
+                            indices[doc] -= level;
+                        } else {
+                            indices[doc] += level;
+                        }
                     });
             });
-    } else {
-        CB_ENSURE_INTERNAL(false, "UpdateIndicesForSplit: unsupported column type");
+        return;
     }
+
+    const auto* columnData = dynamic_cast<const TCompressedValuesHolderImpl<T, FeatureValuesType>*>(&column);
+    CB_ENSURE_INTERNAL(columnData, "UpdateIndicesForSplit: unsupported column type");
+
+    const auto* columnsIndexingPtr = &columnsIndexing;
+    const TCompressedArray* compressedArray = columnData->GetCompressedData().GetSrc();
+
+    updateBlockCallbacks->push_back(
+        [columnsIndexingPtr,
+         cmpOp,
+         level,
+         indices,
+         compressedArray]
+            (TIndexRange<ui32> indexRange) {
+
+            NCB::DispatchBitsPerKeyToDataType(
+                *compressedArray,
+                "UpdateIndicesForSplit",
+                [=] (const auto* histogram) {
+                    UpdateIndicesForSplit(
+                        columnsIndexingPtr->data(),
+                        histogram,
+                        indexRange,
+                        cmpOp,
+                        level,
+                        indices);
+                });
+        });
 }
 
 
@@ -130,22 +169,26 @@ void ScheduleUpdateIndicesForSplit(
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
     TConstArrayRef<TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData,
     const TIndexedSubset<ui32>& columnsIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     const TTypedFeatureValuesHolder<T, FeatureValuesType>& column,
     std::function<const TExclusiveFeatureBundleHolder*(ui32)>&& getExclusiveFeaturesBundle,
     std::function<const TBinaryPacksHolder*(ui32)>&& getBinaryFeaturesPack,
     TCmpOp cmpOp,
     int level,
     TIndexType* indices,
-    TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks) {
+    TVector<std::function<void(TIndexRange<ui32>)>>* updateBlockCallbacks,
+    TVector<std::function<void(TIndexRange<ui32>)>>* updateNonDefaultBlockCallbacks) {
 
     auto scheduleUpdateIndicesForSplit = [&] (const auto& column, auto&& cmpOp) {
         ScheduleUpdateIndicesForSplit(
             columnsIndexing,
+            docByObjectIdx,
             column,
             std::move(cmpOp),
             level,
             indices,
-            updateBlockCallbacks);
+            updateBlockCallbacks,
+            updateNonDefaultBlockCallbacks);
     };
 
     if (maybeBinaryIndex) {
@@ -190,6 +233,7 @@ static void UpdateIndices(
     ui32 onlineCtrObjectOffset,
     const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
     const TIndexedSubset<ui32>& columnsIndexing,
+    TConstArrayRef<ui32> docByObjectIdx, // for sparse columns, empty if it is an identity mapping
     NPar::TLocalExecutor* localExecutor,
     TArrayRef<TIndexType> indices) {
 
@@ -197,6 +241,9 @@ static void UpdateIndices(
 
     TVector<std::function<void(TIndexRange<ui32>)>> updateBlockCallbacks;
 
+    // for sparse columns, called after updateBlockCallbacks for all blocks
+    TVector<std::function<void(TIndexRange<ui32>)>> updateNonDefaultBlockCallbacks;
+
     TIndexType* indicesData = indices.data();
 
     for (const auto& splitParams : params) {
@@ -227,6 +274,7 @@ static void UpdateIndices(
                     maybeBinaryIndex,
                     objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
                     columnsIndexing,
+                    docByObjectIdx,
                     column,
                     [&] (ui32 bundleIdx) {
                         return &objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx);
@@ -235,7 +283,8 @@ static void UpdateIndices(
                     std::move(cmpOp),
                     splitWeight,
                     indicesData,
-                    &updateBlockCallbacks);
+                    &updateBlockCallbacks,
+                    &updateNonDefaultBlockCallbacks);
             };
 
 
@@ -292,6 +341,28 @@ static void UpdateIndices(
                 updateBlockCallback(indexRange);
             }
         });
+
+    if (updateNonDefaultBlockCallbacks.empty()) {
+        return;
+    }
+
+    // objects are mapped to different docs so blocks of objects can be processed in parallel
+    const ui32 nonDefaultBlockSize = 10000;
+
+    TSimpleIndexRangesGenerator<ui32> objectIndexRanges(
+        TIndexRange<ui32>(objectsDataProvider.GetObjectCount()),
+        nonDefaultBlockSize);
+
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<int>(objectIndexRanges.RangesCount()),
+        [&] (int blockIdx) {
+            auto objectIndexRange = objectIndexRanges.GetRange((ui32)blockIdx);
+            for (auto& updateNonDefaultBlockCallback : updateNonDefaultBlockCallbacks) {
+                updateNonDefaultBlockCallback(objectIndexRange);
+            }
+        });
 }
 
 void SetPermutedIndices(
@@ -317,6 +388,7 @@ void SetPermutedIndices(
         /*onlineCtrObjectOffset*/ 0,
         objectsDataProvider,
         fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>(),
+        fold.InvertedLearnPermutation,
         localExecutor,
         *indices);
 }
@@ -371,6 +443,7 @@ static void BuildIndicesForDataset(
     const TSplitTree& tree,
     const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
     const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx, // for sparse columns, empty if it is an identity mapping
     ui32 sampleCount,
     const TVector<const TOnlineCTR*>& onlineCtrs,
     ui32 docOffset,
@@ -404,6 +477,7 @@ static void BuildIndicesForDataset(
         docOffset,
         objectsDataProvider,
         *columnsIndexing,
+        docByObjectIdx,
         localExecutor,
         MakeArrayRef(indices, sampleCount));
 }
@@ -431,6 +505,7 @@ TVector<TIndexType> BuildIndices(
             tree,
             *learnData->ObjectsData,
             fold.LearnPermutationFeaturesSubset,
+            fold.InvertedLearnPermutation,
             learnSampleCount,
             onlineCtrs,
             0,
@@ -444,6 +519,7 @@ TVector<TIndexType> BuildIndices(
             tree,
             *testSet.ObjectsData,
             testSet.ObjectsData->GetFeaturesArraySubsetIndexing(),
+            /*docByObjectIdx*/ TConstArrayRef<ui32>(),
             testSet.GetObjectCount(),
             onlineCtrs,
             docOffset,
@@ -13,6 +13,7 @@ void CalcHashes(
     const TProjection& proj,
     const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
     const TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     const TPerfectHashedToHashedCatValuesMap* perfectHashedToHashedCatValuesMap,
     bool processBundledAndBinaryFeaturesInPacks,
     ui64* begin,
@@ -27,7 +28,6 @@ void CalcHashes(
 
     ui64* hashArr = begin;
 
-
     // [bundleIdx]
     TVector<TVector<TCalcHashInBundleContext>> featuresInBundles(
         objectsDataProvider.GetExclusiveFeatureBundlesSize()
@@ -52,6 +52,7 @@ void CalcHashes(
                 objectsDataProvider.GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
                 objectsDataProvider.GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 /*processBundledAndBinaryFeaturesInPacks*/ false,
                 /*isBinaryFeatureEquals1*/ false, // unused
                 TArrayRef<TVector<TCalcHashInBundleContext>>(), // unused
@@ -74,6 +75,7 @@ void CalcHashes(
                 objectsDataProvider.GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
                 objectsDataProvider.GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 processBundledAndBinaryFeaturesInPacks,
                 /*isBinaryFeatureEquals1*/ true,
                 featuresInBundles,
@@ -100,6 +102,7 @@ void CalcHashes(
             objectsDataProvider.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx),
             objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx),
             featuresSubsetIndexing,
+            docByObjectIdx,
             processBundledAndBinaryFeaturesInPacks,
             /*isBinaryFeatureEquals1*/ 1,
             featuresInBundles,
@@ -137,6 +140,7 @@ void CalcHashes(
             objectsDataProvider.GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
             maybeBinaryIndex,
             featuresSubsetIndexing,
+            docByObjectIdx,
             processBundledAndBinaryFeaturesInPacks,
             /*isBinaryFeatureEquals1*/ feature.Value == 1,
             featuresInBundles,
@@ -186,6 +190,7 @@ void CalcHashes(
             ProcessColumnForCalcHashes(
                 objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 std::move(processBundleValue),
                 localExecutor
             );
@@ -207,6 +212,7 @@ void CalcHashes(
             ProcessColumnForCalcHashes(
                 objectsDataProvider.GetBinaryFeaturesPack(packIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 std::move(getBinFromHistogramValue),
                 [=] (ui32 i, ui64 b) {
                     hashArr[i] = CalcHash(hashArr[i], b);
@@ -292,3 +298,67 @@ size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui
     }
     return reindexHash.Size();
 }
+
+
+TProjectionHashCache::TEntryPtr TProjectionHashCache::Find(const TProjection& proj) {
+    with_lock(Lock) {
+        auto it = Entries.find(proj);
+        if (it == Entries.end()) {
+            return nullptr;
+        }
+        UsageList.splice(UsageList.begin(), UsageList, it->second.UsageListPosition);
+        return it->second.Entry;
+    }
+    Y_UNREACHABLE();
+}
+
+void TProjectionHashCache::Insert(const TProjection& proj, TEntryPtr entry) {
+    const size_t entrySize = entry->GetSizeInBytes();
+    with_lock(Lock) {
+        auto it = Entries.find(proj);
+        if (it != Entries.end()) {
+            SizeInBytes -= it->second.Entry->GetSizeInBytes();
+            UsageList.erase(it->second.UsageListPosition);
+            Entries.erase(it);
+        }
+        if (entrySize > MaxSizeInBytes) {
+            return;
+        }
+        EvictToFit(MaxSizeInBytes - entrySize);
+        UsageList.push_front(proj);
+        Entries.emplace(proj, TCachedEntry{std::move(entry), UsageList.begin()});
+        SizeInBytes += entrySize;
+    }
+}
+
+void TProjectionHashCache::SetMaxSizeInBytes(size_t maxSizeInBytes) {
+    with_lock(Lock) {
+        MaxSizeInBytes = maxSizeInBytes;
+        EvictToFit(MaxSizeInBytes);
+    }
+}
+
+size_t TProjectionHashCache::GetSizeInBytes() const {
+    with_lock(Lock) {
+        return SizeInBytes;
+    }
+    Y_UNREACHABLE();
+}
+
+// must be called under Lock
+void TProjectionHashCache::EvictToFit(size_t sizeInBytes) {
+    while (SizeInBytes > sizeInBytes) {
+        auto lruIt = Entries.find(UsageList.back());
+        SizeInBytes -= lruIt->second.Entry->GetSizeInBytes();
+        Entries.erase(lruIt);
+        UsageList.pop_back();
+    }
+}
+
+void TProjectionHashCache::Clear() {
+    with_lock(Lock) {
+        Entries.clear();
+        UsageList.clear();
+        SizeInBytes = 0;
+    }
+}
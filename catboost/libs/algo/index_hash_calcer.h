@@ -1,33 +1,44 @@
 #pragma once
 
+#include "projection.h"
+
 #include <catboost/libs/data_new/objects.h>
 #include <catboost/libs/helpers/clear_array.h>
+#include <catboost/libs/helpers/exception.h>
 
 #include <library/containers/dense_hash/dense_hash.h>
 
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
+#include <util/generic/list.h>
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/system/spinlock.h>
 #include <util/system/yassert.h>
 
 #include <functional>
 
 
-struct TProjection;
-
-
 struct TCalcHashInBundleContext {
     ui32 InBundleIdx = 0;
     std::function<void(ui32, ui32)> CalcHashCallback;
 };
 
 
-template <class T, NCB::EFeatureValuesType FeatureValuesType, class F> // F args are (index, value)
+/* F args are (index, value), f is called once for each index in featuresSubsetIndexing
+ * docByObjectIdx - [objectIdx] -> index for sparse columns, empty if it is an identity mapping
+ */
+template <class T, NCB::EFeatureValuesType FeatureValuesType, class F>
 inline void ProcessColumnForCalcHashes(
     const NCB::TTypedFeatureValuesHolder<T, FeatureValuesType>& column,
     const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     F&& f,
     NPar::TLocalExecutor* localExecutor) {
 
     using TDenseHolder = NCB::TCompressedValuesHolderImpl<T, FeatureValuesType>;
+    using TSparseHolder = NCB::TSparseCompressedValuesHolderImpl<T, FeatureValuesType>;
 
     if (const auto* denseColumnData = dynamic_cast<const TDenseHolder*>(&column)) {
         const TCompressedArray& compressedArray = *denseColumnData->GetCompressedData().GetSrc();
@@ -45,6 +56,49 @@ inline void ProcessColumnForCalcHashes(
                 );
             }
         );
+    } else if (const auto* sparseColumnData = dynamic_cast<const TSparseHolder*>(&column)) {
+        const auto& sparseData = sparseColumnData->GetData();
+        const ui32 size = featuresSubsetIndexing.Size();
+        CB_ENSURE_INTERNAL(
+            (sparseData.GetSize() == size) && (docByObjectIdx.empty() || (docByObjectIdx.size() == size)),
+            "ProcessColumnForCalcHashes: sparse column size does not match features subset size"
+        );
+        const auto getIdx = [docByObjectIdx] (ui32 objectIdx) {
+            return docByObjectIdx.empty() ? objectIdx : docByObjectIdx[objectIdx];
+        };
+
+        // bit mask of indices with non-default values, they are skipped when processing default values
+        TVector<ui64> isNonDefault(CeilDiv<ui32>(size, 64), 0);
+        sparseData.ForEachNonDefault(
+            [&] (ui32 objectIdx, auto /*value*/) {
+                const ui32 i = getIdx(objectIdx);
+                isNonDefault[i / 64] |= ui64(1) << (i % 64);
+            }
+        );
+
+        const ui32 blockSize = 10000;
+        const auto defaultValue = sparseData.GetDefaultValue();
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            SafeIntegerCast<int>(CeilDiv(size, blockSize)),
+            [&] (int blockIdx) {
+                const ui32 blockEnd = Min(size, (ui32)(blockIdx + 1) * blockSize);
+                for (ui32 i = (ui32)blockIdx * blockSize; i < blockEnd; ++i) {
+                    if (!((isNonDefault[i / 64] >> (i % 64)) & 1)) {
+                        f(i, defaultValue);
+                    }
+                }
+                // objects are mapped to different indices so blocks of objects can be processed in parallel
+                sparseData.ForEachNonDefaultInRange(
+                    (ui32)blockIdx * blockSize,
+                    blockEnd,
+                    [&] (ui32 objectIdx, auto value) {
+                        f(getIdx(objectIdx), value);
+                    }
+                );
+            }
+        );
     } else {
         Y_FAIL("ProcessColumnForCalcHashes: unexpected column type");
     }
@@ -54,6 +108,7 @@ template <class T, NCB::EFeatureValuesType FeatureValuesType, class TGetBinFromH
 inline void ProcessColumnForCalcHashes(
     const NCB::TTypedFeatureValuesHolder<T, FeatureValuesType>& column,
     const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     TGetBinFromHistogramValue&& getBinFromHistogramValue,
     F&& f,
     NPar::TLocalExecutor* localExecutor) {
@@ -61,6 +116,7 @@ inline void ProcessColumnForCalcHashes(
     ProcessColumnForCalcHashes(
         column,
         featuresSubsetIndexing,
+        docByObjectIdx,
         [f, getBinFromHistogramValue] (ui32 i, auto value) {
             f(i, getBinFromHistogramValue(value));
         },
@@ -72,6 +128,7 @@ inline void ProcessFeatureForCalcHashes(
     TMaybe<NCB::TExclusiveBundleIndex> maybeExclusiveBundleIndex,
     TMaybe<NCB::TPackedBinaryIndex> maybeBinaryIndex,
     const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx, // for sparse columns, empty if it is an identity mapping
     bool processBundledAndBinaryFeaturesInPacks,
     bool isBinaryFeatureEquals1, // used only if processBinary
     TArrayRef<TVector<TCalcHashInBundleContext>> featuresInBundles,
@@ -102,6 +159,7 @@ inline void ProcessFeatureForCalcHashes(
             ProcessColumnForCalcHashes(
                 *getExclusiveFeatureBundle(bundleIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 [boundsInBundle] (auto bundleData) {
                     return NCB::GetBinFromBundle<decltype(bundleData)>(bundleData, boundsInBundle);
                 },
@@ -123,6 +181,7 @@ inline void ProcessFeatureForCalcHashes(
             ProcessColumnForCalcHashes(
                 *getBinaryFeaturesPack(maybeBinaryIndex->PackIdx),
                 featuresSubsetIndexing,
+                docByObjectIdx,
                 [bitMask, bitIdx] (NCB::TBinaryFeaturesPack featuresPack) {
                     return (featuresPack & bitMask) >> bitIdx;
                 },
@@ -134,6 +193,7 @@ inline void ProcessFeatureForCalcHashes(
         ProcessColumnForCalcHashes(
             *getFeatureColumn(),
             featuresSubsetIndexing,
+            docByObjectIdx,
             [] (auto value) { return value; },
             std::move(f),
             localExecutor
@@ -146,6 +206,8 @@ inline void ProcessFeatureForCalcHashes(
 /// @param proj - Projection delivering the feature ids to hash
 /// @param objectsDataProvider - Values of features to hash
 /// @param featuresSubsetIndexing - Use these indices when accessing raw arrays data
+/// @param docByObjectIdx - [objectIdx] -> index in result range for sparse columns,
+///                         empty if it is an identity mapping
 /// @param perfectHashedToHashedCatValuesMap - if not nullptr use it to Hash original hashed cat values
 //                                             if nullptr - used perfectHashed values
 /// @param processBundledAndBinaryFeaturesInPacks - process bundled and binary features in packs.
@@ -156,6 +218,7 @@ void CalcHashes(
     const TProjection& proj,
     const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
     const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    TConstArrayRef<ui32> docByObjectIdx,
     const NCB::TPerfectHashedToHashedCatValuesMap* perfectHashedToHashedCatValuesMap,
     bool processBundledAndBinaryFeaturesInPacks,
     ui64* begin,
@@ -174,3 +237,52 @@ size_t ComputeReindexHash(ui64 topSize, TDenseHash<ui64, ui32>* reindexHashPtr,
 /// If a hash value is not present in reindexHash, then update reindexHash for that value.
 /// @return the size of updated reindexHash.
 size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end);
+
+
+/// Per-document hashes of projections calculated for online CTRs of one fold (learn and test documents).
+/// Tree CTR candidates are projections of the current tree plus one categorical feature, so their hashes
+/// are calculated from cached hashes of shorter projections.
+/// Least recently used entries are evicted when total size exceeds the limit set by SetMaxSizeInBytes
+/// (nothing is cached until it is set). Thread-safe.
+class TProjectionHashCache {
+public:
+    struct TEntry {
+        TVector<ui64> Hashes; // before reindexing
+
+    public:
+        size_t GetSizeInBytes() const {
+            return sizeof(TEntry) + Hashes.size() * sizeof(ui64);
+        }
+    };
+
+    using TEntryPtr = TAtomicSharedPtr<const TEntry>;
+
+public:
+    // returns nullptr if there's no entry for proj
+    TEntryPtr Find(const TProjection& proj);
+
+    void Insert(const TProjection& proj, TEntryPtr entry);
+
+    // evicts least recently used entries if current size exceeds maxSizeInBytes
+    void SetMaxSizeInBytes(size_t maxSizeInBytes);
+
+    size_t GetSizeInBytes() const;
+
+    void Clear();
+
+private:
+    struct TCachedEntry {
+        TEntryPtr Entry;
+        TList<TProjection>::iterator UsageListPosition;
+    };
+
+private:
+    void EvictToFit(size_t sizeInBytes);
+
+private:
+    mutable TAdaptiveLock Lock;
+    THashMap<TProjection, TCachedEntry> Entries;
+    TList<TProjection> UsageList; // most recently used first
+    size_t SizeInBytes = 0;
+    size_t MaxSizeInBytes = 0;
+};
@@ -6,6 +6,7 @@
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/options/restrictions.h>
 
+#include <library/sse/sse.h>
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
@@ -13,11 +14,46 @@
 #include <util/generic/vector.h>
 #include <util/generic/ymath.h>
 
+#include <functional>
+#include <limits>
+#include <tuple>
+
 
 inline static double GetSingleProbability(double derivativeAbsoluteValue, double threshold) {
     return (derivativeAbsoluteValue > threshold) ? 1.0 : (derivativeAbsoluteValue / threshold);
 }
 
+static void CalcAbsoluteValues(const double* values, ui32 count, double* absoluteValues) {
+    ui32 i = 0;
+#ifdef ARCADIA_SSE
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(absoluteValues + i, _mm_andnot_pd(signMask, _mm_loadu_pd(values + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        absoluteValues[i] = Abs(values[i]);
+    }
+}
+
+// same values as GetSingleProbability(Abs(derivative), threshold), including NaN for zero threshold and derivative
+static void CalcProbabilities(const double* derivatives, ui32 count, double threshold, double* probabilities) {
+    ui32 i = 0;
+#ifdef ARCADIA_SSE
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d ones = _mm_set1_pd(1.0);
+    const __m128d thresholds = _mm_set1_pd(threshold);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d absoluteValues = _mm_andnot_pd(signMask, _mm_loadu_pd(derivatives + i));
+        // _mm_min_pd returns its second operand if any operand is NaN
+        _mm_storeu_pd(probabilities + i, _mm_min_pd(ones, _mm_div_pd(absoluteValues, thresholds)));
+    }
+#endif
+    for (; i < count; ++i) {
+        probabilities[i] = GetSingleProbability(Abs(derivatives[i]), threshold);
+    }
+}
+
 void TMvsSampler::GenSampleWeights(
     EBoostingType boostingType,
     TRestorableFastRng64* rand,
@@ -27,9 +63,7 @@ void TMvsSampler::GenSampleWeights(
     if (GetHeadFraction() == 1.0f) {
         Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1.0f);
     } else {
-        TVector<ui32> docIndices(SampleCount);
         TVector<double> tailDerivatives;
-        Iota(docIndices.begin(), docIndices.end(), 0);
         CB_ENSURE_INTERNAL(
             fold->BodyTailArr[0].WeightedDerivatives.size() == 1,
             "MVS bootstrap mode is not implemented for multi-dimensional approxes"
@@ -61,27 +95,32 @@ void TMvsSampler::GenSampleWeights(
             );
             derivatives = tailDerivatives.data();
         }
+
+        // absolute derivatives for threshold selection, then probabilities for weight generation;
+        // block split does not depend on thread count, so weights are deterministic for a given seed
+        TVector<double> docValues;
+        docValues.yresize(SampleCount);
         TVector<double> sampleThresholds(CB_THREAD_LIMIT);
         NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
         blockParams.SetBlockCount(CB_THREAD_LIMIT);
+        const auto getBlockBounds = [&] (ui32 blockId) {
+            const ui32 blockOffset = blockId * blockParams.GetBlockSize();
+            const ui32 blockSize = Min(
+                static_cast<ui32>(blockParams.GetBlockSize()),
+                SampleCount - blockOffset
+            );
+            return std::make_pair(blockOffset, blockSize);
+        };
         localExecutor->ExecRange(
             [&](ui32 blockId) {
-                const ui32 blockOffset = blockId * blockParams.GetBlockSize();
-                const ui32 blockSize = Min(
-                    static_cast<ui32>(blockParams.GetBlockSize()),
-                    SampleCount - blockOffset
-                );
-                const ui32 blockFinish = blockOffset + blockSize;
-                ui32 headCount = Min(static_cast<ui32>(GetHeadFraction() * blockSize), blockSize);
-                NthElement(
-                    docIndices.begin() + blockOffset,
-                    docIndices.begin() + blockOffset + headCount,
-                    docIndices.begin() + blockFinish,
-                    [derivatives](ui32 lhs, ui32 rhs) {
-                        return Abs(derivatives[lhs]) > Abs(derivatives[rhs]);
-                    }
-                );
-                sampleThresholds[blockId] = Abs(derivatives[docIndices[blockOffset + headCount]]);
+                ui32 blockOffset;
+                ui32 blockSize;
+                std::tie(blockOffset, blockSize) = getBlockBounds(blockId);
+                double* blockValues = docValues.data() + blockOffset;
+                CalcAbsoluteValues(derivatives + blockOffset, blockSize, blockValues);
+                ui32 headCount = Min(static_cast<ui32>(GetHeadFraction() * blockSize), blockSize - 1);
+                NthElement(blockValues, blockValues + headCount, blockValues + blockSize, std::greater<double>());
+                sampleThresholds[blockId] = blockValues[headCount];
             },
             0,
             blockParams.GetBlockCount(),
@@ -95,20 +134,21 @@ void TMvsSampler::GenSampleWeights(
             [&](ui32 blockId) {
                 TRestorableFastRng64 prng(randSeed + blockId);
                 prng.Advance(10); // reduce correlation between RNGs in different threads
-                const ui32 blockOffset = blockId * blockParams.GetBlockSize();
-                const ui32 blockSize = Min(
-                    static_cast<ui32>(blockParams.GetBlockSize()),
-                    SampleCount - blockOffset
-                );
-                const ui32 blockFinish = blockOffset + blockSize;
-                for (ui32 i = blockOffset; i < blockFinish; ++i) {
-                    const double probability = GetSingleProbability(Abs(derivatives[i]), threshold);
+                ui32 blockOffset;
+                ui32 blockSize;
+                std::tie(blockOffset, blockSize) = getBlockBounds(blockId);
+                double* probabilities = docValues.data() + blockOffset;
+                CalcProbabilities(derivatives + blockOffset, blockSize, threshold, probabilities);
+                float* weights = fold->SampleWeights.data() + blockOffset;
+                // random numbers are drawn only for documents with nonzero probability, as before
+                for (ui32 i = 0; i < blockSize; ++i) {
+                    const double probability = probabilities[i];
                     if (probability > std::numeric_limits<double>::epsilon()) {
                         const double weight = 1 / probability;
                         double r = prng.GenRandReal1();
-                        fold->SampleWeights[i] = weight * (r < probability);
+                        weights[i] = weight * (r < probability);
                     } else {
-                        fold->SampleWeights[i] = 0;
+                        weights[i] = 0;
                     }
                 }
             },
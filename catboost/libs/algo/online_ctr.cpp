@@ -11,12 +11,14 @@
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/model/ctr_value_table.h>
+#include <catboost/libs/model/hash.h>
 #include <catboost/libs/model/model.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/bitops.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/system/mem_info.h>
 #include <util/thread/singleton.h>
 
@@ -507,6 +509,168 @@ static inline void CountOnlineCTRTotal(
     }
 }
 
+// combine is called with (hash, featureValue) for learn documents in fold order and then test documents
+template <class TCombine>
+static void CombineCatFeatureWithHashes(
+    const TTrainingForCPUDataProviders& data,
+    const TFold& fold,
+    TCatFeatureIdx catFeatureIdx,
+    TCombine&& combine,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<ui64> hashArr) {
+
+    const size_t learnSampleCount = data.Learn->GetObjectCount();
+    const size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+
+    if (learnSampleCount > 0) {
+        ProcessFeatureForCalcHashes<ui32, EFeatureValuesType::PerfectHashedCategorical>(
+            data.Learn->ObjectsData->GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
+            data.Learn->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
+            fold.LearnPermutationFeaturesSubset,
+            fold.InvertedLearnPermutation,
+            /*processBundledAndBinaryFeaturesInPacks*/ false,
+            /*isBinaryFeatureEquals1*/ false, // unused
+            TArrayRef<TVector<TCalcHashInBundleContext>>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            [&]() { return *data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx); },
+            [&](ui32 bundleIdx) {
+                return data.Learn->ObjectsData->GetExclusiveFeatureBundlesMetaData()[bundleIdx];
+            },
+            [&](ui32 bundleIdx) { return &data.Learn->ObjectsData->GetExclusiveFeaturesBundle(bundleIdx); },
+            [&](ui32 packIdx) { return &data.Learn->ObjectsData->GetBinaryFeaturesPack(packIdx); },
+            [hashArr, combine] (ui32 i, ui32 featureValue) {
+                combine(&hashArr[i], featureValue);
+            },
+            localExecutor
+        );
+    }
+    for (size_t docOffset = learnSampleCount, testIdx = 0;
+         docOffset < totalSampleCount && testIdx < data.Test.size();
+         ++testIdx)
+    {
+        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+
+        ProcessFeatureForCalcHashes<ui32, EFeatureValuesType::PerfectHashedCategorical>(
+            data.Test[testIdx]->ObjectsData->GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
+            data.Test[testIdx]->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
+            data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+            /*docByObjectIdx*/ TConstArrayRef<ui32>(),
+            /*processBundledAndBinaryFeaturesInPacks*/ false,
+            /*isBinaryFeatureEquals1*/ false, // unused
+            TArrayRef<TVector<TCalcHashInBundleContext>>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            [&]() { return *data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx); },
+            [&](ui32 bundleIdx) {
+                return data.Test[testIdx]->ObjectsData->GetExclusiveFeatureBundlesMetaData()[bundleIdx];
+            },
+            [&](ui32 bundleIdx) {
+                return &data.Test[testIdx]->ObjectsData->GetExclusiveFeaturesBundle(bundleIdx);
+            },
+            [&](ui32 packIdx) { return &data.Test[testIdx]->ObjectsData->GetBinaryFeaturesPack(packIdx); },
+            [hashArr, combine, docOffset] (ui32 i, ui32 featureValue) {
+                combine(&hashArr[docOffset + i], featureValue);
+            },
+            localExecutor
+        );
+
+        docOffset += testSampleCount;
+    }
+}
+
+/* Hashes of projection with several features for online CTRs.
+ * Categorical features are hashed after other features in projection, so hashes of proj + catFeature
+ * are calculated from cached hashes of proj (or of the longest cached prefix of categorical features).
+ * Hashes do not depend on cache contents. Calculated hashes are added to the cache.
+ */
+static void CalcProjectionHashes(
+    const TTrainingForCPUDataProviders& data,
+    const TFold& fold,
+    const TProjection& proj,
+    const TLearnContext* ctx,
+    TProjectionHashCache* hashCache, // can be nullptr
+    TVector<ui64>* hashArr) {
+
+    const size_t learnSampleCount = data.Learn->GetObjectCount();
+    const size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+
+    TProjection nonCatProj = proj;
+    nonCatProj.CatFeatures.clear();
+
+    size_t hashedCatFeatureCount = 0;
+    TProjectionHashCache::TEntryPtr prefixEntry;
+    if (hashCache) {
+        TProjection prefixProj = nonCatProj;
+        for (size_t prefixSize = proj.CatFeatures.size(); prefixSize > 0; --prefixSize) {
+            prefixProj.CatFeatures.assign(proj.CatFeatures.begin(), proj.CatFeatures.begin() + prefixSize);
+            if (prefixProj.IsEmpty()) {
+                break;
+            }
+            prefixEntry = hashCache->Find(prefixProj);
+            if (prefixEntry && (prefixEntry->Hashes.size() == totalSampleCount)) {
+                hashedCatFeatureCount = prefixSize;
+                break;
+            }
+            prefixEntry = nullptr;
+        }
+    }
+
+    if (prefixEntry) {
+        hashArr->assign(prefixEntry->Hashes.begin(), prefixEntry->Hashes.end());
+    } else {
+        Clear(hashArr, totalSampleCount);
+        if (!nonCatProj.IsEmpty()) {
+            CalcHashes(
+                nonCatProj,
+                *data.Learn->ObjectsData,
+                fold.LearnPermutationFeaturesSubset,
+                fold.InvertedLearnPermutation,
+                nullptr,
+                /*processBundledAndBinaryFeaturesInPacks*/ ctx->LearnAndTestDataPackingAreCompatible,
+                hashArr->begin(),
+                hashArr->begin() + learnSampleCount,
+                ctx->LocalExecutor);
+            for (size_t docOffset = learnSampleCount, testIdx = 0;
+                 docOffset < totalSampleCount && testIdx < data.Test.size();
+                 ++testIdx)
+            {
+                const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+                CalcHashes(
+                    nonCatProj,
+                    *data.Test[testIdx]->ObjectsData,
+                    data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                    /*docByObjectIdx*/ TConstArrayRef<ui32>(),
+                    nullptr,
+                    /*processBundledAndBinaryFeaturesInPacks*/ ctx->LearnAndTestDataPackingAreCompatible,
+                    hashArr->begin() + docOffset,
+                    hashArr->begin() + docOffset + testSampleCount,
+                    ctx->LocalExecutor);
+                docOffset += testSampleCount;
+            }
+        }
+    }
+
+    for (size_t catFeatureIdx : xrange(hashedCatFeatureCount, proj.CatFeatures.size())) {
+        CombineCatFeatureWithHashes(
+            data,
+            fold,
+            TCatFeatureIdx((ui32)proj.CatFeatures[catFeatureIdx]),
+            [] (ui64* hash, ui32 featureValue) {
+                *hash = CalcHash(*hash, (ui64)featureValue + 1);
+            },
+            ctx->LocalExecutor,
+            *hashArr
+        );
+    }
+
+    if (hashCache && (hashedCatFeatureCount < proj.CatFeatures.size())) {
+        auto newEntry = MakeHolder<TProjectionHashCache::TEntry>();
+        newEntry->Hashes = *hashArr;
+        hashCache->Insert(proj, TProjectionHashCache::TEntryPtr(newEntry.Release()));
+    }
+}
+
 void ComputeOnlineCTRs(
     const TTrainingForCPUDataProviders& data,
     const TFold& fold,
@@ -534,90 +698,23 @@ void ComputeOnlineCTRs(
         auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
 
         Clear(&hashArr, totalSampleCount);
-        TArrayRef<ui64> hashArrView = hashArr;
-        if (learnSampleCount > 0) {
-            ProcessFeatureForCalcHashes<ui32, EFeatureValuesType::PerfectHashedCategorical>(
-                data.Learn->ObjectsData->GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
-                data.Learn->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                fold.LearnPermutationFeaturesSubset,
-                /*processBundledAndBinaryFeaturesInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TVector<TCalcHashInBundleContext>>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 bundleIdx) {
-                    return data.Learn->ObjectsData->GetExclusiveFeatureBundlesMetaData()[bundleIdx];
-                },
-                [&](ui32 bundleIdx) { return &data.Learn->ObjectsData->GetExclusiveFeaturesBundle(bundleIdx); },
-                [&](ui32 packIdx) { return &data.Learn->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView] (ui32 i, ui32 featureValue) {
-                    hashArrView[i] = (ui64)featureValue + 1;
-                },
-                ctx->LocalExecutor
-            );
-        }
-        for (size_t docOffset = learnSampleCount, testIdx = 0;
-             docOffset < totalSampleCount && testIdx < data.Test.size();
-             ++testIdx)
-        {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-
-            ProcessFeatureForCalcHashes<ui32, EFeatureValuesType::PerfectHashedCategorical>(
-                data.Test[testIdx]->ObjectsData->GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
-                data.Test[testIdx]->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                /*processBundledAndBinaryFeaturesInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TVector<TCalcHashInBundleContext>>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 bundleIdx) {
-                    return data.Test[testIdx]->ObjectsData->GetExclusiveFeatureBundlesMetaData()[bundleIdx];
-                },
-                [&](ui32 bundleIdx) {
-                    return &data.Test[testIdx]->ObjectsData->GetExclusiveFeaturesBundle(bundleIdx);
-                },
-                [&](ui32 packIdx) { return &data.Test[testIdx]->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView, docOffset] (ui32 i, ui32 featureValue) {
-                    hashArrView[docOffset + i] = (ui64)featureValue + 1;
-                },
-                ctx->LocalExecutor
-            );
-
-            docOffset += testSampleCount;
-        }
+        CombineCatFeatureWithHashes(
+            data,
+            fold,
+            catFeatureIdx,
+            [] (ui64* hash, ui32 featureValue) {
+                *hash = (ui64)featureValue + 1;
+            },
+            ctx->LocalExecutor,
+            hashArr
+        );
         rehashHashTlsVal.Get().MakeEmpty(
-            quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
+            quantizedFeaturesInfo.GetUniqueValuesCounts(catFeatureIdx).OnLearnOnly
         );
     } else {
-        Clear(&hashArr, totalSampleCount);
-        CalcHashes(
-            proj,
-            *data.Learn->ObjectsData,
-            fold.LearnPermutationFeaturesSubset,
-            nullptr,
-            /*processBundledAndBinaryFeaturesInPacks*/ ctx->LearnAndTestDataPackingAreCompatible,
-            hashArr.begin(),
-            hashArr.begin() + learnSampleCount,
-            ctx->LocalExecutor);
-        for (size_t docOffset = learnSampleCount, testIdx = 0;
-             docOffset < totalSampleCount && testIdx < data.Test.size();
-             ++testIdx)
-        {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            CalcHashes(
-                proj,
-                *data.Test[testIdx]->ObjectsData,
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                nullptr,
-                /*processBundledAndBinaryFeaturesInPacks*/ ctx->LearnAndTestDataPackingAreCompatible,
-                hashArr.begin() + docOffset,
-                hashArr.begin() + docOffset + testSampleCount,
-                ctx->LocalExecutor);
-            docOffset += testSampleCount;
-        }
+        // simple ctrs are calculated once per fold, so only projections with several features are cached
+        CalcProjectionHashes(data, fold, proj, ctx, fold.ProjectionHashCache.Get(), &hashArr);
+
         size_t approxBucketsCount = 1;
         for (auto cf : proj.CatFeatures) {
             approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
@@ -809,6 +906,7 @@ static void CalcFinalCtrs(
     const TProjection& projection,
     const TDatasetDataForFinalCtrs& datasetDataForFinalCtrs,
     const NCB::TFeaturesArraySubsetIndexing& learnFeaturesSubsetIndexing,
+    TConstArrayRef<ui32> learnDocByObjectIdx, // for sparse columns, empty if it is an identity mapping
     const NCB::TPerfectHashedToHashedCatValuesMap& perfectHashedToHashedCatValuesMap,
     int targetBorderClassifierIdx,
     ui64 ctrLeafCountLimit,
@@ -827,6 +925,7 @@ static void CalcFinalCtrs(
         projection,
         *datasetDataForFinalCtrs.Data.Learn->ObjectsData,
         learnFeaturesSubsetIndexing,
+        learnDocByObjectIdx,
         &perfectHashedToHashedCatValuesMap,
         /*processBundledAndBinaryFeaturesInPacks*/ false,
         hashArr.begin(),
@@ -841,6 +940,7 @@ static void CalcFinalCtrs(
                 projection,
                 *testDataPtr->ObjectsData,
                 testDataPtr->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                /*docByObjectIdx*/ TConstArrayRef<ui32>(),
                 &perfectHashedToHashedCatValuesMap,
                 /*processBundledAndBinaryFeaturesInPacks*/ false,
                 testHashBegin,
@@ -939,11 +1039,20 @@ void CalcFinalCtrsAndSaveToModel(
 
     TMaybe<TFeaturesArraySubsetIndexing> permutedLearnFeaturesSubsetIndexing;
     const TFeaturesArraySubsetIndexing* learnFeaturesSubsetIndexing = nullptr;
+    TVector<ui32> learnDocByObjectIdx; // for sparse columns
     if (datasetDataForFinalCtrs.LearnPermutation) {
         permutedLearnFeaturesSubsetIndexing = Compose(
             datasetDataForFinalCtrs.Data.Learn->ObjectsData->GetFeaturesArraySubsetIndexing(),
             **datasetDataForFinalCtrs.LearnPermutation);
         learnFeaturesSubsetIndexing = &*permutedLearnFeaturesSubsetIndexing;
+
+        if (datasetDataForFinalCtrs.Data.Learn->ObjectsData->HasSparseData()) {
+            const auto& learnPermutation = **datasetDataForFinalCtrs.LearnPermutation;
+            learnDocByObjectIdx.yresize(learnPermutation.Size());
+            learnPermutation.ForEach(
+                [&] (ui32 doc, ui32 objectIdx) { learnDocByObjectIdx[objectIdx] = doc; }
+            );
+        }
     } else {
         learnFeaturesSubsetIndexing =
             &datasetDataForFinalCtrs.Data.Learn->ObjectsData->GetFeaturesArraySubsetIndexing();
@@ -969,6 +1078,7 @@ void CalcFinalCtrsAndSaveToModel(
                 featureCombinationToProjectionMap.at(ctr.Projection),
                 datasetDataForFinalCtrs,
                 *learnFeaturesSubsetIndexing,
+                learnDocByObjectIdx,
                 perfectHashedToHashedCatValuesMap,
                 ctr.TargetBorderClassifierIdx,
                 ctrLeafCountLimit,
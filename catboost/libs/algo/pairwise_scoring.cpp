@@ -4,6 +4,7 @@
 #include <catboost/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include "short_vector_ops.h"
 
+#include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
 #include <util/system/yassert.h>
 
@@ -11,6 +12,41 @@
 using namespace NCB;
 
 
+void SortPairsByLeaves(TConstArrayRef<TIndexType> leafIndices, int leafCount, TFlatPairsInfo* pairs) {
+    const auto getLeafPairIdx = [=] (const TPair& pair) {
+        return (ui64)leafIndices[pair.WinnerId] * leafCount + leafIndices[pair.LoserId];
+    };
+    const auto isSelfPair = [] (const TPair& pair) {
+        return pair.WinnerId == pair.LoserId;
+    };
+    const ui64 leafPairCount = (ui64)leafCount * leafCount;
+    if (leafPairCount > Max<ui64>(pairs->size(), 1 << 16)) {
+        EraseIf(*pairs, isSelfPair);
+        StableSortBy(*pairs, getLeafPairIdx);
+        return;
+    }
+
+    // counting sort
+    TVector<ui32> leafPairOffsets(leafPairCount + 1, 0);
+    for (const auto& pair : *pairs) {
+        if (!isSelfPair(pair)) {
+            ++leafPairOffsets[getLeafPairIdx(pair) + 1];
+        }
+    }
+    for (auto leafPairIdx : xrange<ui64>(leafPairCount)) {
+        leafPairOffsets[leafPairIdx + 1] += leafPairOffsets[leafPairIdx];
+    }
+    TFlatPairsInfo sortedPairs;
+    sortedPairs.yresize(leafPairOffsets.back());
+    for (const auto& pair : *pairs) {
+        if (!isSelfPair(pair)) {
+            sortedPairs[leafPairOffsets[getLeafPairIdx(pair)]++] = pair;
+        }
+    }
+    pairs->swap(sortedPairs);
+}
+
+
 void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(SplitEnsembleSpec == rhs.SplitEnsembleSpec);
 
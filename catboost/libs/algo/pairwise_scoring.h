@@ -10,6 +10,12 @@
 
 #include <library/binsaver/bin_saver.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+
+#include <type_traits>
+
 
 struct TBucketPairWeightStatistics {
     double SmallerBorderWeightSum = 0.0; // The weight sum of pair elements with smaller border.
@@ -44,6 +50,13 @@ public:
 };
 
 
+/* Reorders pairs by (winner leaf, loser leaf) and drops pairs of a document with itself.
+ * Called once per tree depth so that pair weight statistics of all split candidates are accumulated
+ * leaf pair by leaf pair.
+ */
+void SortPairsByLeaves(TConstArrayRef<TIndexType> leafIndices, int leafCount, TFlatPairsInfo* pairs);
+
+
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TVector<TVector<double>> ComputeDerSums(
@@ -64,6 +77,44 @@ inline TVector<TVector<double>> ComputeDerSums(
     return derSums;
 }
 
+// Pairs are processed in chunks: leaf indices and values (buckets, packs or bundles) of both pair documents
+// are gathered into contiguous arrays first, so random accesses to document data are not interleaved with
+// statistics updates. For pairs sorted with SortPairsByLeaves consecutive pairs update the same leaf pair.
+// TGetValueFunc is of type TValue(ui32 docId),
+// TAddPairFunc is of type void(TIndexType winnerLeafId, TIndexType loserLeafId, TValue winnerValue,
+//  TValue loserValue, float weight)
+template <class TGetValueFunc, class TAddPairFunc>
+inline void ForEachPairWithGatheredValues(
+    const TFlatPairsInfo& pairs,
+    const TVector<TIndexType>& leafIndices,
+    TGetValueFunc getValueFunc,
+    NCB::TIndexRange<int> pairIndexRange,
+    TAddPairFunc addPairFunc
+) {
+    using TValue = std::decay_t<decltype(getValueFunc(ui32()))>;
+    constexpr int ChunkSize = 256;
+    TIndexType winnerLeafIds[ChunkSize];
+    TIndexType loserLeafIds[ChunkSize];
+    TValue winnerValues[ChunkSize];
+    TValue loserValues[ChunkSize];
+    for (int chunkBegin = pairIndexRange.Begin; chunkBegin < pairIndexRange.End; chunkBegin += ChunkSize) {
+        const int chunkSize = Min(ChunkSize, pairIndexRange.End - chunkBegin);
+        const TPair* chunkPairs = pairs.data() + chunkBegin;
+        for (int idx : xrange(chunkSize)) {
+            winnerLeafIds[idx] = leafIndices[chunkPairs[idx].WinnerId];
+            loserLeafIds[idx] = leafIndices[chunkPairs[idx].LoserId];
+            winnerValues[idx] = getValueFunc(chunkPairs[idx].WinnerId);
+            loserValues[idx] = getValueFunc(chunkPairs[idx].LoserId);
+        }
+        for (int idx : xrange(chunkSize)) {
+            if (chunkPairs[idx].WinnerId == chunkPairs[idx].LoserId) {
+                continue;
+            }
+            addPairFunc(winnerLeafIds[idx], loserLeafIds[idx], winnerValues[idx], loserValues[idx], chunkPairs[idx].Weight);
+        }
+    }
+}
+
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistics(
@@ -76,25 +127,21 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 ) {
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
-    for (size_t pairIdx : pairIndexRange.Iter()) {
-        const auto winnerIdx = pairs[pairIdx].WinnerId;
-        const auto loserIdx = pairs[pairIdx].LoserId;
-        if (winnerIdx == loserIdx) {
-            continue;
-        }
-        const size_t winnerBucketId = getBucketFunc(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
-        const size_t loserBucketId = getBucketFunc(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
-        const float weight = pairs[pairIdx].Weight;
-        if (winnerBucketId > loserBucketId) {
-            weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
-        } else {
-            weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+    ForEachPairWithGatheredValues(
+        pairs,
+        leafIndices,
+        getBucketFunc,
+        pairIndexRange,
+        [&] (auto winnerLeafId, auto loserLeafId, size_t winnerBucketId, size_t loserBucketId, float weight) {
+            if (winnerBucketId > loserBucketId) {
+                weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
+                weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
+            } else {
+                weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
+                weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+            }
         }
-    }
+    );
 
     return weightSums;
 }
@@ -113,39 +160,44 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(2 * binaryFeaturesCount));
-    for (size_t pairIdx : pairIndexRange.Iter()) {
-        const auto winnerIdx = pairs[pairIdx].WinnerId;
-        const auto loserIdx = pairs[pairIdx].LoserId;
-        if (winnerIdx == loserIdx) {
-            continue;
-        }
-        const NCB::TBinaryFeaturesPack winnerFeaturesPack = getBinaryFeaturesPack(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
-        const NCB::TBinaryFeaturesPack loserFeaturesPack = getBinaryFeaturesPack(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
-        const float weight = pairs[pairIdx].Weight;
-
-        for (auto bitIndex : xrange<NCB::TBinaryFeaturesPack>(binaryFeaturesCount)) {
-            auto winnerBit = (winnerFeaturesPack >> bitIndex) & 1;
-            auto loserBit = (loserFeaturesPack >> bitIndex) & 1;
-
-            if (winnerBit > loserBit) {
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex].SmallerBorderWeightSum -= weight;
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
-            } else {
-                auto winnerBucketId = 2 * bitIndex + winnerBit;
-                weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
-                auto loserBucketId = 2 * bitIndex + loserBit;
-                weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+    ForEachPairWithGatheredValues(
+        pairs,
+        leafIndices,
+        getBinaryFeaturesPack,
+        pairIndexRange,
+        [&] (
+            auto winnerLeafId,
+            auto loserLeafId,
+            NCB::TBinaryFeaturesPack winnerFeaturesPack,
+            NCB::TBinaryFeaturesPack loserFeaturesPack,
+            float weight
+        ) {
+            for (auto bitIndex : xrange<NCB::TBinaryFeaturesPack>(binaryFeaturesCount)) {
+                auto winnerBit = (winnerFeaturesPack >> bitIndex) & 1;
+                auto loserBit = (loserFeaturesPack >> bitIndex) & 1;
+
+                if (winnerBit > loserBit) {
+                    weightSums[loserLeafId][winnerLeafId][2 * bitIndex].SmallerBorderWeightSum -= weight;
+                    weightSums[loserLeafId][winnerLeafId][2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
+                } else {
+                    auto winnerBucketId = 2 * bitIndex + winnerBit;
+                    weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
+                    auto loserBucketId = 2 * bitIndex + loserBit;
+                    weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+                }
             }
         }
-    }
+    );
 
     return weightSums;
 }
 
 
 // TGetExclusiveFeaturesBundleValue is of type TBundle(ui32 docId)
+// Statistics of all used bundle parts are accumulated in one histogram over their combined buckets: a bundle
+// value is mapped to its part and bucket with one lookup, so each pair updates only the parts where its
+// documents have non-default values (at most two). The pair contribution to zero buckets of all other parts is
+// the same, it is accumulated once per leaf pair and added to each part after all pairs are processed.
 template <class TGetExclusiveFeaturesBundleValue>
 inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatisticsForExclusiveFeaturesBundle(
     ui32 oneHotMaxSize,
@@ -156,58 +208,110 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     TGetExclusiveFeaturesBundleValue getExclusiveFeaturesBundleValue,
     NCB::TIndexRange<int> pairIndexRange
 ) {
-    size_t totalBucketCount = 0;
-    TVector<bool> calcStatsForBundlePart; // don't calc for cat features that are not one hot
-    calcStatsForBundlePart.yresize(exclusiveFeaturesBundle.Parts.size());
-
-    for (auto bundlePartIdx : xrange(exclusiveFeaturesBundle.Parts.size())) {
-        const auto& bundlePart = exclusiveFeaturesBundle.Parts[bundlePartIdx];
-        if (UseForCalcScores(bundlePart, oneHotMaxSize)) {
-            totalBucketCount += bundlePart.Bounds.GetSize() + 1;
-            calcStatsForBundlePart[bundlePartIdx] = true;
-        } else {
-            calcStatsForBundlePart[bundlePartIdx] = false;
+    constexpr ui32 NotUsedPartIdx = Max<ui32>();
+
+    // [bundleValue], default value and values of parts not used for scores (cat features that are not one hot)
+    //  have NotUsedPartIdx
+    TVector<ui32> usedPartIdxByBundleValue(exclusiveFeaturesBundle.GetBinCount(), NotUsedPartIdx);
+    TVector<ui32> bucketByBundleValue(exclusiveFeaturesBundle.GetBinCount(), 0);
+
+    TVector<ui32> zeroBuckets; // [usedPartIdx]
+
+    ui32 totalBucketCount = 0;
+    for (const auto& bundlePart : exclusiveFeaturesBundle.Parts) {
+        if (!UseForCalcScores(bundlePart, oneHotMaxSize)) {
+            continue;
         }
+        const ui32 usedPartIdx = zeroBuckets.size();
+        zeroBuckets.push_back(totalBucketCount);
+        for (auto bundleValue : bundlePart.Bounds.Iter()) {
+            usedPartIdxByBundleValue[bundleValue] = usedPartIdx;
+            bucketByBundleValue[bundleValue]
+                = totalBucketCount + NCB::GetBinFromBundle<ui32>(bundleValue, bundlePart.Bounds);
+        }
+        totalBucketCount += bundlePart.Bounds.GetSize() + 1;
     }
+    const size_t usedPartCount = zeroBuckets.size();
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(totalBucketCount));
-    for (size_t pairIdx : pairIndexRange.Iter()) {
-        const auto winnerIdx = pairs[pairIdx].WinnerId;
-        const auto loserIdx = pairs[pairIdx].LoserId;
-        if (winnerIdx == loserIdx) {
-            continue;
-        }
-        const ui32 winnerBundleValue = getExclusiveFeaturesBundleValue(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
-        const ui32 loserBundleValue = getExclusiveFeaturesBundleValue(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
-        const float weight = pairs[pairIdx].Weight;
-
-        ui32 bucketOffset = 0;
-        for (auto bundlePartIdx : xrange(exclusiveFeaturesBundle.Parts.size())) {
-            if (!calcStatsForBundlePart[bundlePartIdx]) {
-                continue;
-            }
-
-            NCB::TBoundsInBundle boundsInBundle = exclusiveFeaturesBundle.Parts[bundlePartIdx].Bounds;
 
-            auto winnerBucketId = NCB::GetBinFromBundle<ui32>(winnerBundleValue, boundsInBundle);
-            auto loserBucketId = NCB::GetBinFromBundle<ui32>(loserBundleValue, boundsInBundle);
+    TArray2D<double> pairWeightSums(leafCount, leafCount);
+    pairWeightSums.FillZero();
+
+    // weight sums of pairs with non-default value of at least one document in part
+    TArray2D<TVector<double>> nonDefaultPairWeightSums(leafCount, leafCount); // [usedPartIdx]
+    nonDefaultPairWeightSums.FillEvery(TVector<double>(usedPartCount));
+
+    const auto addPairToPart = [&] (
+        TIndexType winnerLeafId,
+        TIndexType loserLeafId,
+        ui32 usedPartIdx,
+        ui32 winnerBucketId,
+        ui32 loserBucketId,
+        float weight
+    ) {
+        nonDefaultPairWeightSums[winnerLeafId][loserLeafId][usedPartIdx] += weight;
+        if (winnerBucketId > loserBucketId) {
+            weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
+            weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
+        } else {
+            weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
+            weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+        }
+    };
 
-            if (winnerBucketId > loserBucketId) {
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
-                    -= weight;
-            } else {
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + winnerBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + loserBucketId].GreaterBorderRightWeightSum
-                    -= weight;
+    ForEachPairWithGatheredValues(
+        pairs,
+        leafIndices,
+        getExclusiveFeaturesBundleValue,
+        pairIndexRange,
+        [&] (auto winnerLeafId, auto loserLeafId, ui32 winnerBundleValue, ui32 loserBundleValue, float weight) {
+            pairWeightSums[winnerLeafId][loserLeafId] += weight;
+
+            const ui32 winnerPartIdx = usedPartIdxByBundleValue[winnerBundleValue];
+            const ui32 loserPartIdx = usedPartIdxByBundleValue[loserBundleValue];
+            if (winnerPartIdx != NotUsedPartIdx) {
+                addPairToPart(
+                    winnerLeafId,
+                    loserLeafId,
+                    winnerPartIdx,
+                    bucketByBundleValue[winnerBundleValue],
+                    (loserPartIdx == winnerPartIdx) ?
+                        bucketByBundleValue[loserBundleValue]
+                        : zeroBuckets[winnerPartIdx],
+                    weight
+                );
             }
+            if ((loserPartIdx != NotUsedPartIdx) && (loserPartIdx != winnerPartIdx)) {
+                addPairToPart(
+                    winnerLeafId,
+                    loserLeafId,
+                    loserPartIdx,
+                    zeroBuckets[loserPartIdx],
+                    bucketByBundleValue[loserBundleValue],
+                    weight
+                );
+            }
+        }
+    );
 
-            bucketOffset += boundsInBundle.GetSize() + 1;
+    // both documents are in zero buckets: the same as 'else' branch of addPairToPart with equal buckets
+    for (auto winnerLeafId : xrange(leafCount)) {
+        for (auto loserLeafId : xrange(leafCount)) {
+            const double pairWeightSum = pairWeightSums[winnerLeafId][loserLeafId];
+            if (pairWeightSum == 0.0) {
+                continue;
+            }
+            const auto& nonDefaultPairWeightSumsForLeafPair = nonDefaultPairWeightSums[winnerLeafId][loserLeafId];
+            auto& weightSumsForLeafPair = weightSums[winnerLeafId][loserLeafId];
+            for (auto usedPartIdx : xrange(usedPartCount)) {
+                const double defaultPairWeightSum
+                    = pairWeightSum - nonDefaultPairWeightSumsForLeafPair[usedPartIdx];
+                auto& zeroBucketStats = weightSumsForLeafPair[zeroBuckets[usedPartIdx]];
+                zeroBucketStats.SmallerBorderWeightSum -= defaultPairWeightSum;
+                zeroBucketStats.GreaterBorderRightWeightSum -= defaultPairWeightSum;
+            }
         }
     }
 
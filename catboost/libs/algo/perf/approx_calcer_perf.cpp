@@ -0,0 +1,135 @@
+#include <catboost/libs/algo/approx_calcer.h>
+#include <catboost/libs/algo_helpers/approx_calcer_helpers.h>
+#include <catboost/libs/algo_helpers/approx_updater_helpers.h>
+#include <catboost/libs/algo_helpers/error_functions.h>
+#include <catboost/libs/options/catboost_options.h>
+
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/system/info.h>
+
+namespace {
+    struct TLeafEstimationData {
+        static constexpr int DocCount = 1 << 20;
+        static constexpr int LeafCount = 64;
+        static constexpr int IterationCount = 10;
+
+        TVector<TIndexType> Indices;
+        TFold Fold;
+        TVector<double> Approxes;
+        TVector<double> ApproxDeltas;
+        NCatboostOptions::TCatBoostOptions Params{ETaskType::CPU};
+        NPar::TLocalExecutor LocalExecutor;
+
+        // not fused estimation scratch space
+        TVector<TSum> LeafDers = TVector<TSum>(LeafCount, TSum());
+        TVector<double> LeafDeltas = TVector<double>(LeafCount);
+        TArray2D<double> PairwiseBuckets;
+        TVector<TDers> WeightedDers = TVector<TDers>(APPROX_BLOCK_SIZE * CB_THREAD_LIMIT);
+
+        TLeafEstimationData() {
+            TFastRng64 rng(17);
+            for (auto doc : xrange(DocCount)) {
+                Y_UNUSED(doc);
+                Indices.push_back(rng.Uniform(LeafCount));
+                Fold.LearnTarget.push_back(rng.GenRandReal1() * 10);
+                Approxes.push_back(rng.GenRandReal1() * 10);
+            }
+            LocalExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+        }
+    };
+
+    template <ELeavesEstimation EstimationMethod>
+    void RunLeafEstimation(const IDerCalcer& error, bool fuseIterations, const NBench::NCpu::TParams& iface) {
+        static TLeafEstimationData data;
+        const auto calcLeafDeltas = [] (const TVector<TSum>& leafDers, TVector<double>* leafDeltas) {
+            for (auto leaf : xrange(leafDers.size())) {
+                (*leafDeltas)[leaf] = CalcMethodDelta<EstimationMethod>(
+                    leafDers[leaf],
+                    /*l2Regularizer*/ 3.0f,
+                    TLeafEstimationData::DocCount,
+                    TLeafEstimationData::DocCount);
+            }
+        };
+        TVector<double> sumLeafDeltas(TLeafEstimationData::LeafCount);
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+            data.ApproxDeltas.assign(TLeafEstimationData::DocCount, 0.0);
+            if (fuseIterations) {
+                CalcLeafDeltasWithFusedApproxUpdate(
+                    TLeafEstimationData::IterationCount,
+                    TLeafEstimationData::LeafCount,
+                    data.Indices,
+                    data.Fold.LearnTarget,
+                    data.Fold.GetLearnWeights(),
+                    data.Approxes,
+                    TLeafEstimationData::DocCount,
+                    error,
+                    EstimationMethod,
+                    calcLeafDeltas,
+                    &data.LocalExecutor,
+                    data.ApproxDeltas,
+                    &sumLeafDeltas);
+            } else {
+                // derivatives and approx updates in separate passes, as in GradientWalker iterations
+                for (auto iteration : xrange(TLeafEstimationData::IterationCount)) {
+                    CalcLeafDersSimple(
+                        data.Indices,
+                        data.Fold,
+                        TFold::TBodyTail(),
+                        data.Approxes,
+                        data.ApproxDeltas,
+                        error,
+                        TLeafEstimationData::DocCount,
+                        /*queryCount*/ 0,
+                        /*recalcLeafWeights*/ iteration == 0,
+                        EstimationMethod,
+                        data.Params,
+                        /*randomSeed*/ 0,
+                        &data.LocalExecutor,
+                        &data.LeafDers,
+                        &data.PairwiseBuckets,
+                        &data.WeightedDers);
+                    calcLeafDeltas(data.LeafDers, &data.LeafDeltas);
+                    AddElementwise(data.LeafDeltas, &sumLeafDeltas);
+                    UpdateApproxDeltas(
+                        error.GetIsExpApprox(),
+                        data.Indices,
+                        TLeafEstimationData::DocCount,
+                        &data.LocalExecutor,
+                        &data.LeafDeltas,
+                        &data.ApproxDeltas);
+                }
+            }
+            Y_DO_NOT_OPTIMIZE_AWAY(sumLeafDeltas.data());
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(QuantileGradient_NotFused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Gradient>(TQuantileError(0.7, 1e-6, false), /*fuseIterations*/ false, iface);
+}
+
+Y_CPU_BENCHMARK(QuantileGradient_Fused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Gradient>(TQuantileError(0.7, 1e-6, false), /*fuseIterations*/ true, iface);
+}
+
+Y_CPU_BENCHMARK(MAEGradient_NotFused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Gradient>(TQuantileError(false), /*fuseIterations*/ false, iface);
+}
+
+Y_CPU_BENCHMARK(MAEGradient_Fused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Gradient>(TQuantileError(false), /*fuseIterations*/ true, iface);
+}
+
+Y_CPU_BENCHMARK(LqNewton_NotFused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Newton>(TLqError(1.5, false), /*fuseIterations*/ false, iface);
+}
+
+Y_CPU_BENCHMARK(LqNewton_Fused, iface) {
+    RunLeafEstimation<ELeavesEstimation::Newton>(TLqError(1.5, false), /*fuseIterations*/ true, iface);
+}
@@ -0,0 +1,134 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/json/json_value.h>
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NCB;
+
+namespace {
+    /* sparse mutually exclusive features that quantization packs into a single bundle:
+     * every object has a non-default value in exactly one of them
+     */
+    struct TExclusiveFeaturesData {
+        static constexpr ui32 DocCount = 200000;
+        static constexpr ui32 FeatureCount = 64;
+        static constexpr ui32 BorderCount = 15;
+
+        TDataProviderPtr Bundled;
+        TDataProviderPtr NonBundled;
+
+        TExclusiveFeaturesData()
+            : Bundled(QuantizeData(CreateRawData(), /*bundleExclusiveFeatures*/ true))
+            , NonBundled(QuantizeData(CreateRawData(), /*bundleExclusiveFeatures*/ false))
+        {}
+
+        static TDataProviderPtr CreateRawData() {
+            TFastRng64 rng(17);
+            return CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        FeatureCount,
+                        TVector<ui32>{},
+                        TVector<ui32>{},
+                        TVector<TString>{});
+
+                    visitor->Start(metaInfo, DocCount, EObjectsOrder::Undefined, {});
+
+                    TVector<TVector<float>> features(FeatureCount, TVector<float>(DocCount, 0.0f));
+                    TVector<float> target(DocCount);
+                    for (auto docIdx : xrange(DocCount)) {
+                        const ui32 featureIdx = rng.Uniform(FeatureCount);
+                        const float value = 1.0f + rng.GenRandReal1();
+                        features[featureIdx][docIdx] = value;
+                        target[docIdx] = (featureIdx % 2 ? value : -value) + 0.1f * rng.GenRandReal1();
+                    }
+                    for (auto featureIdx : xrange(FeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(features[featureIdx]))
+                        );
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+        }
+
+        static TDataProviderPtr QuantizeData(TDataProviderPtr rawData, bool bundleExclusiveFeatures) {
+            TQuantizationOptions options;
+            options.BundleExclusiveFeaturesForCpu = bundleExclusiveFeatures;
+
+            auto featuresLayout = rawData->MetaInfo.FeaturesLayout;
+            auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+                *featuresLayout,
+                TConstArrayRef<ui32>(),
+                NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, BorderCount)
+            );
+
+            TRestorableFastRng64 rand(0);
+            NPar::TLocalExecutor localExecutor;
+
+            return Quantize(
+                options,
+                rawData->CastMoveTo<TRawObjectsDataProvider>(),
+                quantizedFeaturesInfo,
+                &rand,
+                &localExecutor
+            )->CastMoveTo<TObjectsDataProvider>();
+        }
+    };
+
+    // data is quantized once, so the timings are dominated by score calculation over the features
+    void TrainOnExclusiveFeatures(bool bundled, const NBench::NCpu::TParams& iface) {
+        static TExclusiveFeaturesData data;
+
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+
+            TDataProviders dataProviders;
+            dataProviders.Learn = bundled ? data.Bundled : data.NonBundled;
+
+            NJson::TJsonValue params;
+            params.InsertValue("iterations", 20);
+            params.InsertValue("depth", 6);
+            params.InsertValue("boosting_type", "Plain");
+            params.InsertValue("thread_count", 1);
+            params.InsertValue("random_seed", 0);
+            params.InsertValue("logging_level", "Silent");
+
+            TFullModel model;
+            TrainModel(
+                params,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                std::move(dataProviders),
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                {}
+            );
+            Y_DO_NOT_OPTIMIZE_AWAY(model.GetTreeCount());
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(TrainOnExclusiveFeaturesBundle, iface) {
+    TrainOnExclusiveFeatures(/*bundled*/ true, iface);
+}
+
+Y_CPU_BENCHMARK(TrainOnNonBundledExclusiveFeatures, iface) {
+    TrainOnExclusiveFeatures(/*bundled*/ false, iface);
+}
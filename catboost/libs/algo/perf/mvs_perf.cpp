@@ -0,0 +1,41 @@
+#include <catboost/libs/algo/fold.h>
+#include <catboost/libs/algo/mvs.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/system/info.h>
+
+namespace {
+    struct TMvsData {
+        static constexpr ui32 SampleCount = 10000000;
+
+        TFold Fold;
+        NPar::TLocalExecutor LocalExecutor;
+
+        TMvsData() {
+            Fold.SampleWeights.resize(SampleCount);
+            TFold::TBodyTail bt(0, 0, SampleCount, SampleCount, (double)SampleCount);
+            bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+            TFastRng64 rng(17);
+            for (auto& derivative : bt.WeightedDerivatives[0]) {
+                derivative = rng.GenRandReal1() * 2 - 1;
+            }
+            Fold.BodyTailArr.emplace_back(std::move(bt));
+            LocalExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+        }
+    };
+}
+
+Y_CPU_BENCHMARK(MvsGenSampleWeights, iface) {
+    static TMvsData data;
+    const TMvsSampler sampler(TMvsData::SampleCount, 0.2);
+    for (const auto it : xrange(iface.Iterations())) {
+        TRestorableFastRng64 rand(it);
+        sampler.GenSampleWeights(EBoostingType::Plain, &rand, &data.LocalExecutor, &data.Fold);
+        Y_DO_NOT_OPTIMIZE_AWAY(data.Fold.SampleWeights.data());
+    }
+}
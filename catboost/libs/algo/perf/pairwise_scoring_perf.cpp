@@ -0,0 +1,94 @@
+#include <catboost/libs/algo/pairwise_scoring.h>
+
+#include <library/testing/benchmark/bench.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+namespace {
+    // sparse mutually exclusive features: stats of a bundle vs stats of the same features before bundling
+    struct TPairwiseBundleData {
+        static constexpr ui32 DocCount = 1000000;
+        static constexpr ui32 PairCount = 4000000;
+        static constexpr ui32 LeafCount = 16;
+        static constexpr ui32 PartCount = 16;
+        static constexpr ui32 PartBinCount = 15;
+        static constexpr ui32 OneHotMaxSize = 2;
+
+        NCB::TExclusiveFeaturesBundle Bundle;
+        TVector<ui16> BundleValues;
+        TVector<TVector<ui8>> FeaturesBins; // [partIdx][docIdx]
+        TVector<TIndexType> LeafIndices;
+        TFlatPairsInfo Pairs;
+
+        TPairwiseBundleData() {
+            for (auto partIdx : xrange(PartCount)) {
+                Bundle.Add(
+                    NCB::TExclusiveBundlePart(
+                        EFeatureType::Float,
+                        partIdx,
+                        NCB::TBoundsInBundle(partIdx * PartBinCount, (partIdx + 1) * PartBinCount)
+                    )
+                );
+            }
+            const ui32 defaultBundleValue = Bundle.GetUsedByPartsBinCount();
+
+            TFastRng64 rng(17);
+            BundleValues.yresize(DocCount);
+            FeaturesBins.resize(PartCount, TVector<ui8>(DocCount, 0));
+            LeafIndices.yresize(DocCount);
+            for (auto docIdx : xrange(DocCount)) {
+                LeafIndices[docIdx] = rng.Uniform(LeafCount);
+                // half of the docs have all features with default values
+                if (rng.Uniform(2)) {
+                    BundleValues[docIdx] = defaultBundleValue;
+                } else {
+                    const ui32 bundleValue = rng.Uniform(defaultBundleValue);
+                    BundleValues[docIdx] = bundleValue;
+                    FeaturesBins[bundleValue / PartBinCount][docIdx] = bundleValue % PartBinCount + 1;
+                }
+            }
+            Pairs.reserve(PairCount);
+            for (auto pairIdx : xrange(PairCount)) {
+                Y_UNUSED(pairIdx);
+                Pairs.emplace_back(rng.Uniform(DocCount), rng.Uniform(DocCount), 1.0f);
+            }
+            SortPairsByLeaves(LeafIndices, LeafCount, &Pairs);
+        }
+    };
+}
+
+Y_CPU_BENCHMARK(PairWeightStatisticsForExclusiveFeaturesBundle, iface) {
+    static TPairwiseBundleData data;
+    for (const auto it : xrange(iface.Iterations())) {
+        Y_UNUSED(it);
+        const auto weightSums = ComputePairWeightStatisticsForExclusiveFeaturesBundle(
+            TPairwiseBundleData::OneHotMaxSize,
+            data.Pairs,
+            TPairwiseBundleData::LeafCount,
+            data.LeafIndices,
+            data.Bundle,
+            [&] (ui32 docId) { return data.BundleValues[docId]; },
+            NCB::TIndexRange<int>(data.Pairs.ysize())
+        );
+        Y_DO_NOT_OPTIMIZE_AWAY(weightSums[0][0].data());
+    }
+}
+
+Y_CPU_BENCHMARK(PairWeightStatisticsForNonBundledFeatures, iface) {
+    static TPairwiseBundleData data;
+    for (const auto it : xrange(iface.Iterations())) {
+        Y_UNUSED(it);
+        for (const auto& featureBins : data.FeaturesBins) {
+            const auto weightSums = ComputePairWeightStatistics(
+                data.Pairs,
+                TPairwiseBundleData::LeafCount,
+                TPairwiseBundleData::PartBinCount + 1,
+                data.LeafIndices,
+                [&] (ui32 docId) { return featureBins[docId]; },
+                NCB::TIndexRange<int>(data.Pairs.ysize())
+            );
+            Y_DO_NOT_OPTIMIZE_AWAY(weightSums[0][0].data());
+        }
+    }
+}
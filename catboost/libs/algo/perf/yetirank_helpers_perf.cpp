@@ -0,0 +1,65 @@
+#include <catboost/libs/algo/yetirank_helpers.h>
+#include <catboost/libs/options/loss_description.h>
+
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/system/info.h>
+
+#include <cmath>
+
+namespace {
+    template <ui32 QuerySize>
+    struct TLongQueriesData {
+        static constexpr ui32 QueryCount = 32;
+
+        TVector<double> ExpApproxes;
+        TVector<float> Relevances;
+        TVector<TQueryInfo> QueriesInfo;
+        NCatboostOptions::TLossDescription LossDescription;
+        NPar::TLocalExecutor LocalExecutor;
+
+        TLongQueriesData()
+            : LossDescription(NCatboostOptions::ParseLossDescription("YetiRank:permutations=10"))
+        {
+            TFastRng64 rng(17);
+            for (auto queryIdx : xrange(QueryCount)) {
+                QueriesInfo.emplace_back(queryIdx * QuerySize, (queryIdx + 1) * QuerySize);
+            }
+            for (auto docIdx : xrange(QueryCount * QuerySize)) {
+                Y_UNUSED(docIdx);
+                ExpApproxes.push_back(exp(rng.GenRandReal1() * 4 - 2));
+                Relevances.push_back(rng.Uniform(5));
+            }
+            LocalExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+        }
+    };
+
+    template <ui32 QuerySize>
+    void RunUpdatePairsForYetiRank(const NBench::NCpu::TParams& iface) {
+        static TLongQueriesData<QuerySize> data;
+        for (const auto it : xrange(iface.Iterations())) {
+            UpdatePairsForYetiRank(
+                data.ExpApproxes,
+                data.Relevances,
+                data.LossDescription,
+                /*randomSeed*/ it,
+                /*queryBegin*/ 0,
+                data.QueriesInfo.ysize(),
+                &data.QueriesInfo,
+                &data.LocalExecutor);
+            Y_DO_NOT_OPTIMIZE_AWAY(data.QueriesInfo.data());
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(YetiRankPairs_QuerySize1000, iface) {
+    RunUpdatePairsForYetiRank<1000>(iface);
+}
+
+Y_CPU_BENCHMARK(YetiRankPairs_QuerySize5000, iface) {
+    RunUpdatePairsForYetiRank<5000>(iface);
+}
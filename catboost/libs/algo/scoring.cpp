@@ -179,6 +179,20 @@ inline static void BuildSingleIndex(
             compressedArray,
             "BuildSingleIndex",
             [&] (const auto* histogram) {
+                if (fold.IsLeafwisePartitioned()) {
+                    // bins are gathered in the fold docs order once and partitioned together with docs
+                    SetSingleIndex(
+                        fold,
+                        indexer,
+                        fold.GetLeafwiseBins(&column, histogram),
+                        /*bucketIndexing*/ nullptr,
+                        /*bucketBeginOffset*/ 0,
+                        fold.NonCtrDataPermutationBlockSize,
+                        docIndexRange,
+                        singleIdx
+                    );
+                    return;
+                }
                 SetSingleIndex(
                     fold,
                     indexer,
@@ -391,6 +405,248 @@ inline static void FixUpStats(
 }
 
 
+/* Sparse columns are processed without building singleIdx for all docs: stats of the default bucket
+ * are leaf stats minus stats of docs with non-default values, so the cost is proportional to the number of
+ * non-default values.
+ * Non-default values are processed in parallel by blocks of objects, each block accumulates the differences
+ * from leaf stats in its own stats array.
+ * returns false if column is not sparse
+ */
+template <class T, EFeatureValuesType FeatureValuesType>
+inline static bool CalcStatsForSparseColumn(
+    const TCalcScoreFold& fold,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TTypedFeatureValuesHolder<T, FeatureValuesType>& column,
+    const TStatsIndexer& indexer,
+    bool isCaching,
+    bool isPlainMode,
+    int depth,
+    int splitStatsCount,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsRefOptionalHolder* stats
+) {
+    const auto* sparseColumnData
+        = dynamic_cast<const TSparseCompressedValuesHolderImpl<T, FeatureValuesType>*>(&column);
+    if (!sparseColumnData) {
+        return false;
+    }
+
+    const int approxDimension = fold.GetApproxDimension();
+    const int bodyTailCount = fold.GetBodyTailCount();
+    const int statsCount = bodyTailCount * approxDimension * splitStatsCount;
+    if (stats->NonInited()) {
+        (*stats) = TBucketStatsRefOptionalHolder(statsCount);
+    }
+
+    const int leafCount = 1 << depth;
+    const TConstArrayRef<TVector<TBucketStats>> leafStats
+        = fold.GetLeafStats(leafCount, isPlainMode, localExecutor);
+    const TConstArrayRef<ui32> foldIndexByObjectIdx
+        = fold.GetFoldIndexByObjectIdx(objectsDataProvider.GetFeaturesArraySubsetIndexing());
+    const auto& sparseData = sparseColumnData->GetData();
+    const ui32 defaultBucket = sparseData.GetDefaultValue();
+
+    // when caching, stats for leaves of the other split side are restored by FixUpStats
+    const int firstLeaf = isCaching ? leafCount / 2 : 0;
+    const int filledStatsBegin = indexer.GetIndex(firstLeaf, 0);
+    const int filledStatsEnd = indexer.GetIndex(leafCount, 0);
+
+    TBucketStats* statsData = stats->GetData().data();
+    for (int bodyTailDimIdx : xrange(bodyTailCount * approxDimension)) {
+        TBucketStats* statsSubset = statsData + bodyTailDimIdx * splitStatsCount;
+        Fill(statsSubset + filledStatsBegin, statsSubset + filledStatsEnd, TBucketStats{0, 0, 0, 0});
+        for (int leaf : xrange(firstLeaf, leafCount)) {
+            statsSubset[indexer.GetIndex(leaf, defaultBucket)] = leafStats[bodyTailDimIdx][leaf];
+        }
+    }
+
+    constexpr int MinNonDefaultCountPerBlock = 10000;
+    const int objectCount = SafeIntegerCast<int>(sparseData.GetSize());
+    const int blockCount = Max(
+        1,
+        Min<int>(
+            localExecutor->GetThreadCount() + 1,
+            SafeIntegerCast<int>(sparseData.GetNonDefaultSize()) / MinNonDefaultCountPerBlock
+        )
+    );
+
+    const TIndexType* indices = GetDataPtr(fold.Indices);
+    NCB::MapMerge(
+        localExecutor,
+        NCB::TSimpleIndexRangesGenerator<int>(
+            NCB::TIndexRange<int>(objectCount),
+            Max(1, CeilDiv(objectCount, blockCount))
+        ),
+        /*mapFunc*/[&](NCB::TIndexRange<int> objectIndexRange, TBucketStatsRefOptionalHolder* output) {
+            if (output->NonInited()) {
+                (*output) = TBucketStatsRefOptionalHolder(statsCount);
+                for (int bodyTailDimIdx : xrange(bodyTailCount * approxDimension)) {
+                    TBucketStats* statsSubset = output->GetData().data() + bodyTailDimIdx * splitStatsCount;
+                    Fill(statsSubset + filledStatsBegin, statsSubset + filledStatsEnd, TBucketStats{0, 0, 0, 0});
+                }
+            }
+            TBucketStats* outputData = output->GetData().data();
+            sparseData.ForEachNonDefaultInRange(
+                objectIndexRange.Begin,
+                objectIndexRange.End,
+                [&] (ui32 objectIdx, ui32 bucket) {
+                    const ui32 doc = foldIndexByObjectIdx[objectIdx];
+                    if (doc == TCalcScoreFold::NotInFold) {
+                        return;
+                    }
+                    const int leaf = indices[doc];
+                    for (int bodyTailIdx : xrange(bodyTailCount)) {
+                        for (int dim : xrange(approxDimension)) {
+                            const TBucketStats docStats = fold.GetDocStats(bodyTailIdx, dim, isPlainMode, doc);
+                            TBucketStats* statsSubset
+                                = outputData + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+                            statsSubset[indexer.GetIndex(leaf, bucket)].Add(docStats);
+                            statsSubset[indexer.GetIndex(leaf, defaultBucket)].Remove(docStats);
+                        }
+                    }
+                }
+            );
+        },
+        /*mergeFunc*/[&](
+            TBucketStatsRefOptionalHolder* output,
+            TVector<TBucketStatsRefOptionalHolder>&& addVector
+        ) {
+            for (int bodyTailDimIdx : xrange(bodyTailCount * approxDimension)) {
+                TBucketStats* outputStatsSubset = output->GetData().data() + bodyTailDimIdx * splitStatsCount;
+                for (const auto& addItem : addVector) {
+                    const TBucketStats* addStatsSubset
+                        = addItem.GetData().data() + bodyTailDimIdx * splitStatsCount;
+                    for (int i : xrange(filledStatsBegin, filledStatsEnd)) {
+                        outputStatsSubset[i].Add(addStatsSubset[i]);
+                    }
+                }
+            }
+        },
+        stats
+    );
+
+    if (isCaching) {
+        for (int bodyTailDimIdx : xrange(bodyTailCount * approxDimension)) {
+            FixUpStats(
+                depth,
+                indexer,
+                fold.SmallestSplitSideValue,
+                statsData + bodyTailDimIdx * splitStatsCount
+            );
+        }
+    }
+    return true;
+}
+
+
+// Buckets of sparse column values for fold docs, Nothing() if column is not sparse
+template <class T, EFeatureValuesType FeatureValuesType>
+inline static TMaybe<TVector<ui32>> GetSparseColumnBucketsInFold(
+    const TCalcScoreFold& fold,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TTypedFeatureValuesHolder<T, FeatureValuesType>& column
+) {
+    const auto* sparseColumnData
+        = dynamic_cast<const TSparseCompressedValuesHolderImpl<T, FeatureValuesType>*>(&column);
+    if (!sparseColumnData) {
+        return Nothing();
+    }
+    const auto& sparseData = sparseColumnData->GetData();
+    const TConstArrayRef<ui32> foldIndexByObjectIdx
+        = fold.GetFoldIndexByObjectIdx(objectsDataProvider.GetFeaturesArraySubsetIndexing());
+
+    TVector<ui32> buckets(fold.GetDocCount(), (ui32)sparseData.GetDefaultValue());
+    sparseData.ForEachNonDefault(
+        [&] (ui32 objectIdx, ui32 bucket) {
+            const ui32 doc = foldIndexByObjectIdx[objectIdx];
+            if (doc != TCalcScoreFold::NotInFold) {
+                buckets[doc] = bucket;
+            }
+        }
+    );
+    return MakeMaybe(std::move(buckets));
+}
+
+
+/* Docs of leafwise partitioned folds are ordered by leaves, so stats of each leaf are accumulated over
+ * a contiguous range of docs into its own part of the stats array. Leaves are processed in parallel
+ * without per-block copies of stats and their merging.
+ */
+template <typename TFullIndexType, typename TIsCaching>
+static void CalcStatsForLeafwisePartitionedFold(
+    const TCalcScoreFold& fold,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
+    const TSplitEnsemble& splitEnsemble,
+    const TStatsIndexer& indexer,
+    const TIsCaching& isCaching,
+    int depth,
+    int splitStatsCount,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsRefOptionalHolder* stats
+) {
+    Y_ASSERT(fold.GetBodyTailCount() == 1);
+
+    const int approxDimension = fold.GetApproxDimension();
+    if (stats->NonInited()) {
+        (*stats) = TBucketStatsRefOptionalHolder(approxDimension * splitStatsCount);
+    }
+    TBucketStats* statsData = stats->GetData().data();
+
+    TVector<TFullIndexType> singleIdx;
+    singleIdx.yresize(fold.GetDocCount());
+
+    const TCalcScoreFold::TBodyTail& bt = fold.BodyTailArr[0];
+    const float* sampleWeightsData = GetDataPtr(fold.SampleWeights);
+
+    const int leafCount = 1 << depth;
+
+    // when caching, stats for leaves of the other split side are restored by FixUpStats
+    const int firstLeaf = isCaching ? leafCount / 2 : 0;
+    // leaves can have very different doc counts
+    localExecutor->ExecRangeWithWorkStealing(
+        [&](int leaf) {
+            const NCB::TIndexRange<int> docIndexRange = fold.GetLeafDocRange(leaf);
+            if (!docIndexRange.Empty()) {
+                BuildSingleIndex(
+                    fold,
+                    objectsDataProvider,
+                    allCtrs,
+                    splitEnsemble,
+                    indexer,
+                    docIndexRange,
+                    &singleIdx
+                );
+            }
+            for (int dim : xrange(approxDimension)) {
+                TBucketStats* statsSubset = statsData + dim * splitStatsCount;
+                Fill(
+                    statsSubset + indexer.GetIndex(leaf, 0),
+                    statsSubset + indexer.GetIndex(leaf + 1, 0),
+                    TBucketStats{0, 0, 0, 0}
+                );
+                UpdateWeighted(
+                    singleIdx,
+                    GetDataPtr(bt.SampleWeightedDerivatives[dim]),
+                    sampleWeightsData,
+                    docIndexRange,
+                    statsSubset
+                );
+            }
+        },
+        firstLeaf,
+        leafCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    if (isCaching) {
+        for (int dim : xrange(approxDimension)) {
+            FixUpStats(depth, indexer, fold.SmallestSplitSideValue, statsData + dim * splitStatsCount);
+        }
+    }
+}
+
+
 template <typename TFullIndexType, typename TIsCaching>
 static void CalcStatsImpl(
     const TCalcScoreFold& fold,
@@ -423,6 +679,25 @@ static void CalcStatsImpl(
     const auto pairCount = pairs.ysize();
     const auto pairPart = CeilDiv(pairCount, blockCount);
 
+    // sparse columns are expanded to fold docs once for all blocks
+    TMaybe<TVector<ui32>> sparseColumnBuckets;
+    if (splitEnsemble.Type == ESplitEnsembleType::OneFeature) {
+        const auto& splitCandidate = splitEnsemble.SplitCandidate;
+        if (splitCandidate.Type == ESplitType::FloatFeature) {
+            sparseColumnBuckets = GetSparseColumnBucketsInFold(
+                fold,
+                objectsDataProvider,
+                **objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx)
+            );
+        } else if (splitCandidate.Type == ESplitType::OneHotFeature) {
+            sparseColumnBuckets = GetSparseColumnBucketsInFold(
+                fold,
+                objectsDataProvider,
+                **objectsDataProvider.GetNonPackedCatFeature((ui32)splitCandidate.FeatureIdx)
+            );
+        }
+    }
+
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
@@ -443,6 +718,22 @@ static void CalcStatsImpl(
                 const auto& column,
                 TMaybe<const TExclusiveFeaturesBundle*> exclusiveFeaturesBundle = Nothing()
             ) {
+                if (sparseColumnBuckets) {
+                    ComputePairwiseStats<ui32>(
+                        ESplitEnsembleType::OneFeature,
+                        weightedDerivativesData,
+                        pairs,
+                        leafCount,
+                        indexer.BucketCount,
+                        oneHotMaxSize,
+                        fold.Indices,
+                        /*exclusiveFeaturesBundle*/ Nothing(),
+                        docIndexRange,
+                        pairIndexRange,
+                        [buckets = sparseColumnBuckets->data()](ui32 docIdx) { return buckets[docIdx]; },
+                        output);
+                    return;
+                }
                 ComputePairwiseStats(
                     fold,
                     weightedDerivativesData,
@@ -547,6 +838,54 @@ static void CalcStatsImpl(
 ) {
     Y_ASSERT(!isCaching || depth > 0);
 
+    if (splitEnsemble.Type == ESplitEnsembleType::OneFeature) {
+        const auto& splitCandidate = splitEnsemble.SplitCandidate;
+        auto calcStatsForSparseColumn = [&] (const auto& column) {
+            return CalcStatsForSparseColumn(
+                fold,
+                objectsDataProvider,
+                column,
+                indexer,
+                isCaching,
+                isPlainMode,
+                depth,
+                splitStatsCount,
+                localExecutor,
+                stats
+            );
+        };
+        if (splitCandidate.Type == ESplitType::FloatFeature) {
+            const auto& column = **objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx);
+            if (calcStatsForSparseColumn(column)) {
+                return;
+            }
+        } else if (splitCandidate.Type == ESplitType::OneHotFeature) {
+            const auto& column = **objectsDataProvider.GetNonPackedCatFeature((ui32)splitCandidate.FeatureIdx);
+            if (calcStatsForSparseColumn(column)) {
+                return;
+            }
+        }
+    }
+
+    // with fewer leaves than threads parallelism by doc blocks is better, leafwise partitioned folds support it too
+    const int leafwiseTaskCount = isCaching ? (1 << depth) / 2 : (1 << depth);
+    if (fold.IsLeafwisePartitioned() && (leafwiseTaskCount > localExecutor->GetThreadCount())) {
+        Y_ASSERT(isPlainMode);
+        CalcStatsForLeafwisePartitionedFold<TFullIndexType>(
+            fold,
+            objectsDataProvider,
+            allCtrs,
+            splitEnsemble,
+            indexer,
+            isCaching,
+            depth,
+            splitStatsCount,
+            localExecutor,
+            stats
+        );
+        return;
+    }
+
     const int docCount = fold.GetDocCount();
 
     TVector<TFullIndexType> singleIdx;
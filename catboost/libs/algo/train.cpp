@@ -15,6 +15,7 @@
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 
 
 TErrorTracker BuildErrorTracker(
@@ -150,25 +151,29 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             takenFold->BodyTailArr.ysize(),
             ctx->LearnProgress->Rand.GenRand()
         );
-        if (ctx->Params.SystemOptions->IsSingleHost()) {
-            ctx->LocalExecutor->ExecRangeWithThrow(
-                [&](int bodyTailId) {
-                    CalcWeightedDerivatives(
-                        *error,
-                        bodyTailId,
-                        ctx->Params,
-                        randomSeeds[bodyTailId],
-                        takenFold,
-                        ctx->LocalExecutor
-                    );
-                },
-                0,
-                takenFold->BodyTailArr.ysize(),
-                NPar::TLocalExecutor::WAIT_COMPLETE
-            );
-        } else {
-            Y_ASSERT(takenFold->BodyTailArr.ysize() == 1);
-            MapSetDerivatives(ctx);
+        {
+            NCB::TProfileTraceScope trace("Calc derivatives");
+            trace.AddArg("docs", takenFold->GetLearnSampleCount());
+            if (ctx->Params.SystemOptions->IsSingleHost()) {
+                ctx->LocalExecutor->ExecRangeWithThrow(
+                    [&](int bodyTailId) {
+                        CalcWeightedDerivatives(
+                            *error,
+                            bodyTailId,
+                            ctx->Params,
+                            randomSeeds[bodyTailId],
+                            takenFold,
+                            ctx->LocalExecutor
+                        );
+                    },
+                    0,
+                    takenFold->BodyTailArr.ysize(),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+            } else {
+                Y_ASSERT(takenFold->BodyTailArr.ysize() == 1);
+                MapSetDerivatives(ctx);
+            }
         }
         profile.AddOperation("Calc derivatives");
 
@@ -227,8 +232,12 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
                 seenProjections.insert(proj);
             }
 
+            NCB::TProfileTraceScope trace("ComputeOnlineCTRs");
+            trace.AddArg("jobs", parallelJobsData.ysize());
             ctx->LocalExecutor->ExecRange(
                 [&](int taskId){
+                    NCB::TProfileTraceScope jobTrace("ComputeOnlineCTRs job");
+                    jobTrace.AddArg("docs", parallelJobsData[taskId].Fold->GetLearnSampleCount());
                     parallelJobsData[taskId].DoTask(ctx);
                 },
                 0,
@@ -246,6 +255,8 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             const TVector<ui64> randomSeeds = GenRandUI64Vector(foldCount, ctx->LearnProgress->Rand.GenRand());
             ctx->LocalExecutor->ExecRangeWithThrow(
                 [&](int foldId) {
+                    NCB::TProfileTraceScope foldTrace("UpdateLearningFold");
+                    foldTrace.AddArg("fold", foldId).AddArg("docs", trainFolds[foldId]->GetLearnSampleCount());
                     UpdateLearningFold(
                         data,
                         *error,
@@ -264,15 +275,19 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             CheckInterrupted(); // check after long-lasting operation
 
             TVector<TIndexType> indices;
-            CalcLeafValues(
-                data,
-                *error,
-                ctx->LearnProgress->AveragingFold,
-                bestSplitTree,
-                ctx,
-                &treeValues,
-                &indices
-            );
+            {
+                NCB::TProfileTraceScope trace("CalcLeafValues");
+                trace.AddArg("docs", ctx->LearnProgress->AveragingFold.GetLearnSampleCount());
+                CalcLeafValues(
+                    data,
+                    *error,
+                    ctx->LearnProgress->AveragingFold,
+                    bestSplitTree,
+                    ctx,
+                    &treeValues,
+                    &indices
+                );
+            }
 
             ctx->Profile.AddOperation("CalcApprox result leaves");
             CheckInterrupted(); // check after long-lasting operation
@@ -293,6 +308,8 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
                 &treeValues
             );
 
+            NCB::TProfileTraceScope trace("UpdateAvrgApprox");
+            trace.AddArg("docs", data.Learn->GetObjectCount());
             UpdateAvrgApprox(
                 error->GetIsExpApprox(),
                 data.Learn->GetObjectCount(),
@@ -0,0 +1,238 @@
+#include <catboost/libs/algo/approx_calcer.h>
+#include <catboost/libs/algo/approx_calcer_multi.h>
+#include <catboost/libs/algo_helpers/approx_calcer_helpers.h>
+#include <catboost/libs/algo_helpers/approx_updater_helpers.h>
+#include <catboost/libs/algo_helpers/error_functions.h>
+#include <catboost/libs/options/catboost_options.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TFusedLeafEstimationTest) {
+    /* Compare with leaf estimation iterations done as before fusion:
+     * derivatives by CalcLeafDersSimple, then a separate pass of UpdateApproxDeltas over all point documents
+     */
+    template <ELeavesEstimation EstimationMethod>
+    void TestFusedIterationsMatchSeparatePasses(const IDerCalcer& error, bool isApproxesDelta) {
+        const int docCount = 30000;
+        const int derDocCount = isApproxesDelta ? 20000 : docCount; // the rest is like fold tail
+        const int leafCount = 16;
+        const int iterationCount = 5;
+
+        TFastRng64 rng(0);
+        TVector<TIndexType> indices;
+        TFold fold;
+        TVector<double> approxes;
+        for (auto doc : xrange(docCount)) {
+            Y_UNUSED(doc);
+            indices.push_back(rng.Uniform(leafCount));
+            fold.LearnTarget.push_back(rng.GenRandReal1());
+            approxes.push_back(rng.GenRandReal1() * 4 - 2);
+        }
+        ExpApproxIf(error.GetIsExpApprox(), approxes);
+        const auto calcLeafDeltas = [] (const TVector<TSum>& leafDers, TVector<double>* leafDeltas) {
+            for (auto leaf : xrange(leafDers.size())) {
+                (*leafDeltas)[leaf] = CalcMethodDelta<EstimationMethod>(leafDers[leaf], 1.0f, docCount, docCount);
+            }
+        };
+        // point is approxes delta or approxes
+        const TVector<double> initialPoint = isApproxesDelta ?
+            TVector<double>(docCount, error.GetIsExpApprox() ? 1.0 : 0.0) :
+            approxes;
+        const TVector<double> fixedApproxes = isApproxesDelta ? approxes : TVector<double>();
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TVector<double> fusedPoint = initialPoint;
+        TVector<double> fusedSumLeafDeltas(leafCount, 0.0);
+        CalcLeafDeltasWithFusedApproxUpdate(
+            iterationCount,
+            leafCount,
+            indices,
+            fold.LearnTarget,
+            fold.GetLearnWeights(),
+            fixedApproxes,
+            derDocCount,
+            error,
+            EstimationMethod,
+            calcLeafDeltas,
+            &localExecutor,
+            fusedPoint,
+            &fusedSumLeafDeltas);
+
+        const NCatboostOptions::TCatBoostOptions params(ETaskType::CPU);
+        TVector<double> point = initialPoint;
+        TVector<double> sumLeafDeltas(leafCount, 0.0);
+        TVector<TSum> leafDers(leafCount, TSum());
+        TVector<double> leafDeltas(leafCount);
+        TArray2D<double> pairwiseBuckets;
+        TVector<TDers> weightedDers;
+        weightedDers.yresize(APPROX_BLOCK_SIZE * CB_THREAD_LIMIT);
+        for (auto iteration : xrange(iterationCount)) {
+            CalcLeafDersSimple(
+                indices,
+                fold,
+                TFold::TBodyTail(),
+                isApproxesDelta ? fixedApproxes : point,
+                isApproxesDelta ? point : TVector<double>(),
+                error,
+                derDocCount,
+                /*queryCount*/ 0,
+                /*recalcLeafWeights*/ iteration == 0,
+                EstimationMethod,
+                params,
+                /*randomSeed*/ 0,
+                &localExecutor,
+                &leafDers,
+                &pairwiseBuckets,
+                &weightedDers);
+            calcLeafDeltas(leafDers, &leafDeltas);
+            AddElementwise(leafDeltas, &sumLeafDeltas);
+            UpdateApproxDeltas(error.GetIsExpApprox(), indices, docCount, &localExecutor, &leafDeltas, &point);
+        }
+
+        UNIT_ASSERT(fusedSumLeafDeltas == sumLeafDeltas);
+        UNIT_ASSERT(fusedPoint == point);
+    }
+
+    Y_UNIT_TEST(QuantileGradient) {
+        for (bool isApproxesDelta : {false, true}) {
+            TestFusedIterationsMatchSeparatePasses<ELeavesEstimation::Gradient>(
+                TQuantileError(0.3, 1e-6, false),
+                isApproxesDelta);
+        }
+    }
+
+    Y_UNIT_TEST(RMSENewton) {
+        for (bool isApproxesDelta : {false, true}) {
+            TestFusedIterationsMatchSeparatePasses<ELeavesEstimation::Newton>(TRMSEError(false), isApproxesDelta);
+        }
+    }
+
+    Y_UNIT_TEST(LoglossExpApproxNewton) {
+        for (bool isApproxesDelta : {false, true}) {
+            TestFusedIterationsMatchSeparatePasses<ELeavesEstimation::Newton>(
+                TCrossEntropyError(/*isExpApprox*/ true),
+                isApproxesDelta);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TMultiClassLeafDersTest) {
+    // not TMultiClassError, so CalcLeafDersMulti uses the generic kernel with virtual CalcDersMulti calls
+    class TGenericMultiClassError final : public IDerCalcer {
+    public:
+        TGenericMultiClassError()
+            : IDerCalcer(/*isExpApprox*/ false, /*maxDerivativeOrder*/ 2)
+            , Error(/*isExpApprox*/ false)
+        {
+        }
+
+        void CalcDersMulti(
+            const TVector<double>& approx,
+            float target,
+            float weight,
+            TVector<double>* der,
+            THessianInfo* der2
+        ) const override {
+            Error.CalcDersMulti(approx, target, weight, der, der2);
+        }
+
+    private:
+        TMultiClassError Error;
+    };
+
+    static void AssertEqualWithTolerance(const TVector<double>& expected, const TVector<double>& actual) {
+        UNIT_ASSERT_VALUES_EQUAL(expected.size(), actual.size());
+        for (auto idx : xrange(expected.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(expected[idx], actual[idx], 1e-9 * Max(1.0, Abs(expected[idx])));
+        }
+    }
+
+    static void TestFixedDimensionKernelMatchesGeneric(
+        int approxDimension,
+        ELeavesEstimation estimationMethod,
+        bool hasApproxDeltas,
+        bool hasWeights
+    ) {
+        const int docCount = 5003;
+        const int leafCount = 8;
+
+        TFastRng64 rng(approxDimension);
+        TVector<TIndexType> indices;
+        TVector<float> target;
+        TVector<float> weight;
+        for (auto doc : xrange(docCount)) {
+            Y_UNUSED(doc);
+            indices.push_back(rng.Uniform(leafCount));
+            target.push_back(rng.Uniform(approxDimension));
+            if (hasWeights) {
+                weight.push_back(rng.GenRandReal1() * 2);
+            }
+        }
+        TVector<TVector<double>> approx(approxDimension);
+        TVector<TVector<double>> approxDeltas(hasApproxDeltas ? approxDimension : 0);
+        for (auto dim : xrange(approxDimension)) {
+            for (auto doc : xrange(docCount)) {
+                Y_UNUSED(doc);
+                approx[dim].push_back(rng.GenRandReal1() * 4 - 2);
+                if (hasApproxDeltas) {
+                    approxDeltas[dim].push_back(rng.GenRandReal1() - 0.5);
+                }
+            }
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const auto calcLeafDers = [&] (const IDerCalcer& error) {
+            TVector<TSumMulti> leafDers(
+                leafCount,
+                estimationMethod == ELeavesEstimation::Newton ?
+                    TSumMulti(approxDimension, error.GetHessianType()) :
+                    TSumMulti(approxDimension));
+            CalcLeafDersMulti(
+                indices,
+                target,
+                weight,
+                approx,
+                approxDeltas,
+                error,
+                docCount,
+                /*isUpdateWeight*/ true,
+                estimationMethod,
+                &localExecutor,
+                &leafDers);
+            return leafDers;
+        };
+        const auto fixedLeafDers = calcLeafDers(TMultiClassError(/*isExpApprox*/ false));
+        const auto genericLeafDers = calcLeafDers(TGenericMultiClassError());
+
+        for (auto leaf : xrange(leafCount)) {
+            AssertEqualWithTolerance(genericLeafDers[leaf].SumDer, fixedLeafDers[leaf].SumDer);
+            AssertEqualWithTolerance(genericLeafDers[leaf].SumDer2.Data, fixedLeafDers[leaf].SumDer2.Data);
+            UNIT_ASSERT_DOUBLES_EQUAL(genericLeafDers[leaf].SumWeights, fixedLeafDers[leaf].SumWeights, 1e-9);
+        }
+    }
+
+    Y_UNIT_TEST(FixedDimensionKernelMatchesGeneric) {
+        // 17 is above the largest dimension with a specialized kernel, both errors use the generic one
+        for (int approxDimension : {3, 4, 7, 16, 17}) {
+            for (auto estimationMethod : {ELeavesEstimation::Newton, ELeavesEstimation::Gradient}) {
+                for (bool hasApproxDeltas : {false, true}) {
+                    for (bool hasWeights : {false, true}) {
+                        TestFixedDimensionKernelMatchesGeneric(
+                            approxDimension,
+                            estimationMethod,
+                            hasApproxDeltas,
+                            hasWeights);
+                    }
+                }
+            }
+        }
+    }
+}
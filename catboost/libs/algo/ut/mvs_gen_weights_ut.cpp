@@ -4,6 +4,7 @@
 #include "catboost/libs/algo/mvs.h"
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <util/generic/ymath.h>
+#include <util/random/fast.h>
 
 Y_UNIT_TEST_SUITE(mvs) {
     Y_UNIT_TEST(mvs_GenWeights) {
@@ -80,4 +81,38 @@ Y_UNIT_TEST_SUITE(mvs) {
             }
         }
     }
+
+    Y_UNIT_TEST(mvs_GenWeights_does_not_depend_on_thread_count) {
+        const ui32 SampleCount = 100000;
+        const int SampleCountAsInt = SafeIntegerCast<int>(SampleCount);
+
+        TVector<double> derivatives(SampleCount);
+        TFastRng64 derivativesRand(1);
+        for (auto& derivative : derivatives) {
+            derivative = derivativesRand.GenRandReal1() * 2 - 1;
+        }
+
+        const auto genWeights = [&] (int threadCount) {
+            TFold ff;
+            ff.SampleWeights.resize(SampleCount, 1);
+            TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
+            bt.WeightedDerivatives.resize(1, derivatives);
+            ff.BodyTailArr.emplace_back(std::move(bt));
+
+            NPar::TLocalExecutor executor;
+            executor.RunAdditionalThreads(threadCount - 1);
+
+            TMvsSampler sampler(SampleCount, 0.5);
+            TRestorableFastRng64 rand(0);
+            sampler.GenSampleWeights(Plain, &rand, &executor, &ff);
+            return ff.SampleWeights;
+        };
+
+        const TVector<float> weights = genWeights(1);
+        UNIT_ASSERT(weights == genWeights(3));
+        UNIT_ASSERT(weights == genWeights(8));
+        for (ui32 i = 0; i < SampleCount; ++i) {
+            UNIT_ASSERT(weights[i] == 0 || weights[i] >= 1);
+        }
+    }
 }
@@ -3,6 +3,10 @@
 #include <catboost/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     double score = 0;
     for (int x = 0; x < sumDer.ysize(); ++x) {
@@ -192,4 +196,191 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[1], scores2[1], 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[2], scores2[2], 1e-6);
     }
+
+    Y_UNIT_TEST(SortPairsByLeaves) {
+        const int docCount = 1000;
+        const int leafCount = 4;
+        const int bucketCount = 5;
+        TFastRng64 rng(0);
+        TVector<TIndexType> leafIndices(docCount);
+        TVector<ui8> bucketIndices(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            leafIndices[docId] = rng.Uniform(leafCount);
+            bucketIndices[docId] = rng.Uniform(bucketCount);
+        }
+        TFlatPairsInfo pairs;
+        for (int pairIdx = 0; pairIdx < 3000; ++pairIdx) {
+            pairs.emplace_back(rng.Uniform(docCount), rng.Uniform(docCount), 1.0f);
+        }
+        pairs.emplace_back(7, 7, 1.0f);
+
+        TFlatPairsInfo sortedPairs = pairs;
+        SortPairsByLeaves(leafIndices, leafCount, &sortedPairs);
+        const auto getLeafPairIdx = [&] (const TPair& pair) {
+            return leafIndices[pair.WinnerId] * leafCount + leafIndices[pair.LoserId];
+        };
+        for (int pairIdx = 0; pairIdx < sortedPairs.ysize(); ++pairIdx) {
+            UNIT_ASSERT(sortedPairs[pairIdx].WinnerId != sortedPairs[pairIdx].LoserId);
+            if (pairIdx > 0) {
+                UNIT_ASSERT(getLeafPairIdx(sortedPairs[pairIdx - 1]) <= getLeafPairIdx(sortedPairs[pairIdx]));
+            }
+        }
+        UNIT_ASSERT_VALUES_EQUAL(
+            sortedPairs.size(),
+            (size_t)CountIf(pairs, [] (const TPair& pair) { return pair.WinnerId != pair.LoserId; }));
+
+        const auto getBucket = [&] (ui32 docId) { return bucketIndices[docId]; };
+        const auto weightSums = ComputePairWeightStatistics(
+            pairs,
+            leafCount,
+            bucketCount,
+            leafIndices,
+            getBucket,
+            NCB::TIndexRange<int>(pairs.ysize()));
+        const auto sortedWeightSums = ComputePairWeightStatistics(
+            sortedPairs,
+            leafCount,
+            bucketCount,
+            leafIndices,
+            getBucket,
+            NCB::TIndexRange<int>(sortedPairs.ysize()));
+        for (int leaf1 = 0; leaf1 < leafCount; ++leaf1) {
+            for (int leaf2 = 0; leaf2 < leafCount; ++leaf2) {
+                for (int bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                    const auto& expected = weightSums[leaf1][leaf2][bucketIdx];
+                    const auto& actual = sortedWeightSums[leaf1][leaf2][bucketIdx];
+                    UNIT_ASSERT_VALUES_EQUAL(expected.SmallerBorderWeightSum, actual.SmallerBorderWeightSum);
+                    UNIT_ASSERT_VALUES_EQUAL(expected.GreaterBorderRightWeightSum, actual.GreaterBorderRightWeightSum);
+                }
+            }
+        }
+    }
+
+    // with non-integer pair weights sorting changes the order of additions, scores must stay within tolerance
+    // and the best split must not change
+    Y_UNIT_TEST(SortPairsByLeavesFractionalWeights) {
+        const int docCount = 2000;
+        const int leafCount = 8;
+        const int bucketCount = 16;
+        const float l2DiagReg = 0.3;
+        const float pairwiseNonDiagReg = 0.1;
+        const ui32 oneHotMaxSize = 2;
+
+        TFastRng64 rng(1);
+        TVector<TIndexType> leafIndices(docCount);
+        TVector<ui8> bucketIndices(docCount);
+        TVector<double> ders(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            leafIndices[docId] = rng.Uniform(leafCount);
+            bucketIndices[docId] = rng.Uniform(bucketCount);
+            ders[docId] = rng.GenRandReal1() * 2 - 1;
+        }
+        TFlatPairsInfo pairs;
+        for (int pairIdx = 0; pairIdx < 20000; ++pairIdx) {
+            pairs.emplace_back(rng.Uniform(docCount), rng.Uniform(docCount), (float)(rng.GenRandReal1() * 3));
+        }
+        TFlatPairsInfo sortedPairs = pairs;
+        SortPairsByLeaves(leafIndices, leafCount, &sortedPairs);
+
+        const auto getBucket = [&] (ui32 docId) { return bucketIndices[docId]; };
+        const auto calcScores = [&] (const TFlatPairsInfo& curPairs) {
+            TPairwiseStats pairwiseStats;
+            pairwiseStats.DerSums = ComputeDerSums(
+                ders,
+                leafCount,
+                bucketCount,
+                leafIndices,
+                getBucket,
+                NCB::TIndexRange<int>(docCount));
+            pairwiseStats.PairWeightStatistics = ComputePairWeightStatistics(
+                curPairs,
+                leafCount,
+                bucketCount,
+                leafIndices,
+                getBucket,
+                NCB::TIndexRange<int>(curPairs.ysize()));
+            pairwiseStats.SplitEnsembleSpec = TSplitEnsembleSpec::OneSplit(ESplitType::FloatFeature);
+            TPairwiseScoreCalcer scoreCalcer;
+            CalculatePairwiseScore(pairwiseStats, bucketCount, l2DiagReg, pairwiseNonDiagReg, oneHotMaxSize, &scoreCalcer);
+            return scoreCalcer.GetScores();
+        };
+        const TVector<double> scores = calcScores(pairs);
+        const TVector<double> sortedScores = calcScores(sortedPairs);
+
+        UNIT_ASSERT_VALUES_EQUAL(scores.size(), sortedScores.size());
+        for (auto splitIdx : xrange(scores.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(scores[splitIdx], sortedScores[splitIdx], 1e-9 * Max(1.0, Abs(scores[splitIdx])));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(
+            MaxElement(scores.begin(), scores.end()) - scores.begin(),
+            MaxElement(sortedScores.begin(), sortedScores.end()) - sortedScores.begin());
+    }
+
+    Y_UNIT_TEST(ExclusiveFeaturesBundlePairWeightStatistics) {
+        const int docCount = 1000;
+        const int leafCount = 4;
+        const ui32 oneHotMaxSize = 5;
+
+        NCB::TExclusiveFeaturesBundle bundle;
+        bundle.Add(NCB::TExclusiveBundlePart(EFeatureType::Float, 0, NCB::TBoundsInBundle(0, 3)));
+        bundle.Add(NCB::TExclusiveBundlePart(EFeatureType::Categorical, 0, NCB::TBoundsInBundle(3, 7)));
+        // not one hot, not used for scores
+        bundle.Add(NCB::TExclusiveBundlePart(EFeatureType::Categorical, 1, NCB::TBoundsInBundle(7, 17)));
+        bundle.Add(NCB::TExclusiveBundlePart(EFeatureType::Float, 1, NCB::TBoundsInBundle(17, 19)));
+        const ui32 defaultBundleValue = bundle.GetUsedByPartsBinCount();
+
+        TFastRng64 rng(0);
+        TVector<TIndexType> leafIndices(docCount);
+        TVector<ui8> bundleValues(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            leafIndices[docId] = rng.Uniform(leafCount);
+            bundleValues[docId] = rng.Uniform(2) ? defaultBundleValue : rng.Uniform(defaultBundleValue);
+        }
+        TFlatPairsInfo pairs;
+        for (int pairIdx = 0; pairIdx < 3000; ++pairIdx) {
+            pairs.emplace_back(rng.Uniform(docCount), rng.Uniform(docCount), (float)rng.GenRandReal1());
+        }
+
+        const auto weightSums = ComputePairWeightStatisticsForExclusiveFeaturesBundle(
+            oneHotMaxSize,
+            pairs,
+            leafCount,
+            leafIndices,
+            bundle,
+            [&] (ui32 docId) { return bundleValues[docId]; },
+            NCB::TIndexRange<int>(pairs.ysize()));
+
+        size_t bucketOffset = 0;
+        for (const auto& bundlePart : bundle.Parts) {
+            if (!UseForCalcScores(bundlePart, oneHotMaxSize)) {
+                continue;
+            }
+            const int bucketCount = bundlePart.Bounds.GetSize() + 1;
+            const auto partWeightSums = ComputePairWeightStatistics(
+                pairs,
+                leafCount,
+                bucketCount,
+                leafIndices,
+                [&] (ui32 docId) { return NCB::GetBinFromBundle<ui32>(bundleValues[docId], bundlePart.Bounds); },
+                NCB::TIndexRange<int>(pairs.ysize()));
+            for (int leaf1 = 0; leaf1 < leafCount; ++leaf1) {
+                for (int leaf2 = 0; leaf2 < leafCount; ++leaf2) {
+                    UNIT_ASSERT_VALUES_EQUAL(
+                        weightSums[leaf1][leaf2].size(),
+                        (size_t)(bundle.Parts[0].Bounds.GetSize() + bundle.Parts[1].Bounds.GetSize()
+                            + bundle.Parts[3].Bounds.GetSize() + 3));
+                    for (int bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                        const auto& expected = partWeightSums[leaf1][leaf2][bucketIdx];
+                        const auto& actual = weightSums[leaf1][leaf2][bucketOffset + bucketIdx];
+                        UNIT_ASSERT_DOUBLES_EQUAL(expected.SmallerBorderWeightSum, actual.SmallerBorderWeightSum, 1e-6);
+                        UNIT_ASSERT_DOUBLES_EQUAL(
+                            expected.GreaterBorderRightWeightSum,
+                            actual.GreaterBorderRightWeightSum,
+                            1e-6);
+                    }
+                }
+            }
+            bucketOffset += bucketCount;
+        }
+    }
 }
@@ -0,0 +1,87 @@
+#include <catboost/libs/algo/index_hash_calcer.h>
+#include <catboost/libs/algo/projection.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+
+
+static TProjection MakeCatProjection(TVector<int> catFeatures) {
+    TProjection proj;
+    proj.CatFeatures = std::move(catFeatures);
+    return proj;
+}
+
+static TProjectionHashCache::TEntryPtr MakeEntry(size_t docCount, ui64 hash) {
+    auto entry = MakeHolder<TProjectionHashCache::TEntry>();
+    entry->Hashes.assign(docCount, hash);
+    return TProjectionHashCache::TEntryPtr(entry.Release());
+}
+
+
+Y_UNIT_TEST_SUITE(TProjectionHashCache) {
+    Y_UNIT_TEST(TestNothingIsCachedWithoutLimit) {
+        TProjectionHashCache cache;
+        cache.Insert(MakeCatProjection({0, 1}), MakeEntry(10, 1));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({0, 1})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 0);
+    }
+
+    Y_UNIT_TEST(TestFindInsert) {
+        TProjectionHashCache cache;
+        cache.SetMaxSizeInBytes(1 << 20);
+        const auto entry = MakeEntry(10, 1);
+        cache.Insert(MakeCatProjection({0, 1}), entry);
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({0})));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({0, 2})));
+        UNIT_ASSERT_EQUAL(cache.Find(MakeCatProjection({0, 1})), entry);
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), entry->GetSizeInBytes());
+
+        // reinsertion replaces the entry
+        const auto otherEntry = MakeEntry(20, 2);
+        cache.Insert(MakeCatProjection({0, 1}), otherEntry);
+        UNIT_ASSERT_EQUAL(cache.Find(MakeCatProjection({0, 1})), otherEntry);
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), otherEntry->GetSizeInBytes());
+
+        cache.Clear();
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({0, 1})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 0);
+    }
+
+    Y_UNIT_TEST(TestLeastRecentlyUsedAreEvicted) {
+        const size_t entrySize = MakeEntry(100, 0)->GetSizeInBytes();
+
+        TProjectionHashCache cache;
+        cache.SetMaxSizeInBytes(3 * entrySize);
+        for (auto catFeature : xrange(3)) {
+            cache.Insert(MakeCatProjection({catFeature, 10}), MakeEntry(100, catFeature));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 3 * entrySize);
+
+        // {0, 10} becomes the most recently used, so {1, 10} is evicted
+        UNIT_ASSERT(cache.Find(MakeCatProjection({0, 10})));
+        cache.Insert(MakeCatProjection({3, 10}), MakeEntry(100, 3));
+        UNIT_ASSERT(cache.Find(MakeCatProjection({0, 10})));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({1, 10})));
+        UNIT_ASSERT(cache.Find(MakeCatProjection({2, 10})));
+        UNIT_ASSERT(cache.Find(MakeCatProjection({3, 10})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 3 * entrySize);
+
+        // entries larger than the limit are not cached
+        cache.Insert(MakeCatProjection({4, 10}), MakeEntry(400, 4));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({4, 10})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 3 * entrySize);
+
+        // decreasing the limit evicts least recently used entries: {0, 10} and {2, 10}
+        UNIT_ASSERT(cache.Find(MakeCatProjection({3, 10})));
+        cache.SetMaxSizeInBytes(entrySize);
+        UNIT_ASSERT(cache.Find(MakeCatProjection({3, 10})));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({0, 10})));
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({2, 10})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), entrySize);
+
+        cache.SetMaxSizeInBytes(0);
+        UNIT_ASSERT(!cache.Find(MakeCatProjection({3, 10})));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetSizeInBytes(), 0);
+    }
+}
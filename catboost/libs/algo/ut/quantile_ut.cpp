@@ -6,6 +6,8 @@
 #include <catboost/libs/eval_result/eval_result.h>
 #include <catboost/libs/train_lib/train_model.h>
 
+#include <util/random/fast.h>
+
 using namespace NCB;
 
 Y_UNIT_TEST_SUITE(TCalcQuantile) {
@@ -210,8 +212,45 @@ Y_UNIT_TEST_SUITE(TCalcQuantile) {
         TVector<double> approxes(sampleCount);
         TVector<float> weights1(sampleCount, 1);
         TVector<double> leafDeltas(2);
-        CalcQuantileLeafDeltas(2, indices, error, sampleCount, MakeConstArrayRef(approxes), MakeConstArrayRef(targets), MakeConstArrayRef(weights1), &leafDeltas);
+        NPar::TLocalExecutor localExecutor;
+        CalcQuantileLeafDeltas(2, indices, error, sampleCount, MakeConstArrayRef(approxes), MakeConstArrayRef(targets), MakeConstArrayRef(weights1), /*precision*/ 0.0f, &localExecutor, &leafDeltas);
         UNIT_ASSERT_DOUBLES_EQUAL(leafDeltas[0], 5 + eps, 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(leafDeltas[1], 25 + eps, 1e-6);
     }
+
+    Y_UNIT_TEST(TCalcQuantileLeafDeltasFromHistograms) {
+        const size_t leafCount = 4;
+        const size_t sampleCount = 10000;
+        const int binCount = 100;
+        TVector<TIndexType> indices(sampleCount);
+        TVector<float> targets(sampleCount);
+        TVector<double> approxes(sampleCount);
+        TVector<float> weights(sampleCount);
+        TVector<TVector<double>> leafSamples(leafCount);
+        TVector<TVector<double>> leafWeights(leafCount);
+        TFastRng64 rng(0);
+        for (size_t i = 0; i < sampleCount; ++i) {
+            indices[i] = rng.Uniform(leafCount - 1); // last leaf is empty
+            targets[i] = rng.GenRandReal1() * 100 * (indices[i] + 1);
+            approxes[i] = rng.GenRandReal1();
+            weights[i] = rng.GenRandReal1();
+            leafSamples[indices[i]].push_back(targets[i] - approxes[i]);
+            leafWeights[indices[i]].push_back(weights[i]);
+        }
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        for (double alpha : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+            TQuantileError error(alpha, eps, false);
+            TVector<double> leafDeltas(leafCount);
+            CalcQuantileLeafDeltasFromHistograms(leafCount, indices, error, sampleCount, approxes, targets, weights, binCount, &localExecutor, &leafDeltas);
+            for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+                const auto& sample = leafSamples[leaf];
+                const double expected = CalcSampleQuantile(sample, leafWeights[leaf], alpha, eps);
+                const double tolerance = sample.empty()
+                    ? 0.0
+                    : (*MaxElement(sample.begin(), sample.end()) - *MinElement(sample.begin(), sample.end())) / binCount + 2 * eps;
+                UNIT_ASSERT_DOUBLES_EQUAL(leafDeltas[leaf], expected, tolerance);
+            }
+        }
+    }
 }
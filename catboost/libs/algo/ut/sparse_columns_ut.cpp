@@ -0,0 +1,286 @@
+#include <catboost/libs/algo/index_hash_calcer.h>
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/eval_result/eval_result.h>
+#include <catboost/libs/helpers/compression.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/json/json_value.h>
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+static const ui32 BinCount = 16;
+
+
+// [featureIdx][objectIdx], most of bins are 0
+static TVector<TVector<ui8>> GenerateMostlyDefaultBins(ui32 objectCount, ui32 featureCount, ui64 seed) {
+    TFastRng64 rng(seed);
+    TVector<TVector<ui8>> bins(featureCount, TVector<ui8>(objectCount, 0));
+    for (auto& featureBins : bins) {
+        for (auto& bin : featureBins) {
+            if (rng.GenRandReal1() < 0.1) {
+                bin = (ui8)(1 + rng.Uniform(BinCount - 1));
+            }
+        }
+    }
+    return bins;
+}
+
+template <class T>
+static TSparseCompressedArray<T, ui32> MakeSparseCompressedArray(TConstArrayRef<T> values) {
+    TVector<ui32> indices;
+    TVector<T> nonDefaultValues;
+    for (auto objectIdx : xrange(values.size())) {
+        if (values[objectIdx] != T(0)) {
+            indices.push_back(objectIdx);
+            nonDefaultValues.push_back(values[objectIdx]);
+        }
+    }
+    const ui32 bitsPerKey = sizeof(T) * 8;
+    return TSparseCompressedArray<T, ui32>(
+        TSparseArrayIndexing<ui32>(TSparseSubsetIndices<ui32>(std::move(indices)), (ui32)values.size()),
+        TCompressedArray(
+            nonDefaultValues.size(),
+            bitsPerKey,
+            CompressVector<ui64>(nonDefaultValues.data(), nonDefaultValues.size(), bitsPerKey)
+        ),
+        T(0)
+    );
+}
+
+static TDataProviderPtr CreateQuantizedDataProvider(
+    const TVector<TVector<ui8>>& bins, // [featureIdx][objectIdx]
+    const TVector<float>& target,
+    bool isSparse,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const ui32 featureCount = bins.size();
+    const ui32 objectCount = target.size();
+
+    TDataMetaInfo metaInfo;
+    metaInfo.HasTarget = true;
+    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(featureCount, TVector<ui32>{}, TVector<TString>{});
+
+    TCommonObjectsData commonData;
+    commonData.FeaturesLayout = metaInfo.FeaturesLayout;
+    commonData.SubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(TFullSubset<ui32>(objectCount));
+
+    TQuantizedForCPUObjectsData data;
+    data.Data.QuantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+        *metaInfo.FeaturesLayout,
+        TConstArrayRef<ui32>(),
+        NCatboostOptions::TBinarizationOptions()
+    );
+    for (auto featureIdx : xrange(featureCount)) {
+        TVector<float> borders;
+        for (auto border : xrange(BinCount - 1)) {
+            borders.push_back(border + 0.5f);
+        }
+        data.Data.QuantizedFeaturesInfo->SetBorders(TFloatFeatureIdx(featureIdx), std::move(borders));
+        data.Data.QuantizedFeaturesInfo->SetNanMode(TFloatFeatureIdx(featureIdx), ENanMode::Forbidden);
+
+        if (isSparse) {
+            data.Data.FloatFeatures.emplace_back(
+                MakeHolder<TQuantizedFloatSparseValuesHolder>(
+                    featureIdx,
+                    MakeSparseCompressedArray<ui8>(bins[featureIdx])
+                )
+            );
+        } else {
+            data.Data.FloatFeatures.emplace_back(
+                MakeHolder<TQuantizedFloatValuesHolder>(
+                    featureIdx,
+                    TCompressedArray(
+                        objectCount,
+                        8,
+                        CompressVector<ui64>(bins[featureIdx].data(), objectCount, 8)
+                    ),
+                    commonData.SubsetIndexing.Get()
+                )
+            );
+        }
+    }
+    data.ExclusiveFeatureBundlesData = TExclusiveFeatureBundlesData(
+        *metaInfo.FeaturesLayout,
+        TVector<TExclusiveFeaturesBundle>()
+    );
+    data.PackedBinaryFeaturesData = TPackedBinaryFeaturesData(
+        *metaInfo.FeaturesLayout,
+        *data.Data.QuantizedFeaturesInfo,
+        data.ExclusiveFeatureBundlesData,
+        true
+    );
+    data.FeaturesGroupsData = TFeatureGroupsData(*metaInfo.FeaturesLayout, TVector<TFeaturesGroup>());
+
+    auto objectsGrouping = MakeIntrusive<TObjectsGrouping>(objectCount);
+    auto objectsData = MakeIntrusive<TQuantizedForCPUObjectsDataProvider>(
+        objectsGrouping,
+        std::move(commonData),
+        std::move(data),
+        true,
+        Nothing()
+    );
+
+    TRawTargetData rawTargetData;
+    TVector<TString> stringTarget;
+    for (auto value : target) {
+        stringTarget.push_back(ToString(value));
+    }
+    rawTargetData.Target = std::move(stringTarget);
+    rawTargetData.SetTrivialWeights(objectCount);
+
+    return MakeIntrusive<TDataProvider>(
+        std::move(metaInfo),
+        std::move(objectsData),
+        objectsGrouping,
+        TRawTargetDataProvider(objectsGrouping, std::move(rawTargetData), false, localExecutor)
+    );
+}
+
+static TDataProviders CreateDataProviders(bool isSparse, NPar::TLocalExecutor* localExecutor) {
+    const ui32 learnObjectCount = 20000;
+    const ui32 testObjectCount = 5000;
+    const ui32 featureCount = 6;
+
+    const auto learnBins = GenerateMostlyDefaultBins(learnObjectCount, featureCount, /*seed*/ 17);
+    const auto testBins = GenerateMostlyDefaultBins(testObjectCount, featureCount, /*seed*/ 18);
+    const auto getTarget = [] (const TVector<TVector<ui8>>& bins) {
+        TFastRng64 rng(0);
+        TVector<float> target(bins[0].size());
+        for (auto objectIdx : xrange(target.size())) {
+            target[objectIdx] = bins[0][objectIdx] + 0.5f * bins[1][objectIdx] * (bins[2][objectIdx] > 3)
+                + 0.1f * rng.GenRandReal1();
+        }
+        return target;
+    };
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreateQuantizedDataProvider(learnBins, getTarget(learnBins), isSparse, localExecutor);
+    dataProviders.Test.push_back(
+        CreateQuantizedDataProvider(testBins, getTarget(testBins), isSparse, localExecutor)
+    );
+    return dataProviders;
+}
+
+
+Y_UNIT_TEST_SUITE(TSparseColumnsTest) {
+    template <class T, EFeatureValuesType FeatureValuesType>
+    void TestProcessColumnForCalcHashes(ui32 objectCount, ui64 seed) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TFastRng64 rng(seed);
+        TVector<T> values(objectCount, T(0));
+        for (auto& value : values) {
+            if (rng.GenRandReal1() < 0.05) {
+                value = (T)(1 + rng.Uniform(100));
+            }
+        }
+
+        // [i] -> objectIdx, as in folds' LearnPermutationFeaturesSubset
+        TVector<ui32> permutation(objectCount);
+        Iota(permutation.begin(), permutation.end(), 0);
+        Shuffle(permutation.begin(), permutation.end(), rng);
+        TVector<ui32> docByObjectIdx(objectCount);
+        for (auto i : xrange(objectCount)) {
+            docByObjectIdx[permutation[i]] = i;
+        }
+        const TFeaturesArraySubsetIndexing featuresSubsetIndexing{TIndexedSubset<ui32>(permutation)};
+        const TFeaturesArraySubsetIndexing fullSubset{TFullSubset<ui32>(objectCount)};
+
+        const ui32 bitsPerKey = sizeof(T) * 8;
+        const TCompressedValuesHolderImpl<T, FeatureValuesType> denseColumn(
+            0,
+            TCompressedArray(objectCount, bitsPerKey, CompressVector<ui64>(values.data(), objectCount, bitsPerKey)),
+            &fullSubset
+        );
+        const TSparseCompressedValuesHolderImpl<T, FeatureValuesType> sparseColumn(
+            0,
+            MakeSparseCompressedArray<T>(values)
+        );
+
+        TVector<T> denseResult(objectCount);
+        ProcessColumnForCalcHashes(
+            denseColumn,
+            featuresSubsetIndexing,
+            /*docByObjectIdx*/ TConstArrayRef<ui32>(),
+            [&] (ui32 i, T value) { denseResult[i] = value; },
+            &localExecutor
+        );
+
+        TVector<T> sparseResult(objectCount);
+        TVector<ui32> visitCounts(objectCount, 0);
+        ProcessColumnForCalcHashes(
+            sparseColumn,
+            featuresSubsetIndexing,
+            docByObjectIdx,
+            [&] (ui32 i, T value) {
+                sparseResult[i] = value;
+                ++visitCounts[i];
+            },
+            &localExecutor
+        );
+
+        for (auto i : xrange(objectCount)) {
+            UNIT_ASSERT_VALUES_EQUAL(denseResult[i], values[permutation[i]]);
+            UNIT_ASSERT_VALUES_EQUAL(sparseResult[i], denseResult[i]);
+            UNIT_ASSERT_VALUES_EQUAL(visitCounts[i], 1);
+        }
+    }
+
+    Y_UNIT_TEST(TestProcessColumnForCalcHashes) {
+        for (auto objectCount : {0, 1, 100, 10000, 25017}) {
+            TestProcessColumnForCalcHashes<ui8, EFeatureValuesType::QuantizedFloat>(objectCount, 1);
+            TestProcessColumnForCalcHashes<ui32, EFeatureValuesType::PerfectHashedCategorical>(objectCount, 2);
+        }
+    }
+
+    // stats of sparse columns are calculated from non-default values only,
+    // splits and leaf values must be the same as for dense columns
+    Y_UNIT_TEST(TestTrainOnSparseColumnsEqualsDense) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (const TString boostingType : {"Plain", "Ordered"}) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 10);
+            plainFitParams.InsertValue("depth", 6);
+            plainFitParams.InsertValue("boosting_type", boostingType);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 4);
+
+            TVector<TFullModel> models(2);
+            TVector<TEvalResult> testApproxes(2);
+            for (auto isSparse : {false, true}) {
+                TrainModel(
+                    plainFitParams,
+                    nullptr,
+                    Nothing(),
+                    Nothing(),
+                    CreateDataProviders(isSparse, &localExecutor),
+                    /*initModel*/ Nothing(),
+                    /*initLearnProgress*/ nullptr,
+                    "",
+                    &models[isSparse],
+                    {&testApproxes[isSparse]}
+                );
+            }
+
+            UNIT_ASSERT_EQUAL(*models[0].ObliviousTrees, *models[1].ObliviousTrees);
+            UNIT_ASSERT_EQUAL(
+                testApproxes[0].GetRawValuesConstRef(),
+                testApproxes[1].GetRawValuesConstRef()
+            );
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/model/ut/lib/model_test_helpers.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <library/unittest/registar.h>
 #include <library/json/json_reader.h>
@@ -134,4 +135,88 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestLeafwiseScoring) {
+        // more docs than in a partition block, so that leaves are partitioned by several blocks
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateRandomFloatPool(/*docCount*/ 50000, /*factorCount*/ 10, /*seed*/ 17);
+
+        for (const TString bootstrapType : {"Bayesian", "Bernoulli"}) {
+            for (const TString samplingFrequency : {"PerTree", "PerTreeLevel"}) {
+                NJson::TJsonValue plainFitParams;
+                plainFitParams.InsertValue("random_seed", 5);
+                plainFitParams.InsertValue("random_strength", 0);
+                plainFitParams.InsertValue("iterations", 10);
+                plainFitParams.InsertValue("depth", 6);
+                plainFitParams.InsertValue("boosting_type", "Plain");
+                plainFitParams.InsertValue("bootstrap_type", bootstrapType);
+                plainFitParams.InsertValue("sampling_frequency", samplingFrequency);
+                plainFitParams.InsertValue("train_dir", ".");
+                plainFitParams.InsertValue("thread_count", 4);
+
+                TVector<TFullModel> models(2);
+                for (auto leafwiseScoring : {false, true}) {
+                    plainFitParams.InsertValue("dev_leafwise_scoring", leafwiseScoring);
+                    TrainModel(
+                        plainFitParams,
+                        nullptr,
+                        Nothing(),
+                        Nothing(),
+                        dataProviders,
+                        /*initModel*/ Nothing(),
+                        /*initLearnProgress*/ nullptr,
+                        "",
+                        &models[leafwiseScoring],
+                        /*evalResultPtrs*/ {}
+                    );
+                }
+
+                // docs order in leaves differs, so stats sums are equal up to summation order
+                const auto& trees = *models[0].ObliviousTrees;
+                const auto& leafwiseTrees = *models[1].ObliviousTrees;
+                UNIT_ASSERT_VALUES_EQUAL(trees.TreeSplits, leafwiseTrees.TreeSplits);
+                UNIT_ASSERT_VALUES_EQUAL(trees.LeafValues.size(), leafwiseTrees.LeafValues.size());
+                for (auto i : xrange(trees.LeafValues.size())) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(trees.LeafValues[i], leafwiseTrees.LeafValues[i], 1e-9);
+                }
+            }
+        }
+    }
+
+    // online CTR values do not depend on projection hash cache contents,
+    // there is no memory left for the cache with a tiny used_ram_limit
+    Y_UNIT_TEST(TestProjectionHashCacheDoesNotChangeModel) {
+        for (const TString boostingType : {"Plain", "Ordered"}) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 20);
+            plainFitParams.InsertValue("depth", 4);
+            plainFitParams.InsertValue("max_ctr_complexity", 4);
+            plainFitParams.InsertValue("boosting_type", boostingType);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 4);
+
+            TVector<TFullModel> models(2);
+            for (auto modelIdx : xrange(2)) {
+                plainFitParams.InsertValue("used_ram_limit", modelIdx ? "64Gb" : "1Kb");
+                TDataProviders dataProviders;
+                dataProviders.Learn = GetAdultPool();
+                TrainModel(
+                    plainFitParams,
+                    nullptr,
+                    Nothing(),
+                    Nothing(),
+                    dataProviders,
+                    /*initModel*/ Nothing(),
+                    /*initLearnProgress*/ nullptr,
+                    "",
+                    &models[modelIdx],
+                    /*evalResultPtrs*/ {}
+                );
+            }
+
+            UNIT_ASSERT(!models[0].ObliviousTrees->CtrFeatures.empty());
+            UNIT_ASSERT_EQUAL(*models[0].ObliviousTrees, *models[1].ObliviousTrees);
+        }
+    }
 }
@@ -0,0 +1,76 @@
+#include <catboost/libs/algo/yetirank_helpers.h>
+#include <catboost/libs/options/loss_description.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TYetiRankHelpersTest) {
+    Y_UNIT_TEST(TwoDocumentsQuery) {
+        const TVector<double> approxes = {1.0, 2.0};
+        const TVector<float> relevances = {1.0f, 0.0f};
+        TVector<TQueryInfo> queriesInfo = {TQueryInfo(0, 2)};
+        queriesInfo[0].Weight = 2.0f;
+        NPar::TLocalExecutor localExecutor;
+        UpdatePairsForYetiRank(
+            approxes,
+            relevances,
+            NCatboostOptions::ParseLossDescription("YetiRank:permutations=3"),
+            /*randomSeed*/ 0,
+            /*queryBegin*/ 0,
+            /*queryEnd*/ 1,
+            &queriesInfo,
+            &localExecutor);
+
+        const auto& competitors = queriesInfo[0].Competitors;
+        UNIT_ASSERT_VALUES_EQUAL(competitors.size(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(competitors[0].size(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(competitors[0][0].Id, 1);
+        UNIT_ASSERT_DOUBLES_EQUAL(competitors[0][0].Weight, 2.0 * 0.15, 1e-6);
+        UNIT_ASSERT(competitors[1].empty());
+    }
+
+    Y_UNIT_TEST(LongQueryPairs) {
+        const ui32 querySize = 1000;
+        TFastRng64 rng(0);
+        TVector<double> approxes;
+        TVector<float> relevances;
+        for (auto docIdx : xrange(querySize)) {
+            Y_UNUSED(docIdx);
+            approxes.push_back(rng.GenRandReal1() + 0.5);
+            relevances.push_back(rng.Uniform(4));
+        }
+        const int permutationCount = 10;
+        TVector<TQueryInfo> queriesInfo = {TQueryInfo(0, querySize)};
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        UpdatePairsForYetiRank(
+            approxes,
+            relevances,
+            NCatboostOptions::ParseLossDescription("YetiRank:permutations=10"),
+            /*randomSeed*/ 0,
+            /*queryBegin*/ 0,
+            /*queryEnd*/ 1,
+            &queriesInfo,
+            &localExecutor);
+
+        size_t pairCount = 0;
+        const auto& competitors = queriesInfo[0].Competitors;
+        UNIT_ASSERT_VALUES_EQUAL(competitors.size(), querySize);
+        for (auto winnerIdx : xrange(querySize)) {
+            for (auto competitorIdx : xrange(competitors[winnerIdx].size())) {
+                const auto& competitor = competitors[winnerIdx][competitorIdx];
+                UNIT_ASSERT_GT(relevances[winnerIdx], relevances[competitor.Id]);
+                UNIT_ASSERT_GT(competitor.Weight, 0.0f);
+                if (competitorIdx > 0) {
+                    UNIT_ASSERT_LT(competitors[winnerIdx][competitorIdx - 1].Id, competitor.Id);
+                }
+            }
+            pairCount += competitors[winnerIdx].size();
+        }
+        UNIT_ASSERT(pairCount > 0);
+        UNIT_ASSERT(pairCount <= (querySize - 1) * permutationCount);
+    }
+}
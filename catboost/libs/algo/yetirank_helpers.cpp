@@ -8,8 +8,29 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
+#include <numeric>
+
+
+namespace {
+    struct TYetiRankPair {
+        ui32 Winner;
+        ui32 Loser;
+        float Weight;
+    };
+
+    // reused between queries processed by the same thread
+    struct TYetiRankScratch {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<TYetiRankPair> Pairs;
+        TVector<TYetiRankPair> PairsByWinner;
+        TVector<ui32> WinnerOffsets;
+    };
+}
 
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
@@ -19,6 +40,7 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankScratch* scratch,
     TVector<TVector<TCompetitor>>* competitors
 ) {
     TFastRng64 rand(randomSeed);
@@ -26,15 +48,21 @@ static void GenerateYetiRankPairsForQuery(
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    TVector<int>& indices = scratch->Indices;
+    TVector<double>& bootstrappedApprox = scratch->BootstrappedApprox;
+    TVector<TYetiRankPair>& pairs = scratch->Pairs;
+    indices.yresize(querySize);
+    bootstrappedApprox.yresize(querySize);
+    pairs.clear();
+
+    // only adjacent documents of each permutation are compared, so there are at most
+    //  (querySize - 1) * permutationCount pairs
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
         for (ui32 docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
-            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+            bootstrappedApprox[docId] = expApproxes[docId] * (uniformValue / (1.000001f - uniformValue));
         }
 
         Sort(
@@ -53,23 +81,56 @@ static void GenerateYetiRankPairsForQuery(
             const float pairWeight = magicConst * decayCoefficient
                 * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                pairs.push_back({(ui32)firstCandidate, (ui32)secondCandidate, pairWeight});
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                pairs.push_back({(ui32)secondCandidate, (ui32)firstCandidate, pairWeight});
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
+    // counting sort by winner keeps pairs of each winner in generation order,
+    //  so weights are summed in the same order as permutations were made
+    TVector<ui32>& winnerOffsets = scratch->WinnerOffsets;
+    winnerOffsets.assign(querySize + 1, 0);
+    for (const auto& pair : pairs) {
+        ++winnerOffsets[pair.Winner + 1];
+    }
+    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        winnerOffsets[winnerIndex + 1] += winnerOffsets[winnerIndex];
+    }
+    TVector<TYetiRankPair>& pairsByWinner = scratch->PairsByWinner;
+    pairsByWinner.yresize(pairs.size());
+    for (const auto& pair : pairs) {
+        pairsByWinner[winnerOffsets[pair.Winner]++] = pair;
+    }
+
+    ui32 winnerBegin = 0;
     for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight
-                = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+        const ui32 winnerEnd = winnerOffsets[winnerIndex];
+        if (winnerBegin == winnerEnd) {
+            continue;
+        }
+        const auto winnerPairs = MakeArrayRef(pairsByWinner.data() + winnerBegin, winnerEnd - winnerBegin);
+        StableSort(
+            winnerPairs.begin(),
+            winnerPairs.end(),
+            [](const TYetiRankPair& lhs, const TYetiRankPair& rhs) {
+                return lhs.Loser < rhs.Loser;
+            }
+        );
+        for (size_t pairIdx = 0; pairIdx < winnerPairs.size();) {
+            const ui32 loserIndex = winnerPairs[pairIdx].Loser;
+            float summaryWeight = 0;
+            for (; pairIdx < winnerPairs.size() && winnerPairs[pairIdx].Loser == loserIndex; ++pairIdx) {
+                summaryWeight += winnerPairs[pairIdx].Weight;
+            }
+            const float competitorsWeight = queryWeight * summaryWeight / permutationCount;
             if (competitorsWeight != 0) {
                 competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
             }
         }
+        winnerBegin = winnerEnd;
     }
 }
 
@@ -97,6 +158,7 @@ void UpdatePairsForYetiRank(
         blockCount,
         [&](int blockId) {
             TFastRng64 rand(randomSeeds[blockId]);
+            TYetiRankScratch scratch;
             const int from = queryBegin + blockId * blockSize;
             const int to = Min<int>(queryBegin + (blockId + 1) * blockSize, queryEnd);
             for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -109,6 +171,7 @@ void UpdatePairsForYetiRank(
                     permutationCount,
                     decaySpeed,
                     rand.GenRand(),
+                    &scratch,
                     &queryInfoRef.Competitors
                 );
             }
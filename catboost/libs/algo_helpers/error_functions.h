@@ -169,6 +169,135 @@ private:
     const EHessianType HessianType;
 };
 
+/* Base for errors with per-object derivatives: CalcDersRange calls CalcDer, CalcDer2 and CalcDer3 of
+ *  the final TError class non-virtually, so they are inlined into the loop over objects.
+ * TError must be final and declare this class as friend.
+ */
+template <class TError>
+class TDerCalcerWithInlinedDers : public IDerCalcer {
+public:
+    using IDerCalcer::IDerCalcer;
+
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* firstDers
+    ) const final {
+        CalcDersRangeForOrder</*MaxDerivativeOrder*/ 1, /*UseTDers*/ false>(
+            start,
+            count,
+            approxes,
+            approxDeltas,
+            targets,
+            weights,
+            /*ders*/ nullptr,
+            firstDers);
+    }
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const final {
+        if (calcThirdDer) {
+            CalcDersRangeForOrder<3, true>(start, count, approxes, approxDeltas, targets, weights, ders, nullptr);
+        } else if (GetMaxSupportedDerivativeOrder() >= 2) {
+            CalcDersRangeForOrder<2, true>(start, count, approxes, approxDeltas, targets, weights, ders, nullptr);
+        } else {
+            CalcDersRangeForOrder<1, true>(start, count, approxes, approxDeltas, targets, weights, ders, nullptr);
+        }
+    }
+
+private:
+    template <int MaxDerivativeOrder, bool UseTDers>
+    void CalcDersRangeForOrder(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders,
+        double* firstDers
+    ) const {
+        Y_ASSERT(MaxDerivativeOrder <= (int)GetMaxSupportedDerivativeOrder());
+        if (GetIsExpApprox()) {
+            if (approxDeltas != nullptr) {
+                CalcDersRangeImpl<MaxDerivativeOrder, UseTDers, true, true>(
+                    start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            } else {
+                CalcDersRangeImpl<MaxDerivativeOrder, UseTDers, true, false>(
+                    start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            }
+        } else {
+            if (approxDeltas != nullptr) {
+                CalcDersRangeImpl<MaxDerivativeOrder, UseTDers, false, true>(
+                    start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            } else {
+                CalcDersRangeImpl<MaxDerivativeOrder, UseTDers, false, false>(
+                    start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            }
+        }
+    }
+
+    template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
+    void CalcDersRangeImpl(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders,
+        double* firstDers
+    ) const {
+        const TError& error = static_cast<const TError&>(*this);
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            double updatedApprox = approxes[i];
+            if (HasDelta) {
+                updatedApprox = UpdateApprox<UseExpApprox>(updatedApprox, approxDeltas[i]);
+            }
+            if (UseTDers) {
+                ders[i].Der1 = error.TError::CalcDer(updatedApprox, targets[i]);
+            } else {
+                firstDers[i] = error.TError::CalcDer(updatedApprox, targets[i]);
+            }
+            if (MaxDerivativeOrder >= 2) {
+                ders[i].Der2 = error.TError::CalcDer2(updatedApprox, targets[i]);
+            }
+            if (MaxDerivativeOrder >= 3) {
+                ders[i].Der3 = error.TError::CalcDer3(updatedApprox, targets[i]);
+            }
+        }
+        if (weights != nullptr) {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+            for (int i = start; i < start + count; ++i) {
+                if (UseTDers) {
+                    ders[i].Der1 *= weights[i];
+                } else {
+                    firstDers[i] *= weights[i];
+                }
+                if (MaxDerivativeOrder >= 2) {
+                    ders[i].Der2 *= weights[i];
+                }
+                if (MaxDerivativeOrder >= 3) {
+                    ders[i].Der3 *= weights[i];
+                }
+            }
+        }
+    }
+};
+
 class TCrossEntropyError final : public IDerCalcer {
 public:
     explicit TCrossEntropyError(bool isExpApprox)
@@ -198,14 +327,16 @@ public:
     ) const override;
 };
 
-class TRMSEError final : public IDerCalcer {
+class TRMSEError final : public TDerCalcerWithInlinedDers<TRMSEError> {
+    friend class TDerCalcerWithInlinedDers<TRMSEError>;
+
 public:
     static constexpr double RMSE_DER2 = -1.0;
     static constexpr double RMSE_DER3 = 0.0;
 
 public:
     explicit TRMSEError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
@@ -224,7 +355,9 @@ private:
     }
 };
 
-class TQuantileError final : public IDerCalcer {
+class TQuantileError final : public TDerCalcerWithInlinedDers<TQuantileError> {
+    friend class TDerCalcerWithInlinedDers<TQuantileError>;
+
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
@@ -234,7 +367,7 @@ public:
 
 public:
     explicit TQuantileError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(0.5)
         , Delta(1e-6)
     {
@@ -242,7 +375,7 @@ public:
     }
 
     TQuantileError(double alpha, double delta, bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(alpha)
         , Delta(delta)
     {
@@ -267,7 +400,9 @@ private:
     }
 };
 
-class TExpectileError final : public IDerCalcer {
+class TExpectileError final : public TDerCalcerWithInlinedDers<TExpectileError> {
+    friend class TDerCalcerWithInlinedDers<TExpectileError>;
+
 public:
     static constexpr double EXPECTILE_DER3 = 0.0;
 
@@ -276,14 +411,14 @@ public:
 
 public:
     explicit TExpectileError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
     TExpectileError(double alpha, bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -306,13 +441,15 @@ private:
     }
 };
 
-class TLqError final : public IDerCalcer {
+class TLqError final : public TDerCalcerWithInlinedDers<TLqError> {
+    friend class TDerCalcerWithInlinedDers<TLqError>;
+
 public:
     const double Q;
 
 public:
     TLqError(double q, bool isExpApprox)
-        : IDerCalcer(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
+        : TDerCalcerWithInlinedDers(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
         , Q(q)
     {
         Y_ASSERT(Q >= 1);
@@ -337,7 +474,9 @@ private:
     }
 };
 
-class TLogLinQuantileError final : public IDerCalcer {
+class TLogLinQuantileError final : public TDerCalcerWithInlinedDers<TLogLinQuantileError> {
+    friend class TDerCalcerWithInlinedDers<TLogLinQuantileError>;
+
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
@@ -346,14 +485,14 @@ public:
 
 public:
     explicit TLogLinQuantileError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
     TLogLinQuantileError(double alpha, bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -374,13 +513,15 @@ private:
     }
 };
 
-class TMAPError final : public IDerCalcer {
+class TMAPError final : public TDerCalcerWithInlinedDers<TMAPError> {
+    friend class TDerCalcerWithInlinedDers<TMAPError>;
+
 public:
     static constexpr double MAPE_DER2_AND_DER3 = 0.0;
 
 public:
     explicit TMAPError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
@@ -399,10 +540,12 @@ private:
     }
 };
 
-class TPoissonError final : public IDerCalcer {
+class TPoissonError final : public TDerCalcerWithInlinedDers<TPoissonError> {
+    friend class TDerCalcerWithInlinedDers<TPoissonError>;
+
 public:
     explicit TPoissonError(bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
@@ -472,6 +615,46 @@ public:
             }
         }
     }
+
+    // CalcDersMulti with compile-time approx dimension and plain buffers, der2 is packed as in THessianInfo
+    template <int ApproxDimension>
+    static void CalcDersMultiFixed(
+        const double* approx,
+        float target,
+        float weight,
+        double* der,
+        double* der2
+    ) {
+        constexpr int Der2Size = ApproxDimension * (ApproxDimension + 1) / 2;
+        CalcSoftmax(TConstArrayRef<double>(approx, ApproxDimension), TArrayRef<double>(der, ApproxDimension));
+
+        if (der2 != nullptr) {
+            int idx = 0;
+            for (int dimY = 0; dimY < ApproxDimension; ++dimY) {
+                const double derY = der[dimY];
+                der2[idx++] = derY * (derY - 1);
+                for (int dimX = dimY + 1; dimX < ApproxDimension; ++dimX) {
+                    der2[idx++] = derY * der[dimX];
+                }
+            }
+        }
+
+        for (int dim = 0; dim < ApproxDimension; ++dim) {
+            der[dim] = -der[dim];
+        }
+        der[static_cast<int>(target)] += 1;
+
+        if (weight != 1) {
+            for (int dim = 0; dim < ApproxDimension; ++dim) {
+                der[dim] *= weight;
+            }
+            if (der2 != nullptr) {
+                for (int idx = 0; idx < Der2Size; ++idx) {
+                    der2[idx] *= weight;
+                }
+            }
+        }
+    }
 };
 
 class TMultiClassOneVsAllError final : public IDerCalcer {
@@ -898,7 +1081,9 @@ private:
     }
 };
 
-class THuberError final : public IDerCalcer {
+class THuberError final : public TDerCalcerWithInlinedDers<THuberError> {
+    friend class TDerCalcerWithInlinedDers<THuberError>;
+
     static constexpr double HUBER_DER2 = -1.0;
     static constexpr double HUBER_DER3 = 0.0;
 
@@ -906,7 +1091,7 @@ class THuberError final : public IDerCalcer {
 public:
 
     explicit THuberError(double delta, bool isExpApprox)
-        : IDerCalcer(isExpApprox)
+        : TDerCalcerWithInlinedDers(isExpApprox)
         , Delta(delta)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
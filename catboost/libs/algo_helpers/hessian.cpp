@@ -3,6 +3,8 @@
 #include <catboost/libs/helpers/matrix.h>
 #include <catboost/libs/lapack/linear_system.h>
 
+#include <array>
+
 
 void SolveNewtonEquation(
     const THessianInfo& hessian,
@@ -26,6 +28,23 @@ void TSymmetricHessian::SolveNewtonEquation(
 {
     Y_ASSERT(hessian.ApproxDimension == negativeDer.ysize());
     const int approxDimension = hessian.ApproxDimension;
+    if (approxDimension <= MaxStackHessianApproxDimension) {
+        // called per leaf and, for ordered boosting, per tail document, so avoid heap allocations
+        std::array<double, MaxStackHessianApproxDimension * MaxStackHessianApproxDimension> der2;
+        std::array<double, MaxStackHessianApproxDimension * MaxStackHessianApproxDimension> inverse;
+        int idx = 0;
+        for (int dimY = 0; dimY < approxDimension; ++dimY) {
+            for (int dimX = dimY; dimX < approxDimension; ++dimX) {
+                der2[dimY * approxDimension + dimX] = hessian.Data[idx];
+                der2[dimX * approxDimension + dimY] = hessian.Data[idx++];
+            }
+            der2[dimY * approxDimension + dimY] -= l2Regularizer;
+        }
+        res->resize(approxDimension);
+        SolveLinearSystem(approxDimension, der2, inverse, negativeDer, *res);
+        return;
+    }
+
     TArray2D<double> der2(approxDimension, approxDimension);
     int idx = 0;
     for (int dimY = 0; dimY < approxDimension; ++dimY) {
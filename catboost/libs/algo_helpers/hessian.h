@@ -31,6 +31,10 @@ public:
 };
 
 class TSymmetricHessian : public THessian {
+public:
+    // Newton equations up to this dimension are solved in stack buffers
+    static constexpr int MaxStackHessianApproxDimension = 16;
+
 public:
     static void SolveNewtonEquation(
         const THessianInfo& /*hessian*/,
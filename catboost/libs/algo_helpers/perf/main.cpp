@@ -0,0 +1,95 @@
+#include <catboost/libs/algo_helpers/error_functions.h>
+
+#include <library/testing/benchmark/bench.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+namespace {
+    struct TDersData {
+        static constexpr int ObjectCount = 1 << 16;
+
+        TVector<double> Approxes;
+        TVector<double> ExpApproxes;
+        TVector<double> ApproxDeltas;
+        TVector<double> ExpApproxDeltas;
+        TVector<float> Targets;
+        TVector<float> Weights;
+
+        TDersData() {
+            TFastRng64 rng(17);
+            for (auto i : xrange(ObjectCount)) {
+                Y_UNUSED(i);
+                Approxes.push_back(rng.GenRandReal1() * 4 - 2);
+                ExpApproxes.push_back(exp(Approxes.back()));
+                ApproxDeltas.push_back(rng.GenRandReal1() * 0.2 - 0.1);
+                ExpApproxDeltas.push_back(exp(ApproxDeltas.back()));
+                Targets.push_back(rng.GenRandReal1() * 2 + 0.5);
+                Weights.push_back(rng.GenRandReal1());
+            }
+        }
+    };
+
+    template <bool CalcThirdDer>
+    void RunCalcDersRange(const IDerCalcer& error, const NBench::NCpu::TParams& iface) {
+        static const TDersData data;
+        const bool isExpApprox = error.GetIsExpApprox();
+        TVector<TDers> ders(TDersData::ObjectCount);
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+            error.CalcDersRange(
+                /*start*/ 0,
+                TDersData::ObjectCount,
+                CalcThirdDer,
+                isExpApprox ? data.ExpApproxes.data() : data.Approxes.data(),
+                isExpApprox ? data.ExpApproxDeltas.data() : data.ApproxDeltas.data(),
+                data.Targets.data(),
+                data.Weights.data(),
+                ders.data());
+            Y_DO_NOT_OPTIMIZE_AWAY(ders.data());
+        }
+    }
+
+    void RunCalcFirstDerRange(const IDerCalcer& error, const NBench::NCpu::TParams& iface) {
+        static const TDersData data;
+        const bool isExpApprox = error.GetIsExpApprox();
+        TVector<double> firstDers(TDersData::ObjectCount);
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+            error.CalcFirstDerRange(
+                /*start*/ 0,
+                TDersData::ObjectCount,
+                isExpApprox ? data.ExpApproxes.data() : data.Approxes.data(),
+                isExpApprox ? data.ExpApproxDeltas.data() : data.ApproxDeltas.data(),
+                data.Targets.data(),
+                data.Weights.data(),
+                firstDers.data());
+            Y_DO_NOT_OPTIMIZE_AWAY(firstDers.data());
+        }
+    }
+}
+
+#define DEFINE_BENCHMARKS(name, error)                                             \
+    Y_CPU_BENCHMARK(name##_FirstDer, iface) {                                      \
+        RunCalcFirstDerRange(error, iface);                                        \
+    }                                                                              \
+    Y_CPU_BENCHMARK(name##_Ders, iface) {                                          \
+        RunCalcDersRange</*CalcThirdDer*/ false>(error, iface);                    \
+    }                                                                              \
+    Y_CPU_BENCHMARK(name##_ThirdDers, iface) {                                     \
+        RunCalcDersRange</*CalcThirdDer*/ true>(error, iface);                     \
+    }
+
+DEFINE_BENCHMARKS(Logloss, TCrossEntropyError(/*isExpApprox*/ false))
+DEFINE_BENCHMARKS(LoglossExpApprox, TCrossEntropyError(/*isExpApprox*/ true))
+DEFINE_BENCHMARKS(RMSE, TRMSEError(/*isExpApprox*/ false))
+DEFINE_BENCHMARKS(Quantile, TQuantileError(/*alpha*/ 0.3, /*delta*/ 1e-6, /*isExpApprox*/ false))
+DEFINE_BENCHMARKS(Expectile, TExpectileError(/*alpha*/ 0.3, /*isExpApprox*/ false))
+DEFINE_BENCHMARKS(Lq, TLqError(/*q*/ 3, /*isExpApprox*/ false))
+DEFINE_BENCHMARKS(LogLinQuantile, TLogLinQuantileError(/*alpha*/ 0.3, /*isExpApprox*/ true))
+DEFINE_BENCHMARKS(MAPE, TMAPError(/*isExpApprox*/ false))
+DEFINE_BENCHMARKS(Poisson, TPoissonError(/*isExpApprox*/ true))
+DEFINE_BENCHMARKS(Huber, THuberError(/*delta*/ 0.5, /*isExpApprox*/ false))
@@ -0,0 +1,85 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/algo_helpers/error_functions.h>
+#include <catboost/libs/algo_helpers/hessian.h>
+#include <catboost/libs/lapack/linear_system.h>
+
+#include <library/containers/2d_array/2d_array.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+template <int ApproxDimension>
+static void CheckFixedMultiClassDers(float weight) {
+    TFastRng64 rng(ApproxDimension);
+    TVector<double> approx(ApproxDimension);
+    for (auto& value : approx) {
+        value = rng.GenRandReal1() * 4 - 2;
+    }
+    const float target = rng.Uniform(ApproxDimension);
+
+    const TMultiClassError error(/*isExpApprox*/ false);
+    TVector<double> der(ApproxDimension);
+    THessianInfo der2(ApproxDimension, EHessianType::Symmetric);
+    error.CalcDersMulti(approx, target, weight, &der, &der2);
+
+    TVector<double> fixedDer(ApproxDimension);
+    TVector<double> fixedDer2(der2.Data.size());
+    TMultiClassError::CalcDersMultiFixed<ApproxDimension>(approx.data(), target, weight, fixedDer.data(), fixedDer2.data());
+    UNIT_ASSERT(der == fixedDer);
+    UNIT_ASSERT(der2.Data == fixedDer2);
+
+    TVector<double> gradientOnlyDer(ApproxDimension);
+    TMultiClassError::CalcDersMultiFixed<ApproxDimension>(approx.data(), target, weight, gradientOnlyDer.data(), nullptr);
+    UNIT_ASSERT(der == gradientOnlyDer);
+}
+
+Y_UNIT_TEST_SUITE(MultiClassDersTest) {
+    Y_UNIT_TEST(FixedDimensionDersMatchGeneric) {
+        CheckFixedMultiClassDers<3>(/*weight*/ 1.0f);
+        CheckFixedMultiClassDers<7>(/*weight*/ 0.5f);
+        CheckFixedMultiClassDers<12>(/*weight*/ 1.0f);
+        CheckFixedMultiClassDers<16>(/*weight*/ 2.5f);
+    }
+
+    Y_UNIT_TEST(StackNewtonSolutionMatchesGeneric) {
+        TFastRng64 rng(0);
+        for (int approxDimension : {2, 5, 12, 16, 17}) {
+            const TMultiClassError error(/*isExpApprox*/ false);
+            TVector<double> approx(approxDimension);
+            TVector<double> der(approxDimension);
+            THessianInfo der2(approxDimension, EHessianType::Symmetric);
+            TVector<double> sumDer(approxDimension);
+            THessianInfo sumDer2(approxDimension, EHessianType::Symmetric);
+            for (int doc : xrange(10)) {
+                Y_UNUSED(doc);
+                for (auto& value : approx) {
+                    value = rng.GenRandReal1() * 4 - 2;
+                }
+                error.CalcDersMulti(approx, rng.Uniform(approxDimension), /*weight*/ 1, &der, &der2);
+                for (int dim : xrange(approxDimension)) {
+                    sumDer[dim] -= der[dim];
+                }
+                sumDer2.AddDer2(der2);
+            }
+            const float l2Regularizer = 0.3f;
+
+            TVector<double> solution;
+            SolveNewtonEquation(sumDer2, sumDer, l2Regularizer, &solution);
+
+            TArray2D<double> matrix(approxDimension, approxDimension);
+            int idx = 0;
+            for (int dimY : xrange(approxDimension)) {
+                for (int dimX : xrange(dimY, approxDimension)) {
+                    matrix[dimY][dimX] = sumDer2.Data[idx];
+                    matrix[dimX][dimY] = sumDer2.Data[idx++];
+                }
+                matrix[dimY][dimY] -= l2Regularizer;
+            }
+            TVector<double> expectedSolution;
+            SolveLinearSystem(matrix, sumDer, &expectedSolution);
+            UNIT_ASSERT(solution == expectedSolution);
+        }
+    }
+}
@@ -5,6 +5,7 @@
 #include <catboost/libs/algo/apply.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/eval_result/binary_output.h>
 #include <catboost/libs/eval_result/eval_result.h>
 #include <catboost/libs/labels/label_helper_builder.h>
 #include <catboost/libs/logging/logging.h>
@@ -134,12 +135,16 @@ void NCB::CalcModelSingleHost(
     size_t evalPeriod,
     TFullModel&& model) {
 
-    CB_ENSURE(params.OutputPath.Scheme == "dsv" || params.OutputPath.Scheme == "stream", "Local model evaluation supports only \"dsv\"  and \"stream\" output file schemas.");
+    const bool isBinaryOutput = (params.OutputPath.Scheme == "binary");
+    CB_ENSURE(
+        params.OutputPath.Scheme == "dsv" || params.OutputPath.Scheme == "stream" || isBinaryOutput,
+        "Local model evaluation supports only \"dsv\", \"stream\" and \"binary\" output file schemas."
+    );
     NCatboostOptions::ValidatePoolParams(params.InputPath, params.DsvPoolFormatParams);
 
-    TSetLogging logging(params.OutputPath.Scheme == "dsv" ? ELoggingLevel::Info : ELoggingLevel::Silent);
+    TSetLogging logging(params.OutputPath.Scheme == "stream" ? ELoggingLevel::Silent : ELoggingLevel::Info);
     THolder<IOutputStream> outputStream;
-    if (params.OutputPath.Scheme == "dsv") {
+    if (params.OutputPath.Scheme == "dsv" || isBinaryOutput) {
          outputStream = MakeHolder<TOFStream>(params.OutputPath.Path);
     } else {
         CB_ENSURE(params.OutputPath.Path == "stdout" || params.OutputPath.Path == "stderr", "Local model evaluation supports only stderr and stdout paths.");
@@ -171,20 +176,34 @@ void NCB::CalcModelSingleHost(
         poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
 
         TSetLoggingSilent inThisScope;
-        OutputEvalResultToFile(
-            approx,
-            &executor,
-            params.OutputColumnsIds,
-            visibleLabelsHelper,
-            *datasetPart,
-            outputStream.Get(),
-            // TODO: src file columns output is incompatible with block processing
-            poolColumnsPrinter,
-            /*testFileWhichOf*/ {0, 0},
-            IsFirstBlock,
-            docIdOffset,
-            std::make_pair(evalPeriod, iterationsLimit)
-        );
+        if (isBinaryOutput) {
+            OutputEvalResultToBinaryStream(
+                approx,
+                &executor,
+                params.OutputColumnsIds,
+                visibleLabelsHelper,
+                *datasetPart,
+                outputStream.Get(),
+                IsFirstBlock,
+                docIdOffset,
+                std::make_pair(evalPeriod, iterationsLimit)
+            );
+        } else {
+            OutputEvalResultToFile(
+                approx,
+                &executor,
+                params.OutputColumnsIds,
+                visibleLabelsHelper,
+                *datasetPart,
+                outputStream.Get(),
+                // TODO: src file columns output is incompatible with block processing
+                poolColumnsPrinter,
+                /*testFileWhichOf*/ {0, 0},
+                IsFirstBlock,
+                docIdOffset,
+                std::make_pair(evalPeriod, iterationsLimit)
+            );
+        }
         docIdOffset += datasetPart->ObjectsGrouping->GetObjectCount();
         IsFirstBlock = false;
     }, &executor);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_index.h"
+#include "hashed_cat_values_map.h"
 
 #include <catboost/libs/helpers/checksum.h>
 #include <catboost/libs/helpers/exception.h>
@@ -8,7 +9,6 @@
 #include <library/binsaver/bin_saver.h>
 
 #include <util/generic/guid.h>
-#include <util/generic/map.h>
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
 #include <util/generic/typetraits.h>
@@ -39,23 +39,6 @@ namespace NCB {
         return UpdateCheckSum(checkSum, data.OnAll);
     }
 
-    struct TValueWithCount {
-        ui32 Value = 0;
-        ui32 Count = 0;
-
-    public:
-        bool operator==(const TValueWithCount rhs) const {
-            return (Value == rhs.Value) && (Count == rhs.Count);
-        }
-    };
-
-    // for some reason TValueWithCount is not std::is_trivial
-    inline ui32 UpdateCheckSumImpl(ui32 init, const TValueWithCount& data) {
-        ui32 checkSum = UpdateCheckSum(init, data.Value);
-        return UpdateCheckSum(checkSum, data.Count);
-    }
-
-
     struct TCatFeaturePerfectHashDefaultValue {
         ui32 SrcValue;
         TValueWithCount DstValueWithCount;
@@ -71,7 +54,7 @@ namespace NCB {
 
     struct TCatFeaturePerfectHash {
         TMaybe<TCatFeaturePerfectHashDefaultValue> DefaultMap;
-        TMap<ui32, TValueWithCount> Map;
+        THashedCatValuesMap Map;
 
     public:
         bool operator==(const TCatFeaturePerfectHash& rhs) const {
@@ -106,7 +89,6 @@ namespace NCB {
 }
 
 Y_DECLARE_PODTYPE(NCB::TCatFeatureUniqueValuesCounts);
-Y_DECLARE_PODTYPE(NCB::TValueWithCount);
 Y_DECLARE_PODTYPE(NCB::TCatFeaturePerfectHashDefaultValue);
 
 
@@ -5,8 +5,7 @@
 #include <util/system/guard.h>
 #include <util/system/yassert.h>
 #include <util/generic/cast.h>
-#include <util/generic/map.h>
-
+#include <util/generic/ymath.h>
 #include <util/generic/ylimits.h>
 
 #include <utility>
@@ -14,13 +13,17 @@
 
 namespace NCB {
 
+    // blocks of values are processed in parallel only if they are large enough to amortize merging
+    static constexpr ui32 MIN_PARALLEL_BLOCK_SIZE = 1 << 16;
+
     void TCatFeaturesPerfectHashHelper::UpdatePerfectHashAndMaybeQuantize(
         const TCatFeatureIdx catFeatureIdx,
         TMaybeOwningConstArraySubset<ui32, ui32> hashedCatArraySubset,
         bool mapMostFrequentValueTo0,
         TMaybe<TDefaultValue<ui32>> hashedCatDefaultValue,
         TMaybe<float> quantizedDefaultBinFraction,
-        TMaybe<TArrayRef<ui32>*> dstBins
+        TMaybe<TArrayRef<ui32>*> dstBins,
+        NPar::TLocalExecutor* localExecutor
     ) {
         QuantizedFeaturesInfo->CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
         auto& featuresHash = QuantizedFeaturesInfo->CatFeaturesPerfectHash;
@@ -81,45 +84,112 @@ namespace NCB {
             }
         }
 
-        auto processNonDefaultValue = [&, dstBins, dstBinsValue] (ui32 idx, ui32 hashedCatValue) {
-            auto it = perfectHashMap.Map.find(hashedCatValue);
-            if (it == perfectHashMap.Map.end()) {
-                CB_ENSURE(
-                    perfectHashMap.Map.size() != MAX_UNIQ_CAT_VALUES,
-                    "Error: categorical feature with id #" << *catFeatureIdx
-                    << " has more than " << MAX_UNIQ_CAT_VALUES
-                    << " unique values, which is currently unsupported"
-                );
-                const ui32 bin = (ui32)perfectHashMap.GetSize();
-                if (dstBins) {
-                    dstBinsValue[idx] = bin;
-                }
-                perfectHashMap.Map.emplace_hint(it, hashedCatValue, TValueWithCount{bin, 1});
-            } else {
-                if (dstBins) {
-                    dstBinsValue[idx] = it->second.Value;
+        const auto& subsetIndexing = *hashedCatArraySubset.GetSubsetIndexing();
+        const auto& srcValues = *hashedCatArraySubset.GetSrc();
+
+        const TMaybe<TCatFeaturePerfectHashDefaultValue> defaultMap = perfectHashMap.DefaultMap;
+
+        // f is called with (idx, hashedCatValue) for values not mapped by DefaultMap
+        auto forEachNonDefaultValueInBlock = [&] (NCB::TIndexRange<ui32> unitSubRange, auto&& f) {
+            subsetIndexing.ForEachInSubRange(
+                unitSubRange,
+                [&] (ui32 idx, ui32 srcIdx) {
+                    const ui32 hashedCatValue = srcValues[srcIdx];
+                    if (defaultMap && (hashedCatValue == defaultMap->SrcValue)) {
+                        if (dstBins) {
+                            dstBinsValue[idx] = defaultMap->DstValueWithCount.Value;
+                        }
+                    } else {
+                        f(idx, hashedCatValue);
+                    }
                 }
-                ++(it->second.Count);
-            }
+            );
+        };
+
+        auto addNewValue = [&] (ui32 hashedCatValue, ui32 count) -> ui32 {
+            CB_ENSURE(
+                perfectHashMap.Map.size() != MAX_UNIQ_CAT_VALUES,
+                "Error: categorical feature with id #" << *catFeatureIdx
+                << " has more than " << MAX_UNIQ_CAT_VALUES
+                << " unique values, which is currently unsupported"
+            );
+            const ui32 bin = (ui32)perfectHashMap.GetSize();
+            perfectHashMap.Map.emplace(hashedCatValue, TValueWithCount{bin, count});
+            return bin;
         };
 
-        if (perfectHashMap.DefaultMap) {
-            const TCatFeaturePerfectHashDefaultValue defaultMap = *perfectHashMap.DefaultMap;
-            const ui32 defaultHashedCatValue = defaultMap.SrcValue;
-            const ui32 defaultMappedValue = defaultMap.DstValueWithCount.Value;
-            hashedCatArraySubset.ForEach(
-                [&, defaultHashedCatValue, defaultMappedValue] (ui32 idx, ui32 hashedCatValue) {
-                    if (hashedCatValue == defaultHashedCatValue) {
+        const ui32 approximateBlockSize = Max<ui32>(
+            CeilDiv<ui32>(hashedCatArraySubset.Size(), (ui32)localExecutor->GetThreadCount() + 1),
+            MIN_PARALLEL_BLOCK_SIZE
+        );
+        const auto parallelUnitRanges = subsetIndexing.GetParallelUnitRanges(approximateBlockSize);
+        const int blockCount = SafeIntegerCast<int>(parallelUnitRanges.RangesCount());
+
+        if (blockCount == 1) {
+            forEachNonDefaultValueInBlock(
+                parallelUnitRanges.GetRange(0),
+                [&] (ui32 idx, ui32 hashedCatValue) {
+                    auto it = perfectHashMap.Map.find(hashedCatValue);
+                    if (it == perfectHashMap.Map.end()) {
+                        const ui32 bin = addNewValue(hashedCatValue, 1);
                         if (dstBins) {
-                            dstBinsValue[idx] = defaultMappedValue;
+                            dstBinsValue[idx] = bin;
                         }
                     } else {
-                        processNonDefaultValue(idx, hashedCatValue);
+                        if (dstBins) {
+                            dstBinsValue[idx] = it->second.Value;
+                        }
+                        ++(it->second.Count);
                     }
                 }
             );
         } else {
-            hashedCatArraySubset.ForEach(processNonDefaultValue);
+            // count unique values in blocks in parallel (in the order of their first occurrence)
+            TVector<THashedCatValuesMap> blocksUniqueValues(blockCount);
+            localExecutor->ExecRangeWithThrow(
+                [&] (int blockIdx) {
+                    auto& blockUniqueValues = blocksUniqueValues[blockIdx];
+                    forEachNonDefaultValueInBlock(
+                        parallelUnitRanges.GetRange(blockIdx),
+                        [&] (ui32 /*idx*/, ui32 hashedCatValue) {
+                            ++(blockUniqueValues.emplace(hashedCatValue, TValueWithCount()).first->second.Count);
+                        }
+                    );
+                },
+                0,
+                blockCount,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+
+            // merge in blocks order so bins are the same as with sequential processing
+            for (auto& blockUniqueValues : blocksUniqueValues) {
+                for (const auto& [hashedCatValue, valueWithCount] : blockUniqueValues) {
+                    auto it = perfectHashMap.Map.find(hashedCatValue);
+                    if (it == perfectHashMap.Map.end()) {
+                        addNewValue(hashedCatValue, valueWithCount.Count);
+                    } else {
+                        it->second.Count += valueWithCount.Count;
+                    }
+                }
+                blockUniqueValues = THashedCatValuesMap();
+            }
+
+            if (dstBins) {
+                const auto& map = perfectHashMap.Map;
+                localExecutor->ExecRangeWithThrow(
+                    [&] (int blockIdx) {
+                        forEachNonDefaultValueInBlock(
+                            parallelUnitRanges.GetRange(blockIdx),
+                            [&] (ui32 idx, ui32 hashedCatValue) {
+                                dstBinsValue[idx] = map.find(hashedCatValue)->second.Value;
+                            }
+                        );
+                    },
+                    0,
+                    blockCount,
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+            }
         }
 
         if (perfectHashMapWasEmptyBeforeUpdate &&
@@ -134,7 +204,10 @@ namespace NCB {
             TValueWithCount* mappedTo0 = (iter->second.Value == 0) ? &(iter->second) : nullptr;
             for (++iter; iter != iterEnd; ++iter) {
                 TValueWithCount* mapped = &(iter->second);
-                if (mapped->Count > mappedForMostFrequent->Count) {
+                // ties are resolved in favor of the smallest hashed value independently of Map order
+                if ((mapped->Count > mappedForMostFrequent->Count) ||
+                    ((mapped->Count == mappedForMostFrequent->Count) && (iter->first < mostFrequentSrcValue)))
+                {
                     mostFrequentSrcValue = iter->first;
                     mappedForMostFrequent = mapped;
                 }
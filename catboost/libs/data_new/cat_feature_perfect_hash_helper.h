@@ -5,6 +5,7 @@
 #include <catboost/libs/helpers/array_subset.h>
 
 #include <library/grid_creator/binarization.h>
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
@@ -34,7 +35,8 @@ namespace NCB {
             bool mapMostFrequentValueTo0,
             TMaybe<TDefaultValue<ui32>> hashedCatDefaultValue,
             TMaybe<float> quantizedDefaultBinFraction,
-            TMaybe<TArrayRef<ui32>*> dstBins
+            TMaybe<TArrayRef<ui32>*> dstBins,
+            NPar::TLocalExecutor* localExecutor
         );
 
     private:
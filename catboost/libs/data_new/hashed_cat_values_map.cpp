@@ -0,0 +1,121 @@
+#include "hashed_cat_values_map.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/ysaveload.h>
+
+
+namespace NCB {
+    bool THashedCatValuesMap::operator==(const THashedCatValuesMap& rhs) const {
+        if (size() != rhs.size()) {
+            return false;
+        }
+        for (const auto& [key, value] : Entries) {
+            const auto it = rhs.find(key);
+            if ((it == rhs.end()) || !(it->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t THashedCatValuesMap::erase(ui32 key) {
+        if (Slots.empty()) {
+            return 0;
+        }
+        const size_t mask = Slots.size() - 1;
+        size_t hole = FindSlot(key);
+        const ui32 entryIdx = Slots[hole];
+        if (entryIdx == EmptySlot) {
+            return 0;
+        }
+
+        // backward shift deletion: move entries of the probe sequence that can be placed into the hole
+        for (size_t slot = (hole + 1) & mask; Slots[slot] != EmptySlot; slot = (slot + 1) & mask) {
+            const size_t initialSlot = GetInitialSlot(Entries[Slots[slot]].first);
+            if (((slot - initialSlot) & mask) >= ((slot - hole) & mask)) {
+                Slots[hole] = Slots[slot];
+                hole = slot;
+            }
+        }
+        Slots[hole] = EmptySlot;
+
+        const ui32 lastEntryIdx = (ui32)Entries.size() - 1;
+        if (entryIdx != lastEntryIdx) {
+            Entries[entryIdx] = Entries[lastEntryIdx];
+            Slots[FindSlot(Entries[entryIdx].first)] = entryIdx;
+        }
+        Entries.pop_back();
+        return 1;
+    }
+
+    TVector<const THashedCatValuesMap::value_type*> THashedCatValuesMap::GetSortedEntries() const {
+        TVector<const value_type*> result;
+        result.reserve(Entries.size());
+        for (const auto& entry : Entries) {
+            result.push_back(&entry);
+        }
+        Sort(result, [] (const value_type* lhs, const value_type* rhs) { return lhs->first < rhs->first; });
+        return result;
+    }
+
+    void THashedCatValuesMap::Rehash(size_t slotCount) {
+        Slots.assign(slotCount, EmptySlot);
+        for (auto entryIdx : xrange(Entries.size())) {
+            Slots[FindSlot(Entries[entryIdx].first)] = (ui32)entryIdx;
+        }
+    }
+
+    // same format as TMapSerializer
+    void THashedCatValuesMap::Save(IOutputStream* out) const {
+        ::SaveSize(out, Entries.size());
+        for (const auto* entry : GetSortedEntries()) {
+            ::Save(out, *entry);
+        }
+    }
+
+    void THashedCatValuesMap::Load(IInputStream* in) {
+        const size_t size = ::LoadSize(in);
+        clear();
+        reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            value_type entry;
+            ::Load(in, entry);
+            emplace(entry.first, entry.second);
+        }
+    }
+
+    // same format as IBinSaver::DoAnyMap for TMap (keys in descending order, then values)
+    int THashedCatValuesMap::operator&(IBinSaver& binSaver) {
+        IBinSaver::TStoredSize size = 0;
+        if (binSaver.IsReading()) {
+            binSaver.Add(3, &size);
+            TVector<ui32> keys(size);
+            for (auto& key : keys) {
+                binSaver.Add(1, &key);
+            }
+            clear();
+            reserve(size);
+            for (auto key : keys) {
+                TValueWithCount value;
+                binSaver.Add(2, &value);
+                emplace(key, value);
+            }
+        } else {
+            size = SafeIntegerCast<IBinSaver::TStoredSize>(Entries.size());
+            binSaver.Add(3, &size);
+            TVector<const value_type*> sortedEntries = GetSortedEntries();
+            Reverse(sortedEntries.begin(), sortedEntries.end());
+            for (const auto* entry : sortedEntries) {
+                ui32 key = entry->first;
+                binSaver.Add(1, &key);
+            }
+            for (const auto* entry : sortedEntries) {
+                TValueWithCount value = entry->second;
+                binSaver.Add(2, &value);
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <catboost/libs/helpers/checksum.h>
+
+#include <library/binsaver/bin_saver.h>
+
+#include <util/digest/numeric.h>
+#include <util/generic/bitops.h>
+#include <util/generic/typetraits.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+#include <initializer_list>
+#include <utility>
+
+
+namespace NCB {
+    struct TValueWithCount {
+        ui32 Value = 0;
+        ui32 Count = 0;
+
+    public:
+        bool operator==(const TValueWithCount rhs) const {
+            return (Value == rhs.Value) && (Count == rhs.Count);
+        }
+    };
+
+    // for some reason TValueWithCount is not std::is_trivial
+    inline ui32 UpdateCheckSumImpl(ui32 init, const TValueWithCount& data) {
+        ui32 checkSum = UpdateCheckSum(init, data.Value);
+        return UpdateCheckSum(checkSum, data.Count);
+    }
+
+
+    /*
+     * Map from hashed categorical feature values to TValueWithCount.
+     *
+     * Entries are stored densely in insertion order and are addressed by an open-addressing
+     *  (linear probing) table of entry indices, so lookups touch two flat arrays instead of
+     *  tree nodes and memory usage is ~20 bytes per entry instead of ~48 bytes for TMap.
+     *
+     * Iteration order is insertion order, serialization (both ysaveload and IBinSaver) and checksums are
+     *  done in the order of keys and are compatible with the previously used TMap<ui32, TValueWithCount>.
+     */
+    class THashedCatValuesMap {
+    public:
+        using key_type = ui32;
+        using mapped_type = TValueWithCount;
+        using value_type = std::pair<ui32, TValueWithCount>;
+
+        // keys must not be modified through iterators
+        using iterator = TVector<value_type>::iterator;
+        using const_iterator = TVector<value_type>::const_iterator;
+
+    public:
+        THashedCatValuesMap() = default;
+
+        THashedCatValuesMap(std::initializer_list<value_type> values) {
+            reserve(values.size());
+            for (const auto& [key, value] : values) {
+                emplace(key, value);
+            }
+        }
+
+        bool operator==(const THashedCatValuesMap& rhs) const;
+
+        size_t size() const {
+            return Entries.size();
+        }
+
+        bool empty() const {
+            return Entries.empty();
+        }
+
+        iterator begin() {
+            return Entries.begin();
+        }
+
+        iterator end() {
+            return Entries.end();
+        }
+
+        const_iterator begin() const {
+            return Entries.begin();
+        }
+
+        const_iterator end() const {
+            return Entries.end();
+        }
+
+        iterator find(ui32 key) {
+            const ui32 entryIdx = FindEntryIdx(key);
+            return (entryIdx == EmptySlot) ? Entries.end() : (Entries.begin() + entryIdx);
+        }
+
+        const_iterator find(ui32 key) const {
+            const ui32 entryIdx = FindEntryIdx(key);
+            return (entryIdx == EmptySlot) ? Entries.end() : (Entries.begin() + entryIdx);
+        }
+
+        // returns (iterator, inserted) like THashMap::emplace, existing values are not overwritten
+        std::pair<iterator, bool> emplace(ui32 key, TValueWithCount value) {
+            if ((Entries.size() + 1) * 2 > Slots.size()) {
+                Rehash(Max<size_t>(MinSlotCount, FastClp2((Entries.size() + 1) * 2)));
+            }
+            const size_t slot = FindSlot(key);
+            if (Slots[slot] != EmptySlot) {
+                return {Entries.begin() + Slots[slot], false};
+            }
+            Slots[slot] = (ui32)Entries.size();
+            Entries.emplace_back(key, value);
+            return {Entries.end() - 1, true};
+        }
+
+        // last entry takes the place of the erased one in iteration order
+        size_t erase(ui32 key);
+
+        void reserve(size_t size) {
+            Entries.reserve(size);
+            if (size * 2 > Slots.size()) {
+                Rehash(Max<size_t>(MinSlotCount, FastClp2(size * 2)));
+            }
+        }
+
+        void clear() {
+            Entries.clear();
+            Slots.clear();
+        }
+
+        // entries ordered by key
+        TVector<const value_type*> GetSortedEntries() const;
+
+        void Save(IOutputStream* out) const;
+        void Load(IInputStream* in);
+
+        int operator&(IBinSaver& binSaver);
+
+    private:
+        size_t GetInitialSlot(ui32 key) const {
+            return IntHash(key) & (Slots.size() - 1);
+        }
+
+        // returns slot containing key or the empty slot where it has to be inserted
+        size_t FindSlot(ui32 key) const {
+            const size_t mask = Slots.size() - 1;
+            for (size_t slot = GetInitialSlot(key); ; slot = (slot + 1) & mask) {
+                const ui32 entryIdx = Slots[slot];
+                if ((entryIdx == EmptySlot) || (Entries[entryIdx].first == key)) {
+                    return slot;
+                }
+            }
+        }
+
+        ui32 FindEntryIdx(ui32 key) const {
+            return Slots.empty() ? EmptySlot : Slots[FindSlot(key)];
+        }
+
+        void Rehash(size_t slotCount);
+
+    private:
+        static constexpr ui32 EmptySlot = Max<ui32>();
+        static constexpr size_t MinSlotCount = 16;
+
+        TVector<value_type> Entries;
+        TVector<ui32> Slots; // entry indices, size is a power of 2, load factor <= 0.5
+    };
+
+    // compatible with checksum of TMap<ui32, TValueWithCount>
+    inline ui32 UpdateCheckSumImpl(ui32 init, const THashedCatValuesMap& data) {
+        ui32 checkSum = init;
+        for (const auto* entry : data.GetSortedEntries()) {
+            checkSum = UpdateCheckSum(checkSum, entry->first);
+            checkSum = UpdateCheckSum(checkSum, entry->second);
+        }
+        return checkSum;
+    }
+}
+
+Y_DECLARE_PODTYPE(NCB::TValueWithCount);
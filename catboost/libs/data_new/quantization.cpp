@@ -153,49 +153,20 @@ namespace NCB {
     }
 
 
-    static void CalcBordersAndNanMode(
-        const TFloatValuesHolder& srcFeature,
-        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
-        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    void CalcBordersAndNanMode(
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        ui32 featureId,
+        bool hasNans,
+        TVector<float>* nonNanValues,
         ENanMode* nanMode,
         TVector<float>* borders
     ) {
-        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
-
         Y_VERIFY(binarizationOptions.BorderCount > 0);
 
-        // does not contain nans
-        TVector<float> srcFeatureValuesForBuildBorders;
-
-        bool hasNans = false;
-
-        if (const auto* denseSrcFeature = dynamic_cast<const TFloatArrayValuesHolder*>(&srcFeature)) {
-            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = denseSrcFeature->GetArrayData();
-
-            TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
-                srcFeatureData.GetSrc(),
-                subsetForBuildBorders
-            );
-
-            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
-
-            srcDataForBuildBorders.ForEach(
-                [&] (ui32 /*idx*/, float value) {
-                    if (IsNan(value)) {
-                        hasNans = true;
-                    } else {
-                        srcFeatureValuesForBuildBorders.push_back(value);
-                    }
-                }
-            );
-        } else {
-            CB_ENSURE_INTERNAL(false, "CalcQuantizationAndNanMode: Unsupported column type");
-        }
-
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
             !hasNans,
-            "Feature #" << srcFeature.GetId() << ": There are nan factors and nan values for "
+            "Feature #" << featureId << ": There are nan factors and nan values for "
             " float features are not allowed. Set nan_mode != Forbidden."
         );
 
@@ -211,7 +182,7 @@ namespace NCB {
 
         if (nonNanValuesBorderCount > 0) {
             borderSet = BestSplit(
-                srcFeatureValuesForBuildBorders,
+                *nonNanValues,
                 nonNanValuesBorderCount,
                 binarizationOptions.BorderSelectionType
             );
@@ -233,6 +204,54 @@ namespace NCB {
     }
 
 
+    static void CalcBordersAndNanMode(
+        const TFloatValuesHolder& srcFeature,
+        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
+        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
+
+        // does not contain nans
+        TVector<float> srcFeatureValuesForBuildBorders;
+
+        bool hasNans = false;
+
+        if (const auto* denseSrcFeature = dynamic_cast<const TFloatArrayValuesHolder*>(&srcFeature)) {
+            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = denseSrcFeature->GetArrayData();
+
+            TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
+                srcFeatureData.GetSrc(),
+                subsetForBuildBorders
+            );
+
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+            srcDataForBuildBorders.ForEach(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
+                }
+            );
+        } else {
+            CB_ENSURE_INTERNAL(false, "CalcQuantizationAndNanMode: Unsupported column type");
+        }
+
+        CalcBordersAndNanMode(
+            binarizationOptions,
+            srcFeature.GetId(),
+            hasNans,
+            &srcFeatureValuesForBuildBorders,
+            nanMode,
+            borders
+        );
+    }
+
+
     using TGetBinFunction = std::function<ui32(size_t, size_t)>;
 
     TGetBinFunction GetQuantizedFloatFeatureFunction(
@@ -1071,6 +1090,7 @@ namespace NCB {
         bool storeFeaturesDataAsExternalValuesHolder,
         bool mapMostFrequentValueTo0,
         const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedCatValuesHolder>* dstQuantizedFeature
     ) {
@@ -1101,7 +1121,8 @@ namespace NCB {
                 mapMostFrequentValueTo0,
                 /*hashedCatDefaultValue*/ Nothing(),
                 /*quantizedDefaultBinFraction*/ Nothing(),
-                quantizeData ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing()
+                quantizeData ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing(),
+                localExecutor
             );
         };
 
@@ -1570,6 +1591,7 @@ namespace NCB {
                                             storeFeaturesDataAsExternalValuesHolders,
                                             /*mapMostFrequentValueTo0*/ bundleExclusiveFeatures,
                                             subsetIndexing.Get(),
+                                            localExecutor,
                                             quantizedFeaturesInfo,
                                             &(data->ObjectsData.Data.CatFeatures[*catFeatureIdx])
                                         );
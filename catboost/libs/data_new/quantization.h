@@ -56,6 +56,18 @@ namespace NCB {
     );
 
 
+    /* calculates borders of a float feature from a sample of its values,
+     * nonNanValues must not contain nans, hasNans - whether the feature has nan values
+     */
+    void CalcBordersAndNanMode(
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        ui32 featureId, // for error messages
+        bool hasNans,
+        TVector<float>* nonNanValues,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    );
+
     void CalcBordersAndNanMode(
         const TQuantizationOptions& options,
         TRawDataProviderPtr rawDataProvider,
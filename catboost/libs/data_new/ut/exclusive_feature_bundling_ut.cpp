@@ -0,0 +1,103 @@
+#include <catboost/libs/data_new/exclusive_feature_bundling.h>
+
+#include <catboost/libs/data_new/features_layout.h>
+#include <catboost/libs/data_new/objects.h>
+#include <catboost/libs/data_new/quantized_features_info.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(ExclusiveFeatureBundling) {
+    /* features 0, 1, 2 are non-default on disjoint sets of objects, feature 3 is non-default on all objects
+     * all features have 4 bins, so they need 3 bins in a bundle
+     */
+    TVector<TExclusiveFeaturesBundle> CreateBundles(const TExclusiveFeaturesBundlingOptions& options) {
+        const ui32 objectCount = 300;
+        const ui32 featureCount = 4;
+
+        TVector<TVector<float>> features(featureCount, TVector<float>(objectCount, 0.0f));
+        for (auto objectIdx : xrange(objectCount)) {
+            const float nonDefaultValue = 1.0f + (objectIdx / 3) % 3;
+            features[objectIdx % 3][objectIdx] = nonDefaultValue;
+            features[3][objectIdx] = nonDefaultValue;
+        }
+
+        TFeaturesLayout featuresLayout(featureCount, TVector<ui32>{}, TVector<TString>{});
+        TFeaturesArraySubsetIndexing subsetIndexing(TFullSubset<ui32>(objectCount));
+
+        TQuantizedFeaturesInfo quantizedFeaturesInfo(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions()
+        );
+        TRawObjectsData rawObjectsData;
+        for (auto featureIdx : xrange(featureCount)) {
+            quantizedFeaturesInfo.SetBorders(TFloatFeatureIdx(featureIdx), {0.5f, 1.5f, 2.5f});
+            quantizedFeaturesInfo.SetNanMode(TFloatFeatureIdx(featureIdx), ENanMode::Forbidden);
+            rawObjectsData.FloatFeatures.emplace_back(
+                MakeHolder<TFloatArrayValuesHolder>(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(features[featureIdx])),
+                    &subsetIndexing
+                )
+            );
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        return CreateExclusiveFeatureBundles(
+            rawObjectsData,
+            subsetIndexing,
+            featuresLayout,
+            quantizedFeaturesInfo,
+            options,
+            &localExecutor
+        );
+    }
+
+    Y_UNIT_TEST(TestExclusiveFeaturesAreBundled) {
+        const auto bundles = CreateBundles(TExclusiveFeaturesBundlingOptions());
+
+        // feature 3 conflicts with all other features, bundles with one part are not saved
+        UNIT_ASSERT_VALUES_EQUAL(bundles.size(), 1);
+        const TVector<TExclusiveBundlePart> expectedParts = {
+            TExclusiveBundlePart(EFeatureType::Float, 0, TBoundsInBundle(0, 3)),
+            TExclusiveBundlePart(EFeatureType::Float, 1, TBoundsInBundle(3, 6)),
+            TExclusiveBundlePart(EFeatureType::Float, 2, TBoundsInBundle(6, 9))
+        };
+        UNIT_ASSERT_EQUAL(bundles[0].Parts, expectedParts);
+        UNIT_ASSERT_VALUES_EQUAL(bundles[0].SizeInBytes, 1);
+    }
+
+    Y_UNIT_TEST(TestMaxBuckets) {
+        TExclusiveFeaturesBundlingOptions options;
+        options.MaxBuckets = 8;
+        const auto bundles = CreateBundles(options);
+
+        // feature 2 does not fit into the bundle of features 0 and 1
+        UNIT_ASSERT_VALUES_EQUAL(bundles.size(), 1);
+        const TVector<TExclusiveBundlePart> expectedParts = {
+            TExclusiveBundlePart(EFeatureType::Float, 0, TBoundsInBundle(0, 3)),
+            TExclusiveBundlePart(EFeatureType::Float, 1, TBoundsInBundle(3, 6))
+        };
+        UNIT_ASSERT_EQUAL(bundles[0].Parts, expectedParts);
+    }
+
+    Y_UNIT_TEST(TestMaxConflictFraction) {
+        TExclusiveFeaturesBundlingOptions options;
+        options.MaxConflictFraction = 1.0f;
+        const auto bundles = CreateBundles(options);
+
+        // all features can be bundled when any conflicts are allowed
+        UNIT_ASSERT_VALUES_EQUAL(bundles.size(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(bundles[0].Parts.size(), 4);
+        UNIT_ASSERT_VALUES_EQUAL(bundles[0].GetUsedByPartsBinCount(), 12);
+    }
+}
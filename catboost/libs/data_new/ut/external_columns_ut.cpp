@@ -107,7 +107,8 @@ Y_UNIT_TEST_SUITE(ExternalColumns) {
                 mapMostFrequentValueTo0,
                 /*hashedCatDefaultValue*/ Nothing(),
                 /*quantizedDefaultBinFraction*/ Nothing(),
-                /*dstBins*/ Nothing()
+                /*dstBins*/ Nothing(),
+                &NPar::LocalExecutor()
             );
 
             TExternalCatValuesHolder externalCatValuesHolder(
@@ -0,0 +1,107 @@
+#include <catboost/libs/data_new/hashed_cat_values_map.h>
+
+#include <catboost/libs/helpers/checksum.h>
+
+#include <library/binsaver/util_stream_io.h>
+
+#include <util/generic/map.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/buffer.h>
+#include <util/ysaveload.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+static void AssertEqual(const TMap<ui32, TValueWithCount>& expected, const THashedCatValuesMap& map) {
+    UNIT_ASSERT_VALUES_EQUAL(expected.size(), map.size());
+    for (const auto& [key, value] : expected) {
+        const auto it = map.find(key);
+        UNIT_ASSERT(it != map.end());
+        UNIT_ASSERT_EQUAL(it->second, value);
+    }
+}
+
+static void GenerateRandomMaps(
+    ui32 size,
+    TMap<ui32, TValueWithCount>* expected,
+    THashedCatValuesMap* map
+) {
+    TFastRng32 rng(size, 0);
+    for (auto i : xrange(size)) {
+        // include keys that collide after masking and the max key
+        const ui32 key = (i % 3 == 0) ? (Max<ui32>() - i) : ((i % 3 == 1) ? (i << 16) : rng.GenRand());
+        const TValueWithCount value{i, rng.Uniform(100)};
+        if (expected->emplace(key, value).second) {
+            UNIT_ASSERT(map->emplace(key, value).second);
+        } else {
+            UNIT_ASSERT(!map->emplace(key, value).second);
+        }
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(THashedCatValuesMap) {
+    Y_UNIT_TEST(InsertFindErase) {
+        for (ui32 size : {0, 1, 7, 100, 10000}) {
+            TMap<ui32, TValueWithCount> expected;
+            THashedCatValuesMap map;
+            GenerateRandomMaps(size, &expected, &map);
+            AssertEqual(expected, map);
+
+            TVector<ui32> keysToErase;
+            for (const auto& [key, value] : expected) {
+                if (value.Value % 2) {
+                    keysToErase.push_back(key);
+                }
+            }
+            for (auto key : keysToErase) {
+                UNIT_ASSERT_VALUES_EQUAL(map.erase(key), 1);
+                UNIT_ASSERT_VALUES_EQUAL(map.erase(key), 0);
+                expected.erase(key);
+            }
+            AssertEqual(expected, map);
+        }
+    }
+
+    Y_UNIT_TEST(SaveLoadCompatibleWithMap) {
+        TMap<ui32, TValueWithCount> expected;
+        THashedCatValuesMap map;
+        GenerateRandomMaps(1000, &expected, &map);
+
+        {
+            TBufferStream stream;
+            ::Save(&stream, expected);
+            THashedCatValuesMap loadedMap;
+            ::Load(&stream, loadedMap);
+            AssertEqual(expected, loadedMap);
+            UNIT_ASSERT(loadedMap == map);
+        }
+        {
+            TBufferStream stream;
+            ::Save(&stream, map);
+            TMap<ui32, TValueWithCount> loadedMap;
+            ::Load(&stream, loadedMap);
+            UNIT_ASSERT(loadedMap == expected);
+        }
+        {
+            TBufferStream stream;
+            SerializeToStream(stream, expected);
+            THashedCatValuesMap loadedMap;
+            SerializeFromStream(stream, loadedMap);
+            AssertEqual(expected, loadedMap);
+        }
+        {
+            TBufferStream stream;
+            SerializeToStream(stream, map);
+            TMap<ui32, TValueWithCount> loadedMap;
+            SerializeFromStream(stream, loadedMap);
+            UNIT_ASSERT(loadedMap == expected);
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(UpdateCheckSum(0, expected), UpdateCheckSum(0, map));
+    }
+}
@@ -0,0 +1,281 @@
+#include "binary_output.h"
+
+#include "eval_helpers.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/xrange.h>
+#include <util/string/builder.h>
+#include <util/string/cast.h>
+#include <util/system/byteorder.h>
+
+#include <cstring>
+#include <functional>
+
+
+using namespace NCB;
+
+
+namespace {
+    struct TBinaryColumn {
+        TString Name;
+        EBinaryEvalColumnType Type;
+        std::function<void(IOutputStream*)> WriteValues;
+    };
+}
+
+
+template <class T>
+static void WriteLittleEndian(T value, IOutputStream* outputStream) {
+    value = HostToLittle(value);
+    outputStream->Write(&value, sizeof(value));
+}
+
+template <class T>
+static void WriteLittleEndianArray(TConstArrayRef<T> values, IOutputStream* outputStream) {
+#if defined(_little_endian_)
+    outputStream->Write(values.data(), values.size() * sizeof(T));
+#else
+    for (auto value : values) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        outputStream->Write(bytes, sizeof(T));
+    }
+#endif
+}
+
+template <class T>
+static T ReadLittleEndian(IInputStream* inputStream) {
+    T value;
+    const size_t bytesRead = inputStream->Load(&value, sizeof(value));
+    CB_ENSURE(bytesRead == sizeof(value), "Unexpected end of binary eval output");
+    return LittleToHost(value);
+}
+
+static TString ReadString(ui32 size, IInputStream* inputStream) {
+    auto value = TString::Uninitialized(size);
+    const size_t bytesRead = inputStream->Load(value.begin(), size);
+    CB_ENSURE(bytesRead == size, "Unexpected end of binary eval output");
+    return value;
+}
+
+template <class T>
+static void ReadLittleEndianArray(ui64 count, IInputStream* inputStream, TVector<T>* values) {
+    const size_t offset = values->size();
+    values->yresize(offset + count);
+    const size_t byteCount = count * sizeof(T);
+    const size_t bytesRead = inputStream->Load(values->data() + offset, byteCount);
+    CB_ENSURE(bytesRead == byteCount, "Unexpected end of binary eval output");
+#if !defined(_little_endian_)
+    for (auto i : xrange(offset, values->size())) {
+        (*values)[i] = LittleToHost((*values)[i]);
+    }
+#endif
+}
+
+template <class T>
+static TBinaryColumn MakeArrayColumn(const TString& name, EBinaryEvalColumnType type, TConstArrayRef<T> values) {
+    return TBinaryColumn{
+        name,
+        type,
+        [values] (IOutputStream* outputStream) {
+            WriteLittleEndianArray(values, outputStream);
+        }
+    };
+}
+
+static TBinaryColumn MakeStringColumn(const TString& name, TConstArrayRef<TString> values) {
+    return TBinaryColumn{
+        name,
+        EBinaryEvalColumnType::String,
+        [values] (IOutputStream* outputStream) {
+            for (const auto& value : values) {
+                WriteLittleEndian<ui32>(value.size(), outputStream);
+                outputStream->Write(value.data(), value.size());
+            }
+        }
+    };
+}
+
+template <class T>
+static TBinaryColumn MakeOwningArrayColumn(const TString& name, EBinaryEvalColumnType type, TVector<T>&& values) {
+    auto holder = MakeAtomicShared<TVector<T>>(std::move(values));
+    return TBinaryColumn{
+        name,
+        type,
+        [holder] (IOutputStream* outputStream) {
+            WriteLittleEndianArray(TConstArrayRef<T>(*holder), outputStream);
+        }
+    };
+}
+
+
+namespace NCB {
+
+    void OutputEvalResultToBinaryStream(
+        const TEvalResult& evalResult,
+        NPar::TLocalExecutor* executor,
+        const TVector<TString>& outputColumns,
+        const TExternalLabelsHelper& visibleLabelsHelper,
+        const TDataProvider& pool,
+        IOutputStream* outputStream,
+        bool writeHeader,
+        ui64 docIdOffset,
+        TMaybe<std::pair<size_t, size_t>> evalParameters) {
+
+        const ui32 objectCount = pool.ObjectsGrouping->GetObjectCount();
+        const TString baselinePrefix = "Baseline#";
+
+        TVector<TBinaryColumn> columns;
+
+        for (const auto& outputColumn : outputColumns) {
+            EPredictionType predictionType;
+            if (TryFromString<EPredictionType>(outputColumn, predictionType)) {
+                ui32 startTreeIndex = 0;
+                for (const auto& raws : evalResult.GetRawValuesConstRef()) {
+                    CB_ENSURE(visibleLabelsHelper.IsInitialized() == IsMulticlass(raws),
+                              "Inappropriate usage of visible label helper: it MUST be initialized ONLY for multiclass problem");
+                    const auto& approx = visibleLabelsHelper.IsInitialized() ? MakeExternalApprox(raws, visibleLabelsHelper) : raws;
+                    TVector<TVector<double>> prepared = PrepareEval(predictionType, approx, executor);
+                    const TVector<TString> headers = CreatePredictionTypeHeader(
+                        approx.size(),
+                        predictionType,
+                        visibleLabelsHelper,
+                        startTreeIndex,
+                        evalParameters.Get());
+                    Y_VERIFY(headers.size() == prepared.size());
+                    for (auto dim : xrange(prepared.size())) {
+                        columns.push_back(
+                            MakeOwningArrayColumn(headers[dim], EBinaryEvalColumnType::Float64, std::move(prepared[dim]))
+                        );
+                    }
+                    if (evalParameters) {
+                        startTreeIndex += evalParameters->first;
+                    }
+                }
+                continue;
+            }
+            EColumn outputType;
+            if (TryFromString<EColumn>(ToCanonicalColumnName(outputColumn), outputType)) {
+                if (outputType == EColumn::Label) {
+                    const auto& target = pool.RawTargetData.GetTarget();
+                    CB_ENSURE(target, "bad output column name " << outputColumn << " (No target/label info in pool)");
+                    columns.push_back(MakeStringColumn(outputColumn, *target));
+                    continue;
+                }
+                if (outputType == EColumn::SampleId) {
+                    TVector<ui64> docIds(objectCount);
+                    Iota(docIds.begin(), docIds.end(), docIdOffset);
+                    columns.push_back(MakeOwningArrayColumn(outputColumn, EBinaryEvalColumnType::UI64, std::move(docIds)));
+                    continue;
+                }
+                if (outputType == EColumn::Timestamp) {
+                    const auto& timestamp = pool.ObjectsData->GetTimestamp();
+                    CB_ENSURE(timestamp, "bad output column name " << outputColumn << " (No Timestamp info in pool)");
+                    columns.push_back(MakeArrayColumn(outputColumn, EBinaryEvalColumnType::UI64, *timestamp));
+                    continue;
+                }
+                if (outputType == EColumn::Weight) {
+                    const auto& weights = pool.RawTargetData.GetWeights();
+                    if (weights.IsTrivial()) {
+                        columns.push_back(
+                            MakeOwningArrayColumn(outputColumn, EBinaryEvalColumnType::Float32, TVector<float>(objectCount, 1.0f))
+                        );
+                    } else {
+                        columns.push_back(
+                            MakeArrayColumn(outputColumn, EBinaryEvalColumnType::Float32, weights.GetNonTrivialData())
+                        );
+                    }
+                    continue;
+                }
+                if (outputType == EColumn::Baseline) {
+                    const auto& maybeBaseline = pool.RawTargetData.GetBaseline();
+                    CB_ENSURE(maybeBaseline, "bad output column name " << outputColumn << " (No baseline info in pool)");
+                    const auto baseline = *maybeBaseline;
+                    for (auto idx : xrange(baseline.size())) {
+                        TStringBuilder header;
+                        header << "Baseline";
+                        if (baseline.size() > 1) {
+                            header << "#" << idx;
+                        }
+                        columns.push_back(MakeArrayColumn(header, EBinaryEvalColumnType::Float32, baseline[idx]));
+                    }
+                    continue;
+                }
+            }
+            if (!outputColumn.compare(0, baselinePrefix.length(), baselinePrefix)) {
+                const auto& baseline = pool.RawTargetData.GetBaseline();
+                CB_ENSURE(baseline, "bad output column name " << outputColumn << " (No baseline info in pool)");
+                const ui32 idx = FromString<ui32>(outputColumn.substr(baselinePrefix.length()));
+                CB_ENSURE(
+                    idx < baseline->size(),
+                    "bad output column name " << outputColumn << " (pool has " << baseline->size() << " baseline dimensions)"
+                );
+                columns.push_back(MakeArrayColumn(outputColumn, EBinaryEvalColumnType::Float32, (*baseline)[idx]));
+                continue;
+            }
+            CB_ENSURE(false, "Output column " << outputColumn << " is not supported in binary output");
+        }
+
+        if (writeHeader) {
+            outputStream->Write(BinaryEvalOutputMagic.data(), BinaryEvalOutputMagic.size());
+            WriteLittleEndian<ui32>(columns.size(), outputStream);
+            for (const auto& column : columns) {
+                WriteLittleEndian<ui8>(static_cast<ui8>(column.Type), outputStream);
+                WriteLittleEndian<ui32>(column.Name.size(), outputStream);
+                outputStream->Write(column.Name.data(), column.Name.size());
+            }
+        }
+        WriteLittleEndian<ui64>(objectCount, outputStream);
+        for (const auto& column : columns) {
+            column.WriteValues(outputStream);
+        }
+    }
+
+    TVector<TBinaryEvalColumn> ReadEvalResultFromBinaryStream(IInputStream* inputStream) {
+        auto magic = TString::Uninitialized(BinaryEvalOutputMagic.size());
+        const size_t magicSize = inputStream->Load(magic.begin(), magic.size());
+        CB_ENSURE(
+            TStringBuf(magic.data(), magicSize) == BinaryEvalOutputMagic,
+            "Stream does not contain binary eval output"
+        );
+
+        TVector<TBinaryEvalColumn> columns(ReadLittleEndian<ui32>(inputStream));
+        for (auto& column : columns) {
+            const ui8 type = ReadLittleEndian<ui8>(inputStream);
+            CB_ENSURE(type <= static_cast<ui8>(EBinaryEvalColumnType::String), "Unknown column type " << (ui32)type);
+            column.Type = static_cast<EBinaryEvalColumnType>(type);
+            column.Name = ReadString(ReadLittleEndian<ui32>(inputStream), inputStream);
+        }
+
+        ui64 rowCount;
+        while (inputStream->Load(&rowCount, sizeof(rowCount)) == sizeof(rowCount)) {
+            rowCount = LittleToHost(rowCount);
+            for (auto& column : columns) {
+                switch (column.Type) {
+                    case EBinaryEvalColumnType::Float32:
+                        ReadLittleEndianArray(rowCount, inputStream, &column.Float32Values);
+                        break;
+                    case EBinaryEvalColumnType::Float64:
+                        ReadLittleEndianArray(rowCount, inputStream, &column.Float64Values);
+                        break;
+                    case EBinaryEvalColumnType::UI64:
+                        ReadLittleEndianArray(rowCount, inputStream, &column.UI64Values);
+                        break;
+                    case EBinaryEvalColumnType::String:
+                        for (auto i : xrange(rowCount)) {
+                            Y_UNUSED(i);
+                            column.StringValues.push_back(ReadString(ReadLittleEndian<ui32>(inputStream), inputStream));
+                        }
+                        break;
+                }
+            }
+        }
+        return columns;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "eval_result.h"
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/labels/external_label_helper.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/fwd.h>
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/input.h>
+#include <util/stream/output.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+
+namespace NCB {
+
+    /* Binary columnar eval output, all values are little-endian:
+     *
+     *  header (written once, see writeHeader argument):
+     *      magic "CBEVALB1" (8 bytes)
+     *      ui32 columnCount
+     *      columnCount times:
+     *          ui8 column type (EBinaryEvalColumnType)
+     *          ui32 name size, name bytes
+     *  then any number of row blocks until the end of the stream (one per OutputEvalResultToBinaryStream call):
+     *      ui64 rowCount
+     *      columnCount times: rowCount values of the column type
+     *          (String values are ui32 size and bytes each)
+     *
+     * Column values are written directly from the buffers without formatting.
+     * Supported columns: prediction types (Float64, Class is written as class index), SampleId (UI64,
+     *  generated from docIdOffset), Timestamp (UI64), Weight and Baseline (Float32), Label (String).
+     */
+    enum class EBinaryEvalColumnType : ui8 {
+        Float32 = 0,
+        Float64 = 1,
+        UI64 = 2,
+        String = 3
+    };
+
+    constexpr TStringBuf BinaryEvalOutputMagic = AsStringBuf("CBEVALB1");
+
+    void OutputEvalResultToBinaryStream(
+        const TEvalResult& evalResult,
+        NPar::TLocalExecutor* executor,
+        const TVector<TString>& outputColumns,
+        const TExternalLabelsHelper& visibleLabelsHelper,
+        const TDataProvider& pool,
+        IOutputStream* outputStream,
+        bool writeHeader = true,
+        ui64 docIdOffset = 0,
+        TMaybe<std::pair<size_t, size_t>> evalParameters = Nothing());
+
+    struct TBinaryEvalColumn {
+        TString Name;
+        EBinaryEvalColumnType Type = EBinaryEvalColumnType::Float64;
+
+        // only values of Type are filled
+        TVector<float> Float32Values;
+        TVector<double> Float64Values;
+        TVector<ui64> UI64Values;
+        TVector<TString> StringValues;
+    };
+
+    // reads the header and all row blocks of the binary eval output
+    TVector<TBinaryEvalColumn> ReadEvalResultFromBinaryStream(IInputStream* inputStream);
+}
@@ -33,6 +33,10 @@ namespace NCB {
         virtual TString GetAfterColumnDelimiter() const {
             return "\t";
         }
+        // OutputValue can be called concurrently and for documents in any order
+        virtual bool SupportsParallelOutput() const {
+            return false;
+        }
         virtual ~IColumnPrinter() = default;
     };
 
@@ -66,6 +70,10 @@ namespace NCB {
             *outStream << Header;
         }
 
+        bool SupportsParallelOutput() const override {
+            return true;
+        }
+
     private:
         const NCB::TMaybeOwningConstArrayHolder<T> Array;
         const TString Header;
@@ -87,6 +95,10 @@ namespace NCB {
             *outStream << Header;
         }
 
+        bool SupportsParallelOutput() const override {
+            return true;
+        }
+
     private:
         const TWeights<float>& Weights;
         const TString Header;
@@ -116,6 +128,10 @@ namespace NCB {
             return Delimiter;
         }
 
+        bool SupportsParallelOutput() const override {
+            return true;
+        }
+
     private:
         const TString Prefix;
         const TString Header;
@@ -170,6 +186,10 @@ namespace NCB {
             *outStream << Header;
         }
 
+        bool SupportsParallelOutput() const override {
+            return true;
+        }
+
     private:
         const TMaybeOwningArrayHolder<ui32> HashedValues;
         const THashMap<ui32, TString>& HashToString;
@@ -189,6 +209,10 @@ namespace NCB {
         void OutputValue(IOutputStream* outStream, size_t docIndex) override;
         void OutputHeader(IOutputStream* outStream) override;
 
+        bool SupportsParallelOutput() const override {
+            return true;
+        }
+
     private:
         TVector<TString> Header;
         TVector<TVector<TVector<double>>> Approxes;
@@ -252,6 +276,10 @@ namespace NCB {
             }
         }
 
+        bool SupportsParallelOutput() const override {
+            return NeedToGenerate;
+        }
+
     private:
         TIntrusivePtr<IPoolColumnsPrinter> PrinterPtr;
         bool NeedToGenerate;
@@ -5,8 +5,11 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/logging/logging.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/hash_set.h>
+#include <util/generic/ymath.h>
 #include <util/stream/fwd.h>
+#include <util/stream/str.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 
@@ -44,6 +47,19 @@ static TFeatureIdToDesc GetFeatureIdToDesc(const TDataProvider& pool) {
     return res;
 }
 
+static void OutputRow(
+    const TVector<THolder<IColumnPrinter>>& columnPrinter,
+    ui32 docId,
+    IOutputStream* outputStream) {
+
+    TString delimiter = "";
+    for (auto& printer : columnPrinter) {
+        *outputStream << delimiter;
+        printer->OutputValue(outputStream, docId);
+        delimiter = printer->GetAfterColumnDelimiter();
+    }
+}
+
 namespace NCB {
 
     TVector<TVector<TVector<double>>>& TEvalResult::GetRawValuesRef() {
@@ -286,15 +302,48 @@ namespace NCB {
             }
             *outputStream << Endl;
         }
-        for (ui32 docId = 0; docId < pool.ObjectsGrouping->GetObjectCount(); ++docId) {
-            TString delimiter = "";
-            for (auto& printer : columnPrinter) {
-                *outputStream << delimiter;
-                printer->OutputValue(outputStream, docId);
-                delimiter = printer->GetAfterColumnDelimiter();
+
+        const ui32 docCount = pool.ObjectsGrouping->GetObjectCount();
+        const bool canOutputInParallel = AllOf(
+            columnPrinter,
+            [] (const THolder<IColumnPrinter>& printer) { return printer->SupportsParallelOutput(); }
+        );
+        if (!canOutputInParallel || !executor || (executor->GetThreadCount() == 0)) {
+            for (ui32 docId = 0; docId < docCount; ++docId) {
+                OutputRow(columnPrinter, docId, outputStream);
+                *outputStream << Endl;
+            }
+            return;
+        }
+
+        // text formatting dominates output time, so blocks of rows are formatted in parallel
+        //  and written in order, at most blockCount blocks are kept in memory
+        const ui32 blockSize = 10000;
+        const ui32 blockCount = executor->GetThreadCount() + 1;
+        TVector<TString> blockBuffers(blockCount);
+        for (ui32 roundBegin = 0; roundBegin < docCount; roundBegin += blockSize * blockCount) {
+            const ui32 roundBlockCount = Min<ui32>(blockCount, CeilDiv(docCount - roundBegin, blockSize));
+            executor->ExecRange(
+                [&] (int blockIdx) {
+                    TString& buffer = blockBuffers[blockIdx];
+                    buffer.clear();
+                    TStringOutput blockOutput(buffer);
+                    const ui32 blockBegin = roundBegin + blockIdx * blockSize;
+                    const ui32 blockEnd = Min(blockBegin + blockSize, docCount);
+                    for (ui32 docId = blockBegin; docId < blockEnd; ++docId) {
+                        OutputRow(columnPrinter, docId, &blockOutput);
+                        blockOutput << '\n';
+                    }
+                },
+                0,
+                roundBlockCount,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            for (ui32 blockIdx = 0; blockIdx < roundBlockCount; ++blockIdx) {
+                outputStream->Write(blockBuffers[blockIdx]);
             }
-            *outputStream << Endl;
         }
+        outputStream->Flush();
     }
 
     void OutputEvalResultToFile(
@@ -0,0 +1,172 @@
+#include <catboost/libs/eval_result/binary_output.h>
+
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/labels/external_label_helper.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+static TDataProviderPtr CreatePool(ui32 objectCount, bool hasTimestamp, ui32 baselineCount) {
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.HasWeights = true;
+            metaInfo.HasTimestamp = hasTimestamp;
+            metaInfo.BaselineCount = baselineCount;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(1, TVector<ui32>{}, TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+            TVector<float> feature(objectCount);
+            TVector<TString> target(objectCount);
+            TVector<float> weights(objectCount);
+            for (auto objectIdx : xrange(objectCount)) {
+                feature[objectIdx] = objectIdx;
+                target[objectIdx] = "label" + ToString(objectIdx % 3);
+                weights[objectIdx] = 0.5f + objectIdx;
+                if (hasTimestamp) {
+                    visitor->AddTimestamp(objectIdx, 1000 + objectIdx);
+                }
+            }
+            visitor->AddFloatFeature(0, TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(feature)));
+            visitor->AddTarget(target);
+            visitor->AddWeights(weights);
+            for (auto baselineIdx : xrange(baselineCount)) {
+                TVector<float> baseline(objectCount);
+                for (auto objectIdx : xrange(objectCount)) {
+                    baseline[objectIdx] = baselineIdx * 10.0f + objectIdx * 0.25f;
+                }
+                visitor->AddBaseline(baselineIdx, baseline);
+            }
+            visitor->Finish();
+        }
+    );
+}
+
+static TEvalResult CreateEvalResult(ui32 objectCount) {
+    TVector<TVector<double>> rawValues(1, TVector<double>(objectCount));
+    for (auto objectIdx : xrange(objectCount)) {
+        rawValues[0][objectIdx] = objectIdx * 0.125 - 1.0;
+    }
+    TEvalResult evalResult;
+    evalResult.SetRawValuesByMove(rawValues);
+    return evalResult;
+}
+
+
+Y_UNIT_TEST_SUITE(BinaryEvalOutput) {
+    Y_UNIT_TEST(TestRoundTrip) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+
+        const TVector<TString> outputColumns = {
+            "SampleId", "RawFormulaVal", "Label", "Weight", "Timestamp", "Baseline", "Baseline#1"
+        };
+        const TVector<ui32> blockSizes = {5, 3};
+
+        TBufferStream stream;
+        ui64 docIdOffset = 0;
+        for (auto blockIdx : xrange(blockSizes.size())) {
+            OutputEvalResultToBinaryStream(
+                CreateEvalResult(blockSizes[blockIdx]),
+                &localExecutor,
+                outputColumns,
+                TExternalLabelsHelper(),
+                *CreatePool(blockSizes[blockIdx], /*hasTimestamp*/ true, /*baselineCount*/ 2),
+                &stream,
+                /*writeHeader*/ blockIdx == 0,
+                docIdOffset
+            );
+            docIdOffset += blockSizes[blockIdx];
+        }
+
+        const auto columns = ReadEvalResultFromBinaryStream(&stream);
+
+        TVector<TString> names;
+        for (const auto& column : columns) {
+            names.push_back(column.Name);
+        }
+        const TVector<TString> expectedNames = {
+            "SampleId", "RawFormulaVal", "Label", "Weight", "Timestamp", "Baseline#0", "Baseline#1", "Baseline#1"
+        };
+        UNIT_ASSERT_VALUES_EQUAL(names, expectedNames);
+
+        UNIT_ASSERT_EQUAL(columns[0].Type, EBinaryEvalColumnType::UI64);
+        UNIT_ASSERT_EQUAL(columns[1].Type, EBinaryEvalColumnType::Float64);
+        UNIT_ASSERT_EQUAL(columns[2].Type, EBinaryEvalColumnType::String);
+        UNIT_ASSERT_EQUAL(columns[3].Type, EBinaryEvalColumnType::Float32);
+        UNIT_ASSERT_EQUAL(columns[4].Type, EBinaryEvalColumnType::UI64);
+        for (auto columnIdx : xrange(5, 8)) {
+            UNIT_ASSERT_EQUAL(columns[columnIdx].Type, EBinaryEvalColumnType::Float32);
+        }
+
+        ui64 sampleId = 0;
+        for (auto blockSize : blockSizes) {
+            for (auto objectIdx : xrange(blockSize)) {
+                UNIT_ASSERT_VALUES_EQUAL(columns[0].UI64Values[sampleId], sampleId);
+                UNIT_ASSERT_VALUES_EQUAL(columns[1].Float64Values[sampleId], objectIdx * 0.125 - 1.0);
+                UNIT_ASSERT_VALUES_EQUAL(columns[2].StringValues[sampleId], "label" + ToString(objectIdx % 3));
+                UNIT_ASSERT_VALUES_EQUAL(columns[3].Float32Values[sampleId], 0.5f + objectIdx);
+                UNIT_ASSERT_VALUES_EQUAL(columns[4].UI64Values[sampleId], 1000 + objectIdx);
+                UNIT_ASSERT_VALUES_EQUAL(columns[5].Float32Values[sampleId], objectIdx * 0.25f);
+                UNIT_ASSERT_VALUES_EQUAL(columns[6].Float32Values[sampleId], 10.0f + objectIdx * 0.25f);
+                UNIT_ASSERT_VALUES_EQUAL(columns[7].Float32Values[sampleId], 10.0f + objectIdx * 0.25f);
+                ++sampleId;
+            }
+        }
+        for (const auto& column : columns) {
+            const size_t valueCount = column.Float32Values.size() + column.Float64Values.size()
+                + column.UI64Values.size() + column.StringValues.size();
+            UNIT_ASSERT_VALUES_EQUAL(valueCount, sampleId);
+        }
+    }
+
+    Y_UNIT_TEST(TestAbsentColumns) {
+        NPar::TLocalExecutor localExecutor;
+        const auto pool = CreatePool(4, /*hasTimestamp*/ false, /*baselineCount*/ 1);
+
+        for (const TString column : {"Timestamp", "Baseline#1", "GroupId"}) {
+            TBufferStream stream;
+            UNIT_ASSERT_EXCEPTION(
+                OutputEvalResultToBinaryStream(
+                    CreateEvalResult(4),
+                    &localExecutor,
+                    {"RawFormulaVal", column},
+                    TExternalLabelsHelper(),
+                    *pool,
+                    &stream
+                ),
+                TCatBoostException
+            );
+        }
+
+        const auto poolWithoutBaseline = CreatePool(4, /*hasTimestamp*/ false, /*baselineCount*/ 0);
+        TBufferStream stream;
+        UNIT_ASSERT_EXCEPTION(
+            OutputEvalResultToBinaryStream(
+                CreateEvalResult(4),
+                &localExecutor,
+                {"Baseline"},
+                TExternalLabelsHelper(),
+                *poolWithoutBaseline,
+                &stream
+            ),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(TestNotBinaryEvalOutput) {
+        TBufferStream stream;
+        stream << "SampleId\tRawFormulaVal\n";
+        UNIT_ASSERT_EXCEPTION(ReadEvalResultFromBinaryStream(&stream), TCatBoostException);
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "exception.h"
+#include "numa.h"
 
 #include <catboost/libs/index_range/index_range.h>
 
@@ -15,6 +16,12 @@ namespace NCB {
     /**
      * Processes data in parallel by blocks then merges results
      *  if there is only one block then there's no merge
+     *  blocks are scheduled with work stealing, so blocks of different cost are balanced
+     *  and nested MapMerge calls (e.g. from parallel candidates) share threads
+     *  block outputs are merged in block order, so results don't depend on blocks scheduling
+     *  if mapFunc writes only to its block output and to data of its index range
+     *  if there is NUMA placement for localExecutor blocks are sharded between nodes and outputs
+     *  are merged on each node first, then across nodes
      *
      * indexRange determine source data ranges for mapFunc input
      *   (mapFunc knows itself how source data is indexed)
@@ -40,20 +47,57 @@ namespace NCB {
             mapFunc(indexRangesGenerator.GetRange(0), output);
         } else {
             TVector<TOutput> mapOutputs(blockCount - 1); // w/o first, first is reused from 'output' param
+            const auto getBlockOutput = [&] (int blockId) {
+                return (blockId == 0) ? output : &(mapOutputs[blockId - 1]);
+            };
+            const auto mapBlock = [&](int blockId) {
+                mapFunc(indexRangesGenerator.GetRange(blockId), getBlockOutput(blockId));
+            };
 
-            localExecutor->ExecRange(
-                [&](int blockId) {
-                    mapFunc(
-                        indexRangesGenerator.GetRange(blockId),
-                        (blockId == 0) ? output : &(mapOutputs[blockId - 1])
-                    );
+            const auto* numaPlacement = GetNumaPlacement(localExecutor);
+            if (!numaPlacement || (numaPlacement->GetNodeCount() == 1)) {
+                localExecutor->ExecRangeWithWorkStealing(
+                    mapBlock,
+                    0,
+                    blockCount,
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+                mergeFunc(output, std::move(mapOutputs));
+                return;
+            }
+
+            numaPlacement->ExecBlocks(mapBlock, blockCount);
+
+            // node-local merge into the first block output of each node
+            const int nodeCount = numaPlacement->GetNodeCount();
+            TVector<int> nodeBlocksBegin(nodeCount + 1);
+            for (int node = 0; node <= nodeCount; ++node) {
+                nodeBlocksBegin[node] = CeilDiv<i64>((i64)node * blockCount, nodeCount);
+            }
+            numaPlacement->ExecBlocks(
+                [&](int node) {
+                    const int begin = nodeBlocksBegin[node];
+                    const int end = nodeBlocksBegin[node + 1];
+                    if (end - begin < 2) {
+                        return;
+                    }
+                    TVector<TOutput> nodeOutputs;
+                    nodeOutputs.reserve(end - begin - 1);
+                    for (int blockId = begin + 1; blockId < end; ++blockId) {
+                        nodeOutputs.push_back(std::move(*getBlockOutput(blockId)));
+                    }
+                    mergeFunc(getBlockOutput(begin), std::move(nodeOutputs));
                 },
-                0,
-                blockCount,
-                NPar::TLocalExecutor::WAIT_COMPLETE
+                nodeCount
             );
 
-            mergeFunc(output, std::move(mapOutputs));
+            TVector<TOutput> nodesOutputs;
+            for (int node = 1; node < nodeCount; ++node) {
+                if (nodeBlocksBegin[node] < nodeBlocksBegin[node + 1]) {
+                    nodesOutputs.push_back(std::move(*getBlockOutput(nodeBlocksBegin[node])));
+                }
+            }
+            mergeFunc(output, std::move(nodesOutputs));
         }
     }
 
@@ -0,0 +1,230 @@
+#include "numa.h"
+
+#include "exception.h"
+
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/string/strip.h>
+#include <util/system/atomic.h>
+#include <util/system/fs.h>
+#include <util/system/platform.h>
+#include <util/system/yield.h>
+#include <util/stream/file.h>
+
+#include <atomic>
+
+#if defined(_linux_)
+#include <sched.h>
+#endif
+
+
+namespace NCB {
+
+    static std::atomic<const TNumaPlacement*> RegisteredNumaPlacement{nullptr};
+
+
+#if defined(_linux_)
+    // cpulist format is like "0-63,128-191"
+    static TVector<int> ParseCpuList(TStringBuf cpuList) {
+        TVector<int> cpus;
+        while (!cpuList.empty()) {
+            const TStringBuf interval = cpuList.NextTok(',');
+            if (interval.empty()) {
+                continue;
+            }
+            TStringBuf first;
+            TStringBuf last;
+            if (interval.TrySplit('-', first, last)) {
+                for (auto cpu : xrange(FromString<int>(first), FromString<int>(last) + 1)) {
+                    cpus.push_back(cpu);
+                }
+            } else {
+                cpus.push_back(FromString<int>(interval));
+            }
+        }
+        return cpus;
+    }
+
+    TVector<TVector<int>> GetNumaNodesCpus() {
+        TVector<TVector<int>> nodesCpus;
+        for (int node = 0; ; ++node) {
+            const TString cpuListPath = "/sys/devices/system/node/node" + ToString(node) + "/cpulist";
+            if (!NFs::Exists(cpuListPath)) {
+                break;
+            }
+            TVector<int> cpus = ParseCpuList(StripString(TFileInput(cpuListPath).ReadAll()));
+            if (!cpus.empty()) { // memory-only nodes have no cpus
+                nodesCpus.push_back(std::move(cpus));
+            }
+        }
+        if (nodesCpus.empty()) {
+            nodesCpus.emplace_back();
+        }
+        return nodesCpus;
+    }
+
+    static TVector<int> GetCurrentThreadCpus() {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        TVector<int> cpus;
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+            for (auto cpu : xrange(CPU_SETSIZE)) {
+                if (CPU_ISSET(cpu, &cpuSet)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        return cpus;
+    }
+
+    static void PinCurrentThreadToCpus(const TVector<int>& cpus) {
+        if (cpus.empty()) {
+            return;
+        }
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (auto cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            CATBOOST_WARNING_LOG << "Failed to set thread affinity for NUMA placement" << Endl;
+        }
+    }
+#else
+    TVector<TVector<int>> GetNumaNodesCpus() {
+        return TVector<TVector<int>>(1);
+    }
+
+    static TVector<int> GetCurrentThreadCpus() {
+        return {};
+    }
+
+    static void PinCurrentThreadToCpus(const TVector<int>& /*cpus*/) {
+    }
+#endif
+
+
+    TNumaPlacement::TNumaPlacement(NPar::TLocalExecutor* localExecutor)
+        : TNumaPlacement(localExecutor, GetNumaNodesCpus())
+    {}
+
+    TNumaPlacement::TNumaPlacement(NPar::TLocalExecutor* localExecutor, const TVector<TVector<int>>& nodesCpus)
+        : LocalExecutor(localExecutor)
+        , NodeCount(nodesCpus.ysize())
+        , ThreadCount(localExecutor->GetThreadCount())
+    {
+        CB_ENSURE(NodeCount > 0, "NUMA placement needs at least one node");
+
+        // register before pinning, so that a rejected placement does not change threads affinity
+        const TNumaPlacement* expected = nullptr;
+        CB_ENSURE(
+            RegisteredNumaPlacement.compare_exchange_strong(expected, this),
+            "Only one NUMA placement can exist at a time"
+        );
+
+        if (NodeCount > 1) {
+            OriginalCpus = GetCurrentThreadCpus();
+            ExecInEachThread(
+                [&] () {
+                    PinCurrentThreadToCpus(nodesCpus[GetCurrentNode()]);
+                }
+            );
+            ThreadsArePinned = true;
+        }
+    }
+
+    TNumaPlacement::~TNumaPlacement() {
+        if (ThreadsArePinned) {
+            ExecInEachThread(
+                [this] () {
+                    PinCurrentThreadToCpus(OriginalCpus);
+                }
+            );
+        }
+        RegisteredNumaPlacement.store(nullptr);
+    }
+
+    int TNumaPlacement::GetCurrentNode() const {
+        // worker ids are [0, ThreadCount], 0 is the thread that calls ExecRange
+        return (int)((i64)LocalExecutor->GetWorkerThreadId() * NodeCount / (ThreadCount + 1));
+    }
+
+    void TNumaPlacement::ExecInEachThread(const std::function<void()>& f) const {
+        f();
+
+        // each task waits for all others, so every worker thread gets exactly one of them
+        TAtomic startedCount = 0;
+        TAtomic finishedCount = 0;
+        for (auto i : xrange(ThreadCount)) {
+            LocalExecutor->Exec(
+                [&] (int) {
+                    f();
+                    AtomicIncrement(startedCount);
+                    while (AtomicGet(startedCount) < ThreadCount) {
+                        ThreadYield();
+                    }
+                    AtomicIncrement(finishedCount);
+                },
+                i,
+                NPar::TLocalExecutor::HIGH_PRIORITY
+            );
+        }
+        while (AtomicGet(finishedCount) < ThreadCount) {
+            ThreadYield();
+        }
+    }
+
+    void TNumaPlacement::ExecBlocks(const NPar::TLocallyExecutableFunction& body, int blockCount) const {
+        if (blockCount == 0) {
+            return;
+        }
+        // blocks [CeilDiv(node * blockCount, NodeCount), CeilDiv((node + 1) * blockCount, NodeCount))
+        //  are owned by node, see GetBlockNode
+        TVector<TAtomic> nextBlock(NodeCount);
+        TVector<int> endBlock(NodeCount);
+        for (auto node : xrange(NodeCount)) {
+            nextBlock[node] = CeilDiv<i64>((i64)node * blockCount, NodeCount);
+            endBlock[node] = CeilDiv<i64>((i64)(node + 1) * blockCount, NodeCount);
+        }
+        LocalExecutor->ExecRange(
+            [&] (int) {
+                const int ownNode = GetCurrentNode();
+                for (auto shift : xrange(NodeCount)) {
+                    const int node = (ownNode + shift) % NodeCount;
+                    for (;;) {
+                        const int blockIdx = AtomicIncrement(nextBlock[node]) - 1;
+                        if (blockIdx >= endBlock[node]) {
+                            break;
+                        }
+                        body(blockIdx);
+                    }
+                }
+            },
+            0,
+            Min(ThreadCount + 1, blockCount),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+    const TNumaPlacement* GetNumaPlacement(const NPar::TLocalExecutor* localExecutor) {
+        const TNumaPlacement* placement = RegisteredNumaPlacement.load();
+        return (placement && (placement->GetLocalExecutor() == localExecutor)) ? placement : nullptr;
+    }
+
+    void ExecDocBlocks(
+        NPar::TLocalExecutor* localExecutor,
+        const NPar::TLocallyExecutableFunction& body,
+        int blockCount
+    ) {
+        if (const auto* numaPlacement = GetNumaPlacement(localExecutor)) {
+            numaPlacement->ExecBlocks(body, blockCount);
+        } else {
+            localExecutor->ExecRange(body, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/noncopyable.h>
+#include <util/generic/vector.h>
+
+#include <functional>
+
+
+namespace NCB {
+
+    // [node][cpuIdx], single node with no cpus if NUMA topology is not available
+    TVector<TVector<int>> GetNumaNodesCpus();
+
+
+    /* Places threads of localExecutor on NUMA nodes and shards blocks of data between nodes:
+     *  worker threads are pinned to nodes in contiguous groups of worker ids (the thread that calls
+     *  ExecRange has worker id 0 and is pinned to node 0 as well),
+     *  blocks of a range are owned by nodes in contiguous groups as well, so when arrays are written
+     *  (first touched) and then read by ExecBlocks with the same block partition their pages stay
+     *  local to the threads that process them.
+     *
+     * While the object exists it is registered for localExecutor (see GetNumaPlacement), only one
+     *  placement can exist at a time. Threads affinity is restored on destruction.
+     * localExecutor must have no running tasks when TNumaPlacement is created or destroyed.
+     */
+    class TNumaPlacement : public TNonCopyable {
+    public:
+        explicit TNumaPlacement(NPar::TLocalExecutor* localExecutor);
+
+        // nodesCpus is [node][cpuIdx] as returned by GetNumaNodesCpus, nodes with no cpus are not pinned
+        TNumaPlacement(NPar::TLocalExecutor* localExecutor, const TVector<TVector<int>>& nodesCpus);
+
+        ~TNumaPlacement();
+
+        int GetNodeCount() const {
+            return NodeCount;
+        }
+
+        // node of the calling thread
+        int GetCurrentNode() const;
+
+        int GetBlockNode(int blockIdx, int blockCount) const {
+            return (int)((i64)blockIdx * NodeCount / blockCount);
+        }
+
+        /* Executes body for blocks [0, blockCount) and waits for completion. Threads process
+         *  blocks of their own node first, then take the remaining blocks of other nodes.
+         */
+        void ExecBlocks(const NPar::TLocallyExecutableFunction& body, int blockCount) const;
+
+        NPar::TLocalExecutor* GetLocalExecutor() const {
+            return LocalExecutor;
+        }
+
+    private:
+        // calls f once in each thread of LocalExecutor and in the calling thread
+        void ExecInEachThread(const std::function<void()>& f) const;
+
+    private:
+        NPar::TLocalExecutor* LocalExecutor;
+        int NodeCount;
+        int ThreadCount;
+
+        bool ThreadsArePinned = false;
+        TVector<int> OriginalCpus; // affinity of the creating thread, empty if it is not available
+    };
+
+    // placement of localExecutor threads if it is registered, nullptr otherwise
+    const TNumaPlacement* GetNumaPlacement(const NPar::TLocalExecutor* localExecutor);
+
+    /* Executes body for blocks [0, blockCount) with localExecutor and waits for completion,
+     *  blocks are sharded between nodes if there's NUMA placement for localExecutor
+     */
+    void ExecDocBlocks(
+        NPar::TLocalExecutor* localExecutor,
+        const NPar::TLocallyExecutableFunction& body,
+        int blockCount
+    );
+}
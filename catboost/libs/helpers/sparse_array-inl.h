@@ -648,6 +648,22 @@ namespace NCB {
         );
     }
 
+    template <class TValue, class TContainer, class TSize>
+    template <class F>
+    inline void TSparseArrayBase<TValue, TContainer, TSize>::ForEachNonDefaultInRange(
+        TSize begin,
+        TSize end,
+        F&& f) const {
+
+        auto iterator = GetIterator(begin);
+        while (auto next = iterator.Next()) {
+            if (next->first >= end) {
+                break;
+            }
+            f(next->first, next->second);
+        }
+    }
+
     template <class TValue, class TContainer, class TSize>
     template <class F>
     inline void TSparseArrayBase<TValue, TContainer, TSize>::ForEach(F&& f) const {
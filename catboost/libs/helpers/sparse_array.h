@@ -440,6 +440,13 @@ namespace NCB {
         template <class F>
         inline void ForEachNonDefault(F&& f) const;
 
+        /* f is a visitor function that will be repeatedly called with (index, value) arguments
+         * for non-default values with indices in [begin, end)
+         * useful for parallel processing of non-overlapping ranges
+         */
+        template <class F>
+        inline void ForEachNonDefaultInRange(TSize begin, TSize end, F&& f) const;
+
         // f is a visitor function that will be repeatedly called with (index, value) arguments
         template <class F>
         inline void ForEach(F&& f) const;
@@ -2,9 +2,13 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
 
 #include <library/unittest/registar.h>
 
+#include <cmath>
+
 
 Y_UNIT_TEST_SUITE(TMapMergeTest) {
     Y_UNIT_TEST(TestSumSingleThread) {
@@ -96,4 +100,76 @@ Y_UNIT_TEST_SUITE(TMapMergeTest) {
             UNIT_ASSERT_EQUAL(maxLen, 6); // maxLen = 6 ("google")
         }
     }
+
+    // floating point sums of blocks of different cost with values of different magnitude
+    static double MapMergeSum(
+        const TVector<double>& values,
+        int blockSize,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        double result = 0.0;
+        NCB::MapMerge(
+            localExecutor,
+            NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(values.ysize()), blockSize),
+            [&values](NCB::TIndexRange<int> range, double* sum) {
+                *sum = 0.0;
+                // skewed cost, so that blocks are stolen
+                const int repeatCount = 1 + (range.Begin / 7) % 13;
+                for (auto repeat : xrange(repeatCount)) {
+                    double blockSum = 0.0;
+                    for (int i : range.Iter()) {
+                        blockSum += values[i];
+                    }
+                    *sum = (repeat == 0) ? blockSum : Min(*sum, blockSum);
+                }
+            },
+            [](double* sum, TVector<double>&& mapOutputs) {
+                for (auto blockSum : mapOutputs) {
+                    *sum += blockSum;
+                }
+            },
+            &result
+        );
+        return result;
+    }
+
+    // block outputs are merged in block order, so results don't depend on blocks scheduling
+    Y_UNIT_TEST(TestDeterministicMerge) {
+        TFastRng64 rng(0);
+        TVector<double> values(100000);
+        for (auto& value : values) {
+            value = (rng.GenRandReal1() - 0.5) * pow(10.0, rng.Uniform(12));
+        }
+        const int blockSize = 97;
+
+        double expected = 0.0;
+        for (int blockBegin = 0; blockBegin < values.ysize(); blockBegin += blockSize) {
+            double blockSum = 0.0;
+            for (int i : xrange(blockBegin, Min(blockBegin + blockSize, values.ysize()))) {
+                blockSum += values[i];
+            }
+            expected += blockSum;
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(7);
+        for (auto attempt : xrange(20)) {
+            Y_UNUSED(attempt);
+            UNIT_ASSERT_EQUAL(MapMergeSum(values, blockSize, &localExecutor), expected);
+        }
+
+        // nested in parallel tasks as in scoring of candidates
+        TVector<double> nestedResults(16);
+        localExecutor.ExecRangeWithWorkStealing(
+            [&](int taskIdx) {
+                nestedResults[taskIdx] = MapMergeSum(values, blockSize, &localExecutor);
+            },
+            0,
+            nestedResults.ysize(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        for (auto nestedResult : nestedResults) {
+            UNIT_ASSERT_EQUAL(nestedResult, expected);
+        }
+    }
 }
@@ -0,0 +1,129 @@
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/map_merge.h>
+#include <catboost/libs/helpers/numa.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/atomic.h>
+#include <util/system/yield.h>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TNumaPlacementTest) {
+    Y_UNIT_TEST(TestNodesCpus) {
+        const auto nodesCpus = NCB::GetNumaNodesCpus();
+        UNIT_ASSERT(!nodesCpus.empty());
+        for (const auto& cpus : nodesCpus) {
+            UNIT_ASSERT(IsSorted(cpus.begin(), cpus.end()));
+        }
+    }
+
+    Y_UNIT_TEST(TestExecBlocks) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(7);
+        NCB::TNumaPlacement numaPlacement(&localExecutor);
+        UNIT_ASSERT_EQUAL(NCB::GetNumaPlacement(&localExecutor), &numaPlacement);
+
+        for (int blockCount : {0, 1, 3, 100}) {
+            TVector<TAtomic> executed(blockCount, 0);
+            numaPlacement.ExecBlocks(
+                [&](int blockIdx) {
+                    AtomicIncrement(executed[blockIdx]);
+                },
+                blockCount
+            );
+            for (auto blockIdx : xrange(blockCount)) {
+                UNIT_ASSERT_VALUES_EQUAL(AtomicGet(executed[blockIdx]), 1);
+                const int node = numaPlacement.GetBlockNode(blockIdx, blockCount);
+                UNIT_ASSERT(node >= 0 && node < numaPlacement.GetNodeCount());
+                if (blockIdx > 0) {
+                    UNIT_ASSERT(node >= numaPlacement.GetBlockNode(blockIdx - 1, blockCount));
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestSeveralNodes) {
+        // nodes with no cpus are not pinned, so node indexing can be checked on any host
+        for (int nodeCount : {2, 3, 8}) {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(7);
+            NCB::TNumaPlacement numaPlacement(&localExecutor, TVector<TVector<int>>(nodeCount));
+            UNIT_ASSERT_VALUES_EQUAL(numaPlacement.GetNodeCount(), nodeCount);
+
+            UNIT_ASSERT_VALUES_EQUAL(numaPlacement.GetCurrentNode(), 0);
+
+            // each task waits for all others, so every thread including the calling one gets exactly one of them
+            const int threadCount = localExecutor.GetThreadCount() + 1;
+            TVector<TAtomic> threadNodes(threadCount, -1);
+            TAtomic startedCount = 0;
+            localExecutor.ExecRange(
+                [&] (int) {
+                    AtomicSet(threadNodes[localExecutor.GetWorkerThreadId()], numaPlacement.GetCurrentNode());
+                    AtomicIncrement(startedCount);
+                    while (AtomicGet(startedCount) < threadCount) {
+                        ThreadYield();
+                    }
+                },
+                0,
+                threadCount,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            // worker threads are grouped by node in order of their ids and all nodes are used
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(threadNodes.front()), 0);
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(threadNodes.back()), nodeCount - 1);
+            for (auto workerId : xrange(1, threadCount)) {
+                UNIT_ASSERT(AtomicGet(threadNodes[workerId]) >= AtomicGet(threadNodes[workerId - 1]));
+                UNIT_ASSERT(AtomicGet(threadNodes[workerId]) < nodeCount);
+            }
+
+            const int blockCount = 100;
+            TVector<TAtomic> executed(blockCount, 0);
+            numaPlacement.ExecBlocks(
+                [&](int blockIdx) {
+                    AtomicIncrement(executed[blockIdx]);
+                },
+                blockCount
+            );
+            for (auto blockIdx : xrange(blockCount)) {
+                UNIT_ASSERT_VALUES_EQUAL(AtomicGet(executed[blockIdx]), 1);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestOnlyOnePlacement) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        NCB::TNumaPlacement numaPlacement(&localExecutor, TVector<TVector<int>>(2));
+        UNIT_ASSERT_EXCEPTION(
+            NCB::TNumaPlacement(&localExecutor, TVector<TVector<int>>(2)),
+            TCatBoostException
+        );
+        UNIT_ASSERT_EQUAL(NCB::GetNumaPlacement(&localExecutor), &numaPlacement);
+    }
+
+    Y_UNIT_TEST(TestMapMergeWithPlacement) {
+        TVector<int> v(1000);
+        Iota(v.begin(), v.end(), 0);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(5);
+        NCB::TNumaPlacement numaPlacement(&localExecutor);
+
+        int res = 0;
+        NCB::MapMerge(
+            &localExecutor,
+            NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>((int)v.size()), 7),
+            [&v](NCB::TIndexRange<int> range, int* res) {
+                *res = Accumulate(v.begin() + range.Begin, v.begin() + range.End, 0);
+            },
+            [](int* res, TVector<int>&& mapOutputs) {
+                *res += Accumulate(mapOutputs.begin(), mapOutputs.end(), 0);
+            },
+            &res
+        );
+        UNIT_ASSERT_VALUES_EQUAL(res, 999 * 1000 / 2);
+    }
+}
@@ -590,6 +590,29 @@ Y_UNIT_TEST_SUITE(SparseArray) {
             UNIT_ASSERT_VALUES_EQUAL(i, nonDefaultValues.GetSize());
         }
 
+        {
+            for (auto begin : xrange(expectedArray.size() + 1)) {
+                for (auto end : xrange(begin, expectedArray.size() + 1)) {
+                    TVector<ui32> nonDefaultIndices;
+                    sparseArray.ForEachNonDefaultInRange(
+                        begin,
+                        end,
+                        [&] (ui32 nonDefaultIdx, TValue v) {
+                            UNIT_ASSERT_VALUES_EQUAL(v, expectedArray[nonDefaultIdx]);
+                            nonDefaultIndices.push_back(nonDefaultIdx);
+                        });
+
+                    TVector<ui32> expectedNonDefaultIndices;
+                    for (auto nonDefaultIdx : expectedNonDefaultIndicesArray) {
+                        if ((nonDefaultIdx >= begin) && (nonDefaultIdx < end)) {
+                            expectedNonDefaultIndices.push_back(nonDefaultIdx);
+                        }
+                    }
+                    UNIT_ASSERT_VALUES_EQUAL(nonDefaultIndices, expectedNonDefaultIndices);
+                }
+            }
+        }
+
         {
             ui32 expectedI = 0;
             sparseArray.ForEach(
@@ -10,25 +10,20 @@
 
 // TODO(vitekmel): styleguide
 
-void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& proj, TVector<double>* res) {
-    size_t nSize = proj.size();
-    Y_ASSERT(matrix.GetXSize() == nSize && matrix.GetYSize() == nSize);
-    res->resize(nSize);
-
-    TArray2D<double> left(matrix);
-    TArray2D<double> right(nSize, nSize);
+// left and right are row-major nSize x nSize matrices, left is destroyed, right receives the inverse
+static void SolveLinearSystemImpl(size_t nSize, double* left, double* right, const double* proj, double* res) {
     for (size_t y = 0; y < nSize; ++y) {
         for (size_t x = 0; x < nSize; ++x) {
-            right[y][x] = x == y;
+            right[y * nSize + x] = x == y;
         }
     }
 
     const double about0 = 1e-5f;
     for (size_t y = 0; y < nSize; ++y) {
-        double fDiag = left[y][y], fMax = Abs(fDiag);
+        double fDiag = left[y * nSize + y], fMax = Abs(fDiag);
         size_t nBestRow = y;
         for (size_t k = y + 1; k < nSize; ++k) {
-            double fTest = Abs(left[k][y]);
+            double fTest = Abs(left[k * nSize + y]);
             if (fTest > 2 * fMax) {
                 fMax = fTest;
                 nBestRow = k;
@@ -38,22 +33,22 @@ void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& pr
         if (nBestRow != y) {
             double f = fMax * fDiag > 0 ? 1 : -1;
             for (size_t x = 0; x < nSize; ++x) {
-                left[y][x] += f * left[nBestRow][x];
-                right[y][x] += f * right[nBestRow][x];
+                left[y * nSize + x] += f * left[nBestRow * nSize + x];
+                right[y * nSize + x] += f * right[nBestRow * nSize + x];
             }
         }
 
-        fDiag = left[y][y];
+        fDiag = left[y * nSize + y];
         if (Abs(fDiag) < about0) {
             ptrdiff_t h = y;
             while ((h < (ptrdiff_t)nSize - 1) && (Abs(fDiag) < about0)) {
                 h++;
-                if (Abs(left[h][y]) > about0) {
+                if (Abs(left[h * nSize + y]) > about0) {
                     for (size_t u = 0; u < nSize; u++) {
-                        left[y][u] += left[h][u];
-                        right[y][u] += right[h][u];
+                        left[y * nSize + u] += left[h * nSize + u];
+                        right[y * nSize + u] += right[h * nSize + u];
                     }
-                    fDiag = left[y][y];
+                    fDiag = left[y * nSize + y];
                 }
             }
             if (Abs(fDiag) < 1e-8) {
@@ -63,15 +58,15 @@ void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& pr
 
         double fDiag1 = 1 / fDiag;
         for (size_t x = 0; x < nSize; ++x) {
-            left[y][x] *= fDiag1;
-            right[y][x] *= fDiag1;
+            left[y * nSize + x] *= fDiag1;
+            right[y * nSize + x] *= fDiag1;
         }
 
         size_t leftOffset = 0, rightOffset = nSize;
-        while (leftOffset < nSize && left[y][leftOffset] == 0) {
+        while (leftOffset < nSize && left[y * nSize + leftOffset] == 0) {
             ++leftOffset;
         }
-        while (rightOffset > 0 && right[y][rightOffset - 1] == 0) {
+        while (rightOffset > 0 && right[y * nSize + rightOffset - 1] == 0) {
             --rightOffset;
         }
 
@@ -79,24 +74,24 @@ void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& pr
             if (k == y) {
                 continue;
             }
-            double fK = left[k][y];
+            double fK = left[k * nSize + y];
             if (fK == 0) {
                 continue;
             }
 
             {
-                double* leftPtr = &left[k][0] + leftOffset;
-                const double* leftSub = &left[y][0] + leftOffset;
-                double* finPtr = &left[k][0] + nSize;
+                double* leftPtr = left + k * nSize + leftOffset;
+                const double* leftSub = left + y * nSize + leftOffset;
+                double* finPtr = left + k * nSize + nSize;
                 while (leftPtr < finPtr) {
                     *leftPtr++ -= *leftSub++ * fK;
                 }
             }
 
             {
-                double* rightPtr = &right[k][0];
-                const double* rightSub = &right[y][0];
-                double* finPtr = &right[k][0] + rightOffset;
+                double* rightPtr = right + k * nSize;
+                const double* rightSub = right + y * nSize;
+                double* finPtr = right + k * nSize + rightOffset;
                 while (rightPtr < finPtr) {
                     *rightPtr++ -= *rightSub++ * fK;
                 }
@@ -107,10 +102,37 @@ void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& pr
     for (size_t y = 0; y < nSize; ++y) {
         double fRes = 0;
         for (size_t x = 0; x < nSize; ++x) {
-            fRes += right[y][x] * proj[x];
+            fRes += right[y * nSize + x] * proj[x];
+        }
+        res[y] = fRes;
+    }
+}
+
+void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& proj, TVector<double>* res) {
+    size_t nSize = proj.size();
+    Y_ASSERT(matrix.GetXSize() == nSize && matrix.GetYSize() == nSize);
+    res->resize(nSize);
+
+    TVector<double> left(nSize * nSize);
+    for (size_t y = 0; y < nSize; ++y) {
+        for (size_t x = 0; x < nSize; ++x) {
+            left[y * nSize + x] = matrix[y][x];
         }
-        (*res)[y] = fRes;
     }
+    TVector<double> right(nSize * nSize);
+    SolveLinearSystemImpl(nSize, left.data(), right.data(), proj.data(), res->data());
+}
+
+void SolveLinearSystem(
+    size_t size,
+    TArrayRef<double> matrix,
+    TArrayRef<double> inverse,
+    TConstArrayRef<double> proj,
+    TArrayRef<double> res
+) {
+    Y_ASSERT(matrix.size() >= size * size && inverse.size() >= size * size);
+    Y_ASSERT(proj.size() >= size && res.size() >= size);
+    SolveLinearSystemImpl(size, matrix.data(), inverse.data(), proj.data(), res.data());
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 
 template <typename T>
@@ -7,4 +8,13 @@ class TArray2D;
 
 void SolveLinearSystem(const TArray2D<double>& matrix, const TVector<double>& proj, TVector<double>* res);
 
+// Same solver without allocations: matrix is row-major size x size and is destroyed,
+// inverse is scratch space of the same size.
+void SolveLinearSystem(
+    size_t size,
+    TArrayRef<double> matrix,
+    TArrayRef<double> inverse,
+    TConstArrayRef<double> proj,
+    TArrayRef<double> res);
+
 void SolveLinearSystemCholesky(TVector<double>* matrix, TVector<double>* target);
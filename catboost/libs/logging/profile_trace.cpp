@@ -0,0 +1,133 @@
+#include "profile_trace.h"
+#include "logging.h"
+
+#include <library/chromium_trace/global.h>
+
+#include <util/generic/ptr.h>
+#include <util/system/atomic.h>
+#include <util/system/platform.h>
+
+#if defined(_linux_)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace NCB {
+    static TAtomic ProfileTraceEnabled = 0;
+    static TAtomic HardwareCountersEnabled = 0;
+
+#if defined(_linux_)
+    namespace {
+        class TThreadPerfCounters {
+        public:
+            TThreadPerfCounters() {
+                CyclesFd = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+                LlcMissesFd = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            }
+
+            ~TThreadPerfCounters() {
+                for (int fd : {CyclesFd, LlcMissesFd}) {
+                    if (fd != -1) {
+                        close(fd);
+                    }
+                }
+            }
+
+            TMaybe<TPerfCountersValues> Read() const {
+                TPerfCountersValues values;
+                if (!ReadCounter(CyclesFd, &values.Cycles) || !ReadCounter(LlcMissesFd, &values.LlcMisses)) {
+                    return Nothing();
+                }
+                return values;
+            }
+
+        private:
+            static int OpenCounter(ui32 type, ui64 config) {
+                perf_event_attr attr = {};
+                attr.type = type;
+                attr.size = sizeof(attr);
+                attr.config = config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+
+                // calling thread on any cpu
+                const long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                return (fd < 0) ? -1 : (int)fd;
+            }
+
+            static bool ReadCounter(int fd, ui64* value) {
+                return (fd != -1) && (read(fd, value, sizeof(*value)) == sizeof(*value));
+            }
+
+        private:
+            int CyclesFd = -1;
+            int LlcMissesFd = -1;
+        };
+    }
+
+    TMaybe<TPerfCountersValues> ReadThreadPerfCounters() {
+        static thread_local TThreadPerfCounters threadPerfCounters;
+        return threadPerfCounters.Read();
+    }
+#else
+    TMaybe<TPerfCountersValues> ReadThreadPerfCounters() {
+        return Nothing();
+    }
+#endif
+
+
+    TProfileTraceSink::TProfileTraceSink(const TString& fileName, bool collectHardwareCounters) {
+        if (!AtomicCas(&ProfileTraceEnabled, 1, 0)) {
+            CATBOOST_WARNING_LOG << "Profile trace is already written by another training in this process, "
+                "trace to " << fileName << " is skipped" << Endl;
+            return;
+        }
+        try {
+            Sink = MakeHolder<NChromiumTrace::TGlobalJsonFileSink>(fileName);
+        } catch (...) {
+            AtomicSet(ProfileTraceEnabled, 0);
+            throw;
+        }
+        AtomicSet(HardwareCountersEnabled, collectHardwareCounters ? 1 : 0);
+    }
+
+    TProfileTraceSink::~TProfileTraceSink() {
+        if (!Sink) {
+            return;
+        }
+        AtomicSet(HardwareCountersEnabled, 0);
+        Sink.Destroy();
+        AtomicSet(ProfileTraceEnabled, 0);
+    }
+
+    bool IsProfileTraceEnabled() {
+        return AtomicGet(ProfileTraceEnabled);
+    }
+
+
+    TProfileTraceScope::TProfileTraceScope(TStringBuf name, TStringBuf category) {
+        if (!IsProfileTraceEnabled()) {
+            return;
+        }
+        if (AtomicGet(HardwareCountersEnabled)) {
+            BeginPerfCounters = ReadThreadPerfCounters();
+        }
+        Event = NChromiumTrace::GetGlobalTracer()->BeginDurationCompleteNow(name, category);
+    }
+
+    TProfileTraceScope::~TProfileTraceScope() {
+        if (!Event) {
+            return;
+        }
+        if (BeginPerfCounters) {
+            if (const auto endPerfCounters = ReadThreadPerfCounters()) {
+                Args.Add(AsStringBuf("cycles"), i64(endPerfCounters->Cycles - BeginPerfCounters->Cycles));
+                Args.Add(AsStringBuf("llc_misses"), i64(endPerfCounters->LlcMisses - BeginPerfCounters->LlcMisses));
+            }
+        }
+        NChromiumTrace::GetGlobalTracer()->EndDurationCompleteNow(*Event, &Args);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <library/chromium_trace/event.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/strbuf.h>
+#include <util/system/types.h>
+
+
+namespace NChromiumTrace {
+    class TGlobalJsonFileSink;
+}
+
+
+namespace NCB {
+    struct TPerfCountersValues {
+        ui64 Cycles = 0;
+        ui64 LlcMisses = 0;
+    };
+
+    /* Hardware counters of the calling thread (perf_event_open on Linux)
+     * Nothing() if counters are not supported on this platform or not permitted (see perf_event_paranoid)
+     */
+    TMaybe<TPerfCountersValues> ReadThreadPerfCounters();
+
+
+    /* Writes trace of training phases in Chrome trace JSON format (see chrome://tracing) while it exists.
+     * The trace is process-wide: if another sink already exists (e.g. trainings in parallel threads),
+     *  this one writes nothing and a warning is logged, scopes of all trainings go to the existing trace.
+     */
+    class TProfileTraceSink : public TNonCopyable {
+    public:
+        TProfileTraceSink(const TString& fileName, bool collectHardwareCounters);
+        ~TProfileTraceSink();
+
+        bool IsActive() const {
+            return Sink.Get() != nullptr;
+        }
+
+    private:
+        THolder<NChromiumTrace::TGlobalJsonFileSink> Sink;
+    };
+
+    bool IsProfileTraceEnabled();
+
+
+    /* Records a complete event for the current thread with added args and, if enabled, hardware counters
+     * deltas. Does nothing if there's no TProfileTraceSink.
+     * name, category and arg names must outlive the scope (string literals are the intended use).
+     */
+    class TProfileTraceScope : public TNonCopyable {
+    public:
+        explicit TProfileTraceScope(TStringBuf name, TStringBuf category = AsStringBuf("train"));
+        ~TProfileTraceScope();
+
+        bool IsEnabled() const {
+            return Event.Defined();
+        }
+
+        TProfileTraceScope& AddArg(TStringBuf argName, i64 value) {
+            if (Event) {
+                Args.Add(argName, value);
+            }
+            return *this;
+        }
+
+    private:
+        TMaybe<NChromiumTrace::TDurationCompleteEvent> Event;
+        NChromiumTrace::TEventArgs Args;
+        TMaybe<TPerfCountersValues> BeginPerfCounters;
+    };
+}
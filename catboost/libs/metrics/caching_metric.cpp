@@ -2,6 +2,7 @@
 #include "metric.h"
 #include "description_utils.h"
 #include "classification_utils.h"
+#include "ranking_metrics.h"
 
 #include <catboost/libs/options/enum_helpers.h>
 #include <util/generic/string.h>
@@ -889,13 +890,42 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TVector<TMetricHolder> objectwiseBlockResults(objectwiseBlockParams.GetBlockCount());
     TVector<TMetricHolder> querywiseBlockResults(querywiseBlockParams.GetBlockCount());
 
+    // ranking metrics share one ranking of each query
+    TVector<const IRankingMetric*> rankingMetrics;
+    TVector<size_t> rankingMetricsIndices;
+    for (auto i : xrange(metrics.size())) {
+        if (auto rankingMetric = dynamic_cast<const IRankingMetric*>(metrics[i])) {
+            CB_ENSURE(target, "Metric [" + metrics[i]->GetDescription() + "] requires target");
+            rankingMetrics.push_back(rankingMetric);
+            rankingMetricsIndices.push_back(i);
+        }
+    }
+    TVector<TMaybe<TMetricHolder>> rankingErrors(metrics.size());
+    if (!rankingMetrics.empty()) {
+        auto rankingMetricsErrors = EvalRankingMetrics(
+            rankingMetrics,
+            approx[0],
+            approxDelta.empty() ? TConstArrayRef<double>() : TConstArrayRef<double>(approxDelta[0]),
+            isExpApprox,
+            *target,
+            queriesInfo,
+            0,
+            queryCount,
+            localExecutor);
+        for (auto i : xrange(rankingMetrics.size())) {
+            rankingErrors[rankingMetricsIndices[i]] = std::move(rankingMetricsErrors[i]);
+        }
+    }
+
     for (auto i : xrange(metrics.size())) {
         auto metric = metrics[i];
         auto cachingMetric = dynamic_cast<const TCachingMetric*>(metrics[i]);
         const bool isObjectwise = metric->GetErrorType() == EErrorType::PerObjectError;
         CB_ENSURE(!metric->NeedTarget() || target, "Metric [" + metric->GetDescription() + "] requires target");
 
-        if (cachingMetric && metric->IsAdditiveMetric()) {
+        if (rankingErrors[i]) {
+            errors.push_back(std::move(*rankingErrors[i]));
+        } else if (cachingMetric && metric->IsAdditiveMetric()) {
             const auto blockSize = isObjectwise ? objectwiseBlockParams.GetBlockSize() : querywiseBlockParams.GetBlockSize();
             const auto blockCount = isObjectwise ? objectwiseBlockParams.GetBlockCount() : querywiseBlockParams.GetBlockCount();
 
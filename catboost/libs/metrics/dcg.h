@@ -30,3 +30,10 @@ double CalcIDcg(
     TMaybe<double> expDecay = Nothing(),
     ui32 topSize = Max<ui32>(),
     ENdcgDenominatorType denominator = ENdcgDenominatorType::LogPosition);
+
+// sortedTargets are targets of the top documents in ranking order
+double CalcDcgSorted(
+    TConstArrayRef<double> sortedTargets,
+    ENdcgMetricType type,
+    TMaybe<double> expDecay,
+    ENdcgDenominatorType denominator);
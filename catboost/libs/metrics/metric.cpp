@@ -12,6 +12,7 @@
 #include "llp.h"
 #include "pfound.h"
 #include "precision_recall_at_k.h"
+#include "ranking_metrics.h"
 #include "description_utils.h"
 
 #include <catboost/libs/helpers/exception.h>
@@ -21,6 +22,7 @@
 
 #include <library/fast_exp/fast_exp.h>
 #include <library/fast_log/fast_log.h>
+#include <library/containers/stack_vector/stack_vec.h>
 
 #include <util/generic/array_ref.h>
 #include <util/generic/hash.h>
@@ -76,6 +78,46 @@ static inline TConstArrayRef<double> GetRowRef(const TVector<TVector<double>>& m
     }
 }
 
+static TMetricHolder EvalRankingMetricSingleThread(
+    const IRankingMetric* metric,
+    const TVector<TVector<double>>& approx,
+    const TVector<TVector<double>>& approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex
+) {
+    return EvalRankingMetricsSingleThread(
+        TConstArrayRef<const IRankingMetric*>(&metric, 1),
+        approx[0],
+        GetRowRef(approxDelta, /*rowIdx*/0),
+        isExpApprox,
+        target,
+        queriesInfo,
+        queryStartIndex,
+        queryEndIndex
+    )[0];
+}
+
+static ui32 ToRankedTopSize(int topSize) {
+    return topSize < 0 ? Max<ui32>() : static_cast<ui32>(topSize);
+}
+
+static int CountRelevant(TConstArrayRef<float> target, TConstArrayRef<ui32> docs, double border) {
+    int relevant = 0;
+    for (auto doc : docs) {
+        if (target[doc] > border) {
+            ++relevant;
+        }
+    }
+    return relevant;
+}
+
+static int CountRelevant(TConstArrayRef<float> target, double border) {
+    return static_cast<int>(CountIf(target, [=] (float value) { return value > border; }));
+}
+
 static constexpr ui32 EncodeFlags(bool flagOne, bool flagTwo, bool flagThree = false, bool flagFour = false) {
     return flagOne + flagTwo * 2 + flagThree * 4 + flagFour * 8;
 }
@@ -1606,7 +1648,7 @@ void TQueryRMSEMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
 /* PFound */
 
 namespace {
-    struct TPFoundMetric : public TAdditiveMetric<TPFoundMetric> {
+    struct TPFoundMetric : public TAdditiveMetric<TPFoundMetric>, public IRankingMetric {
         explicit TPFoundMetric(int topSize, double decay);
         TMetricHolder EvalSingleThread(
             const TVector<TVector<double>>& approx,
@@ -1622,6 +1664,8 @@ namespace {
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        ui32 GetRankedTopSize() const override;
+        void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const override;
 
     private:
         int TopSize;
@@ -1649,37 +1693,33 @@ TMetricHolder TPFoundMetric::EvalSingleThread(
     int queryStartIndex,
     int queryEndIndex
 ) const {
-    const auto impl = [=] (auto hasDelta, auto isExpApprox, TConstArrayRef<double> approx, TConstArrayRef<double> approxDelta) {
-        TPFoundCalcer calcer(TopSize, Decay);
-        for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-            const int queryBegin = queriesInfo[queryIndex].Begin;
-            const int queryEnd = queriesInfo[queryIndex].End;
-            const ui32* subgroupIdData = nullptr;
-            const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.0;
-            if (!queriesInfo[queryIndex].SubgroupId.empty()) {
-                subgroupIdData = queriesInfo[queryIndex].SubgroupId.data();
-            }
-            const double* approxDeltaData = nullptr;
-            if (hasDelta) {
-                approxDeltaData = approxDelta.data();
+    return EvalRankingMetricSingleThread(
+        this, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+}
+
+ui32 TPFoundMetric::GetRankedTopSize() const {
+    return ToRankedTopSize(TopSize);
+}
+
+void TPFoundMetric::AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const {
+    const float queryWeight = UseWeights ? query.Weight : 1.0;
+    double pLook = 1, pFound = 0;
+    TSet<ui32> subgroupIds;
+    for (auto docId : query.GetRankedDocs(GetRankedTopSize())) {
+        if (!query.SubgroupId.empty()) {
+            const ui32 subgroupId = query.SubgroupId[docId];
+            if (subgroupIds.contains(subgroupId)) {
+                continue;
             }
-            calcer.AddQuery<isExpApprox, hasDelta>(target.data() + queryBegin, approx.data() + queryBegin, approxDeltaData + queryBegin, queryWeight, subgroupIdData, queryEnd - queryBegin);
+            subgroupIds.insert(subgroupId);
         }
-        return calcer.GetMetric();
-    };
-    switch (EncodeFlags(!approxDelta.empty(), isExpApprox)) {
-        case EncodeFlags(false, false):
-            return impl(std::false_type(), std::false_type(), approx[0], GetRowRef(approxDelta, /*rowIdx*/0));
-        case EncodeFlags(false, true):
-            return impl(std::false_type(), std::true_type(), approx[0], GetRowRef(approxDelta, /*rowIdx*/0));
-        case EncodeFlags(true, false):
-            return impl(std::true_type(), std::false_type(), approx[0], GetRowRef(approxDelta, /*rowIdx*/0));
-        case EncodeFlags(true, true):
-            return impl(std::true_type(), std::true_type(), approx[0], GetRowRef(approxDelta, /*rowIdx*/0));
-        default:
-            Y_VERIFY(false);
-    }
 
+        const double pRel = query.Target[docId];
+        pFound += pRel * pLook;
+        pLook *= (1 - pRel) * Decay;
+    }
+    stats->Stats[0] += queryWeight * pFound;
+    stats->Stats[1] += queryWeight;
 }
 
 EErrorType TPFoundMetric::GetErrorType() const {
@@ -1703,7 +1743,7 @@ void TPFoundMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
 /* NDCG@N */
 
 namespace {
-    struct TDcgMetric: public TAdditiveMetric<TDcgMetric> {
+    struct TDcgMetric: public TAdditiveMetric<TDcgMetric>, public IRankingMetric {
         explicit TDcgMetric(int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator);
         TMetricHolder EvalSingleThread(
                 const TVector<TVector<double>>& approx,
@@ -1719,6 +1759,9 @@ namespace {
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        ui32 GetRankedTopSize() const override;
+        bool NeedIdealRanking() const override;
+        void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const override;
 
     private:
         int TopSize;
@@ -1752,25 +1795,36 @@ TMetricHolder TDcgMetric::EvalSingleThread(
 ) const {
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-    TVector<NMetrics::TSample> samples;
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        const auto queryBegin = queriesInfo[queryIndex].Begin;
-        const auto queryEnd = queriesInfo[queryIndex].End;
-        const auto querySize = queryEnd - queryBegin;
-        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
-        NMetrics::TSample::FromVectors(
-            MakeArrayRef(target.data() + queryBegin, querySize),
-            MakeArrayRef(approx.front().data() + queryBegin, querySize),
-            &samples);
-        if (Normalized) {
-            error.Stats[0] += queryWeight * CalcNdcg(samples, MetricType, TopSize, DenominatorType);
-        } else {
-            error.Stats[0] += queryWeight * CalcDcg(samples, MetricType, Nothing(), TopSize, DenominatorType);
-        }
-        error.Stats[1] += queryWeight;
+    return EvalRankingMetricSingleThread(
+        this, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+}
+
+ui32 TDcgMetric::GetRankedTopSize() const {
+    return ToRankedTopSize(TopSize);
+}
+
+bool TDcgMetric::NeedIdealRanking() const {
+    return Normalized;
+}
+
+void TDcgMetric::AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const {
+    const float queryWeight = UseWeights ? query.Weight : 1.f;
+    const auto rankedDocs = query.GetRankedDocs(GetRankedTopSize());
+    TStackVec<double> sortedTargets;
+    sortedTargets.yresize(rankedDocs.size());
+    for (auto i : xrange(rankedDocs.size())) {
+        sortedTargets[i] = query.Target[rankedDocs[i]];
     }
-    return error;
+    const double dcg = CalcDcgSorted(sortedTargets, MetricType, Nothing(), DenominatorType);
+    if (Normalized) {
+        const auto idealTargets = query.GetIdealTargets(GetRankedTopSize());
+        sortedTargets.assign(idealTargets.begin(), idealTargets.end());
+        const double idcg = CalcDcgSorted(sortedTargets, MetricType, Nothing(), DenominatorType);
+        stats->Stats[0] += queryWeight * (idcg > 0 ? dcg / idcg : 0);
+    } else {
+        stats->Stats[0] += queryWeight * dcg;
+    }
+    stats->Stats[1] += queryWeight;
 }
 
 TString TDcgMetric::GetDescription() const {
@@ -2953,7 +3007,7 @@ void TPairAccuracyMetric::GetBestValue(EMetricBestValue* valueType, float*) cons
 /* PrecisionAtK */
 
 namespace {
-    struct TPrecisionAtKMetric: public TAdditiveMetric<TPrecisionAtKMetric> {
+    struct TPrecisionAtKMetric: public TAdditiveMetric<TPrecisionAtKMetric>, public IRankingMetric {
         explicit TPrecisionAtKMetric(int topSize, double border);
         TMetricHolder EvalSingleThread(
                 const TVector<TVector<double>>& approx,
@@ -2969,6 +3023,8 @@ namespace {
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        ui32 GetRankedTopSize() const override;
+        void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const override;
     private:
         int TopSize;
         double Border;
@@ -2997,18 +3053,18 @@ TMetricHolder TPrecisionAtKMetric::EvalSingleThread(
 ) const {
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
+    return EvalRankingMetricSingleThread(
+        this, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+}
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
+ui32 TPrecisionAtKMetric::GetRankedTopSize() const {
+    return ToRankedTopSize(TopSize);
+}
 
-        error.Stats[0] += CalcPrecisionAtK(approxCopy, targetCopy, TopSize, Border);
-        error.Stats[1]++;
-    }
-    return error;
+void TPrecisionAtKMetric::AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const {
+    const auto rankedDocs = query.GetRankedDocs(GetRankedTopSize());
+    stats->Stats[0] += CountRelevant(query.Target, rankedDocs, Border) / static_cast<double>(rankedDocs.size());
+    stats->Stats[1]++;
 }
 
 EErrorType TPrecisionAtKMetric::GetErrorType() const {
@@ -3031,7 +3087,7 @@ void TPrecisionAtKMetric::GetBestValue(EMetricBestValue* valueType, float*) cons
 /* RecallAtK */
 
 namespace {
-    struct TRecallAtKMetric: public TAdditiveMetric<TRecallAtKMetric> {
+    struct TRecallAtKMetric: public TAdditiveMetric<TRecallAtKMetric>, public IRankingMetric {
         explicit TRecallAtKMetric(int topSize, double border);
         TMetricHolder EvalSingleThread(
                 const TVector<TVector<double>>& approx,
@@ -3048,6 +3104,9 @@ namespace {
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
 
+        ui32 GetRankedTopSize() const override;
+        void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const override;
+
     private:
         int TopSize;
         double Border;
@@ -3076,18 +3135,19 @@ TMetricHolder TRecallAtKMetric::EvalSingleThread(
 ) const {
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
+    return EvalRankingMetricSingleThread(
+        this, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+}
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
+ui32 TRecallAtKMetric::GetRankedTopSize() const {
+    return ToRankedTopSize(TopSize);
+}
 
-        error.Stats[0] += CalcRecallAtK(approxCopy, targetCopy, TopSize, Border);
-        error.Stats[1]++;
-    }
-    return error;
+void TRecallAtKMetric::AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const {
+    const int relevant = CountRelevant(query.Target, Border);
+    const int rankedRelevant = CountRelevant(query.Target, query.GetRankedDocs(GetRankedTopSize()), Border);
+    stats->Stats[0] += relevant != 0 ? rankedRelevant / static_cast<double>(relevant) : 1;
+    stats->Stats[1]++;
 }
 
 EErrorType TRecallAtKMetric::GetErrorType() const {
@@ -3110,7 +3170,7 @@ void TRecallAtKMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
 /* Mean Average Precision at k */
 
 namespace {
-    struct TMAPKMetric: public TAdditiveMetric<TMAPKMetric> {
+    struct TMAPKMetric: public TAdditiveMetric<TMAPKMetric>, public IRankingMetric {
         explicit TMAPKMetric(int topSize, double border);
         TMetricHolder EvalSingleThread(
                 const TVector<TVector<double>>& approx,
@@ -3127,6 +3187,9 @@ namespace {
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
 
+        ui32 GetRankedTopSize() const override;
+        void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const override;
+
     private:
         int TopSize;
         double Border;
@@ -3155,19 +3218,27 @@ TMetricHolder TMAPKMetric::EvalSingleThread(
 ) const {
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
-    TMetricHolder error(2);
-
-    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
+    return EvalRankingMetricSingleThread(
+        this, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+}
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.data() + queryBegin, target.data() + queryEnd);
+ui32 TMAPKMetric::GetRankedTopSize() const {
+    return ToRankedTopSize(TopSize);
+}
 
-        error.Stats[0] += CalcAveragePrecisionK(approxCopy, targetCopy, TopSize, Border);
-        error.Stats[1]++;
+void TMAPKMetric::AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const {
+    const auto rankedDocs = query.GetRankedDocs(GetRankedTopSize());
+    double score = 0;
+    double rankedHits = 0;
+    for (auto position : xrange(rankedDocs.size())) {
+        if (query.Target[rankedDocs[position]] > Border) {
+            rankedHits += 1;
+            score += rankedHits / (position + 1);
+        }
     }
-    return error;
+    const double hits = CountRelevant(query.Target, Border);
+    stats->Stats[0] += hits > 0 ? score / Min<double>(hits, rankedDocs.size()) : 0;
+    stats->Stats[1]++;
 }
 
 TString TMAPKMetric::GetDescription() const {
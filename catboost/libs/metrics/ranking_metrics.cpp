@@ -0,0 +1,161 @@
+#include "ranking_metrics.h"
+
+#include "doc_comparator.h"
+#include "metric.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <functional>
+
+
+namespace {
+    // buffers are reused between queries
+    class TQueryRanker {
+    public:
+        explicit TQueryRanker(TConstArrayRef<const IRankingMetric*> metrics) {
+            for (const auto* metric : metrics) {
+                TopSize = Max(TopSize, metric->GetRankedTopSize());
+                NeedIdealRanking = NeedIdealRanking || metric->NeedIdealRanking();
+            }
+        }
+
+        TRankedQuery Rank(
+            const double* approx,
+            const double* approxDelta, // can be nullptr
+            bool isExpApprox,
+            const float* target,
+            const TQueryInfo& queryInfo
+        ) {
+            const ui32 querySize = queryInfo.End - queryInfo.Begin;
+            const ui32 topSize = Min(TopSize, querySize);
+            approx += queryInfo.Begin;
+            target += queryInfo.Begin;
+
+            if (approxDelta) {
+                approxDelta += queryInfo.Begin;
+                Approx.yresize(querySize);
+                for (auto doc : xrange(querySize)) {
+                    Approx[doc] = isExpApprox ? approx[doc] * approxDelta[doc] : approx[doc] + approxDelta[doc];
+                }
+                approx = Approx.data();
+            }
+
+            Docs.yresize(querySize);
+            Iota(Docs.begin(), Docs.end(), static_cast<ui32>(0));
+            const auto compareDocs = [=] (ui32 left, ui32 right) {
+                return CompareDocs(approx[left], target[left], approx[right], target[right]);
+            };
+            if (topSize == querySize) {
+                Sort(Docs.begin(), Docs.end(), compareDocs);
+            } else {
+                PartialSort(Docs.begin(), Docs.begin() + topSize, Docs.end(), compareDocs);
+            }
+
+            TRankedQuery rankedQuery;
+            rankedQuery.Target = MakeArrayRef(target, querySize);
+            rankedQuery.SubgroupId = queryInfo.SubgroupId;
+            rankedQuery.RankedDocs = MakeArrayRef(Docs.data(), topSize);
+            if (NeedIdealRanking) {
+                IdealTargets.assign(target, target + querySize);
+                if (topSize == querySize) {
+                    Sort(IdealTargets.begin(), IdealTargets.end(), std::greater<float>());
+                } else {
+                    PartialSort(IdealTargets.begin(), IdealTargets.begin() + topSize, IdealTargets.end(), std::greater<float>());
+                }
+                rankedQuery.IdealTargets = MakeArrayRef(IdealTargets.data(), topSize);
+            }
+            rankedQuery.Weight = queryInfo.Weight;
+            return rankedQuery;
+        }
+
+    private:
+        ui32 TopSize = 0;
+        bool NeedIdealRanking = false;
+        TVector<double> Approx;
+        TVector<ui32> Docs;
+        TVector<float> IdealTargets;
+    };
+}
+
+
+TVector<TMetricHolder> EvalRankingMetricsSingleThread(
+    TConstArrayRef<const IRankingMetric*> metrics,
+    TConstArrayRef<double> approx,
+    TConstArrayRef<double> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex
+) {
+    TVector<TMetricHolder> stats;
+    stats.reserve(metrics.size());
+    for (const auto* metric : metrics) {
+        stats.emplace_back(metric->GetRankingStatsCount());
+    }
+
+    TQueryRanker ranker(metrics);
+    const double* approxDeltaData = approxDelta.empty() ? nullptr : approxDelta.data();
+    for (auto queryIndex : xrange(queryStartIndex, queryEndIndex)) {
+        const TRankedQuery rankedQuery = ranker.Rank(
+            approx.data(),
+            approxDeltaData,
+            isExpApprox,
+            target.data(),
+            queriesInfo[queryIndex]);
+        for (auto metricIdx : xrange(metrics.size())) {
+            metrics[metricIdx]->AddRankedQuery(rankedQuery, &stats[metricIdx]);
+        }
+    }
+    return stats;
+}
+
+TVector<TMetricHolder> EvalRankingMetrics(
+    TConstArrayRef<const IRankingMetric*> metrics,
+    TConstArrayRef<double> approx,
+    TConstArrayRef<double> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    NPar::TLocalExecutor* localExecutor
+) {
+    // more blocks than threads, query sizes can differ a lot
+    const int queryCount = queryEndIndex - queryStartIndex;
+    const int blockSize = GetMinBlockSize(queryCount);
+    const int blockCount = CeilDiv(queryCount, blockSize);
+    if (blockCount <= 1) {
+        return EvalRankingMetricsSingleThread(
+            metrics, approx, approxDelta, isExpApprox, target, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+
+    TVector<TVector<TMetricHolder>> blockStats(blockCount);
+    localExecutor->ExecRangeWithWorkStealing(
+        [&] (int blockId) {
+            const int blockStart = queryStartIndex + blockId * blockSize;
+            blockStats[blockId] = EvalRankingMetricsSingleThread(
+                metrics,
+                approx,
+                approxDelta,
+                isExpApprox,
+                target,
+                queriesInfo,
+                blockStart,
+                Min(blockStart + blockSize, queryEndIndex));
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TVector<TMetricHolder> stats(metrics.size());
+    for (const auto& oneBlockStats : blockStats) {
+        for (auto metricIdx : xrange(metrics.size())) {
+            stats[metricIdx].Add(oneBlockStats[metricIdx]);
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "metric_holder.h"
+
+#include <catboost/libs/data_types/query.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/fwd.h>
+#include <util/generic/utility.h>
+#include <util/system/types.h>
+
+/* Query documents ranked once for all ranking metrics evaluated together.
+ * Only the first RankedDocs.size() == Min(querySize, max GetRankedTopSize() of the metrics) documents are ordered
+ * (by CompareDocs), IdealTargets are the same number of largest targets in descending order.
+ */
+struct TRankedQuery {
+    TConstArrayRef<float> Target; // whole query
+    TConstArrayRef<ui32> SubgroupId; // whole query, can be empty
+    TConstArrayRef<ui32> RankedDocs; // indices are relative to the query begin
+    TConstArrayRef<float> IdealTargets; // empty if no metric needs ideal ranking
+    float Weight = 0.0f;
+
+    TConstArrayRef<ui32> GetRankedDocs(ui32 topSize) const {
+        return RankedDocs.first(Min<size_t>(topSize, RankedDocs.size()));
+    }
+
+    TConstArrayRef<float> GetIdealTargets(ui32 topSize) const {
+        return IdealTargets.first(Min<size_t>(topSize, IdealTargets.size()));
+    }
+};
+
+class IRankingMetric {
+public:
+    virtual ~IRankingMetric() = default;
+
+    // Max<ui32>() if the whole query has to be ranked
+    virtual ui32 GetRankedTopSize() const = 0;
+    virtual bool NeedIdealRanking() const {
+        return false;
+    }
+    virtual int GetRankingStatsCount() const {
+        return 2;
+    }
+    virtual void AddRankedQuery(const TRankedQuery& query, TMetricHolder* stats) const = 0;
+};
+
+// stats are returned in the order of metrics
+TVector<TMetricHolder> EvalRankingMetricsSingleThread(
+    TConstArrayRef<const IRankingMetric*> metrics,
+    TConstArrayRef<double> approx,
+    TConstArrayRef<double> approxDelta, // can be empty
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex);
+
+TVector<TMetricHolder> EvalRankingMetrics(
+    TConstArrayRef<const IRankingMetric*> metrics,
+    TConstArrayRef<double> approx,
+    TConstArrayRef<double> approxDelta, // can be empty
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    NPar::TLocalExecutor* localExecutor);
@@ -0,0 +1,82 @@
+#include <catboost/libs/metrics/caching_metric.h>
+#include <catboost/libs/metrics/dcg.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/pfound.h>
+#include <catboost/libs/metrics/precision_recall_at_k.h>
+#include <catboost/libs/metrics/sample.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(RankingMetricsTests) {
+    Y_UNIT_TEST(TestSharedRankingMatchesPerMetric) {
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<TQueryInfo> queriesInfo;
+        for (auto queryIdx : xrange(3000)) {
+            Y_UNUSED(queryIdx);
+            const ui32 begin = target.size();
+            const ui32 querySize = 1 + rng.Uniform(50);
+            for (auto doc : xrange(querySize)) {
+                Y_UNUSED(doc);
+                // coarse approxes to get ties
+                approx[0].push_back(rng.Uniform(10) / 10.0);
+                target.push_back(rng.Uniform(4) / 3.0f);
+            }
+            queriesInfo.emplace_back(begin, begin + querySize);
+            queriesInfo.back().Weight = 0.5f + rng.GenRandReal1();
+        }
+
+        TVector<THolder<IMetric>> metrics;
+        metrics.push_back(MakeDcgMetric(5, ENdcgMetricType::Exp, /*normalized*/ true));
+        metrics.push_back(MakeDcgMetric(10, ENdcgMetricType::Base, /*normalized*/ false));
+        metrics.push_back(MakePFoundMetric());
+        metrics.push_back(MakeMAPKMetric(3));
+        metrics.push_back(MakePrecisionAtKMetric(5));
+        metrics.push_back(MakeRecallAtKMetric(5));
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        const auto errors = EvalErrorsWithCaching(
+            approx,
+            /*approxDelta*/ {},
+            /*isExpApprox*/ false,
+            MakeArrayRef(target),
+            /*weight*/ {},
+            queriesInfo,
+            metrics,
+            &executor);
+        UNIT_ASSERT_VALUES_EQUAL(errors.size(), metrics.size());
+
+        TVector<double> expected(metrics.size());
+        double weightSum = 0;
+        TPFoundCalcer pFoundCalcer;
+        for (const auto& queryInfo : queriesInfo) {
+            const auto queryApprox = MakeArrayRef(approx[0].data() + queryInfo.Begin, queryInfo.End - queryInfo.Begin);
+            const auto queryTarget = MakeArrayRef(target.data() + queryInfo.Begin, queryInfo.End - queryInfo.Begin);
+            const auto samples = NMetrics::TSample::FromVectors(queryTarget, queryApprox);
+            expected[0] += queryInfo.Weight * CalcNdcg(samples, ENdcgMetricType::Exp, 5);
+            expected[1] += queryInfo.Weight * CalcDcg(samples, ENdcgMetricType::Base, Nothing(), 10);
+            pFoundCalcer.AddQuery</*isExpApprox*/false, /*hasDelta*/false>(
+                queryTarget.data(), queryApprox.data(), (const double*)nullptr, queryInfo.Weight, nullptr, queryTarget.size());
+            expected[3] += CalcAveragePrecisionK(queryApprox, queryTarget, 3, GetDefaultTargetBorder());
+            expected[4] += CalcPrecisionAtK(queryApprox, queryTarget, 5, GetDefaultTargetBorder());
+            expected[5] += CalcRecallAtK(queryApprox, queryTarget, 5, GetDefaultTargetBorder());
+            weightSum += queryInfo.Weight;
+        }
+        expected[0] /= weightSum;
+        expected[1] /= weightSum;
+        expected[2] = TPFoundCalcer::Score(pFoundCalcer.GetMetric());
+        for (auto i : xrange<size_t>(3, metrics.size())) {
+            expected[i] /= queriesInfo.size();
+        }
+
+        for (auto i : xrange(metrics.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL_C(metrics[i]->GetFinalError(errors[i]), expected[i], 1e-9, metrics[i]->GetDescription());
+        }
+    }
+}
@@ -0,0 +1,323 @@
+#include "compiled_model_abi.h"
+
+#include <catboost/libs/model/eval_processing.h>
+#include <catboost/libs/model/evaluation_interface.h>
+#include <catboost/libs/model/model.h>
+
+#include <util/digest/murmur.h>
+#include <util/stream/labeled.h>
+#include <util/string/cast.h>
+#include <util/system/dynlib.h>
+#include <util/thread/singleton.h>
+
+namespace NCB::NModelEvaluation {
+    ui64 CalcCompiledModelChecksum(const TObliviousTrees& trees) {
+        ui64 checksum = MurmurHash<ui64>(&trees.ApproxDimension, sizeof(trees.ApproxDimension), 0);
+        checksum = MurmurHash<ui64>(trees.TreeSizes.data(), trees.TreeSizes.size() * sizeof(int), checksum);
+        checksum = MurmurHash<ui64>(trees.TreeSplits.data(), trees.TreeSplits.size() * sizeof(int), checksum);
+        checksum = MurmurHash<ui64>(trees.LeafValues.data(), trees.LeafValues.size() * sizeof(double), checksum);
+        for (const auto& floatFeature : trees.FloatFeatures) {
+            checksum = MurmurHash<ui64>(&floatFeature.Position.FlatIndex, sizeof(floatFeature.Position.FlatIndex), checksum);
+            checksum = MurmurHash<ui64>(floatFeature.Borders.data(), floatFeature.Borders.size() * sizeof(float), checksum);
+        }
+        return checksum;
+    }
+
+    namespace NDetail {
+        class TCompiledModelLibrary {
+        public:
+            TCompiledModelLibrary(const TString& libraryPath, const TObliviousTrees& trees)
+                : Library(libraryPath)
+            {
+                const auto abiVersion = reinterpret_cast<TCompiledModelAbiVersionFunction>(
+                    Library.Sym(COMPILED_MODEL_ABI_VERSION_SYMBOL));
+                CB_ENSURE(
+                    abiVersion() == COMPILED_MODEL_ABI_VERSION,
+                    "Compiled model " << libraryPath << " has ABI version " << abiVersion()
+                    << ", expected " << COMPILED_MODEL_ABI_VERSION
+                );
+                const auto checksum = reinterpret_cast<TCompiledModelChecksumFunction>(
+                    Library.Sym(COMPILED_MODEL_CHECKSUM_SYMBOL));
+                CB_ENSURE(
+                    checksum() == CalcCompiledModelChecksum(trees),
+                    "Compiled model " << libraryPath << " is built from another model"
+                );
+                FlatFeatureCount = reinterpret_cast<TCompiledModelFlatFeatureCountFunction>(
+                    Library.Sym(COMPILED_MODEL_FLAT_FEATURE_COUNT_SYMBOL))();
+                CalcFunction = reinterpret_cast<TCompiledModelCalcFunction>(Library.Sym(COMPILED_MODEL_CALC_SYMBOL));
+            }
+
+            size_t GetFlatFeatureCount() const {
+                return FlatFeatureCount;
+            }
+
+            void Calc(const float* const* features, size_t docCount, bool isTransposed, double* results) const {
+                CalcFunction(features, docCount, isTransposed ? 1 : 0, results);
+            }
+
+        private:
+            TDynamicLibrary Library;
+            size_t FlatFeatureCount = 0;
+            TCompiledModelCalcFunction CalcFunction = nullptr;
+        };
+
+        // per-thread buffer for feature pointers passed to compiled model
+        struct TFeaturePointersHolder {
+            TVector<const float*> Pointers;
+        };
+
+        /**
+         * Evaluator that uses model compiled to native code for flat float features input
+         *  and falls back to TCpuEvaluator for everything the compiled code doesn't support
+         *  (categorical features, tree ranges, feature layouts, leaf indexes, quantized data).
+         */
+        class TCompiledEvaluator final : public IModelEvaluator {
+        public:
+            TCompiledEvaluator(const TFullModel& model, const TString& libraryPath)
+                : ObliviousTrees(model.ObliviousTrees)
+                , Library(MakeAtomicShared<TCompiledModelLibrary>(libraryPath, *model.ObliviousTrees))
+                , FallbackEvaluator(CreateCpuEvaluator(model))
+            {
+                CB_ENSURE(
+                    Library->GetFlatFeatureCount() == ObliviousTrees->GetFlatFeatureVectorExpectedSize(),
+                    "Compiled model " << libraryPath << " expects " << Library->GetFlatFeatureCount() << " features"
+                );
+            }
+
+            TCompiledEvaluator(const TCompiledEvaluator& other)
+                : ObliviousTrees(other.ObliviousTrees)
+                , Library(other.Library)
+                , FallbackEvaluator(other.FallbackEvaluator->Clone())
+                , PredictionType(other.PredictionType)
+                , HasFeatureLayout(other.HasFeatureLayout)
+                , BinclassProbabilityBorder(other.BinclassProbabilityBorder)
+            {}
+
+            void SetPredictionType(EPredictionType type) override {
+                PredictionType = type;
+                FallbackEvaluator->SetPredictionType(type);
+            }
+
+            EPredictionType GetPredictionType() const override {
+                return PredictionType;
+            }
+
+            TModelEvaluatorPtr Clone() const override {
+                return new TCompiledEvaluator(*this);
+            }
+
+            i32 GetApproxDimension() const override {
+                return ObliviousTrees->ApproxDimension;
+            }
+
+            size_t GetTreeCount() const override {
+                return ObliviousTrees->GetTreeCount();
+            }
+
+            void SetFeatureLayout(const TFeatureLayout& featureLayout) override {
+                HasFeatureLayout = true;
+                FallbackEvaluator->SetFeatureLayout(featureLayout);
+            }
+
+            void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
+                FallbackEvaluator->SetProperty(propName, propValue);
+                if (propName == TStringBuf("BinclassProbabilityBorder")) {
+                    BinclassProbabilityBorder = FromString<double>(propValue);
+                }
+            }
+
+            void CalcFlatTransposed(
+                TConstArrayRef<TConstArrayRef<float>> transposedFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!CanUseCompiledModel(treeStart, treeEnd, featureInfo)) {
+                    FallbackEvaluator->CalcFlatTransposed(transposedFeatures, treeStart, treeEnd, results, featureInfo);
+                    return;
+                }
+                CB_ENSURE(
+                    Library->GetFlatFeatureCount() <= transposedFeatures.size(),
+                    "Not enough features provided" << LabeledOutput(Library->GetFlatFeatureCount(), transposedFeatures.size())
+                );
+                const size_t docCount = transposedFeatures.empty() ? 0 : transposedFeatures[0].size();
+                for (const auto& featureValues : transposedFeatures) {
+                    CB_ENSURE(featureValues.size() == docCount, "All features should have the same number of objects");
+                }
+                CalcCompiled(transposedFeatures, docCount, /*isTransposed*/ true, results);
+            }
+
+            void CalcFlat(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!CanUseCompiledModel(treeStart, treeEnd, featureInfo)) {
+                    FallbackEvaluator->CalcFlat(features, treeStart, treeEnd, results, featureInfo);
+                    return;
+                }
+                for (const auto& docFeatures : features) {
+                    CB_ENSURE(
+                        docFeatures.size() >= Library->GetFlatFeatureCount(),
+                        "insufficient flat features vector size: " << docFeatures.size()
+                        << " expected: " << Library->GetFlatFeatureCount()
+                    );
+                }
+                CalcCompiled(features, features.size(), /*isTransposed*/ false, results);
+            }
+
+            void CalcFlatSingle(
+                TConstArrayRef<float> features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!CanUseCompiledModel(treeStart, treeEnd, featureInfo)) {
+                    FallbackEvaluator->CalcFlatSingle(features, treeStart, treeEnd, results, featureInfo);
+                    return;
+                }
+                CB_ENSURE(Library->GetFlatFeatureCount() <= features.size(), "Not enough features provided");
+                CalcCompiled(MakeArrayRef(&features, 1), 1, /*isTransposed*/ false, results);
+            }
+
+            void Calc(
+                TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> catFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->Calc(floatFeatures, catFeatures, treeStart, treeEnd, results, featureInfo);
+            }
+
+            void Calc(
+                TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->Calc(floatFeatures, catFeatures, treeStart, treeEnd, results, featureInfo);
+            }
+
+            void CalcFlatSparse(
+                const TCSRFlatFeaturesRef& features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->CalcFlatSparse(features, treeStart, treeEnd, results, featureInfo);
+            }
+
+            void CalcTransposed(
+                TConstArrayRef<TConstArrayRef<float>> transposedFloatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> transposedHashedCatFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->CalcTransposed(
+                    transposedFloatFeatures,
+                    transposedHashedCatFeatures,
+                    treeStart,
+                    treeEnd,
+                    results,
+                    featureInfo
+                );
+            }
+
+            void Calc(
+                const IQuantizedData* quantizedFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results
+            ) const override {
+                FallbackEvaluator->Calc(quantizedFeatures, treeStart, treeEnd, results);
+            }
+
+            void CalcLeafIndexesSingle(
+                TConstArrayRef<float> floatFeatures,
+                TConstArrayRef<TStringBuf> catFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<TCalcerIndexType> indexes,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->CalcLeafIndexesSingle(floatFeatures, catFeatures, treeStart, treeEnd, indexes, featureInfo);
+            }
+
+            void CalcLeafIndexes(
+                TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<TCalcerIndexType> indexes,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                FallbackEvaluator->CalcLeafIndexes(floatFeatures, catFeatures, treeStart, treeEnd, indexes, featureInfo);
+            }
+
+            void CalcLeafIndexes(
+                const IQuantizedData* quantizedFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<TCalcerIndexType> indexes
+            ) const override {
+                FallbackEvaluator->CalcLeafIndexes(quantizedFeatures, treeStart, treeEnd, indexes);
+            }
+
+        private:
+            bool CanUseCompiledModel(size_t treeStart, size_t treeEnd, const TFeatureLayout* featureInfo) const {
+                return treeStart == 0 && treeEnd == GetTreeCount() && !featureInfo && !HasFeatureLayout;
+            }
+
+            void CalcCompiled(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t docCount,
+                bool isTransposed,
+                TArrayRef<double> results
+            ) const {
+                CB_ENSURE(results.size() >= docCount, "`results` size is insufficient: " << LabeledOutput(results.size(), docCount));
+                auto& pointers = FastTlsSingleton<TFeaturePointersHolder>()->Pointers;
+                pointers.resize(features.size());
+                for (size_t i = 0; i < features.size(); ++i) {
+                    pointers[i] = features[i].data();
+                }
+                Library->Calc(pointers.data(), docCount, isTransposed, results.data());
+                TEvalResultProcessor resultProcessor(
+                    docCount,
+                    results,
+                    PredictionType,
+                    /*approxDimension*/ 1,
+                    Max<ui32>(docCount, 1),
+                    BinclassProbabilityBorder
+                );
+                resultProcessor.PostprocessBlock(0);
+            }
+
+        private:
+            TCOWTreeWrapper ObliviousTrees;
+            TAtomicSharedPtr<TCompiledModelLibrary> Library;
+            TModelEvaluatorPtr FallbackEvaluator;
+            EPredictionType PredictionType = EPredictionType::RawFormulaVal;
+            bool HasFeatureLayout = false;
+            TMaybe<double> BinclassProbabilityBorder;
+        };
+    }
+
+    TModelEvaluatorPtr CreateCompiledEvaluator(const TFullModel& model, const TString& libraryPath) {
+        CB_ENSURE(
+            !model.HasCategoricalFeatures() && model.ObliviousTrees->ApproxDimension == 1 && model.IsOblivious(),
+            "Only oblivious models with float features and one dimensional approx can be compiled"
+        );
+        return new NDetail::TCompiledEvaluator(model, libraryPath);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <catboost/libs/model/fwd.h>
+
+#include <util/system/types.h>
+
+#include <cstddef>
+
+/**
+ * Interface between CatBoost and shared objects built from models exported in EModelType::CppCompiled format.
+ * Generated code declares these functions with C linkage.
+ */
+namespace NCB::NModelEvaluation {
+    constexpr ui32 COMPILED_MODEL_ABI_VERSION = 1;
+
+    constexpr const char* COMPILED_MODEL_ABI_VERSION_SYMBOL = "CatboostCompiledModelAbiVersion";
+    constexpr const char* COMPILED_MODEL_CHECKSUM_SYMBOL = "CatboostCompiledModelChecksum";
+    constexpr const char* COMPILED_MODEL_FLAT_FEATURE_COUNT_SYMBOL = "CatboostCompiledModelFlatFeatureCount";
+    constexpr const char* COMPILED_MODEL_CALC_SYMBOL = "CatboostCompiledModelCalc";
+
+    using TCompiledModelAbiVersionFunction = unsigned int (*)();
+    using TCompiledModelChecksumFunction = unsigned long long (*)();
+    using TCompiledModelFlatFeatureCountFunction = size_t (*)();
+
+    /**
+     * Calculates raw formula values for docCount documents.
+     * If isTransposed == 0 features[docId][flatFeatureIdx] is used, otherwise features[flatFeatureIdx][docId].
+     */
+    using TCompiledModelCalcFunction = void (*)(
+        const float* const* features,
+        size_t docCount,
+        int isTransposed,
+        double* results);
+
+    /**
+     * Checksum of trees structure, borders and leaf values, used to check that shared object is built from the same model
+     */
+    ui64 CalcCompiledModelChecksum(const TObliviousTrees& trees);
+}
@@ -0,0 +1,23 @@
+#include "evaluation_workspace.h"
+#include "quantization.h"
+
+#include <catboost/libs/model/model.h>
+
+#include <util/thread/singleton.h>
+
+namespace NCB::NModelEvaluation {
+
+    void TCPUEvaluatorWorkspace::Reserve(const TObliviousTrees& trees, size_t blockSize) {
+        blockSize = Min(blockSize, FORMULA_EVALUATION_BLOCK_SIZE);
+        GetQuantizedDataBuffer(blockSize * trees.GetEffectiveBinaryFeaturesBucketsCount());
+        GetTransposedHashBuffer(blockSize * trees.GetUsedCatFeaturesCount());
+        GetCtrsBuffer(blockSize * trees.GetUsedModelCtrs().size());
+        GetIndexesBuffer(blockSize);
+        GetTransposedLeafIndexesBuffer(blockSize * trees.GetTreeCount());
+        GetIntermediateResultsBuffer(blockSize * trees.ApproxDimension);
+    }
+
+    TCPUEvaluatorWorkspace& GetThreadLocalCPUEvaluatorWorkspace() {
+        return *FastTlsSingleton<TCPUEvaluatorWorkspace>();
+    }
+}
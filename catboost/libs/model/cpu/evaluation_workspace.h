@@ -0,0 +1,102 @@
+#pragma once
+
+#include <catboost/libs/model/fwd.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NCB::NModelEvaluation {
+
+    /**
+     * Reusable scratch buffers for CPU model evaluation.
+     * Buffers only grow, so after the first evaluation of the largest batch no further heap allocations
+     *  are made through the workspace.
+     * Workspace is not thread safe, CPU evaluator uses one per thread (see GetThreadLocalCPUEvaluatorWorkspace).
+     */
+    class TCPUEvaluatorWorkspace {
+    public:
+        TArrayRef<ui8> GetQuantizedDataBuffer(size_t size) {
+            return GetBuffer(&QuantizedData, size);
+        }
+
+        TArrayRef<ui32> GetTransposedHashBuffer(size_t size) {
+            return GetBuffer(&TransposedHash, size);
+        }
+
+        TArrayRef<float> GetCtrsBuffer(size_t size) {
+            return GetBuffer(&Ctrs, size);
+        }
+
+        TArrayRef<TCalcerIndexType> GetIndexesBuffer(size_t size) {
+            return GetBuffer(&Indexes, size);
+        }
+
+        TArrayRef<TCalcerIndexType> GetTransposedLeafIndexesBuffer(size_t size) {
+            return GetBuffer(&TransposedLeafIndexes, size);
+        }
+
+        TArrayRef<double> GetIntermediateResultsBuffer(size_t size) {
+            return GetBuffer(&IntermediateResults, size);
+        }
+
+        TArrayRef<TConstArrayRef<float>> GetFloatFeatureRefsBuffer(size_t size) {
+            return GetBuffer(&FloatFeatureRefs, size);
+        }
+
+        TArrayRef<TConstArrayRef<TStringBuf>> GetCatFeatureRefsBuffer(size_t size) {
+            return GetBuffer(&CatFeatureRefs, size);
+        }
+
+        TArrayRef<ui8> GetCascadeQuantizedDataBuffer(size_t size) {
+            return GetBuffer(&CascadeQuantizedData, size);
+        }
+
+        TArrayRef<ui32> GetCascadeDocIdsBuffer(size_t size) {
+            return GetBuffer(&CascadeDocIds, size);
+        }
+
+        TArrayRef<double> GetCascadeBoundsBuffer(size_t size) {
+            return GetBuffer(&CascadeBounds, size);
+        }
+
+        /**
+         * Preallocate all buffers needed to evaluate `trees` on blocks of `blockSize` documents
+         */
+        void Reserve(const TObliviousTrees& trees, size_t blockSize);
+
+        /**
+         * How many times buffers were (re)allocated. Stays constant in steady state.
+         */
+        size_t GetAllocationCount() const {
+            return AllocationCount;
+        }
+
+    private:
+        template <typename T>
+        TArrayRef<T> GetBuffer(TVector<T>* buffer, size_t size) {
+            if (buffer->size() < size) {
+                buffer->yresize(size);
+                ++AllocationCount;
+            }
+            return MakeArrayRef(buffer->data(), size);
+        }
+
+    private:
+        TVector<ui8> QuantizedData;
+        TVector<ui32> TransposedHash;
+        TVector<float> Ctrs;
+        TVector<TCalcerIndexType> Indexes;
+        TVector<TCalcerIndexType> TransposedLeafIndexes;
+        TVector<double> IntermediateResults;
+        TVector<TConstArrayRef<float>> FloatFeatureRefs;
+        TVector<TConstArrayRef<TStringBuf>> CatFeatureRefs;
+        TVector<ui8> CascadeQuantizedData;
+        TVector<ui32> CascadeDocIds;
+        TVector<double> CascadeBounds;
+        size_t AllocationCount = 0;
+    };
+
+    TCPUEvaluatorWorkspace& GetThreadLocalCPUEvaluatorWorkspace();
+}
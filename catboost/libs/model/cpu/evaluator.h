@@ -1,5 +1,6 @@
 #pragma once
 
+#include "evaluation_workspace.h"
 #include "quantization.h"
 
 #include <util/generic/utility.h>
@@ -51,7 +52,8 @@ namespace NCB::NModelEvaluation {
         size_t docCount,
         size_t blockSize,
         TFunctor callback,
-        const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+        TCPUEvaluatorWorkspace* workspace
     ) {
         const size_t binSlots = blockSize * trees.GetEffectiveBinaryFeaturesBucketsCount();
 
@@ -60,13 +62,12 @@ namespace NCB::NModelEvaluation {
             quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
                 MakeArrayRef(GetAligned((ui8*)(alloca(binSlots + 0x20))), binSlots));
         } else {
-            TVector<ui8> binFeaturesHolder;
-            binFeaturesHolder.yresize(binSlots);
-            quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateOwning(std::move(binFeaturesHolder));
+            quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                workspace->GetQuantizedDataBuffer(binSlots));
         }
         if constexpr (!isQuantizedFeaturesData) {
-            TVector<ui32> transposedHash(blockSize * trees.GetUsedCatFeaturesCount());
-            TVector<float> ctrs(trees.GetUsedModelCtrs().size() * blockSize);
+            auto transposedHash = workspace->GetTransposedHashBuffer(blockSize * trees.GetUsedCatFeaturesCount());
+            auto ctrs = workspace->GetCtrsBuffer(trees.GetUsedModelCtrs().size() * blockSize);
             for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
                 const auto docCountInBlock = Min(blockSize, docCount - blockStart);
                 BinarizeFeatures(
@@ -126,7 +127,8 @@ namespace NCB::NModelEvaluation {
         size_t treeStart,
         size_t treeEnd,
         TArrayRef<TCalcerIndexType> treeLeafIndexes,
-        const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+        TCPUEvaluatorWorkspace* workspace
     ) {
         Y_ASSERT(treeEnd >= treeStart);
         const size_t treeCount = treeEnd - treeStart;
@@ -154,12 +156,12 @@ namespace NCB::NModelEvaluation {
                         nullptr
                     );
                 },
-                featureInfo
+                featureInfo,
+                workspace
             );
             return;
         }
-        TVector<TCalcerIndexType> tmpLeafIndexHolder(blockSize * treeCount);
-        TCalcerIndexType* transposedLeafIndexesPtr = tmpLeafIndexHolder.data();
+        TCalcerIndexType* transposedLeafIndexesPtr = workspace->GetTransposedLeafIndexesBuffer(blockSize * treeCount).data();
         ProcessDocsInBlocks<IsQuantizedFeaturesData>(trees, ctrProvider, floatFeatureAccessor, catFeaturesAccessor,
                                                      docCount, blockSize,
                                                      [&](size_t docCountInBlock,
@@ -182,7 +184,8 @@ namespace NCB::NModelEvaluation {
                                                          );
                                                          indexesWritePtr += indexCountInBlock;
                                                      },
-                                                     featureInfo
+                                                     featureInfo,
+                                                     workspace
         );
     }
 }
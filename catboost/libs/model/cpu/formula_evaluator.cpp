@@ -3,8 +3,157 @@
 
 #include "evaluator.h"
 
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+
+#include <cstring>
+
 namespace NCB::NModelEvaluation {
     namespace NDetail {
+        /**
+         * Settings of cascade evaluation for binary classification with EPredictionType::Class.
+         * Trees are applied in blocks of TreeBlockSize, after each block documents whose decision can't be
+         *  changed by the remaining trees (according to per-tree leaf value bounds) are excluded from evaluation.
+         */
+        struct TCascadeEvaluationParams {
+            size_t TreeBlockSize = 0;
+            TVector<double> TreeMinLeafValues;
+            TVector<double> TreeMaxLeafValues;
+        };
+
+        // relative slack that covers difference in floating point summation order
+        constexpr double CASCADE_BOUND_RELATIVE_SLACK = 1e-9;
+
+        template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+        inline void CalcCascadeGeneric(
+            const TObliviousTrees& trees,
+            const TIntrusivePtr<ICtrProvider>& ctrProvider,
+            TFloatFeatureAccessor floatFeatureAccessor,
+            TCatFeatureAccessor catFeaturesAccessor,
+            size_t docCount,
+            size_t treeStart,
+            size_t treeEnd,
+            const TCascadeEvaluationParams& cascadeParams,
+            double rawValueBorder,
+            TArrayRef<double> results,
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        ) {
+            Y_ASSERT(trees.ApproxDimension == 1);
+            CB_ENSURE(results.size() >= docCount, "`results` size is insufficient: " << LabeledOutput(results.size(), docCount));
+            std::fill(results.begin(), results.end(), 0.0);
+            if (trees.GetTreeCount() == 0) {
+                return;
+            }
+            if (treeStart >= treeEnd) {
+                std::fill(results.begin(), results.begin() + docCount, double(0.0 > rawValueBorder));
+                return;
+            }
+            const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+            const size_t bucketCount = trees.GetEffectiveBinaryFeaturesBucketsCount();
+            // blocked implementation handles any number of documents, so it is used even when one document is left
+            auto calcTrees = GetCalcTreesFunction(trees, FORMULA_EVALUATION_BLOCK_SIZE);
+
+            TCPUEvaluatorWorkspace& workspace = GetThreadLocalCPUEvaluatorWorkspace();
+            auto indexesVec = workspace.GetIndexesBuffer(blockSize);
+            auto activeQuantizedData = workspace.GetCascadeQuantizedDataBuffer(blockSize * bucketCount);
+            auto docIds = workspace.GetCascadeDocIdsBuffer(2 * blockSize);
+            auto activeDocIds = docIds.first(blockSize);
+            auto keptPositions = docIds.Slice(blockSize, blockSize);
+            // leaf values are accumulated into sums between tree blocks, vectorized calcers expect aligned results
+            double* activeSums = GetAligned(workspace.GetIntermediateResultsBuffer(blockSize + 2).data());
+
+            // bounds of the sum of trees which are not applied yet after each tree block
+            const size_t treeBlockSize = cascadeParams.TreeBlockSize;
+            const size_t treeBlockCount = CeilDiv(treeEnd - treeStart, treeBlockSize);
+            auto bounds = workspace.GetCascadeBoundsBuffer(3 * (treeBlockCount + 1));
+            auto remainingMin = bounds.Slice(0, treeBlockCount + 1);
+            auto remainingMax = bounds.Slice(treeBlockCount + 1, treeBlockCount + 1);
+            auto remainingAbs = bounds.Slice(2 * (treeBlockCount + 1), treeBlockCount + 1);
+            remainingMin[treeBlockCount] = remainingMax[treeBlockCount] = remainingAbs[treeBlockCount] = 0.0;
+            for (size_t treeBlockId = treeBlockCount; treeBlockId > 0; --treeBlockId) {
+                double blockMin = 0.0;
+                double blockMax = 0.0;
+                double blockAbs = 0.0;
+                const size_t blockTreeStart = treeStart + (treeBlockId - 1) * treeBlockSize;
+                const size_t blockTreeEnd = Min(treeEnd, blockTreeStart + treeBlockSize);
+                for (size_t treeId = blockTreeStart; treeId < blockTreeEnd; ++treeId) {
+                    blockMin += cascadeParams.TreeMinLeafValues[treeId];
+                    blockMax += cascadeParams.TreeMaxLeafValues[treeId];
+                    blockAbs += Max(Abs(cascadeParams.TreeMinLeafValues[treeId]), Abs(cascadeParams.TreeMaxLeafValues[treeId]));
+                }
+                remainingMin[treeBlockId - 1] = remainingMin[treeBlockId] + blockMin;
+                remainingMax[treeBlockId - 1] = remainingMax[treeBlockId] + blockMax;
+                remainingAbs[treeBlockId - 1] = remainingAbs[treeBlockId] + blockAbs;
+            }
+
+            size_t blockStart = 0;
+            ProcessDocsInBlocks(
+                trees,
+                ctrProvider,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                docCount,
+                blockSize,
+                [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                    memcpy(activeQuantizedData.data(), quantizedData->QuantizedData.data(), bucketCount * docCountInBlock);
+                    TCPUEvaluatorQuantizedData activeData;
+                    activeData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(activeQuantizedData);
+                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                        activeDocIds[docId] = docId;
+                        activeSums[docId] = 0.0;
+                    }
+                    double* blockResults = results.data() + blockStart;
+                    size_t activeCount = docCountInBlock;
+                    for (size_t treeBlockId = 0; treeBlockId < treeBlockCount && activeCount > 0; ++treeBlockId) {
+                        const size_t blockTreeStart = treeStart + treeBlockId * treeBlockSize;
+                        calcTrees(
+                            trees,
+                            &activeData,
+                            activeCount,
+                            indexesVec.data(),
+                            blockTreeStart,
+                            Min(treeEnd, blockTreeStart + treeBlockSize),
+                            activeSums
+                        );
+                        const double restMin = remainingMin[treeBlockId + 1];
+                        const double restMax = remainingMax[treeBlockId + 1];
+                        size_t keptCount = 0;
+                        for (size_t position = 0; position < activeCount; ++position) {
+                            const double sum = activeSums[position];
+                            const double slack = CASCADE_BOUND_RELATIVE_SLACK * (Abs(sum) + remainingAbs[treeBlockId + 1]);
+                            if (sum + restMin - slack > rawValueBorder) {
+                                blockResults[activeDocIds[position]] = 1.0;
+                            } else if (sum + restMax + slack < rawValueBorder) {
+                                blockResults[activeDocIds[position]] = 0.0;
+                            } else {
+                                activeDocIds[keptCount] = activeDocIds[position];
+                                activeSums[keptCount] = sum;
+                                keptPositions[keptCount] = position;
+                                ++keptCount;
+                            }
+                        }
+                        if (keptCount != 0 && keptCount != activeCount) {
+                            // compaction is done in place: destination offset never exceeds source offset
+                            ui8* data = activeQuantizedData.data();
+                            for (size_t bucketId = 0; bucketId < bucketCount; ++bucketId) {
+                                for (size_t position = 0; position < keptCount; ++position) {
+                                    data[bucketId * keptCount + position] = data[bucketId * activeCount + keptPositions[position]];
+                                }
+                            }
+                        }
+                        activeCount = keptCount;
+                    }
+                    for (size_t position = 0; position < activeCount; ++position) {
+                        blockResults[activeDocIds[position]] = activeSums[position] > rawValueBorder;
+                    }
+                    blockStart += docCountInBlock;
+                },
+                featureInfo,
+                &workspace
+            );
+        }
+
         template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
         inline void CalcGeneric(
             const TObliviousTrees& trees,
@@ -16,21 +165,42 @@ namespace NCB::NModelEvaluation {
             size_t treeEnd,
             EPredictionType predictionType,
             TArrayRef<double> results,
-            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr,
+            TMaybe<double> binclassProbabilityBorder = Nothing(),
+            const TCascadeEvaluationParams* cascadeParams = nullptr
         ) {
+            if (cascadeParams && predictionType == EPredictionType::Class && trees.ApproxDimension == 1) {
+                CalcCascadeGeneric(
+                    trees,
+                    ctrProvider,
+                    floatFeatureAccessor,
+                    catFeaturesAccessor,
+                    docCount,
+                    treeStart,
+                    treeEnd,
+                    *cascadeParams,
+                    binclassProbabilityBorder.Defined() ? CalcBinclassRawValueBorder(*binclassProbabilityBorder) : 0.0,
+                    results,
+                    featureInfo
+                );
+                return;
+            }
             const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
             auto calcTrees = GetCalcTreesFunction(trees, blockSize);
             std::fill(results.begin(), results.end(), 0.0);
             if (trees.GetTreeCount() == 0) {
                 return;
             }
-            TVector<TCalcerIndexType> indexesVec(blockSize);
+            TCPUEvaluatorWorkspace& workspace = GetThreadLocalCPUEvaluatorWorkspace();
+            auto indexesVec = workspace.GetIndexesBuffer(blockSize);
             TEvalResultProcessor resultProcessor(
                 docCount,
                 results,
                 predictionType,
                 trees.ApproxDimension,
-                blockSize
+                blockSize,
+                binclassProbabilityBorder,
+                workspace.GetIntermediateResultsBuffer(blockSize * trees.ApproxDimension)
             );
             ui32 blockId = 0;
             ProcessDocsInBlocks(
@@ -54,7 +224,8 @@ namespace NCB::NModelEvaluation {
                     resultProcessor.PostprocessBlock(blockId);
                     ++blockId;
                 },
-                featureInfo
+                featureInfo,
+                &workspace
             );
         }
 
@@ -89,9 +260,22 @@ namespace NCB::NModelEvaluation {
                 return ObliviousTrees->ApproxDimension;
             }
 
+            /**
+             * Supported properties:
+             *  BinclassProbabilityBorder - probability border for EPredictionType::Class of binary classifiers
+             *  CascadeTreeBlockSize - enable cascade evaluation of EPredictionType::Class for binary classifiers
+             *   with bounds check after every given number of trees, 0 disables it
+             */
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                CB_ENSURE(false, "CPU evaluator don't have any properties. Got: " << propName);
-                Y_UNUSED(propValue);
+                if (propName == TStringBuf("BinclassProbabilityBorder")) {
+                    const double border = FromString<double>(propValue);
+                    CalcBinclassRawValueBorder(border); // validate
+                    BinclassProbabilityBorder = border;
+                } else if (propName == TStringBuf("CascadeTreeBlockSize")) {
+                    SetCascadeTreeBlockSize(FromString<size_t>(propValue));
+                } else {
+                    CB_ENSURE(false, "CPU evaluator don't have property " << propName);
+                }
             }
 
             void CalcFlatTransposed(
@@ -150,7 +334,9 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
                 );
             }
 
@@ -192,7 +378,9 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
                 );
             }
 
@@ -224,10 +412,78 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
                 );
             }
 
+            void CalcFlatSparse(
+                const TCSRFlatFeaturesRef& features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                CB_ENSURE(
+                    !featureInfo && !ExtFeatureLayout.Defined(),
+                    "Feature layout is not supported for sparse input"
+                );
+                CB_ENSURE(
+                    ObliviousTrees->GetUsedCatFeaturesCount() == 0,
+                    "Sparse input is not supported for models with categorical features"
+                );
+                const size_t docCount = features.GetDocCount();
+                CB_ENSURE(
+                    features.FlatFeatureIndexes.size() == features.Values.size(),
+                    "CSR feature indexes and values should have equal sizes: "
+                    << LabeledOutput(features.FlatFeatureIndexes.size(), features.Values.size())
+                );
+                CB_ENSURE(
+                    docCount == 0 || features.RowOffsets.back() <= features.Values.size(),
+                    "CSR row offsets are out of range of values"
+                );
+                const auto& trees = *ObliviousTrees;
+                const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+                auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+                std::fill(results.begin(), results.end(), 0.0);
+                if (trees.GetTreeCount() == 0) {
+                    return;
+                }
+                TCPUEvaluatorWorkspace& workspace = GetThreadLocalCPUEvaluatorWorkspace();
+                auto indexesVec = workspace.GetIndexesBuffer(blockSize);
+                TCPUEvaluatorQuantizedData quantizedData;
+                quantizedData.QuantizedData = TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                    workspace.GetQuantizedDataBuffer(blockSize * trees.GetEffectiveBinaryFeaturesBucketsCount())
+                );
+                TEvalResultProcessor resultProcessor(
+                    docCount,
+                    results,
+                    PredictionType,
+                    trees.ApproxDimension,
+                    blockSize,
+                    BinclassProbabilityBorder,
+                    workspace.GetIntermediateResultsBuffer(blockSize * trees.ApproxDimension)
+                );
+                ui32 blockId = 0;
+                for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
+                    const auto docCountInBlock = Min(blockSize, docCount - blockStart);
+                    BinarizeSparseFloatFeatures(trees, features, blockStart, blockStart + docCountInBlock, &quantizedData);
+                    auto blockResultsView = resultProcessor.GetViewForRawEvaluation(blockId);
+                    calcTrees(
+                        trees,
+                        &quantizedData,
+                        docCountInBlock,
+                        docCount == 1 ? nullptr : indexesVec.data(),
+                        treeStart,
+                        treeEnd,
+                        blockResultsView.data()
+                    );
+                    resultProcessor.PostprocessBlock(blockId);
+                    ++blockId;
+                }
+            }
+
             void Calc(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                 TConstArrayRef<TConstArrayRef<int>> catFeatures,
@@ -255,7 +511,9 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
                 );
             }
 
@@ -286,8 +544,46 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
+                );
+            }
+
+            void CalcTransposed(
+                TConstArrayRef<TConstArrayRef<float>> transposedFloatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> transposedHashedCatFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!featureInfo) {
+                    featureInfo = ExtFeatureLayout.Get();
+                }
+                const size_t docCount = ValidateTransposedInputFeatures(
+                    transposedFloatFeatures,
+                    transposedHashedCatFeatures,
                     featureInfo
                 );
+                CalcGeneric(
+                    *ObliviousTrees,
+                    CtrProvider,
+                    [&transposedFloatFeatures](TFeaturePosition position, size_t index) -> float {
+                        return transposedFloatFeatures[position.Index][index];
+                    },
+                    [&transposedHashedCatFeatures](TFeaturePosition position, size_t index) -> int {
+                        return transposedHashedCatFeatures[position.Index][index];
+                    },
+                    docCount,
+                    treeStart,
+                    treeEnd,
+                    PredictionType,
+                    results,
+                    featureInfo,
+                    BinclassProbabilityBorder,
+                    GetCascadeParams()
+                );
             }
 
             void CalcLeafIndexesSingle(
@@ -315,7 +611,8 @@ namespace NCB::NModelEvaluation {
                     treeStart,
                     treeEnd,
                     indexes,
-                    featureInfo
+                    featureInfo,
+                    &GetThreadLocalCPUEvaluatorWorkspace()
                 );
             }
 
@@ -346,7 +643,8 @@ namespace NCB::NModelEvaluation {
                     treeStart,
                     treeEnd,
                     indexes,
-                    featureInfo
+                    featureInfo,
+                    &GetThreadLocalCPUEvaluatorWorkspace()
                 );
             }
             void Calc(
@@ -370,7 +668,7 @@ namespace NCB::NModelEvaluation {
                     false
                 );
                 CB_ENSURE(results.size() == ObliviousTrees->ApproxDimension * cpuQuantizedFeatures->ObjectsCount);
-                TVector<TCalcerIndexType> indexesVec(subBlockSize);
+                auto indexesVec = GetThreadLocalCPUEvaluatorWorkspace().GetIndexesBuffer(subBlockSize);
                 double* resultPtr = results.data();
                 for (size_t blockId = 0; blockId < cpuQuantizedFeatures->BlocksCount; ++blockId) {
                     auto subBlock = cpuQuantizedFeatures->ExtractBlock(blockId);
@@ -421,6 +719,55 @@ namespace NCB::NModelEvaluation {
             }
 
         private:
+            void SetCascadeTreeBlockSize(size_t treeBlockSize) {
+                if (treeBlockSize == 0) {
+                    CascadeParams = TCascadeEvaluationParams();
+                    return;
+                }
+                CB_ENSURE(
+                    ObliviousTrees->ApproxDimension == 1,
+                    "Cascade evaluation is supported only for models with one dimensional approx"
+                );
+                // tree blocks are aligned by 4 to keep summation order of vectorized leaf values calculation
+                CascadeParams.TreeBlockSize = (treeBlockSize + 3) & ~size_t(3);
+                const size_t treeCount = ObliviousTrees->GetTreeCount();
+                const auto& firstLeafOffsets = ObliviousTrees->GetFirstLeafOffsets();
+                CascadeParams.TreeMinLeafValues.yresize(treeCount);
+                CascadeParams.TreeMaxLeafValues.yresize(treeCount);
+                for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                    const size_t leafBegin = firstLeafOffsets[treeId];
+                    const size_t leafEnd = treeId + 1 == treeCount ? ObliviousTrees->LeafValues.size() : firstLeafOffsets[treeId + 1];
+                    const auto leafValues = MakeArrayRef(ObliviousTrees->LeafValues.data() + leafBegin, leafEnd - leafBegin);
+                    CascadeParams.TreeMinLeafValues[treeId] = *MinElement(leafValues.begin(), leafValues.end());
+                    CascadeParams.TreeMaxLeafValues[treeId] = *MaxElement(leafValues.begin(), leafValues.end());
+                }
+            }
+
+            const TCascadeEvaluationParams* GetCascadeParams() const {
+                return CascadeParams.TreeBlockSize != 0 ? &CascadeParams : nullptr;
+            }
+
+            // minimal float and categorical feature counts to be passed for every document
+            std::pair<size_t, size_t> GetMinimalSufficientFeatureCounts(const TFeatureLayout* featureInfo) const {
+                size_t minimalSufficientFloatFeatureCount = ObliviousTrees->GetMinimalSufficientFloatFeaturesVectorSize();
+                if (featureInfo && featureInfo->FloatFeatureIndexes.Defined()) {
+                    CB_ENSURE(featureInfo->FloatFeatureIndexes->size() >= minimalSufficientFloatFeatureCount);
+                    minimalSufficientFloatFeatureCount = *MaxElement(
+                        featureInfo->FloatFeatureIndexes->begin(),
+                        featureInfo->FloatFeatureIndexes->end()
+                    );
+                }
+                size_t minimalSufficientCatFeatureCount = ObliviousTrees->GetMinimalSufficientCatFeaturesVectorSize();
+                if (featureInfo && featureInfo->CatFeatureIndexes.Defined()) {
+                    CB_ENSURE(featureInfo->CatFeatureIndexes->size() >= minimalSufficientCatFeatureCount);
+                    minimalSufficientCatFeatureCount = *MaxElement(
+                        featureInfo->CatFeatureIndexes->begin(),
+                        featureInfo->CatFeatureIndexes->end()
+                    );
+                }
+                return {minimalSufficientFloatFeatureCount, minimalSufficientCatFeatureCount};
+            }
+
             template <typename TCatFeatureContainer = TConstArrayRef<int>>
             void ValidateInputFeatures(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
@@ -438,14 +785,8 @@ namespace NCB::NModelEvaluation {
                     ObliviousTrees->GetUsedCatFeaturesCount() == 0 || !catFeatures.empty(),
                     "Model has categorical features but no categorical features provided"
                 );
-                size_t minimalSufficientFloatFeatureCount = ObliviousTrees->GetMinimalSufficientFloatFeaturesVectorSize();
-                if (featureInfo && featureInfo->FloatFeatureIndexes.Defined()) {
-                    CB_ENSURE(featureInfo->FloatFeatureIndexes->size() >= minimalSufficientFloatFeatureCount);
-                    minimalSufficientFloatFeatureCount = *MaxElement(
-                        featureInfo->FloatFeatureIndexes->begin(),
-                        featureInfo->FloatFeatureIndexes->end()
-                    );
-                }
+                const auto [minimalSufficientFloatFeatureCount, minimalSufficientCatFeatureCount]
+                    = GetMinimalSufficientFeatureCounts(featureInfo);
                 for (const auto& floatFeaturesVec : floatFeatures) {
                     CB_ENSURE(
                         floatFeaturesVec.size() >= minimalSufficientFloatFeatureCount,
@@ -453,14 +794,6 @@ namespace NCB::NModelEvaluation {
                         << " expected: " << minimalSufficientFloatFeatureCount
                     );
                 }
-                size_t minimalSufficientCatFeatureCount = ObliviousTrees->GetMinimalSufficientCatFeaturesVectorSize();
-                if (featureInfo && featureInfo->CatFeatureIndexes.Defined()) {
-                    CB_ENSURE(featureInfo->CatFeatureIndexes->size() >= minimalSufficientCatFeatureCount);
-                    minimalSufficientCatFeatureCount = *MaxElement(
-                        featureInfo->CatFeatureIndexes->begin(),
-                        featureInfo->CatFeatureIndexes->end()
-                    );
-                }
                 for (const auto& catFeaturesVec : catFeatures) {
                     CB_ENSURE(
                         catFeaturesVec.size() >= minimalSufficientCatFeatureCount,
@@ -469,11 +802,53 @@ namespace NCB::NModelEvaluation {
                     );
                 }
             }
+
+            // same checks as ValidateInputFeatures for [featureIdx][docIdx] layout, returns document count
+            size_t ValidateTransposedInputFeatures(
+                TConstArrayRef<TConstArrayRef<float>> transposedFloatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> transposedHashedCatFeatures,
+                const TFeatureLayout* featureInfo
+            ) const {
+                const auto [minimalSufficientFloatFeatureCount, minimalSufficientCatFeatureCount]
+                    = GetMinimalSufficientFeatureCounts(featureInfo);
+                CB_ENSURE(
+                    ObliviousTrees->GetUsedFloatFeaturesCount() == 0 ||
+                        transposedFloatFeatures.size() >= minimalSufficientFloatFeatureCount,
+                    "insufficient float features count: " << transposedFloatFeatures.size()
+                    << " expected: " << minimalSufficientFloatFeatureCount
+                );
+                CB_ENSURE(
+                    ObliviousTrees->GetUsedCatFeaturesCount() == 0 ||
+                        transposedHashedCatFeatures.size() >= minimalSufficientCatFeatureCount,
+                    "insufficient cat features count: " << transposedHashedCatFeatures.size()
+                    << " expected: " << minimalSufficientCatFeatureCount
+                );
+                TMaybe<size_t> docCount;
+                auto checkColumnSize = [&docCount] (size_t columnSize) {
+                    if (!docCount.Defined()) {
+                        docCount = columnSize;
+                    }
+                    CB_ENSURE(
+                        *docCount == columnSize,
+                        "all feature columns must have the same size: " << LabeledOutput(*docCount, columnSize)
+                    );
+                };
+                for (const auto& column : transposedFloatFeatures) {
+                    checkColumnSize(column.size());
+                }
+                for (const auto& column : transposedHashedCatFeatures) {
+                    checkColumnSize(column.size());
+                }
+                CB_ENSURE(docCount.Defined(), "couldn't determine document count: no feature columns provided");
+                return *docCount;
+            }
         private:
             TCOWTreeWrapper ObliviousTrees;
             const TIntrusivePtr<ICtrProvider> CtrProvider;
             EPredictionType PredictionType = EPredictionType::RawFormulaVal;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
+            TMaybe<double> BinclassProbabilityBorder;
+            TCascadeEvaluationParams CascadeParams;
         };
     }
     TModelEvaluatorPtr CreateCpuEvaluator(const TFullModel& model) {
@@ -8,10 +8,13 @@
 
 #include <library/sse/sse.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/hash.h>
 #include <util/generic/ymath.h>
 
+#include <cstring>
+
 namespace NCB::NModelEvaluation {
     constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
 
@@ -53,13 +56,14 @@ namespace NCB::NModelEvaluation {
 
     inline void OneHotBinsFromTransposedCatFeatures(
         const TConstArrayRef<TOneHotFeature> OneHotFeatures,
-        const THashMap<int, int> catFeaturePackedIndex,
+        const TConstArrayRef<int> catFeaturePackedIndex,
         const size_t docCount,
         TArrayRef<ui32> transposedHash,
         ui8*& result
     ) {
         for (const auto& oheFeature : OneHotFeatures) {
-            const auto catIdx = catFeaturePackedIndex.at(oheFeature.CatFeatureIndex);
+            const auto catIdx = catFeaturePackedIndex[oheFeature.CatFeatureIndex];
+            Y_ASSERT(catIdx >= 0);
             for (size_t docId = 0; docId < docCount; ++docId) {
                 static_assert(sizeof(int) >= sizeof(i32));
                 const int val = *reinterpret_cast<i32*>(&(transposedHash[catIdx * docCount + docId]));
@@ -333,13 +337,11 @@ namespace NCB::NModelEvaluation {
                 }
             }
             if (trees.GetUsedCatFeaturesCount() != 0) {
-                THashMap<int, int> catFeaturePackedIndexes;
                 int usedFeatureIdx = 0;
                 for (const auto& catFeature : trees.CatFeatures) {
                     if (!catFeature.UsedInModel) {
                         continue;
                     }
-                    catFeaturePackedIndexes[catFeature.Position.Index] = usedFeatureIdx;
                     TFeaturePosition position = catFeature.Position;
                     if (featureInfo) {
                         position = featureInfo->AdjustFeature(catFeature);
@@ -354,7 +356,7 @@ namespace NCB::NModelEvaluation {
                 Y_ASSERT(trees.GetUsedCatFeaturesCount() == (size_t)usedFeatureIdx);
                 OneHotBinsFromTransposedCatFeatures(
                     trees.OneHotFeatures,
-                    catFeaturePackedIndexes,
+                    trees.GetUsedCatFeaturesPackedIndexes(),
                     docCount,
                     transposedHash,
                     resultPtr
@@ -422,4 +424,61 @@ namespace NCB::NModelEvaluation {
             ++cpuEvaluatorQuantizedData->BlocksCount;
         }
     }
+
+/**
+* This function is for sparse input of models without categorical features.
+* Bucket stripes are filled with precomputed bins of zero value, then only listed values are binarized.
+*/
+    inline void BinarizeSparseFloatFeatures(
+        const TObliviousTrees& trees,
+        const TCSRFlatFeaturesRef& features,
+        size_t start,
+        size_t end,
+        TCPUEvaluatorQuantizedData* cpuEvaluatorQuantizedData
+    ) {
+        Y_ASSERT(trees.GetUsedCatFeaturesCount() == 0);
+        Y_ASSERT(end - start <= FORMULA_EVALUATION_BLOCK_SIZE);
+        const size_t docCount = end - start;
+        const auto zeroValueBins = trees.GetFloatFeaturesZeroValueBins();
+        ui8* resultPtr = cpuEvaluatorQuantizedData->QuantizedData.data();
+        CB_ENSURE(
+            cpuEvaluatorQuantizedData->QuantizedData.GetSize() >= zeroValueBins.size() * docCount,
+            "No enough space to store quantized data for evaluator"
+        );
+        cpuEvaluatorQuantizedData->BlockStride =
+            trees.GetEffectiveBinaryFeaturesBucketsCount() * FORMULA_EVALUATION_BLOCK_SIZE;
+        cpuEvaluatorQuantizedData->BlocksCount = 1;
+        cpuEvaluatorQuantizedData->ObjectsCount = docCount;
+        for (size_t bucketIdx = 0; bucketIdx < zeroValueBins.size(); ++bucketIdx) {
+            memset(resultPtr + bucketIdx * docCount, zeroValueBins[bucketIdx], docCount);
+        }
+        const auto usedFloatFeaturesIdxByFlatIndex = trees.GetUsedFloatFeaturesIdxByFlatIndex();
+        const auto floatFeaturesFirstBucket = trees.GetFloatFeaturesFirstBucket();
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            for (size_t valueIdx = features.RowOffsets[start + docId]; valueIdx < features.RowOffsets[start + docId + 1]; ++valueIdx) {
+                const ui32 flatIndex = features.FlatFeatureIndexes[valueIdx];
+                if (flatIndex >= usedFloatFeaturesIdxByFlatIndex.size() || usedFloatFeaturesIdxByFlatIndex[flatIndex] < 0) {
+                    continue;
+                }
+                const int floatFeatureIdx = usedFloatFeaturesIdxByFlatIndex[flatIndex];
+                const auto& floatFeature = trees.FloatFeatures[floatFeatureIdx];
+                const auto& borders = floatFeature.Borders;
+                const float value = features.Values[valueIdx];
+                // number of borders less than value, i.e. the bin over all buckets of the feature
+                size_t bin = 0;
+                if (IsNan(value)) {
+                    if (floatFeature.HasNans && floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue) {
+                        bin = borders.size();
+                    }
+                } else {
+                    bin = LowerBound(borders.begin(), borders.end(), value) - borders.begin();
+                }
+                ui8* writePtr = resultPtr + floatFeaturesFirstBucket[floatFeatureIdx] * docCount + docId;
+                for (size_t bucketStart = 0; bucketStart < borders.size(); bucketStart += MAX_VALUES_PER_BIN) {
+                    *writePtr = bin > bucketStart ? Min<size_t>(bin - bucketStart, MAX_VALUES_PER_BIN) : 0;
+                    writePtr += docCount;
+                }
+            }
+        }
+    }
 }
@@ -3,6 +3,8 @@
 #include "flatbuffers_serializer_helper.h"
 #include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/stream/input.h>
@@ -11,41 +13,44 @@
 #include <util/ysaveload.h>
 
 
-void TCtrValueTable::Save(IOutputStream* s) const {
+void TCtrValueTable::SaveFlatbuffer(size_t dataAlignment, IOutputStream* s, bool withSizePrefix) const {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
     TModelPartsCachingSerializer serializer;
-    if (HoldsAlternative<TSolidTable>(Impl)) {
-        auto& solid = Get<TSolidTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) solid.IndexBuckets.data(),
-                                                sizeof(NCatboost::TBucket) * solid.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
-        auto ctrValueTable = CreateTCtrValueTable(
-            serializer.FlatbufBuilder,
-            serializer.GetOffset(ModelCtrBase),
-            indexHashOffset,
-            ctrBlob,
-            CounterDenominator,
-            TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
-    } else {
-        auto& thin = Get<TThinTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) thin.IndexBuckets.data(),
-                                                sizeof(NCatboost::TBucket) * thin.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(thin.CTRBlob.data(), thin.CTRBlob.size());
-        auto ctrValueTable = CreateTCtrValueTable(
-            serializer.FlatbufBuilder,
-            serializer.GetOffset(ModelCtrBase),
-            indexHashOffset,
-            ctrBlob,
-            CounterDenominator,
-            TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
+    const auto indexBuckets = GetIndexHashViewer().GetBuckets();
+    const auto ctrBlob = GetTypedArrayRefForBlobData<ui8>();
+
+    const size_t indexHashSize = sizeof(NCatboost::TBucket) * indexBuckets.size();
+    if (dataAlignment) {
+        serializer.FlatbufBuilder.ForceVectorAlignment(indexHashSize, sizeof(ui8), dataAlignment);
+    }
+    auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*)indexBuckets.data(), indexHashSize);
+    if (dataAlignment) {
+        serializer.FlatbufBuilder.ForceVectorAlignment(ctrBlob.size(), sizeof(ui8), dataAlignment);
+    }
+    auto ctrBlobOffset = serializer.FlatbufBuilder.CreateVector(ctrBlob.data(), ctrBlob.size());
+    auto ctrValueTable = CreateTCtrValueTable(
+        serializer.FlatbufBuilder,
+        serializer.GetOffset(ModelCtrBase),
+        indexHashOffset,
+        ctrBlobOffset,
+        CounterDenominator,
+        TargetClassesCount);
+    serializer.FlatbufBuilder.Finish(ctrValueTable);
+    if (withSizePrefix) {
+        SaveSize(s, serializer.FlatbufBuilder.GetSize());
     }
-    SaveSize(s, serializer.FlatbufBuilder.GetSize());
     s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
 }
 
+void TCtrValueTable::Save(IOutputStream* s) const {
+    SaveFlatbuffer(/*dataAlignment*/ 0, s, /*withSizePrefix*/ true);
+}
+
+void TCtrValueTable::SaveForThinLoad(IOutputStream* s) const {
+    SaveFlatbuffer(ThinDataAlignment, s, /*withSizePrefix*/ false);
+}
+
 void TCtrValueTable::Load(IInputStream* s) {
     const ui32 size = LoadSize(s);
     TArrayHolder<ui8> arrayHolder = new ui8[size];
@@ -68,3 +73,31 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(const void* buf, size_t length) {
+    CB_ENSURE(
+        reinterpret_cast<uintptr_t>(buf) % ThinDataAlignment == 0,
+        "CTR value table buffer is not aligned for thin load"
+    );
+    {
+        flatbuffers::Verifier verifier(static_cast<const ui8*>(buf), length);
+        CB_ENSURE(NCatBoostFbs::VerifyTCtrValueTableBuffer(verifier), "Flatbuffers CTR table verification failed");
+    }
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+
+    const auto* indexHashRaw = ctrValueTable->IndexHashRaw();
+    const auto* ctrBlob = ctrValueTable->CTRBlob();
+    CB_ENSURE(
+        reinterpret_cast<uintptr_t>(indexHashRaw->data()) % alignof(NCatboost::TBucket) == 0,
+        "CTR value table index hash is not aligned, table should be saved by SaveForThinLoad"
+    );
+    TThinTable thin;
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(indexHashRaw->data()),
+        indexHashRaw->size() / sizeof(NCatboost::TBucket));
+    thin.CTRBlob = MakeArrayRef(ctrBlob->data(), ctrBlob->size());
+    Impl = thin;
+}
@@ -45,9 +45,16 @@ public:
     {
     }
 
+    // solid and thin tables with the same data are equal
     bool operator==(const TCtrValueTable& other) const {
-        return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
-               std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
+        return std::tie(CounterDenominator, TargetClassesCount) ==
+               std::tie(other.CounterDenominator, other.TargetClassesCount) &&
+            (GetIndexHashViewer().GetBuckets() == other.GetIndexHashViewer().GetBuckets()) &&
+            (GetTypedArrayRefForBlobData<ui8>() == other.GetTypedArrayRefForBlobData<ui8>());
+    }
+
+    bool IsThin() const {
+        return HoldsAlternative<TThinTable>(Impl);
     }
 
     template <typename T>
@@ -100,10 +107,25 @@ public:
 
     void LoadSolid(void* buf, size_t length);
 
+    /* Table data is not copied: index hash and CTR blob are views of buf, so it must outlive the table.
+     * buf must be aligned by ThinDataAlignment and contain a table serialized by SaveForThinLoad.
+     */
+    void LoadThin(const void* buf, size_t length);
+
+    // Saves the table flatbuffer without size prefix, with index hash and CTR blob data aligned by
+    // ThinDataAlignment relative to the flatbuffer begin
+    void SaveForThinLoad(IOutputStream* s) const;
+
+    static constexpr size_t ThinDataAlignment = 16;
+
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
     int TargetClassesCount = 0;
+private:
+    // dataAlignment == 0 means default flatbuffers alignment of index hash and CTR blob data
+    void SaveFlatbuffer(size_t dataAlignment, IOutputStream* s, bool withSizePrefix) const;
+
 private:
     TVariant<TSolidTable, TThinTable> Impl;
 };
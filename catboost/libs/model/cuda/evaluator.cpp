@@ -233,6 +233,36 @@ namespace NCB::NModelEvaluation {
                 CalcFlat(floatFeatures, treeStart, treeEnd, results, featureLayout);
             }
 
+            void CalcFlatSparse(
+                const TCSRFlatFeaturesRef& features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                Y_UNUSED(features);
+                Y_UNUSED(treeStart);
+                Y_UNUSED(treeEnd);
+                Y_UNUSED(results);
+                Y_UNUSED(featureInfo);
+                ythrow yexception() << "Unimplemented on GPU";
+            }
+
+            void CalcTransposed(
+                TConstArrayRef<TConstArrayRef<float>> transposedFloatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> transposedHashedCatFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureLayout
+            ) const override {
+                CB_ENSURE(
+                    transposedHashedCatFeatures.empty(),
+                    "Cat features are not supported on GPU, should be empty"
+                );
+                CalcFlatTransposed(transposedFloatFeatures, treeStart, treeEnd, results, featureLayout);
+            }
+
             void Calc(
                 const IQuantizedData* quantizedFeatures,
                 size_t treeStart,
@@ -19,5 +19,6 @@ enum class EModelType {
     Json           /* "Json", "json"       */,
     Onnx           /* "Onnx", "onnx" */,
     Pmml           /* "PMML", "pmml" */,
-    CPUSnapshot    /* "CpuSnapshot" */
+    CPUSnapshot    /* "CpuSnapshot" */,
+    CppCompiled    /* "CppCompiled", "cpp_compiled" */
 };
@@ -7,7 +7,8 @@ NCB::NModelEvaluation::TEvalResultProcessor::TEvalResultProcessor(
     TArrayRef<double> results,
     NCB::NModelEvaluation::EPredictionType predictionType,
     ui32 approxDimension, ui32 blockSize,
-    TMaybe<double> binclassProbabilityBorder
+    TMaybe<double> binclassProbabilityBorder,
+    TArrayRef<double> intermediateBlockResultsBuffer
 )
     : Results(results)
     , PredictionType(predictionType)
@@ -20,12 +21,21 @@ NCB::NModelEvaluation::TEvalResultProcessor::TEvalResultProcessor(
         "`results` size is insufficient: " << LabeledOutput(Results.size(), resultApproxDimension, docCount * resultApproxDimension)
     );
     if (approxDimension > 1 && predictionType == EPredictionType::Class) {
-        IntermediateBlockResults.resize(blockSize * approxDimension);
+        const size_t intermediateBlockResultsSize = blockSize * approxDimension;
+        if (intermediateBlockResultsBuffer.size() >= intermediateBlockResultsSize) {
+            IntermediateBlockResults = intermediateBlockResultsBuffer.first(intermediateBlockResultsSize);
+        } else {
+            IntermediateBlockResultsHolder.resize(intermediateBlockResultsSize);
+            IntermediateBlockResults = IntermediateBlockResultsHolder;
+        }
     }
     if (binclassProbabilityBorder.Defined() && predictionType == EPredictionType::Class &&
         approxDimension == 1) {
-        double probabilityBorder = *binclassProbabilityBorder;
-        CB_ENSURE(probabilityBorder > 0 && probabilityBorder < 1, "probability border should be in (0;1)");
-        BinclassRawValueBorder = -log((1 / probabilityBorder) - 1);
+        BinclassRawValueBorder = CalcBinclassRawValueBorder(*binclassProbabilityBorder);
     }
 }
+
+double NCB::NModelEvaluation::CalcBinclassRawValueBorder(double probabilityBorder) {
+    CB_ENSURE(probabilityBorder > 0 && probabilityBorder < 1, "probability border should be in (0;1)");
+    return -log((1 / probabilityBorder) - 1);
+}
@@ -55,6 +55,9 @@ inline TVector<double> CalcSigmoid(const TConstArrayRef<double> approx) {
 
 namespace NCB::NModelEvaluation {
 
+    // raw formula value border equivalent to probability border for binary classification
+    double CalcBinclassRawValueBorder(double probabilityBorder);
+
     class TEvalResultProcessor {
     public:
         TEvalResultProcessor(
@@ -63,7 +66,8 @@ namespace NCB::NModelEvaluation {
             EPredictionType predictionType,
             ui32 approxDimension,
             ui32 blockSize,
-            TMaybe<double> binclassProbabilityBorder = Nothing());
+            TMaybe<double> binclassProbabilityBorder = Nothing(),
+            TArrayRef<double> intermediateBlockResultsBuffer = TArrayRef<double>());
 
         inline TArrayRef<double> GetResultBlockView(ui32 blockId, ui32 dimension) {
             return Results.Slice(
@@ -117,7 +121,8 @@ namespace NCB::NModelEvaluation {
         ui32 ApproxDimension;
         ui32 BlockSize;
 
-        TVector<double> IntermediateBlockResults;
+        TArrayRef<double> IntermediateBlockResults;
+        TVector<double> IntermediateBlockResultsHolder;
 
         double BinclassRawValueBorder = 0.0;
     };
@@ -39,6 +39,21 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
             }
         };
 
+        /**
+         * Float features of documents in CSR format: features of document docId are
+         *  Values[RowOffsets[docId]..RowOffsets[docId + 1]) with flat indexes from FlatFeatureIndexes at the same positions.
+         * Flat indexes should be unique within a document, features that are not listed are equal to zero.
+         */
+        struct TCSRFlatFeaturesRef {
+            TConstArrayRef<size_t> RowOffsets;
+            TConstArrayRef<ui32> FlatFeatureIndexes;
+            TConstArrayRef<float> Values;
+
+            size_t GetDocCount() const {
+                return RowOffsets.empty() ? 0 : RowOffsets.size() - 1;
+            }
+        };
+
         class IModelEvaluator {
         public:
             virtual ~IModelEvaluator() = default;
@@ -135,6 +150,23 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 CalcFlatSingle(features, 0, GetTreeCount(), results, featureInfo);
             }
 
+            // sparse input is supported only for models without categorical features
+            virtual void CalcFlatSparse(
+                const TCSRFlatFeaturesRef& features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const = 0;
+
+            void CalcFlatSparse(
+                const TCSRFlatFeaturesRef& features,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const {
+                CalcFlatSparse(features, 0, GetTreeCount(), results, featureInfo);
+            }
+
             virtual void Calc(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                 TConstArrayRef<TConstArrayRef<int>> catFeatures,
@@ -177,6 +209,17 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 Calc<TStringBuf>(floatRefs, catFeatureStringRefs, results, featureInfo);
             }
 
+            // column-major input: transposedFloatFeatures[floatFeatureIdx][docIdx],
+            // transposedHashedCatFeatures[catFeatureIdx][docIdx] are already hashed with CalcCatFeatureHash
+            virtual void CalcTransposed(
+                TConstArrayRef<TConstArrayRef<float>> transposedFloatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> transposedHashedCatFeatures,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const = 0;
+
             virtual void Calc(
                 const IQuantizedData* quantizedFeatures,
                 size_t treeStart,
@@ -212,6 +255,9 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
 
         TModelEvaluatorPtr CreateCpuEvaluator(const TFullModel& model);
 
+        // libraryPath is a shared object built from the model exported in EModelType::CppCompiled format
+        TModelEvaluatorPtr CreateCompiledEvaluator(const TFullModel& model, const TString& libraryPath);
+
         bool CudaEvaluationPossible(const TFullModel& model);
         TModelEvaluatorPtr CreateGpuEvaluator(const TFullModel& model);
     }
@@ -4,6 +4,7 @@
 #include "model_import_interface.h"
 #include "model_build_helper.h"
 #include "static_ctr_provider.h"
+#include "cpu/evaluation_workspace.h"
 
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 
@@ -208,12 +209,17 @@ void TObliviousTrees::UpdateRuntimeData() const {
     ref.UsedCatFeaturesCount = 0;
     ref.MinimalSufficientFloatFeaturesVectorSize = 0;
     ref.MinimalSufficientCatFeaturesVectorSize = 0;
-    for (const auto& feature : FloatFeatures) {
+    ref.UsedFloatFeaturesIdxByFlatIndex.assign(GetFlatFeatureVectorExpectedSize(), -1);
+    ref.FloatFeaturesFirstBucket.assign(FloatFeatures.size(), 0);
+    for (size_t floatFeatureIdx = 0; floatFeatureIdx < FloatFeatures.size(); ++floatFeatureIdx) {
+        const auto& feature = FloatFeatures[floatFeatureIdx];
         if (!feature.UsedInModel()) {
             continue;
         }
         ++ref.UsedFloatFeaturesCount;
         ref.MinimalSufficientFloatFeaturesVectorSize = static_cast<size_t>(feature.Position.Index) + 1;
+        ref.UsedFloatFeaturesIdxByFlatIndex[feature.Position.FlatIndex] = static_cast<int>(floatFeatureIdx);
+        ref.FloatFeaturesFirstBucket[floatFeatureIdx] = ref.EffectiveBinFeaturesBucketCount;
         for (int borderId = 0; borderId < feature.Borders.ysize(); ++borderId) {
             TFloatSplit fs{feature.Position.Index, feature.Borders[borderId]};
             ref.BinFeatures.emplace_back(fs);
@@ -223,11 +229,19 @@ void TObliviousTrees::UpdateRuntimeData() const {
         }
         ref.EffectiveBinFeaturesBucketCount
             += (feature.Borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
+        for (int borderId = 0; borderId < feature.Borders.ysize(); ++borderId) {
+            if (borderId % MAX_VALUES_PER_BIN == 0) {
+                ref.FloatFeaturesZeroValueBins.push_back(0);
+            }
+            ref.FloatFeaturesZeroValueBins.back() += (0.0f > feature.Borders[borderId]);
+        }
     }
+    ref.UsedCatFeaturesPackedIndexes.assign(GetNumCatFeatures(), -1);
     for (const auto& feature : CatFeatures) {
         if (!feature.UsedInModel) {
             continue;
         }
+        ref.UsedCatFeaturesPackedIndexes[feature.Position.Index] = static_cast<int>(ref.UsedCatFeaturesCount);
         ++ref.UsedCatFeaturesCount;
         ref.MinimalSufficientCatFeaturesVectorSize = static_cast<size_t>(feature.Position.Index) + 1;
     }
@@ -434,6 +448,17 @@ void TFullModel::CalcFlat(
     GetCurrentEvaluator()->CalcFlat(features, treeStart, treeEnd, results, featureInfo);
 }
 
+void TFullModel::CalcFlat(
+    TConstArrayRef<TVector<float>> features,
+    TArrayRef<double> results,
+    const TFeatureLayout* featureInfo) const {
+    auto featureRefs = NCB::NModelEvaluation::GetThreadLocalCPUEvaluatorWorkspace().GetFloatFeatureRefsBuffer(
+        features.size()
+    );
+    Copy(features.begin(), features.end(), featureRefs.begin());
+    CalcFlat(featureRefs, results, featureInfo);
+}
+
 void TFullModel::CalcFlatSingle(
     TConstArrayRef<float> features,
     size_t treeStart,
@@ -471,7 +496,10 @@ void TFullModel::Calc(
     TArrayRef<double> results,
     const TFeatureLayout* featureInfo
 ) const {
-    TVector<TConstArrayRef<TStringBuf>> stringbufVecRefs{catFeatures.begin(), catFeatures.end()};
+    auto stringbufVecRefs = NCB::NModelEvaluation::GetThreadLocalCPUEvaluatorWorkspace().GetCatFeatureRefsBuffer(
+        catFeatures.size()
+    );
+    Copy(catFeatures.begin(), catFeatures.end(), stringbufVecRefs.begin());
     GetCurrentEvaluator()->Calc(floatFeatures, stringbufVecRefs, treeStart, treeEnd, results, featureInfo);
 }
 
@@ -595,12 +623,19 @@ void TFullModel::UpdateDynamicData() {
 }
 
 NCB::NModelEvaluation::TModelEvaluatorPtr TFullModel::CreateEvaluator(EFormulaEvaluatorType evaluatorType) const {
-    if (evaluatorType == EFormulaEvaluatorType::CPU) {
-        return NCB::NModelEvaluation::CreateCpuEvaluator(*this);
-    } else {
-        Y_ASSERT(evaluatorType == EFormulaEvaluatorType::GPU);
-        return NCB::NModelEvaluation::CreateGpuEvaluator(*this);
+    switch (evaluatorType) {
+        case EFormulaEvaluatorType::CPU:
+            return NCB::NModelEvaluation::CreateCpuEvaluator(*this);
+        case EFormulaEvaluatorType::GPU:
+            return NCB::NModelEvaluation::CreateGpuEvaluator(*this);
+        case EFormulaEvaluatorType::Compiled:
+            CB_ENSURE(
+                !CompiledModelLibraryPath.empty(),
+                "Compiled model library is not specified, use SetCompiledEvaluator"
+            );
+            return NCB::NModelEvaluation::CreateCompiledEvaluator(*this, CompiledModelLibraryPath);
     }
+    Y_UNREACHABLE();
 }
 
 TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model) {
@@ -890,6 +925,7 @@ DEFINE_DUMPER(
     UsedCatFeaturesCount,
     MinimalSufficientFloatFeaturesVectorSize,
     MinimalSufficientCatFeaturesVectorSize,
+    UsedCatFeaturesPackedIndexes,
     UsedModelCtrs,
     BinFeatures,
     RepackedBins,
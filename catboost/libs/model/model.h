@@ -92,6 +92,23 @@ public:
         size_t UsedCatFeaturesCount = 0;
         size_t MinimalSufficientFloatFeaturesVectorSize = 0;
         size_t MinimalSufficientCatFeaturesVectorSize = 0;
+        /**
+         * Index of categorical feature among used categorical features by its TFeaturePosition::Index,
+         *  -1 for features not used in model
+         */
+        TVector<int> UsedCatFeaturesPackedIndexes;
+        /**
+         * Index of float feature in FloatFeatures by its TFeaturePosition::FlatIndex, -1 for features not used in model
+         */
+        TVector<int> UsedFloatFeaturesIdxByFlatIndex;
+        /**
+         * Index of the first bin bucket of float feature in quantized data by its index in FloatFeatures
+         */
+        TVector<ui32> FloatFeaturesFirstBucket;
+        /**
+         * Bin values of zero feature value in float features bin buckets, used to binarize sparse input
+         */
+        TVector<ui8> FloatFeaturesZeroValueBins;
         /**
          * List of all TModelCTR used in model
          */
@@ -338,6 +355,26 @@ public:
         return RuntimeData->UsedCatFeaturesCount;
     }
 
+    TConstArrayRef<int> GetUsedCatFeaturesPackedIndexes() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->UsedCatFeaturesPackedIndexes;
+    }
+
+    TConstArrayRef<int> GetUsedFloatFeaturesIdxByFlatIndex() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->UsedFloatFeaturesIdxByFlatIndex;
+    }
+
+    TConstArrayRef<ui32> GetFloatFeaturesFirstBucket() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->FloatFeaturesFirstBucket;
+    }
+
+    TConstArrayRef<ui8> GetFloatFeaturesZeroValueBins() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->FloatFeaturesZeroValueBins;
+    }
+
     size_t GetBinaryFeaturesFullCount() const {
         return GetBinFeatures().size();
     }
@@ -365,7 +402,8 @@ private:
 
 enum class EFormulaEvaluatorType {
     CPU,
-    GPU
+    GPU,
+    Compiled // shared object built from the model exported in EModelType::CppCompiled format
 };
 
 class TCOWTreeWrapper {
@@ -409,6 +447,7 @@ public:
     TIntrusivePtr<ICtrProvider> CtrProvider;
 private:
     EFormulaEvaluatorType FormulaEvaluatorType = EFormulaEvaluatorType::CPU;
+    TString CompiledModelLibraryPath; // used by EFormulaEvaluatorType::Compiled
     TAdaptiveLock CurrentEvaluatorLock;
     mutable NCB::NModelEvaluation::TModelEvaluatorPtr Evaluator;
 public:
@@ -421,6 +460,18 @@ public:
         }
     }
 
+    /**
+     * Switch to EFormulaEvaluatorType::Compiled evaluator.
+     * libraryPath is a shared object built from this model exported in EModelType::CppCompiled format.
+     */
+    void SetCompiledEvaluator(const TString& libraryPath) {
+        with_lock(CurrentEvaluatorLock) {
+            CompiledModelLibraryPath = libraryPath;
+            Evaluator = CreateEvaluator(EFormulaEvaluatorType::Compiled); // we can fail here
+            FormulaEvaluatorType = EFormulaEvaluatorType::Compiled;
+        }
+    }
+
     NCB::NModelEvaluation::TConstModelEvaluatorPtr GetCurrentEvaluator() const {
         with_lock(CurrentEvaluatorLock) {
             if (!Evaluator) {
@@ -607,10 +658,7 @@ public:
         TConstArrayRef<TVector<float>> features,
         TArrayRef<double> results,
         const TFeatureLayout* featureInfo = nullptr
-    ) const {
-        TVector<TConstArrayRef<float>> featureRefs{features.begin(), features.end()};
-        CalcFlat(featureRefs, results, featureInfo);
-    }
+    ) const;
 
     /**
      * Same as CalcFlat method but for one object
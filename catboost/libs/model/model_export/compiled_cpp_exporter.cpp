@@ -0,0 +1,240 @@
+#include "compiled_cpp_exporter.h"
+
+#include "export_helpers.h"
+
+#include <catboost/libs/model/cpu/compiled_model_abi.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+
+namespace NCB {
+    using namespace NCatboostModelExportHelpers;
+
+    // documents are binarized and evaluated in blocks of this size
+    static constexpr size_t COMPILED_MODEL_BLOCK_SIZE = 64;
+    // limits size of generated functions to keep compilation time reasonable
+    static constexpr size_t COMPILED_MODEL_TREES_PER_FUNCTION = 64;
+
+    namespace {
+        struct TUsedBorder {
+            float Border = 0.0f;
+            size_t SplitIdx = 0;
+        };
+
+        struct TUsedFloatFeature {
+            int FlatIndex = 0;
+            bool NanIsTrue = false;
+            TVector<TUsedBorder> Borders;
+        };
+
+        struct TTreeGroup {
+            int Depth = 0;
+            TVector<size_t> TreeIds;
+        };
+    }
+
+    static TString DoubleToString(double value) {
+        TString str = FloatToString(value, PREC_NDIGITS, 17);
+        if (int intValue; TryFromString<int>(str, intValue)) {
+            str.append(".0");
+        }
+        return str;
+    }
+
+    void TCatboostModelToCompiledCppConverter::Write(const TFullModel& model, const THashMap<ui32, TString>*) {
+        const TObliviousTrees& trees = *model.ObliviousTrees;
+        CB_ENSURE(!model.HasCategoricalFeatures(), "Compilation of models with categorical features is not supported");
+        CB_ENSURE(trees.ApproxDimension == 1, "Compilation of MultiClassification models is not supported");
+        CB_ENSURE(trees.IsOblivious(), "Compilation of non symmetric trees is not supported");
+
+        // only borders used in tree splits are binarized, splits get dense indexes in order of features
+        const auto& binFeatures = trees.GetBinFeatures();
+        TVector<bool> isSplitUsed(binFeatures.size(), false);
+        for (int binFeatureIdx : trees.TreeSplits) {
+            isSplitUsed[binFeatureIdx] = true;
+        }
+        THashMap<int, const TFloatFeature*> floatFeatureByIndex;
+        for (const auto& floatFeature : trees.FloatFeatures) {
+            floatFeatureByIndex[floatFeature.Position.Index] = &floatFeature;
+        }
+        TVector<size_t> splitIdxByBinFeature(binFeatures.size(), Max<size_t>());
+        TVector<TUsedFloatFeature> usedFeatures;
+        size_t splitCount = 0;
+        for (size_t binFeatureIdx : xrange(binFeatures.size())) {
+            if (!isSplitUsed[binFeatureIdx]) {
+                continue;
+            }
+            const auto& split = binFeatures[binFeatureIdx].FloatFeature;
+            const TFloatFeature& floatFeature = *floatFeatureByIndex.at(split.FloatFeature);
+            if (usedFeatures.empty() || usedFeatures.back().FlatIndex != floatFeature.Position.FlatIndex) {
+                auto& usedFeature = usedFeatures.emplace_back();
+                usedFeature.FlatIndex = floatFeature.Position.FlatIndex;
+                usedFeature.NanIsTrue = floatFeature.HasNans
+                    && floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue;
+            }
+            usedFeatures.back().Borders.push_back({split.Split, splitCount});
+            splitIdxByBinFeature[binFeatureIdx] = splitCount;
+            ++splitCount;
+        }
+
+        // trees with equal depth are evaluated together, summation order differs from TCpuEvaluator
+        TVector<size_t> treeOrder(trees.GetTreeCount());
+        Iota(treeOrder.begin(), treeOrder.end(), 0);
+        StableSort(
+            treeOrder.begin(),
+            treeOrder.end(),
+            [&trees](size_t lhs, size_t rhs) { return trees.TreeSizes[lhs] < trees.TreeSizes[rhs]; }
+        );
+        TVector<TTreeGroup> treeGroups;
+        for (size_t treeId : treeOrder) {
+            const int depth = trees.TreeSizes[treeId];
+            if (treeGroups.empty() || treeGroups.back().Depth != depth
+                || treeGroups.back().TreeIds.size() == COMPILED_MODEL_TREES_PER_FUNCTION)
+            {
+                treeGroups.push_back({depth, {}});
+            }
+            treeGroups.back().TreeIds.push_back(treeId);
+        }
+
+        Out << "/* CatBoost model compiled to C++." << '\n';
+        Out << " * Build it into a shared object, e.g. c++ -std=c++11 -O3 -march=native -fPIC -shared model.compiled.cpp -o model.so" << '\n';
+        Out << " * and load it with NCB::NModelEvaluation::CreateCompiledEvaluator." << '\n';
+        Out << " */" << '\n';
+        Out << "#include <cstddef>" << '\n';
+        Out << '\n';
+        Out << "#if defined(_WIN32)" << '\n';
+        Out << "#define CATBOOST_COMPILED_MODEL_API extern \"C\" __declspec(dllexport)" << '\n';
+        Out << "#else" << '\n';
+        Out << "#define CATBOOST_COMPILED_MODEL_API extern \"C\" __attribute__((visibility(\"default\")))" << '\n';
+        Out << "#endif" << '\n';
+        Out << '\n';
+        Out << "namespace {" << '\n';
+        Out << "    const size_t BlockSize = " << COMPILED_MODEL_BLOCK_SIZE << ";" << '\n';
+        Out << '\n';
+        Out << "    /* Binarized splits of documents in the current block: Bins[splitIdx][docId]." << '\n';
+        Out << "     * Trees are applied to the whole block, bins of the last incomplete block left from the previous block" << '\n';
+        Out << "     * only affect results that are not returned." << '\n';
+        Out << "     */" << '\n';
+        Out << "    thread_local unsigned char Bins[" << Max<size_t>(splitCount, 1) << "][BlockSize];" << '\n';
+        Out << '\n';
+        Out << "    template <bool IsTransposed>" << '\n';
+        Out << "    inline float GetFeature(const float* const* features, size_t flatFeatureIdx, size_t docId) {" << '\n';
+        Out << "        return IsTransposed ? features[flatFeatureIdx][docId] : features[docId][flatFeatureIdx];" << '\n';
+        Out << "    }" << '\n';
+        Out << '\n';
+        Out << "    template <bool IsTransposed>" << '\n';
+        Out << "    void Binarize(const float* const* features, size_t blockStart, size_t docCount) {" << '\n';
+        for (const auto& usedFeature : usedFeatures) {
+            Out << "        for (size_t docId = 0; docId < docCount; ++docId) {" << '\n';
+            Out << "            const float value = GetFeature<IsTransposed>(features, " << usedFeature.FlatIndex << ", blockStart + docId);" << '\n';
+            for (const auto& usedBorder : usedFeature.Borders) {
+                Out << "            Bins[" << usedBorder.SplitIdx << "][docId] = ";
+                if (usedFeature.NanIsTrue) {
+                    Out << "(value > " << FloatToStringWithSuffix(usedBorder.Border, true) << ") | (value != value);" << '\n';
+                } else {
+                    Out << "value > " << FloatToStringWithSuffix(usedBorder.Border, true) << ";" << '\n';
+                }
+            }
+            Out << "        }" << '\n';
+        }
+        Out << "    }" << '\n';
+
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+        for (size_t groupId : xrange(treeGroups.size())) {
+            const auto& group = treeGroups[groupId];
+            const size_t leafCount = size_t(1) << group.Depth;
+            Out << '\n';
+            Out << "    /* Trees of depth " << group.Depth << " */" << '\n';
+            Out << "    const double LeafValues" << groupId << "[" << group.TreeIds.size() << "][" << leafCount << "] = {" << '\n';
+            for (size_t treeId : group.TreeIds) {
+                const double* leafValues = trees.LeafValues.data() + firstLeafOffsets[treeId];
+                Out << "        {" << OutputArrayInitializer([leafValues] (size_t i) { return DoubleToString(leafValues[i]); }, leafCount) << "}," << '\n';
+            }
+            Out << "    };" << '\n';
+            if (group.Depth == 0) {
+                Out << '\n';
+                Out << "    void ApplyTrees" << groupId << "(double* __restrict sums) {" << '\n';
+                Out << "        for (size_t treeIdx = 0; treeIdx < " << group.TreeIds.size() << "; ++treeIdx) {" << '\n';
+                Out << "            for (size_t docId = 0; docId < BlockSize; ++docId) {" << '\n';
+                Out << "                sums[docId] += LeafValues" << groupId << "[treeIdx][0];" << '\n';
+                Out << "            }" << '\n';
+                Out << "        }" << '\n';
+                Out << "    }" << '\n';
+                continue;
+            }
+            Out << "    const unsigned int Splits" << groupId << "[" << group.TreeIds.size() << "][" << group.Depth << "] = {" << '\n';
+            for (size_t treeId : group.TreeIds) {
+                const int* treeSplits = trees.TreeSplits.data() + trees.TreeStartOffsets[treeId];
+                Out << "        {" << OutputArrayInitializer(
+                    [&] (size_t depth) { return splitIdxByBinFeature[treeSplits[depth]]; },
+                    group.Depth
+                ) << "}," << '\n';
+            }
+            Out << "    };" << '\n';
+            Out << '\n';
+            // every tree of the group is two loops over the block with compile time bounds: leaf indexes
+            //  from bins of its splits and accumulation of leaf values, both can be vectorized
+            Out << "    void ApplyTrees" << groupId << "(double* __restrict sums) {" << '\n';
+            Out << "        for (size_t treeIdx = 0; treeIdx < " << group.TreeIds.size() << "; ++treeIdx) {" << '\n';
+            for (int depth : xrange(group.Depth)) {
+                Out << "            const unsigned char* __restrict bins" << depth << " = Bins[Splits" << groupId << "[treeIdx][" << depth << "]];" << '\n';
+            }
+            Out << "            " << (group.Depth <= 8 ? "unsigned char" : "unsigned short") << " leafIndexes[BlockSize];" << '\n';
+            Out << "            for (size_t docId = 0; docId < BlockSize; ++docId) {" << '\n';
+            Out << "                leafIndexes[docId] = ";
+            for (int depth : xrange(group.Depth)) {
+                if (depth != 0) {
+                    Out << " | ";
+                }
+                Out << "(bins" << depth << "[docId] << " << depth << ")";
+            }
+            Out << ";" << '\n';
+            Out << "            }" << '\n';
+            Out << "            const double* __restrict leafValues = LeafValues" << groupId << "[treeIdx];" << '\n';
+            Out << "            for (size_t docId = 0; docId < BlockSize; ++docId) {" << '\n';
+            Out << "                sums[docId] += leafValues[leafIndexes[docId]];" << '\n';
+            Out << "            }" << '\n';
+            Out << "        }" << '\n';
+            Out << "    }" << '\n';
+        }
+        Out << "}" << '\n';
+        Out << '\n';
+
+        Out << "CATBOOST_COMPILED_MODEL_API unsigned int " << NModelEvaluation::COMPILED_MODEL_ABI_VERSION_SYMBOL << "() {" << '\n';
+        Out << "    return " << NModelEvaluation::COMPILED_MODEL_ABI_VERSION << ";" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "CATBOOST_COMPILED_MODEL_API unsigned long long " << NModelEvaluation::COMPILED_MODEL_CHECKSUM_SYMBOL << "() {" << '\n';
+        Out << "    return " << NModelEvaluation::CalcCompiledModelChecksum(trees) << "ull;" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "CATBOOST_COMPILED_MODEL_API size_t " << NModelEvaluation::COMPILED_MODEL_FLAT_FEATURE_COUNT_SYMBOL << "() {" << '\n';
+        Out << "    return " << trees.GetFlatFeatureVectorExpectedSize() << ";" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "CATBOOST_COMPILED_MODEL_API void " << NModelEvaluation::COMPILED_MODEL_CALC_SYMBOL << "(" << '\n';
+        Out << "    const float* const* features," << '\n';
+        Out << "    size_t docCount," << '\n';
+        Out << "    int isTransposed," << '\n';
+        Out << "    double* results" << '\n';
+        Out << ") {" << '\n';
+        Out << "    for (size_t blockStart = 0; blockStart < docCount; blockStart += BlockSize) {" << '\n';
+        Out << "        const size_t blockDocCount = docCount - blockStart < BlockSize ? docCount - blockStart : BlockSize;" << '\n';
+        Out << "        if (isTransposed) {" << '\n';
+        Out << "            Binarize<true>(features, blockStart, blockDocCount);" << '\n';
+        Out << "        } else {" << '\n';
+        Out << "            Binarize<false>(features, blockStart, blockDocCount);" << '\n';
+        Out << "        }" << '\n';
+        Out << "        double sums[BlockSize] = {};" << '\n';
+        for (size_t groupId : xrange(treeGroups.size())) {
+            Out << "        ApplyTrees" << groupId << "(sums);" << '\n';
+        }
+        Out << "        for (size_t docId = 0; docId < blockDocCount; ++docId) {" << '\n';
+        Out << "            results[blockStart + docId] = sums[docId];" << '\n';
+        Out << "        }" << '\n';
+        Out << "    }" << '\n';
+        Out << "}" << '\n';
+    }
+}
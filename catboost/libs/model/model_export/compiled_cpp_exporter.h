@@ -0,0 +1,31 @@
+#pragma once
+
+#include "model_exporter.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/stream/file.h>
+
+
+namespace NCB {
+    /**
+     * Generates model specific C++ code to be built into a shared object and loaded with CreateCompiledEvaluator.
+     * Unlike TCatboostModelToCppConverter, the code doesn't interpret model arrays: borders are compile time
+     *  constants, only borders used in splits are calculated, documents are binarized by blocks and trees of
+     *  equal depth are applied to a block in one function, in loops with compile time bounds that compilers
+     *  vectorize at -O3.
+     */
+    class TCatboostModelToCompiledCppConverter: public ICatboostModelExporter {
+    private:
+        TOFStream Out;
+
+    public:
+        TCatboostModelToCompiledCppConverter(const TString& modelFile, bool addFileFormatExtension, const TString& userParametersJson)
+            : Out(modelFile + (addFileFormatExtension ? ".compiled.cpp" : ""))
+        {
+            CB_ENSURE(userParametersJson.empty(), "JSON user params for compiling the model are not supported");
+        };
+
+        void Write(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString = nullptr) override;
+    };
+}
@@ -3,7 +3,7 @@
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 
-static TString FloatToStringWithSuffix(float value, bool addFloatingSuffix) {
+TString NCatboostModelExportHelpers::FloatToStringWithSuffix(float value, bool addFloatingSuffix) {
     TString str = FloatToString(value, PREC_NDIGITS, 9);
     if (addFloatingSuffix) {
         if (int value; TryFromString<int>(str, value)) {
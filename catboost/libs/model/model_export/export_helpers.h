@@ -118,6 +118,8 @@ namespace NCatboostModelExportHelpers {
         return OutputArrayInitializer([&values] (size_t i) { return values[i]; }, values.size());
     }
 
+    TString FloatToStringWithSuffix(float value, bool addFloatingSuffix);
+
     int GetBinaryFeatureCount(const TFullModel& model);
 
     TString OutputBorderCounts(const TFullModel& model);
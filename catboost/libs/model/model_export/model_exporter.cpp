@@ -1,5 +1,6 @@
 #include "model_exporter.h"
 
+#include "compiled_cpp_exporter.h"
 #include "coreml_helpers.h"
 #include "cpp_exporter.h"
 #include "json_model_helpers.h"
@@ -23,6 +24,8 @@ namespace NCB {
                 return new TCatboostModelToCppConverter(modelFile, addFileFormatExtension, userParametersJson);
             case EModelType::Python:
                 return new TCatboostModelToPythonConverter(modelFile, addFileFormatExtension, userParametersJson);
+            case EModelType::CppCompiled:
+                return new TCatboostModelToCompiledCppConverter(modelFile, addFileFormatExtension, userParametersJson);
             default:
                 TStringBuilder err;
                 err << "CreateCatboostModelExporter doesn't support " << format << ".";
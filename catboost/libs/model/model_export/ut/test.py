@@ -92,6 +92,55 @@ def test_cpp_export(dataset):
             raise
 
 
+def test_compiled_cpp_export():
+    import ctypes
+
+    train_path, test_path, cd_path = _get_train_test_cd_path('higgs')
+    basename = yatest.common.test_output_path('model')
+    yatest.common.execute([
+        CATBOOST_APP_PATH, 'fit',
+        '-f', train_path,
+        '--cd', cd_path,
+        '-i', '100',
+        '-r', '1234',
+        '-m', basename,
+        '--model-format', 'CppCompiled',
+        '--model-format', 'CatboostBinary',
+    ])
+    model_cpp = basename + '.compiled.cpp'
+    model_so = yatest.common.test_output_path('model.so')
+    compile_cmd = ['g++', '-std=c++11', '-O2', '-fPIC', '-shared', '-o', model_so, model_cpp]
+    try:
+        yatest.common.execute(compile_cmd)
+    except OSError as e:
+        if re.search(r"No such file or directory.*'{}'".format(re.escape(compile_cmd[0])), str(e)):
+            pytest.xfail(reason='We ignore `compiler not found` error: {}\n'.format(str(e)))
+        else:
+            raise
+
+    model = CatBoost()
+    model.load_model(basename + '.bin')
+    test_pool = Pool(test_path, column_description=cd_path)
+    pred_model = model.predict(test_pool, prediction_type='RawFormulaVal')
+
+    features_data, _ = load_pool_features_as_df(test_path, cd_path, _get_target_idx(cd_path))
+    features = np.ascontiguousarray(features_data.values, dtype=np.float32)
+    doc_count = features.shape[0]
+    float_ptr = ctypes.POINTER(ctypes.c_float)
+    rows = (float_ptr * doc_count)(*[row.ctypes.data_as(float_ptr) for row in features])
+    pred_compiled = np.zeros(doc_count, dtype=np.float64)
+
+    compiled_model = ctypes.CDLL(model_so)
+    compiled_model.CatboostCompiledModelCalc.argtypes = [
+        ctypes.POINTER(float_ptr), ctypes.c_size_t, ctypes.c_int, ctypes.POINTER(ctypes.c_double)
+    ]
+    compiled_model.CatboostCompiledModelCalc(
+        rows, doc_count, 0, pred_compiled.ctypes.data_as(ctypes.POINTER(ctypes.c_double))
+    )
+
+    assert _check_data(pred_model, pred_compiled, rtol=1e-6)
+
+
 def test_read_model_after_train():
     train_path, test_path, cd_path = _get_train_test_cd_path('adult')
     eval_file = yatest.common.test_output_path('eval-file')
@@ -0,0 +1,384 @@
+#include "shared_model_registry.h"
+
+#include "static_ctr_provider.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+#include <util/stream/mem.h>
+#include <util/string/cast.h>
+#include <util/system/align.h>
+#include <util/system/error.h>
+#include <util/system/platform.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_unix_)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+    constexpr ui64 SharedModelSegmentMagic = 0x314c444d42544143ull; // "CATBMDL1" in little endian
+
+    struct TSharedModelRegistryControl {
+        std::atomic<ui64> CurrentVersion;
+    };
+
+    static_assert(
+        std::atomic<ui64>::is_always_lock_free,
+        "Shared model registry requires lock free 64-bit atomics"
+    );
+
+    struct TSharedModelCtrTableRef {
+        ui64 Offset;
+        ui64 Size;
+    };
+
+    /* Version segment layout, all offsets are from the segment begin:
+     *  TSharedModelSegmentHeader
+     *  TSharedModelCtrTableRef[CtrTableCount]
+     *  model core (serialized model without CTR provider)
+     *  CTR value tables (saved by TCtrValueTable::SaveForThinLoad), aligned by ThinDataAlignment
+     */
+    struct TSharedModelSegmentHeader {
+        ui64 Magic;
+        ui64 Version;
+        ui64 CoreOffset;
+        ui64 CoreSize;
+        ui64 HasCtrProvider;
+        ui64 CtrTableCount;
+        ui64 CtrTableRefsOffset;
+    };
+}
+
+
+namespace NCB {
+
+#if defined(_unix_)
+    class TSharedModelRegistry::TSharedMemoryMapping : public TThrRefBase {
+    public:
+        // new segment of segmentSize bytes mapped for writing, fails if the segment exists
+        static TIntrusivePtr<TSharedMemoryMapping> Create(const TString& segmentName, size_t segmentSize) {
+            int fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if ((fd == -1) && (errno == EEXIST)) {
+                // left by a publisher that failed before switching to this version
+                shm_unlink(segmentName.c_str());
+                fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            }
+            CB_ENSURE(fd != -1, "Can't create shared memory segment " << segmentName << ": " << LastSystemErrorText());
+            if (ftruncate(fd, segmentSize) != 0) {
+                const TString errorText = LastSystemErrorText();
+                close(fd);
+                shm_unlink(segmentName.c_str());
+                CB_ENSURE(false, "Can't resize shared memory segment " << segmentName << ": " << errorText);
+            }
+            return new TSharedMemoryMapping(segmentName, fd, segmentSize, /*writable*/ true);
+        }
+
+        // nullptr if the segment does not exist
+        static TIntrusivePtr<TSharedMemoryMapping> Open(const TString& segmentName, bool writable) {
+            const int fd = shm_open(segmentName.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+            if (fd == -1) {
+                CB_ENSURE(
+                    errno == ENOENT,
+                    "Can't open shared memory segment " << segmentName << ": " << LastSystemErrorText()
+                );
+                return nullptr;
+            }
+            struct stat segmentStat;
+            if (fstat(fd, &segmentStat) != 0) {
+                const TString errorText = LastSystemErrorText();
+                close(fd);
+                CB_ENSURE(false, "Can't get size of shared memory segment " << segmentName << ": " << errorText);
+            }
+            return new TSharedMemoryMapping(segmentName, fd, segmentStat.st_size, writable);
+        }
+
+        static void Unlink(const TString& segmentName) {
+            shm_unlink(segmentName.c_str());
+        }
+
+        ~TSharedMemoryMapping() override {
+            if (Size) {
+                munmap(Data, Size);
+            }
+            close(Fd);
+        }
+
+        // the segment has been unlinked (e.g. registry has been removed and created again)
+        bool IsUnlinked() const {
+            struct stat segmentStat;
+            return (fstat(Fd, &segmentStat) != 0) || (segmentStat.st_nlink == 0);
+        }
+
+        char* GetData() const {
+            return static_cast<char*>(Data);
+        }
+
+        size_t GetSize() const {
+            return Size;
+        }
+
+    private:
+        TSharedMemoryMapping(const TString& segmentName, int fd, size_t size, bool writable)
+            : Fd(fd)
+            , Size(size)
+        {
+            if (Size) {
+                Data = mmap(nullptr, Size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+            }
+            if (Data == MAP_FAILED) {
+                const TString errorText = LastSystemErrorText();
+                close(fd);
+                Size = 0;
+                CB_ENSURE(false, "Can't map shared memory segment " << segmentName << ": " << errorText);
+            }
+        }
+
+    private:
+        int Fd; // kept open to detect unlinking of the segment
+        void* Data = nullptr;
+        size_t Size = 0;
+    };
+#else
+    class TSharedModelRegistry::TSharedMemoryMapping : public TThrRefBase {
+    public:
+        static TIntrusivePtr<TSharedMemoryMapping> Create(const TString& /*segmentName*/, size_t /*segmentSize*/) {
+            ythrow TCatBoostException() << "Shared memory model registry is supported only on unix platforms";
+        }
+
+        static TIntrusivePtr<TSharedMemoryMapping> Open(const TString& /*segmentName*/, bool /*writable*/) {
+            ythrow TCatBoostException() << "Shared memory model registry is supported only on unix platforms";
+        }
+
+        static void Unlink(const TString& /*segmentName*/) {
+        }
+
+        bool IsUnlinked() const {
+            return false;
+        }
+
+        char* GetData() const {
+            return nullptr;
+        }
+
+        size_t GetSize() const {
+            return 0;
+        }
+    };
+#endif
+
+
+    static TString GetControlSegmentName(const TString& registryName) {
+        return "/" + registryName;
+    }
+
+    static TString GetVersionSegmentName(const TString& registryName, ui64 version) {
+        return "/" + registryName + "." + ToString(version);
+    }
+
+
+    TSharedModelRegistry::TSharedModelRegistry(const TString& registryName)
+        : RegistryName(registryName)
+    {
+        CB_ENSURE(!RegistryName.empty(), "Shared model registry name should not be empty");
+        CB_ENSURE(
+            RegistryName.find('/') == TString::npos,
+            "Shared model registry name should not contain '/': " << RegistryName
+        );
+    }
+
+    TSharedModelRegistry::~TSharedModelRegistry() = default;
+
+    ui64 TSharedModelRegistry::Publish(const TFullModel& model) {
+        const TStaticCtrProvider* ctrProvider = nullptr;
+        if (model.CtrProvider) {
+            ctrProvider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+            CB_ENSURE(ctrProvider, "Only models with static CTR provider can be published to shared memory");
+        }
+
+        TBufferOutput coreOutput;
+        {
+            TFullModel coreModel;
+            coreModel.ObliviousTrees = model.ObliviousTrees;
+            coreModel.ModelInfo = model.ModelInfo;
+            OutputModel(coreModel, &coreOutput);
+        }
+
+        TVector<TBufferOutput> ctrTablesOutputs;
+        if (ctrProvider) {
+            for (const auto& [ctrBase, ctrValueTable] : ctrProvider->CtrData.LearnCtrs) {
+                ctrTablesOutputs.emplace_back();
+                ctrValueTable.SaveForThinLoad(&ctrTablesOutputs.back());
+            }
+        }
+
+        constexpr size_t alignment = TCtrValueTable::ThinDataAlignment;
+
+        TSharedModelSegmentHeader header;
+        header.Magic = SharedModelSegmentMagic;
+        header.HasCtrProvider = ctrProvider != nullptr;
+        header.CtrTableCount = ctrTablesOutputs.size();
+        header.CtrTableRefsOffset = AlignUp<ui64>(sizeof(TSharedModelSegmentHeader), alignment);
+        header.CoreOffset = AlignUp<ui64>(
+            header.CtrTableRefsOffset + sizeof(TSharedModelCtrTableRef) * header.CtrTableCount,
+            alignment
+        );
+        header.CoreSize = coreOutput.Buffer().Size();
+
+        TVector<TSharedModelCtrTableRef> ctrTableRefs;
+        size_t segmentSize = header.CoreOffset + header.CoreSize;
+        for (const auto& ctrTableOutput : ctrTablesOutputs) {
+            segmentSize = AlignUp(segmentSize, alignment);
+            ctrTableRefs.push_back(TSharedModelCtrTableRef{segmentSize, ctrTableOutput.Buffer().Size()});
+            segmentSize += ctrTableOutput.Buffer().Size();
+        }
+
+        auto control = TSharedMemoryMapping::Open(GetControlSegmentName(RegistryName), /*writable*/ true);
+        const bool isNewControl = !control;
+        if (isNewControl) {
+            control = TSharedMemoryMapping::Create(
+                GetControlSegmentName(RegistryName),
+                sizeof(TSharedModelRegistryControl)
+            );
+        }
+        CB_ENSURE(
+            control->GetSize() >= sizeof(TSharedModelRegistryControl),
+            "Shared model registry " << RegistryName << " control segment is corrupted"
+        );
+        auto& currentVersion = reinterpret_cast<TSharedModelRegistryControl*>(control->GetData())->CurrentVersion;
+        const ui64 previousVersion = currentVersion.load();
+        /* versions of a recreated registry continue from the current time, so that readers that have
+         *  attached a model before the registry was removed see a different version
+         */
+        header.Version = isNewControl ? TInstant::Now().MicroSeconds() : (previousVersion + 1);
+
+        {
+            auto segment = TSharedMemoryMapping::Create(
+                GetVersionSegmentName(RegistryName, header.Version),
+                segmentSize
+            );
+            char* data = segment->GetData();
+            memcpy(data, &header, sizeof(header));
+            memcpy(
+                data + header.CtrTableRefsOffset,
+                ctrTableRefs.data(),
+                sizeof(TSharedModelCtrTableRef) * ctrTableRefs.size()
+            );
+            memcpy(data + header.CoreOffset, coreOutput.Buffer().Data(), header.CoreSize);
+            for (auto tableIdx : xrange(ctrTableRefs.size())) {
+                const auto& ctrTableBuffer = ctrTablesOutputs[tableIdx].Buffer();
+                memcpy(data + ctrTableRefs[tableIdx].Offset, ctrTableBuffer.Data(), ctrTableBuffer.Size());
+            }
+        }
+
+        // readers that have read the previous version and not opened its segment yet will retry
+        currentVersion.store(header.Version);
+        if (!isNewControl && previousVersion) {
+            TSharedMemoryMapping::Unlink(GetVersionSegmentName(RegistryName, previousVersion));
+        }
+        return header.Version;
+    }
+
+    ui64 TSharedModelRegistry::GetCurrentVersion() const {
+        if (ControlMapping && ControlMapping->IsUnlinked()) {
+            ControlMapping.Reset();
+        }
+        if (!ControlMapping) {
+            auto control = TSharedMemoryMapping::Open(GetControlSegmentName(RegistryName), /*writable*/ false);
+            // not created yet or created but not resized yet by the publisher
+            if (!control || (control->GetSize() < sizeof(TSharedModelRegistryControl))) {
+                return 0;
+            }
+            ControlMapping = std::move(control);
+        }
+        return reinterpret_cast<const TSharedModelRegistryControl*>(ControlMapping->GetData())
+            ->CurrentVersion.load();
+    }
+
+    TFullModel TSharedModelRegistry::Attach(ui64* version) const {
+        TIntrusivePtr<TSharedMemoryMapping> segment;
+        ui64 attachedVersion = 0;
+        while (!segment) {
+            attachedVersion = GetCurrentVersion();
+            CB_ENSURE(attachedVersion, "No model has been published to shared model registry " << RegistryName);
+            segment = TSharedMemoryMapping::Open(
+                GetVersionSegmentName(RegistryName, attachedVersion),
+                /*writable*/ false
+            );
+            CB_ENSURE(
+                segment || (GetCurrentVersion() != attachedVersion),
+                "Shared model registry " << RegistryName << " version " << attachedVersion << " has been removed"
+            );
+        }
+
+        const char* data = segment->GetData();
+        const size_t segmentSize = segment->GetSize();
+        const auto checkRange = [&] (ui64 offset, ui64 size) {
+            CB_ENSURE(
+                (offset <= segmentSize) && (size <= segmentSize - offset),
+                "Shared model registry " << RegistryName << " version " << attachedVersion << " is corrupted"
+            );
+        };
+
+        checkRange(0, sizeof(TSharedModelSegmentHeader));
+        TSharedModelSegmentHeader header;
+        memcpy(&header, data, sizeof(header));
+        CB_ENSURE(
+            (header.Magic == SharedModelSegmentMagic) && (header.Version == attachedVersion),
+            "Shared model registry " << RegistryName << " version " << attachedVersion << " has wrong format"
+        );
+        checkRange(header.CoreOffset, header.CoreSize);
+        checkRange(header.CtrTableRefsOffset, sizeof(TSharedModelCtrTableRef) * header.CtrTableCount);
+
+        TFullModel model = DeserializeModel(TMemoryInput(data + header.CoreOffset, header.CoreSize));
+        if (header.HasCtrProvider) {
+            TIntrusivePtr<TStaticCtrProvider> ctrProvider = new TStaticCtrProvider;
+            for (auto tableIdx : xrange(header.CtrTableCount)) {
+                TSharedModelCtrTableRef ctrTableRef;
+                memcpy(
+                    &ctrTableRef,
+                    data + header.CtrTableRefsOffset + sizeof(TSharedModelCtrTableRef) * tableIdx,
+                    sizeof(ctrTableRef)
+                );
+                checkRange(ctrTableRef.Offset, ctrTableRef.Size);
+
+                TCtrValueTable ctrValueTable;
+                ctrValueTable.LoadThin(data + ctrTableRef.Offset, ctrTableRef.Size);
+                TModelCtrBase ctrBase = ctrValueTable.ModelCtrBase;
+                ctrProvider->CtrData.LearnCtrs[ctrBase] = std::move(ctrValueTable);
+            }
+            ctrProvider->ThinTablesDataHolders.push_back(segment.Get());
+            model.CtrProvider = ctrProvider;
+            model.UpdateDynamicData();
+        }
+
+        if (version) {
+            *version = attachedVersion;
+        }
+        return model;
+    }
+
+    void TSharedModelRegistry::Remove() {
+        const ui64 currentVersion = GetCurrentVersion();
+        if (currentVersion) {
+            TSharedMemoryMapping::Unlink(GetVersionSegmentName(RegistryName, currentVersion));
+        }
+        TSharedMemoryMapping::Unlink(GetControlSegmentName(RegistryName));
+        ControlMapping.Reset();
+    }
+}
+
+
+TFullModel ReadModelFromSharedMemory(const TString& registryName, ui64* version) {
+    return NCB::TSharedModelRegistry(registryName).Attach(version);
+}
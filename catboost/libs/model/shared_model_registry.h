@@ -0,0 +1,66 @@
+#pragma once
+
+#include "model.h"
+
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Models shared by serving processes of one host via POSIX shared memory.
+     *
+     * Each published model version is a separate read-only segment "/<registryName>.<version>" with
+     *  the model core (trees, features and info) and CTR value tables laid out for TCtrValueTable::LoadThin.
+     * Attached models use CTR tables in place, so they are stored once per host. The model core is
+     *  deserialized by each process: trees and feature descriptions are owned by TObliviousTrees and
+     *  CTR provider feature indexes are built on attach, their size is usually small compared to CTR tables.
+     * The current version is stored in the "/<registryName>" control segment and is switched atomically
+     *  after the new version segment is complete, so readers see either the old or the new model.
+     * Versions increase on each publish, also after the registry has been removed and published again.
+     * The segment of the previous version is unlinked on publish: processes that have attached it keep
+     *  using it until their models are destroyed.
+     *
+     * There must be only one publisher for a registry at a time. Registry objects are not thread-safe.
+     * Supported only on unix platforms.
+     */
+    class TSharedModelRegistry {
+    public:
+        // registryName must not contain '/'
+        explicit TSharedModelRegistry(const TString& registryName);
+        ~TSharedModelRegistry();
+
+        // Returns new current version. Only models with static CTR provider (or without CTRs) are supported.
+        ui64 Publish(const TFullModel& model);
+
+        // 0 if no model has been published yet, follows the control segment if the registry has been recreated
+        ui64 GetCurrentVersion() const;
+
+        // Attaches current version read-only, version is set if not nullptr
+        TFullModel Attach(ui64* version = nullptr) const;
+
+        // Unlinks current version and control segments, attached models remain valid
+        void Remove();
+
+    private:
+        class TSharedMemoryMapping;
+
+    private:
+        TString RegistryName;
+
+        // control segment mapping for cheap version polling, mapped on first use
+        mutable TIntrusivePtr<TSharedMemoryMapping> ControlMapping;
+    };
+}
+
+
+/**
+ * Attach the current model of shared memory registry read-only (see NCB::TSharedModelRegistry).
+ * CTR value tables are not copied to process memory.
+ * @param registryName
+ * @param version if not nullptr, is set to attached model version, compare it with
+ *  NCB::TSharedModelRegistry::GetCurrentVersion to find out if the model has been updated
+ * @return
+ */
+TFullModel ReadModelFromSharedMemory(const TString& registryName, ui64* version = nullptr);
@@ -167,6 +167,7 @@ void TStaticCtrProvider::SetupBinFeatureIndexes(const TVector<TFloatFeature>& fl
 TIntrusivePtr<ICtrProvider> TStaticCtrProvider::Clone() const {
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     result->CtrData = CtrData;
+    result->ThinTablesDataHolders = ThinTablesDataHolders;
     return result;
 }
 
@@ -287,6 +288,12 @@ TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<cons
         return TIntrusivePtr<TStaticCtrProvider>();
     }
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
+    for (const auto& provider : providers) {
+        result->ThinTablesDataHolders.insert(
+            result->ThinTablesDataHolders.end(),
+            provider->ThinTablesDataHolders.begin(),
+            provider->ThinTablesDataHolders.end());
+    }
     if (providers.size() == 1) {
         result->CtrData = providers[0]->CtrData;
         return result;
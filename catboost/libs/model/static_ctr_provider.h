@@ -6,7 +6,9 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/hash.h>
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
+#include <util/generic/vector.h>
 
 #include <functional>
 
@@ -73,6 +75,9 @@ public:
 
 public:
     TCtrData CtrData;
+
+    // owners of memory that thin tables in CtrData point to (e.g. shared memory mappings)
+    TVector<TIntrusivePtr<TThrRefBase>> ThinTablesDataHolders;
 private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
@@ -0,0 +1,176 @@
+#include <catboost/libs/model/ut/lib/model_test_helpers.h>
+
+#include <catboost/libs/model/cpu/evaluation_workspace.h>
+#include <catboost/libs/model/model.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/yassert.h>
+
+#include <cstdlib>
+#include <new>
+
+using namespace NCB::NModelEvaluation;
+
+// Counts heap allocations made through global operator new by the current thread while a guard is alive
+static thread_local bool IsAllocationCountingEnabled = false;
+static thread_local size_t ThreadAllocationCount = 0;
+
+static void* CountedAllocate(size_t size) noexcept {
+    if (IsAllocationCountingEnabled) {
+        ++ThreadAllocationCount;
+    }
+    return malloc(size ? size : 1);
+}
+
+namespace {
+    class TAllocationCountingGuard {
+    public:
+        TAllocationCountingGuard() {
+            Y_VERIFY(!IsAllocationCountingEnabled, "Nested allocation counting guards are not supported");
+            ThreadAllocationCount = 0;
+            IsAllocationCountingEnabled = true;
+        }
+
+        ~TAllocationCountingGuard() {
+            IsAllocationCountingEnabled = false;
+        }
+
+        size_t GetAllocationCount() const {
+            return ThreadAllocationCount;
+        }
+    };
+}
+
+void* operator new(size_t size) {
+    if (void* ptr = CountedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* ptr = CountedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+static const TVector<TVector<float>> FEATURES = {
+    {0.f, 0.f, 0.f},
+    {3.f, 0.f, 0.f},
+    {0.f, 1.f, 0.f},
+    {3.f, 1.f, 0.f},
+    {0.f, 0.f, 1.f},
+    {3.f, 0.f, 1.f},
+    {0.f, 1.f, 1.f},
+    {3.f, 1.f, 1.f},
+};
+
+// evaluate once to warm up thread local buffers, then count allocations of repeated evaluations only
+template <class TEvaluate>
+static size_t CountSteadyStateAllocations(TEvaluate&& evaluate) {
+    evaluate();
+    TAllocationCountingGuard guard;
+    for (size_t iteration = 0; iteration < 10; ++iteration) {
+        evaluate();
+    }
+    return guard.GetAllocationCount();
+}
+
+static void CheckNoSteadyStateAllocations(const TFullModel& model) {
+    const size_t docCount = FEATURES.size();
+    const size_t approxDimension = model.GetDimensionsCount();
+    const size_t treeCount = model.GetTreeCount();
+
+    TVector<TConstArrayRef<float>> featureRefs(FEATURES.begin(), FEATURES.end());
+    const TVector<TVector<TStringBuf>> noCatFeatures(docCount);
+    TVector<double> predicts(docCount * approxDimension);
+    TVector<double> refPredicts(docCount * approxDimension);
+    TVector<double> stringCatPredicts(docCount * approxDimension);
+    TVector<double> singlePredict(approxDimension);
+    TVector<ui32> leafIndexes(docCount * treeCount);
+
+    UNIT_ASSERT_VALUES_EQUAL(CountSteadyStateAllocations([&] { model.CalcFlat(FEATURES, predicts); }), 0);
+    UNIT_ASSERT_VALUES_EQUAL(CountSteadyStateAllocations([&] { model.CalcFlat(featureRefs, refPredicts); }), 0);
+    UNIT_ASSERT_VALUES_EQUAL(
+        CountSteadyStateAllocations([&] { model.CalcFlatSingle(FEATURES[0], singlePredict); }),
+        0
+    );
+    UNIT_ASSERT_VALUES_EQUAL(
+        CountSteadyStateAllocations([&] { model.Calc(featureRefs, noCatFeatures, stringCatPredicts); }),
+        0
+    );
+    UNIT_ASSERT_VALUES_EQUAL(
+        CountSteadyStateAllocations([&] { model.CalcLeafIndexes(featureRefs, {}, leafIndexes); }),
+        0
+    );
+
+    UNIT_ASSERT_EQUAL(predicts, refPredicts);
+    UNIT_ASSERT_EQUAL(predicts, stringCatPredicts);
+    for (size_t dim = 0; dim < approxDimension; ++dim) {
+        UNIT_ASSERT_VALUES_EQUAL(singlePredict[dim], predicts[dim]);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TEvaluationAllocations) {
+    Y_UNIT_TEST(TestAllocationHookCountsAllocations) {
+        size_t allocationCount = 0;
+        {
+            TAllocationCountingGuard guard;
+            // explicit operator calls, unlike new expressions, are not elided by compiler
+            void* ptr = ::operator new(100);
+            ::operator delete(ptr);
+            allocationCount = guard.GetAllocationCount();
+        }
+        UNIT_ASSERT_VALUES_EQUAL(allocationCount, 1);
+
+        // allocations outside of the guard are not counted
+        void* ptr = ::operator new(100);
+        ::operator delete(ptr);
+        UNIT_ASSERT_VALUES_EQUAL(ThreadAllocationCount, 1);
+    }
+
+    Y_UNIT_TEST(TestNoAllocationsInSteadyState) {
+        CheckNoSteadyStateAllocations(SimpleFloatModel(2));
+        CheckNoSteadyStateAllocations(MultiValueFloatModel());
+    }
+
+    Y_UNIT_TEST(TestNoWorkspaceAllocationsInSteadyState) {
+        const auto model = SimpleFloatModel(2);
+        TVector<double> predicts(FEATURES.size());
+        model.CalcFlat(FEATURES, predicts);
+        const auto& workspace = GetThreadLocalCPUEvaluatorWorkspace();
+        const size_t allocationCount = workspace.GetAllocationCount();
+        for (size_t iteration = 0; iteration < 10; ++iteration) {
+            model.CalcFlat(FEATURES, predicts);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(allocationCount, workspace.GetAllocationCount());
+    }
+}
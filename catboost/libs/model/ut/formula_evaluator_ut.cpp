@@ -2,11 +2,14 @@
 
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/model/cpu/evaluator.h>
+#include <catboost/libs/model/eval_processing.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/train_lib/train_model.h>
 
 #include <library/unittest/registar.h>
 
+#include <util/random/fast.h>
+
 using namespace NCB;
 using namespace NCB::NModelEvaluation;
 
@@ -145,6 +148,90 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         };
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
+
+    Y_UNIT_TEST(TestCascadeClassEvaluation) {
+        const auto model = TrainFloatCatboostModel(40);
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(1000, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+        const double probabilityBorder = 0.62;
+
+        auto rawEvaluator = CreateCpuEvaluator(model);
+        TVector<double> rawValues(features.size());
+        rawEvaluator->CalcFlat(features, rawValues);
+        const double rawBorder = CalcBinclassRawValueBorder(probabilityBorder);
+        size_t positiveCount = 0;
+        for (auto& value : rawValues) {
+            value = value > rawBorder;
+            positiveCount += value;
+        }
+        UNIT_ASSERT(positiveCount > 0 && positiveCount < features.size());
+
+        for (size_t treeBlockSize : {1, 4, 10, 1000}) {
+            auto cascadeEvaluator = CreateCpuEvaluator(model);
+            cascadeEvaluator->SetPredictionType(EPredictionType::Class);
+            cascadeEvaluator->SetProperty("BinclassProbabilityBorder", ToString(probabilityBorder));
+            cascadeEvaluator->SetProperty("CascadeTreeBlockSize", ToString(treeBlockSize));
+            TVector<double> classes(features.size());
+            cascadeEvaluator->CalcFlat(features, classes);
+            UNIT_ASSERT_EQUAL(rawValues, classes);
+            for (size_t docId : xrange<size_t>(10)) {
+                double docClass = 0;
+                cascadeEvaluator->CalcFlatSingle(features[docId], MakeArrayRef(&docClass, 1));
+                UNIT_ASSERT_VALUES_EQUAL(rawValues[docId], docClass);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestFlatCalcSparse) {
+        const auto model = TrainFloatCatboostModel(40);
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(300, TVector<float>(3, 0.0f));
+        TVector<size_t> rowOffsets = {0};
+        TVector<ui32> flatFeatureIndexes;
+        TVector<float> values;
+        for (auto& doc : data) {
+            for (ui32 featureIdx : xrange<ui32>(doc.size())) {
+                if (rng.GenRandReal1() < 0.6) {
+                    continue;
+                }
+                doc[featureIdx] = rng.GenRandReal1() * 2 - 0.5;
+                flatFeatureIndexes.push_back(featureIdx);
+                values.push_back(doc[featureIdx]);
+            }
+            rowOffsets.push_back(values.size());
+        }
+        TCSRFlatFeaturesRef sparseFeatures{rowOffsets, flatFeatureIndexes, values};
+        UNIT_ASSERT_VALUES_EQUAL(sparseFeatures.GetDocCount(), data.size());
+
+        for (auto predictionType : {EPredictionType::RawFormulaVal, EPredictionType::Probability}) {
+            auto evaluator = CreateCpuEvaluator(model);
+            evaluator->SetPredictionType(predictionType);
+            TVector<double> expectedPredicts(data.size());
+            evaluator->CalcFlat(GetFeatureRef(data), expectedPredicts);
+            TVector<double> predicts(data.size());
+            evaluator->CalcFlatSparse(sparseFeatures, predicts);
+            UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+
+            TCSRFlatFeaturesRef singleDocFeatures{MakeArrayRef(rowOffsets).first(2), flatFeatureIndexes, values};
+            double singlePredict = 0;
+            evaluator->CalcFlatSparse(singleDocFeatures, MakeArrayRef(&singlePredict, 1));
+            UNIT_ASSERT_VALUES_EQUAL(expectedPredicts[0], singlePredict);
+        }
+    }
+
+    Y_UNIT_TEST(TestCompiledEvaluatorWithoutLibrary) {
+        auto model = SimpleFloatModel();
+        UNIT_ASSERT_EXCEPTION(model.SetEvaluatorType(EFormulaEvaluatorType::Compiled), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(model.SetCompiledEvaluator("nonexistent.compiled.so"), yexception);
+        // failed switches keep the current evaluator
+        CheckFlatCalcResult(model, xrange<double>(8), xrange<ui32>(8));
+    }
 }
 
 Y_UNIT_TEST_SUITE(TNonSymmetricTreeModel) {
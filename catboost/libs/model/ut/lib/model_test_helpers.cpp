@@ -14,13 +14,9 @@ using namespace NCB;
 using namespace NCB::NDataNewUT;
 
 
-TFullModel TrainFloatCatboostModel(int iterations, int seed) {
+TDataProviderPtr CreateRandomFloatPool(ui32 docCount, ui32 factorCount, int seed) {
     TFastRng64 rng(seed);
-    const ui32 docCount = 50000;
-    const ui32 factorCount = 3;
-
-    TDataProviders dataProviders;
-    dataProviders.Learn = CreateDataProvider(
+    return CreateDataProvider(
         [&] (IRawFeaturesOrderDataVisitor* visitor) {
             TDataMetaInfo metaInfo;
             metaInfo.HasTarget = true;
@@ -52,6 +48,11 @@ TFullModel TrainFloatCatboostModel(int iterations, int seed) {
             visitor->Finish();
         }
     );
+}
+
+TFullModel TrainFloatCatboostModel(int iterations, int seed) {
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreateRandomFloatPool(/*docCount*/ 50000, /*factorCount*/ 3, seed);
     dataProviders.Test.push_back(dataProviders.Learn);
 
 
@@ -3,6 +3,9 @@
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/model/model.h>
 
+// Float features and target are uniformly random.
+NCB::TDataProviderPtr CreateRandomFloatPool(ui32 docCount, ui32 factorCount, int seed);
+
 TFullModel TrainFloatCatboostModel(int iterations = 5, int seed = 123);
 
 NCB::TDataProviderPtr GetAdultPool();
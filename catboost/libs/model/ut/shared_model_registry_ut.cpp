@@ -0,0 +1,215 @@
+#include <catboost/libs/model/ut/lib/model_test_helpers.h>
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/shared_model_registry.h>
+#include <catboost/libs/model/static_ctr_provider.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/system/getpid.h>
+
+#include <atomic>
+
+#if defined(_unix_)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace NCB;
+
+static TVector<double> CalcCatOnly(const TFullModel& model) {
+    const TVector<TStringBuf> f[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}};
+    TVector<double> results(3);
+    model.Calc({}, f, results);
+    return results;
+}
+
+static bool IsSamePrediction(const TVector<double>& lhs, const TVector<double>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (auto i : xrange(lhs.size())) {
+        if (Abs(lhs[i] - rhs[i]) > 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(_unix_)
+namespace {
+    // removes segments of the registry even if the test fails
+    class TTestRegistry : public TSharedModelRegistry {
+    public:
+        explicit TTestRegistry(const TString& testName)
+            : TSharedModelRegistry(GetName(testName))
+        {
+            Remove();
+        }
+
+        ~TTestRegistry() {
+            Remove();
+        }
+
+        static TString GetName(const TString& testName) {
+            return "catboost_model_ut." + testName + "." + ToString(GetPID());
+        }
+    };
+}
+#endif
+
+Y_UNIT_TEST_SUITE(TSharedModelRegistry) {
+#if defined(_unix_)
+    Y_UNIT_TEST(TestPublishAttach) {
+        const TFullModel model = TrainCatOnlyModel();
+        TTestRegistry registry("publish_attach");
+
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetCurrentVersion(), 0);
+        UNIT_ASSERT_EXCEPTION(registry.Attach(), TCatBoostException);
+
+        const ui64 firstVersion = registry.Publish(model);
+        UNIT_ASSERT(firstVersion);
+
+        ui64 version = 0;
+        const TFullModel attached = ReadModelFromSharedMemory(TTestRegistry::GetName("publish_attach"), &version);
+        UNIT_ASSERT_VALUES_EQUAL(version, firstVersion);
+        UNIT_ASSERT_EQUAL(*attached.ObliviousTrees, *model.ObliviousTrees);
+
+        const auto* provider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+        const auto* attachedProvider = dynamic_cast<const TStaticCtrProvider*>(attached.CtrProvider.Get());
+        UNIT_ASSERT(provider && attachedProvider);
+        UNIT_ASSERT_VALUES_EQUAL(attachedProvider->CtrData.LearnCtrs.size(), provider->CtrData.LearnCtrs.size());
+        for (const auto& [ctrBase, table] : provider->CtrData.LearnCtrs) {
+            const auto& attachedTable = attachedProvider->CtrData.LearnCtrs.at(ctrBase);
+            UNIT_ASSERT(attachedTable.IsThin());
+            UNIT_ASSERT_EQUAL(attachedTable, table);
+        }
+
+        const auto expected = CalcCatOnly(model);
+        UNIT_ASSERT(IsSamePrediction(CalcCatOnly(attached), expected));
+
+        // attached model must outlive the publication of a new version
+        UNIT_ASSERT_VALUES_EQUAL(registry.Publish(model), firstVersion + 1);
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetCurrentVersion(), firstVersion + 1);
+        UNIT_ASSERT(IsSamePrediction(CalcCatOnly(attached), expected));
+        registry.Attach(&version);
+        UNIT_ASSERT_VALUES_EQUAL(version, firstVersion + 1);
+
+        registry.Remove();
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetCurrentVersion(), 0);
+        UNIT_ASSERT(IsSamePrediction(CalcCatOnly(attached), expected));
+    }
+
+    Y_UNIT_TEST(TestRecreatedRegistry) {
+        const TFullModel model = TrainCatOnlyModel();
+        TTestRegistry publisher("recreated");
+        TSharedModelRegistry reader(TTestRegistry::GetName("recreated"));
+
+        publisher.Publish(model);
+        ui64 attachedVersion = 0;
+        reader.Attach(&attachedVersion);
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetCurrentVersion(), attachedVersion);
+
+        // reader has cached the control segment that is unlinked now
+        publisher.Remove();
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetCurrentVersion(), 0);
+        const ui64 newVersion = publisher.Publish(model);
+        UNIT_ASSERT(newVersion > attachedVersion);
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetCurrentVersion(), newVersion);
+
+        ui64 version = 0;
+        const TFullModel attached = reader.Attach(&version);
+        UNIT_ASSERT_VALUES_EQUAL(version, newVersion);
+        UNIT_ASSERT(IsSamePrediction(CalcCatOnly(attached), CalcCatOnly(model)));
+    }
+
+    Y_UNIT_TEST(TestAttachFromOtherProcess) {
+        const TFullModel model = TrainCatOnlyModel();
+        TTestRegistry registry("other_process");
+        const ui64 publishedVersion = registry.Publish(model);
+        const auto expected = CalcCatOnly(model);
+
+        const pid_t childPid = fork();
+        UNIT_ASSERT(childPid != -1);
+        if (childPid == 0) {
+            int exitCode = 1;
+            try {
+                ui64 version = 0;
+                const TFullModel attached = ReadModelFromSharedMemory(
+                    TTestRegistry::GetName("other_process"),
+                    &version
+                );
+                if ((version == publishedVersion) && IsSamePrediction(CalcCatOnly(attached), expected)) {
+                    exitCode = 0;
+                }
+            } catch (...) {
+            }
+            _exit(exitCode);
+        }
+
+        int status = 0;
+        UNIT_ASSERT_VALUES_EQUAL(waitpid(childPid, &status, 0), childPid);
+        UNIT_ASSERT(WIFEXITED(status));
+        UNIT_ASSERT_VALUES_EQUAL(WEXITSTATUS(status), 0);
+    }
+
+    Y_UNIT_TEST(TestAttachWhilePublishing) {
+        const TFullModel model = TrainCatOnlyModel();
+        TTestRegistry registry("concurrent");
+        registry.Publish(model);
+        const auto expected = CalcCatOnly(model);
+
+        std::atomic<bool> publishingFinished{false};
+        std::atomic<bool> publisherFailed{false};
+        std::atomic<bool> readerFailed{false};
+        const auto publish = [&] () {
+            try {
+                for (auto i : xrange(200)) {
+                    Y_UNUSED(i);
+                    registry.Publish(model);
+                }
+            } catch (...) {
+                publisherFailed.store(true);
+            }
+            publishingFinished.store(true);
+        };
+        const auto attach = [&] () {
+            TSharedModelRegistry readerRegistry(TTestRegistry::GetName("concurrent"));
+            ui64 prevVersion = 0;
+            while (!publishingFinished.load() && !readerFailed.load()) {
+                try {
+                    ui64 version = 0;
+                    const TFullModel attached = readerRegistry.Attach(&version);
+                    if ((version < prevVersion) || !IsSamePrediction(CalcCatOnly(attached), expected)) {
+                        readerFailed.store(true);
+                    }
+                    prevVersion = version;
+                } catch (...) {
+                    readerFailed.store(true);
+                }
+            }
+        };
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        localExecutor.ExecRange(
+            [&] (int taskIdx) {
+                if (taskIdx == 0) {
+                    publish();
+                } else {
+                    attach();
+                }
+            },
+            0,
+            2,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        UNIT_ASSERT(!publisherFailed.load());
+        UNIT_ASSERT(!readerFailed.load());
+    }
+#endif
+}
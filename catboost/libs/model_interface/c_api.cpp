@@ -4,6 +4,7 @@
 #include <catboost/libs/model/model.h>
 
 #include <util/generic/singleton.h>
+#include <util/thread/singleton.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
 
@@ -14,6 +15,34 @@ struct TErrorMessageHolder {
     TString Message;
 };
 
+// per-thread feature references reused between calls to avoid allocations in steady state
+struct TFeatureRefsHolder {
+    TVector<TConstArrayRef<float>> FloatFeatures;
+    TVector<TConstArrayRef<int>> HashedCatFeatures;
+    TVector<TConstArrayRef<TStringBuf>> CatFeatures;
+    TVector<TStringBuf> CatFeaturesValues;
+
+    static TFeatureRefsHolder& Get(size_t docCount, size_t catFeaturesSize) {
+        TFeatureRefsHolder& holder = *FastTlsSingleton<TFeatureRefsHolder>();
+        holder.FloatFeatures.resize(docCount);
+        holder.HashedCatFeatures.resize(docCount);
+        holder.CatFeatures.resize(docCount);
+        holder.CatFeaturesValues.resize(docCount * catFeaturesSize);
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            holder.CatFeatures[docId] = MakeArrayRef(
+                holder.CatFeaturesValues.data() + docId * catFeaturesSize,
+                catFeaturesSize
+            );
+        }
+        return holder;
+    }
+
+    TArrayRef<TStringBuf> GetCatFeatures(size_t docId) {
+        const size_t catFeaturesSize = CatFeatures[docId].size();
+        return MakeArrayRef(CatFeaturesValues.data() + docId * catFeaturesSize, catFeaturesSize);
+    }
+};
+
 extern "C" {
 EXPORT ModelCalcerHandle* ModelCalcerCreate() {
     try {
@@ -74,7 +103,7 @@ EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCo
         if (docCount == 1) {
             FULL_MODEL_PTR(modelHandle)->CalcFlatSingle(TConstArrayRef<float>(*floatFeatures, floatFeaturesSize), TArrayRef<double>(result, resultSize));
         } else {
-            TVector<TConstArrayRef<float>> featuresVec(docCount);
+            auto& featuresVec = TFeatureRefsHolder::Get(docCount, 0).FloatFeatures;
             for (size_t i = 0; i < docCount; ++i) {
                 featuresVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             }
@@ -94,15 +123,20 @@ EXPORT bool CalcModelPrediction(
         const char*** catFeatures, size_t catFeaturesSize,
         double* result, size_t resultSize) {
     try {
-        TVector<TConstArrayRef<float>> floatFeaturesVec(docCount);
-        TVector<TVector<TStringBuf>> catFeaturesVec(docCount, TVector<TStringBuf>(catFeaturesSize));
+        auto& featureRefsHolder = TFeatureRefsHolder::Get(docCount, catFeaturesSize);
+        auto& floatFeaturesVec = featureRefsHolder.FloatFeatures;
         for (size_t i = 0; i < docCount; ++i) {
             floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
+            auto docCatFeatures = featureRefsHolder.GetCatFeatures(i);
             for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
-                catFeaturesVec[i][catFeatureIdx] = catFeatures[i][catFeatureIdx];
+                docCatFeatures[catFeatureIdx] = catFeatures[i][catFeatureIdx];
             }
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        FULL_MODEL_PTR(modelHandle)->GetCurrentEvaluator()->Calc<TStringBuf>(
+            floatFeaturesVec,
+            featureRefsHolder.CatFeatures,
+            TArrayRef<double>(result, resultSize)
+        );
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -116,13 +150,18 @@ EXPORT bool CalcModelPredictionSingle(
         const char** catFeatures, size_t catFeaturesSize,
         double* result, size_t resultSize) {
     try {
-        TVector<TConstArrayRef<float>> floatFeaturesVec(1);
-        TVector<TVector<TStringBuf>> catFeaturesVec(1, TVector<TStringBuf>(catFeaturesSize));
+        auto& featureRefsHolder = TFeatureRefsHolder::Get(1, catFeaturesSize);
+        auto& floatFeaturesVec = featureRefsHolder.FloatFeatures;
         floatFeaturesVec[0] = TConstArrayRef<float>(floatFeatures, floatFeaturesSize);
+        auto docCatFeatures = featureRefsHolder.GetCatFeatures(0);
         for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
-            catFeaturesVec[0][catFeatureIdx] = catFeatures[catFeatureIdx];
+            docCatFeatures[catFeatureIdx] = catFeatures[catFeatureIdx];
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        FULL_MODEL_PTR(modelHandle)->GetCurrentEvaluator()->Calc<TStringBuf>(
+            floatFeaturesVec,
+            featureRefsHolder.CatFeatures,
+            TArrayRef<double>(result, resultSize)
+        );
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -135,8 +174,9 @@ EXPORT bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* modelHan
                                                      const int** catFeatures, size_t catFeaturesSize,
                                                      double* result, size_t resultSize) {
     try {
-        TVector<TConstArrayRef<float>> floatFeaturesVec(docCount);
-        TVector<TConstArrayRef<int>> catFeaturesVec(docCount);
+        auto& featureRefsHolder = TFeatureRefsHolder::Get(docCount, 0);
+        auto& floatFeaturesVec = featureRefsHolder.FloatFeatures;
+        auto& catFeaturesVec = featureRefsHolder.HashedCatFeatures;
         for (size_t i = 0; i < docCount; ++i) {
             floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             catFeaturesVec[i] = TConstArrayRef<int>(catFeatures[i], catFeaturesSize);
@@ -22,6 +22,8 @@ NCatboostOptions::TObliviousTreeLearnerOptions::TObliviousTreeLearnerOptions(ETa
       , SamplingFrequency("sampling_frequency", ESamplingFrequency::PerTree, taskType)
       , ModelSizeReg("model_size_reg", 0.5, taskType)
       , DevScoreCalcObjBlockSize("dev_score_calc_obj_block_size", 5000000, taskType)
+      , DevLeafwiseScoring("dev_leafwise_scoring", false, taskType)
+      , DevLeafQuantilePrecision("dev_leaf_quantile_precision", 0.0f, taskType)
       , DevExclusiveFeaturesBundleMaxBuckets("dev_efb_max_buckets", 1 << 10, taskType)
       , SparseFeaturesConflictFraction("sparse_features_conflict_fraction", 0.0f, taskType)
       , ObservationsToBootstrap("observations_to_bootstrap", EObservationsToBootstrap::TestOnly, taskType) //it's specific for fold-based scheme, so here and not in bootstrap options
@@ -55,6 +57,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Load(const NJson::TJsonValu
             &LeavesEstimationBacktrackingType,
             &SamplingFrequency,
             &DevScoreCalcObjBlockSize,
+            &DevLeafwiseScoring,
+            &DevLeafQuantilePrecision,
             &DevExclusiveFeaturesBundleMaxBuckets,
             &SparseFeaturesConflictFraction,
             &GrowPolicy,
@@ -75,6 +79,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Save(NJson::TJsonValue* opt
             LeavesEstimationBacktrackingType,
             MaxCtrComplexityForBordersCaching, Rsm, ObservationsToBootstrap, SamplingFrequency,
             DevScoreCalcObjBlockSize,
+            DevLeafwiseScoring,
+            DevLeafQuantilePrecision,
             DevExclusiveFeaturesBundleMaxBuckets,
             SparseFeaturesConflictFraction,
             GrowPolicy,
@@ -88,15 +94,15 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
     return std::tie(MaxDepth, LeavesEstimationIterations, LeavesEstimationMethod, L2Reg, ModelSizeReg, RandomStrength,
             BootstrapConfig, Rsm, SamplingFrequency, ObservationsToBootstrap, FoldSizeLossNormalization,
             AddRidgeToTargetFunctionFlag, ScoreFunction, MaxCtrComplexityForBordersCaching,
-            PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize,
-            DevExclusiveFeaturesBundleMaxBuckets, SparseFeaturesConflictFraction,
+            PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize, DevLeafwiseScoring,
+            DevLeafQuantilePrecision, DevExclusiveFeaturesBundleMaxBuckets, SparseFeaturesConflictFraction,
             GrowPolicy, MaxLeaves, MinDataInLeaf, MonotoneConstraints
             ) ==
         std::tie(rhs.MaxDepth, rhs.LeavesEstimationIterations, rhs.LeavesEstimationMethod, rhs.L2Reg, rhs.ModelSizeReg,
                 rhs.RandomStrength, rhs.BootstrapConfig, rhs.Rsm, rhs.SamplingFrequency,
                 rhs.ObservationsToBootstrap, rhs.FoldSizeLossNormalization, rhs.AddRidgeToTargetFunctionFlag,
                 rhs.ScoreFunction, rhs.MaxCtrComplexityForBordersCaching, rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType,
-                rhs.DevScoreCalcObjBlockSize,
+                rhs.DevScoreCalcObjBlockSize, rhs.DevLeafwiseScoring, rhs.DevLeafQuantilePrecision,
                 rhs.DevExclusiveFeaturesBundleMaxBuckets, rhs.SparseFeaturesConflictFraction,
                 rhs.GrowPolicy, rhs.MaxLeaves, rhs.MinDataInLeaf, rhs.MonotoneConstraints);
 }
@@ -123,6 +129,14 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Validate() const {
         (SparseFeaturesConflictFraction.GetUnchecked() >= 0.f) && (SparseFeaturesConflictFraction.GetUnchecked() < 1.f),
         "SparseFeaturesConflictFraction should be in [0, 1)"
     );
+    // leaf quantile histograms have ceil(1 / precision) bins per leaf and per thread
+    const float minLeafQuantilePrecision = 1e-4f;
+    const float leafQuantilePrecision = DevLeafQuantilePrecision.GetUnchecked();
+    CB_ENSURE(
+        (leafQuantilePrecision == 0.f)
+            || ((leafQuantilePrecision >= minLeafQuantilePrecision) && (leafQuantilePrecision < 1.f)),
+        "DevLeafQuantilePrecision should be 0 or in [" << minLeafQuantilePrecision << ", 1)"
+    );
     CB_ENSURE(LeavesEstimationIterations.Get() > 0, "Leaves estimation iterations should be positive");
     CB_ENSURE(L2Reg.Get() >= 0, "L2LeafRegularizer should be >= 0, current value: " << L2Reg.Get());
     CB_ENSURE(PairwiseNonDiagReg.Get() >= 0, "PairwiseNonDiagReg should be >= 0, current value: " << PairwiseNonDiagReg.Get());
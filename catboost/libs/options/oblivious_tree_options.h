@@ -39,6 +39,12 @@ namespace NCatboostOptions {
         // changing this parameter can affect results due to numerical accuracy differences
         TCpuOnlyOption<ui32> DevScoreCalcObjBlockSize;
 
+        // keep docs ordered by leaves in score calculation
+        TCpuOnlyOption<bool> DevLeafwiseScoring;
+
+        // relative bin width of per-leaf residual histograms for Exact leaves estimation, 0 means exact quantiles
+        TCpuOnlyOption<float> DevLeafQuantilePrecision;
+
         TCpuOnlyOption<ui32> DevExclusiveFeaturesBundleMaxBuckets;
         TCpuOnlyOption<float> SparseFeaturesConflictFraction;
 
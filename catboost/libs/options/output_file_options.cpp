@@ -23,6 +23,8 @@ TString NCatboostOptions::GetModelExtensionFromType(const EModelType modelType)
             return "pmml";
         case EModelType::CPUSnapshot:
             return "cbsnapshot";
+        case EModelType::CppCompiled:
+            return "compiled.cpp";
     }
 }
 
@@ -72,6 +74,8 @@ NCatboostOptions::TOutputFilesOptions::TOutputFilesOptions()
     , Name("name", "experiment")
     , JsonLogPath("json_log", "catboost_training.json")
     , ProfileLogPath("profile_log", "catboost_profile.log")
+    , ProfileTracePath("profile_trace", "")
+    , ProfileHardwareCountersFlag("profile_hardware_counters", false)
     , LearnErrorLogPath("learn_error_log", "learn_error.tsv")
     , ModelFormats("model_format", {EModelType::CatboostBinary})
     , TestErrorLogPath("test_error_log", "test_error.tsv")
@@ -152,6 +156,14 @@ const TString& NCatboostOptions::TOutputFilesOptions::GetProfileLogFilename() co
     return ProfileLogPath.Get();
 }
 
+TString NCatboostOptions::TOutputFilesOptions::CreateProfileTraceFullPath() const {
+    return ProfileTracePath.Get().empty() ? TString() : GetFullPath(ProfileTracePath.Get());
+}
+
+bool NCatboostOptions::TOutputFilesOptions::CollectProfileHardwareCounters() const {
+    return ProfileHardwareCountersFlag.Get();
+}
+
 const TString& NCatboostOptions::TOutputFilesOptions::GetResultModelFilename() const {
     return ResultModelPath.Get();
 }
@@ -251,13 +263,15 @@ TString NCatboostOptions::TOutputFilesOptions::GetRocOutputPath() const {
 
 bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions& rhs) const {
     return std::tie(
-            TrainDir, Name, JsonLogPath, ProfileLogPath, LearnErrorLogPath, TestErrorLogPath,
+            TrainDir, Name, JsonLogPath, ProfileLogPath, ProfileTracePath, ProfileHardwareCountersFlag,
+            LearnErrorLogPath, TestErrorLogPath,
             TimeLeftLog, ResultModelPath, SnapshotPath, ModelFormats, SaveSnapshotFlag,
             AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, BestModelMinTrees,
             SnapshotSaveIntervalSeconds, EvalFileName, FstrRegularFileName, FstrInternalFileName, FstrType,
             TrainingOptionsFileName, OutputBordersFileName, RocOutputPath
             ) == std::tie(
-                rhs.TrainDir, rhs.Name, rhs.JsonLogPath, rhs.ProfileLogPath,
+                rhs.TrainDir, rhs.Name, rhs.JsonLogPath, rhs.ProfileLogPath, rhs.ProfileTracePath,
+                rhs.ProfileHardwareCountersFlag,
                 rhs.LearnErrorLogPath, rhs.TestErrorLogPath, rhs.TimeLeftLog, rhs.ResultModelPath,
                 rhs.SnapshotPath, rhs.ModelFormats, rhs.SaveSnapshotFlag, rhs.AllowWriteFilesFlag,
                 rhs.FinalCtrComputationMode, rhs.UseBestModel, rhs.BestModelMinTrees,
@@ -274,8 +288,8 @@ bool NCatboostOptions::TOutputFilesOptions::operator!=(const TOutputFilesOptions
 void NCatboostOptions::TOutputFilesOptions::Load(const NJson::TJsonValue& options) {
     CheckedLoad(
             options,
-            &TrainDir, &Name, &JsonLogPath, &ProfileLogPath, &LearnErrorLogPath,
-            &TestErrorLogPath, &TimeLeftLog, &ResultModelPath, &SnapshotPath, &ModelFormats,
+            &TrainDir, &Name, &JsonLogPath, &ProfileLogPath, &ProfileTracePath, &ProfileHardwareCountersFlag,
+            &LearnErrorLogPath, &TestErrorLogPath, &TimeLeftLog, &ResultModelPath, &SnapshotPath, &ModelFormats,
             &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &UseBestModel,
             &BestModelMinTrees, &SnapshotSaveIntervalSeconds, &EvalFileName, &OutputColumns,
             &FstrRegularFileName, &FstrInternalFileName, &FstrType, &TrainingOptionsFileName, &MetricPeriod,
@@ -290,7 +304,8 @@ void NCatboostOptions::TOutputFilesOptions::Load(const NJson::TJsonValue& option
 void NCatboostOptions::TOutputFilesOptions::Save(NJson::TJsonValue* options) const {
     SaveFields(
             options,
-            TrainDir, Name, JsonLogPath, ProfileLogPath, LearnErrorLogPath, TestErrorLogPath,
+            TrainDir, Name, JsonLogPath, ProfileLogPath, ProfileTracePath, ProfileHardwareCountersFlag,
+            LearnErrorLogPath, TestErrorLogPath,
             TimeLeftLog, ResultModelPath, SnapshotPath, ModelFormats, SaveSnapshotFlag,
             AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, BestModelMinTrees,
             SnapshotSaveIntervalSeconds, EvalFileName, OutputColumns, FstrRegularFileName,
@@ -54,6 +54,11 @@ namespace NCatboostOptions {
 
         const TString& GetProfileLogFilename() const;
 
+        // empty if profile trace is disabled
+        TString CreateProfileTraceFullPath() const;
+
+        bool CollectProfileHardwareCounters() const;
+
         const TString& GetResultModelFilename() const;
 
         const TString& GetSnapshotFilename() const;
@@ -107,6 +112,10 @@ namespace NCatboostOptions {
             SnapshotPath.Set(filename);
         }
 
+        void SetProfileTracePath(const TString& path) {
+            ProfileTracePath.Set(path);
+        }
+
 
         bool operator==(const TOutputFilesOptions& rhs) const;
         bool operator!=(const TOutputFilesOptions& rhs) const;
@@ -124,6 +133,8 @@ namespace NCatboostOptions {
         TOption<TString> Name;
         TOption<TString> JsonLogPath;
         TOption<TString> ProfileLogPath;
+        TOption<TString> ProfileTracePath;
+        TOption<bool> ProfileHardwareCountersFlag;
         TOption<TString> LearnErrorLogPath;
         TOption<TVector<EModelType>> ModelFormats;
         TOption<TString> TestErrorLogPath;
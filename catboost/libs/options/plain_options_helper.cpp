@@ -325,6 +325,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "meta", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "json_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "profile_log", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "profile_trace", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "profile_hardware_counters", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "learn_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "test_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "time_left_log", &outputFilesJson, &seenKeys);
@@ -384,6 +386,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "bayesian_matrix_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "model_size_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_score_calc_obj_block_size", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_leafwise_scoring", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_leaf_quantile_precision", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_efb_max_buckets", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "sparse_features_conflict_fraction", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "random_strength", &treeOptions, &seenKeys);
@@ -490,6 +494,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "node_type", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "node_port", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "file_with_hosts", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_numa_mode", &systemOptions, &seenKeys);
 
 
     //rest
@@ -556,6 +561,8 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
     DeleteSeenOption(&outputoptionsCopy, "meta");
     DeleteSeenOption(&outputoptionsCopy, "json_log");
     DeleteSeenOption(&outputoptionsCopy, "profile_log");
+    DeleteSeenOption(&outputoptionsCopy, "profile_trace");
+    DeleteSeenOption(&outputoptionsCopy, "profile_hardware_counters");
     DeleteSeenOption(&outputoptionsCopy, "learn_error_log");
     DeleteSeenOption(&outputoptionsCopy, "test_error_log");
     DeleteSeenOption(&outputoptionsCopy, "time_left_log");
@@ -671,6 +678,10 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
 
         DeleteSeenOption(&optionsCopyTree, "dev_score_calc_obj_block_size");
 
+        DeleteSeenOption(&optionsCopyTree, "dev_leafwise_scoring");
+
+        DeleteSeenOption(&optionsCopyTree, "dev_leaf_quantile_precision");
+
         DeleteSeenOption(&optionsCopyTree, "dev_efb_max_buckets");
 
         CopyOption(treeOptions, "sparse_features_conflict_fraction", &plainOptionsJson, &seenKeys);
@@ -903,6 +914,9 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(systemOptions, "file_with_hosts", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopySystemOptions, "file_with_hosts");
 
+        CopyOption(systemOptions, "dev_numa_mode", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopySystemOptions, "dev_numa_mode");
+
         CB_ENSURE(optionsCopySystemOptions.GetMapSafe().empty(), "system_options: key " + optionsCopySystemOptions.GetMapSafe().begin()->first + " wasn't added to plain options.");
         DeleteSeenOption(&optionsCopy, "system_options");
     }
@@ -948,6 +962,7 @@ void NCatboostOptions::CleanPlainJson(
     // options with no influence on the final model
     DeleteSeenOption(plainOptionsJsonEfficient, "objective_metric");
     DeleteSeenOption(plainOptionsJsonEfficient, "thread_count");
+    DeleteSeenOption(plainOptionsJsonEfficient, "dev_numa_mode");
     DeleteSeenOption(plainOptionsJsonEfficient, "allow_const_label");
     DeleteSeenOption(plainOptionsJsonEfficient, "detailed_profile");
     DeleteSeenOption(plainOptionsJsonEfficient, "logging_level");
@@ -17,6 +17,7 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
     , NodeType("node_type", ENodeType::SingleHost, taskType)
     , FileWithHosts("file_with_hosts", "hosts.txt", taskType)
     , NodePort("node_port", GetUnusedNodePort(), taskType)
+    , NumaMode("dev_numa_mode", false, taskType)
 {
     Devices.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
     GpuRamPart.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
@@ -24,18 +25,19 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
 }
 
 void TSystemOptions::Load(const NJson::TJsonValue& options) {
-    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort);
+    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort, &NumaMode);
 }
 
 void TSystemOptions::Save(NJson::TJsonValue* options) const {
-    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort);
+    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort, NumaMode);
 }
 
 bool TSystemOptions::operator==(const TSystemOptions& rhs) const {
     return std::tie(NumThreads, CpuUsedRamLimit, Devices,
-                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort) ==
+                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort, NumaMode) ==
            std::tie(rhs.NumThreads, rhs.CpuUsedRamLimit, rhs.Devices,
-                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort);
+                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort,
+                    rhs.NumaMode);
 }
 
 bool TSystemOptions::operator!=(const TSystemOptions& rhs) const {
@@ -29,6 +29,7 @@ namespace NCatboostOptions {
         TCpuOnlyOption<ENodeType> NodeType;
         TCpuOnlyOption<TString> FileWithHosts;
         TCpuOnlyOption<ui32> NodePort;
+        TCpuOnlyOption<bool> NumaMode;
 
         static ui32 GetUnusedNodePort() { return 0; }
         bool IsMaster() const;
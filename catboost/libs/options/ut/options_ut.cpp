@@ -5,6 +5,8 @@
 #include <catboost/libs/options/enums.h>
 #include <catboost/libs/options/system_options.h>
 #include <catboost/libs/options/catboost_options.h>
+#include <catboost/libs/options/oblivious_tree_options.h>
+#include <catboost/libs/helpers/exception.h>
 
 Y_UNIT_TEST_SUITE(TOptionsTest) {
     using namespace NCatboostOptions;
@@ -124,6 +126,18 @@ Y_UNIT_TEST_SUITE(TOptionsTest) {
         TestSaveLoad(options, ETaskType::CPU);
     }
 
+    Y_UNIT_TEST(TestLeafQuantilePrecisionBounds) {
+        TObliviousTreeLearnerOptions options(ETaskType::CPU);
+        for (float precision : {0.f, 1e-4f, 0.01f, 0.5f}) {
+            options.DevLeafQuantilePrecision = precision;
+            options.Validate();
+        }
+        for (float precision : {-0.1f, 1e-9f, 9e-5f, 1.f}) {
+            options.DevLeafQuantilePrecision = precision;
+            UNIT_ASSERT_EXCEPTION(options.Validate(), TCatBoostException);
+        }
+    }
+
     Y_UNIT_TEST(TestGpuOptions) {
         TCatBoostOptions options(ETaskType::GPU);
         options.SetNotSpecifiedOptionsToDefaults();
@@ -5,7 +5,12 @@
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 #include <catboost/idl/pool/proto/metainfo.pb.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/column_description/cd_parser.h>
+#include <catboost/libs/data_new/borders_io.h>
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/quantization.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/quantized_pool/detail.h>
 #include <catboost/libs/quantization_schema/detail.h>
 #include <catboost/libs/quantization_schema/serialization.h>
@@ -19,11 +24,14 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
@@ -117,28 +125,52 @@ namespace {
     };
 }
 
-static void WriteChunk(
-    const NCB::TQuantizedPool::TChunkDescription& chunk,
-    TCountingOutput* const output,
-    TDeque<TChunkInfo>* const chunkInfos,
+static void SerializeChunk(
+    const NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+    const TConstArrayRef<ui8> quants,
     flatbuffers::FlatBufferBuilder* const builder) {
 
     builder->Clear();
 
-    const auto quantsOffset = builder->CreateVector(
-        chunk.Chunk->Quants()->data(),
-        chunk.Chunk->Quants()->size());
+    const auto quantsOffset = builder->CreateVector(quants.data(), quants.size());
     NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
-    chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
+    chunkBuilder.add_BitsPerDocument(bitsPerDocument);
     chunkBuilder.add_Quants(quantsOffset);
     builder->Finish(chunkBuilder.Finish());
+}
+
+static void WriteSerializedChunk(
+    const TConstArrayRef<ui8> serializedChunk,
+    const ui32 documentOffset,
+    const ui32 documentCount,
+    TCountingOutput* const output,
+    TDeque<TChunkInfo>* const chunkInfos) {
 
     AddPadding(16, output);
 
     const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
+    output->Write(serializedChunk.data(), serializedChunk.size());
 
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    chunkInfos->emplace_back(serializedChunk.size(), chunkOffset, documentOffset, documentCount);
+}
+
+static void WriteChunk(
+    const NCB::TQuantizedPool::TChunkDescription& chunk,
+    TCountingOutput* const output,
+    TDeque<TChunkInfo>* const chunkInfos,
+    flatbuffers::FlatBufferBuilder* const builder) {
+
+    SerializeChunk(
+        chunk.Chunk->BitsPerDocument(),
+        MakeArrayRef(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size()),
+        builder);
+
+    WriteSerializedChunk(
+        MakeArrayRef(builder->GetBufferPointer(), builder->GetSize()),
+        chunk.DocumentOffset,
+        chunk.DocumentCount,
+        output,
+        chunkInfos);
 }
 
 static void WriteHeader(TCountingOutput* const output) {
@@ -229,6 +261,60 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
+static void WriteEpilog(
+    const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+    const TConstArrayRef<EColumn> columnTypes,
+    const TConstArrayRef<TString> columnNames,
+    const size_t documentCount,
+    const TConstArrayRef<size_t> ignoredColumnIndices,
+    const TPoolQuantizationSchema& quantizationSchema,
+    const TDeque<TDeque<TChunkInfo>>& perFeatureChunkInfos, // [localIndex]
+    const ui64 chunksOffset,
+    TCountingOutput* const output) {
+
+    const ui64 poolMetainfoSizeOffset = output->Counter();
+    {
+        const auto poolMetainfo = MakePoolMetainfo(
+            columnIndexToLocalIndex,
+            columnTypes,
+            columnNames,
+            documentCount,
+            ignoredColumnIndices);
+        const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
+        WriteLittleEndian(poolMetainfoSize, output);
+        poolMetainfo.SerializeToStream(output);
+    }
+
+    const ui64 quantizationSchemaSizeOffset = output->Counter();
+    const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
+    WriteLittleEndian(quantizationSchemaSize, output);
+    quantizationSchema.SerializeToStream(output);
+
+    const auto sortedTrueFeatureIndices = CollectAndSortKeys(columnIndexToLocalIndex);
+    const ui64 featureCountOffset = output->Counter();
+    const ui32 featureCount = sortedTrueFeatureIndices.size();
+    WriteLittleEndian(featureCount, output);
+    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
+        const auto localIndex = columnIndexToLocalIndex.at(trueFeatureIndex);
+        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
+
+        WriteLittleEndian(trueFeatureIndex, output);
+        WriteLittleEndian(chunkCount, output);
+        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
+            WriteLittleEndian(chunkInfo.Size, output);
+            WriteLittleEndian(chunkInfo.Offset, output);
+            WriteLittleEndian(chunkInfo.DocumentOffset, output);
+            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, output);
+        }
+    }
+
+    WriteLittleEndian(chunksOffset, output);
+    WriteLittleEndian(poolMetainfoSizeOffset, output);
+    WriteLittleEndian(quantizationSchemaSizeOffset, output);
+    WriteLittleEndian(featureCountOffset, output);
+    output->Write(MagicEnd, MagicEndSize);
+}
+
 static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
     TCountingOutput output(slave);
 
@@ -250,46 +336,16 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
         }
     }
 
-    const ui64 poolMetainfoSizeOffset = output.Counter();
-    {
-        const auto poolMetainfo = MakePoolMetainfo(
-            pool.ColumnIndexToLocalIndex,
-            pool.ColumnTypes,
-            pool.ColumnNames,
-            pool.DocumentCount,
-            pool.IgnoredColumnIndices);
-        const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
-        WriteLittleEndian(poolMetainfoSize, &output);
-        poolMetainfo.SerializeToStream(&output);
-    }
-
-    const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
-    WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToStream(&output);
-
-    const ui64 featureCountOffset = output.Counter();
-    const ui32 featureCount = sortedTrueFeatureIndices.size();
-    WriteLittleEndian(featureCount, &output);
-    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
-        const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
-
-        WriteLittleEndian(trueFeatureIndex, &output);
-        WriteLittleEndian(chunkCount, &output);
-        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
-            WriteLittleEndian(chunkInfo.Size, &output);
-            WriteLittleEndian(chunkInfo.Offset, &output);
-            WriteLittleEndian(chunkInfo.DocumentOffset, &output);
-            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &output);
-        }
-    }
-
-    WriteLittleEndian(chunksOffset, &output);
-    WriteLittleEndian(poolMetainfoSizeOffset, &output);
-    WriteLittleEndian(quantizationSchemaSizeOffset, &output);
-    WriteLittleEndian(featureCountOffset, &output);
-    output.Write(MagicEnd, MagicEndSize);
+    WriteEpilog(
+        pool.ColumnIndexToLocalIndex,
+        pool.ColumnTypes,
+        pool.ColumnNames,
+        pool.DocumentCount,
+        pool.IgnoredColumnIndices,
+        pool.QuantizationSchema,
+        perFeatureChunkInfos,
+        chunksOffset,
+        &output);
 }
 
 void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
@@ -784,83 +840,247 @@ NCB::NIdl::TPoolMetainfo NCB::LoadPoolMetainfo(const TStringBuf path) {
 
 namespace NCB {
 
-    template <class T>
-    static void AddToPool(const TSrcColumn<T>& srcColumn, TQuantizedPool* quantizedPool) {
-        quantizedPool->ColumnTypes.push_back(srcColumn.Type);
+    namespace {
+        struct TSrcColumnParts {
+            EColumn Type;
+            NIdl::EBitsPerDocumentFeature BitsPerDocument;
+            TVector<TConstArrayRef<ui8>> Parts; // [partIdx]
+            TVector<ui32> PartDocumentCounts; // [partIdx]
+        };
+    }
+
 
-        size_t documentOffset = 0;
-        TVector<TQuantizedPool::TChunkDescription> chunks;
+    template <class T>
+    static void AddSrcColumnParts(const TSrcColumn<T>& srcColumn, TVector<TSrcColumnParts>* columns) {
+        TSrcColumnParts column;
+        column.Type = srcColumn.Type;
+        column.BitsPerDocument = static_cast<NIdl::EBitsPerDocumentFeature>(sizeof(T)*8);
         for (const auto& dataPart : srcColumn.Data) {
-            flatbuffers::FlatBufferBuilder builder;
-            builder.Finish(
-                NIdl::CreateTQuantizedFeatureChunk(
-                    builder,
-                    static_cast<NIdl::EBitsPerDocumentFeature>(sizeof(T)*8),
-                    builder.CreateVector(
-                        reinterpret_cast<const ui8*>(dataPart.data()),
-                        sizeof(T)*dataPart.size()
-                    )
-                )
-            );
-            quantizedPool->Blobs.push_back(TBlob::Copy(builder.GetBufferPointer(), builder.GetSize()));
-
-            chunks.emplace_back(
-                documentOffset,
-                documentOffset + dataPart.size(),
-                flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(
-                    quantizedPool->Blobs.back().AsCharPtr()
-                )
+            column.Parts.push_back(
+                MakeArrayRef(reinterpret_cast<const ui8*>(dataPart.data()), sizeof(T)*dataPart.size())
             );
-            documentOffset += dataPart.size();
+            column.PartDocumentCounts.push_back(dataPart.size());
         }
-        quantizedPool->Chunks.push_back(std::move(chunks));
+        columns->push_back(std::move(column));
     }
 
 
     template <class T>
-    static void AddToPool(const TMaybe<TSrcColumn<T>>& srcColumn, TQuantizedPool* quantizedPool) {
+    static void AddSrcColumnParts(const TMaybe<TSrcColumn<T>>& srcColumn, TVector<TSrcColumnParts>* columns) {
         if (srcColumn) {
-            AddToPool(*srcColumn, quantizedPool);
+            AddSrcColumnParts(*srcColumn, columns);
         }
     }
 
 
-    void SaveQuantizedPool(
-        const TSrcData& srcData,
-        TString fileName
-    ) {
-        TQuantizedPool pool;
-        pool.DocumentCount = srcData.DocumentCount;
-        for (auto localIndex : xrange(srcData.LocalIndexToColumnIndex.size())) {
-            pool.ColumnIndexToLocalIndex.emplace(srcData.LocalIndexToColumnIndex[localIndex], localIndex);
-        }
-        pool.QuantizationSchema = QuantizationSchemaToProto(srcData.PoolQuantizationSchema);
-        pool.ColumnNames = srcData.ColumnNames;
-        pool.IgnoredColumnIndices = srcData.IgnoredColumnIndices;
+    // in the order of local indices
+    static TVector<TSrcColumnParts> GetSrcColumnParts(const TSrcData& srcData) {
+        TVector<TSrcColumnParts> columns;
 
-        AddToPool(srcData.GroupIds, &pool);
-        AddToPool(srcData.SubgroupIds, &pool);
+        AddSrcColumnParts(srcData.GroupIds, &columns);
+        AddSrcColumnParts(srcData.SubgroupIds, &columns);
 
         for (const auto& floatFeature : srcData.FloatFeatures) {
             if (floatFeature) {
-                AddToPool(*floatFeature, &pool);
+                AddSrcColumnParts(*floatFeature, &columns);
             } else {
-                AddToPool(TSrcColumn<ui8>{EColumn::Num, {{}}}, &pool);
+                columns.push_back(
+                    TSrcColumnParts{EColumn::Num, NIdl::EBitsPerDocumentFeature_BPDF_8, {TConstArrayRef<ui8>()}, {0}}
+                );
             }
         }
 
-        AddToPool(srcData.Target, &pool);
+        AddSrcColumnParts(srcData.Target, &columns);
 
         for (const auto& oneBaseline : srcData.Baseline) {
-            AddToPool(oneBaseline, &pool);
+            AddSrcColumnParts(oneBaseline, &columns);
+        }
+
+        AddSrcColumnParts(srcData.Weights, &columns);
+        AddSrcColumnParts(srcData.GroupWeights, &columns);
+
+        return columns;
+    }
+
+
+    class TQuantizedPoolWriter::TImpl {
+    public:
+        TImpl(IOutputStream* output, NPar::TLocalExecutor* localExecutor)
+            : Output(output)
+            , LocalExecutor(localExecutor)
+        {
+            WriteHeader(&Output);
+            ChunksOffset = Output.Counter();
+        }
+
+        void AddBlock(const TSrcData& srcDataBlock) {
+            CB_ENSURE_INTERNAL(!Finished, "Can't add blocks to finished quantized pool");
+
+            const TVector<TSrcColumnParts> columns = GetSrcColumnParts(srcDataBlock);
+            if (!HasBlocks) {
+                InitColumns(srcDataBlock, columns);
+            } else {
+                CB_ENSURE(
+                    columns.size() == ColumnTypes.size(),
+                    "All blocks of quantized pool must have the same columns"
+                );
+                for (auto localIndex : xrange(columns.size())) {
+                    CB_ENSURE(
+                        columns[localIndex].Type == ColumnTypes[localIndex],
+                        "All blocks of quantized pool must have the same columns"
+                    );
+                }
+            }
+
+            struct TBlockChunk {
+                ui32 LocalIndex;
+                ui32 PartIdx;
+                ui32 DocumentOffset; // in the whole pool
+            };
+
+            // chunks of a block are written in the order of column indices, as in WriteAsOneFile
+            TVector<TBlockChunk> blockChunks;
+            for (auto localIndex : SortedLocalIndices) {
+                const auto& column = columns[localIndex];
+                ui32 documentOffset = SafeIntegerCast<ui32>(DocumentCount);
+                for (auto partIdx : xrange(column.Parts.size())) {
+                    blockChunks.push_back(TBlockChunk{localIndex, (ui32)partIdx, documentOffset});
+                    documentOffset += column.PartDocumentCounts[partIdx];
+                }
+            }
+
+            TVector<TVector<ui8>> serializedChunks(blockChunks.size());
+            LocalExecutor->ExecRange(
+                [&] (int chunkIdx) {
+                    const auto& blockChunk = blockChunks[chunkIdx];
+                    const auto& column = columns[blockChunk.LocalIndex];
+                    flatbuffers::FlatBufferBuilder builder;
+                    SerializeChunk(column.BitsPerDocument, column.Parts[blockChunk.PartIdx], &builder);
+                    serializedChunks[chunkIdx].assign(
+                        builder.GetBufferPointer(),
+                        builder.GetBufferPointer() + builder.GetSize());
+                },
+                0,
+                SafeIntegerCast<int>(blockChunks.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+
+            for (auto chunkIdx : xrange(blockChunks.size())) {
+                const auto& blockChunk = blockChunks[chunkIdx];
+                WriteSerializedChunk(
+                    serializedChunks[chunkIdx],
+                    blockChunk.DocumentOffset,
+                    columns[blockChunk.LocalIndex].PartDocumentCounts[blockChunk.PartIdx],
+                    &Output,
+                    &PerColumnChunkInfos[blockChunk.LocalIndex]);
+                TVector<ui8>().swap(serializedChunks[chunkIdx]);
+            }
+
+            DocumentCount += srcDataBlock.DocumentCount;
         }
 
-        AddToPool(srcData.Weights, &pool);
-        AddToPool(srcData.GroupWeights, &pool);
+        void Finish() {
+            CB_ENSURE_INTERNAL(!Finished, "Quantized pool is already finished");
+            CB_ENSURE(HasBlocks, "Can't write quantized pool without data");
+
+            WriteEpilog(
+                ColumnIndexToLocalIndex,
+                ColumnTypes,
+                ColumnNames,
+                DocumentCount,
+                IgnoredColumnIndices,
+                QuantizationSchema,
+                PerColumnChunkInfos,
+                ChunksOffset,
+                &Output);
+            Output.Flush();
+            Finished = true;
+        }
+
+    private:
+        void InitColumns(const TSrcData& srcDataBlock, TConstArrayRef<TSrcColumnParts> columns) {
+            CB_ENSURE_INTERNAL(
+                srcDataBlock.LocalIndexToColumnIndex.size() == columns.size(),
+                "LocalIndexToColumnIndex size does not correspond to the number of columns"
+            );
+            for (auto localIndex : xrange(columns.size())) {
+                ColumnIndexToLocalIndex.emplace(srcDataBlock.LocalIndexToColumnIndex[localIndex], localIndex);
+                ColumnTypes.push_back(columns[localIndex].Type);
+            }
+            for (auto columnIndex : CollectAndSortKeys(ColumnIndexToLocalIndex)) {
+                SortedLocalIndices.push_back(ColumnIndexToLocalIndex.at(columnIndex));
+            }
+            ColumnNames = srcDataBlock.ColumnNames;
+            IgnoredColumnIndices = srcDataBlock.IgnoredColumnIndices;
+            QuantizationSchema = QuantizationSchemaToProto(srcDataBlock.PoolQuantizationSchema);
+            PerColumnChunkInfos.resize(columns.size());
+            HasBlocks = true;
+        }
+
+    private:
+        TCountingOutput Output;
+        NPar::TLocalExecutor* LocalExecutor;
+        ui64 ChunksOffset = 0;
 
+        bool HasBlocks = false;
+        bool Finished = false;
 
+        THashMap<size_t, size_t> ColumnIndexToLocalIndex;
+        TVector<ui32> SortedLocalIndices; // by column index
+        TVector<EColumn> ColumnTypes;
+        TVector<TString> ColumnNames;
+        TVector<size_t> IgnoredColumnIndices;
+        NIdl::TPoolQuantizationSchema QuantizationSchema;
+
+        TDeque<TDeque<TChunkInfo>> PerColumnChunkInfos; // [localIndex]
+        size_t DocumentCount = 0;
+    };
+
+
+    TQuantizedPoolWriter::TQuantizedPoolWriter(IOutputStream* output, NPar::TLocalExecutor* localExecutor)
+        : Impl(MakeHolder<TImpl>(output, localExecutor))
+    {
+    }
+
+    TQuantizedPoolWriter::~TQuantizedPoolWriter() = default;
+
+    void TQuantizedPoolWriter::AddBlock(const TSrcData& srcDataBlock) {
+        Impl->AddBlock(srcDataBlock);
+    }
+
+    void TQuantizedPoolWriter::Finish() {
+        Impl->Finish();
+    }
+
+
+    static void SaveQuantizedPool(
+        const TSrcData& srcData,
+        const TString& fileName,
+        NPar::TLocalExecutor* localExecutor
+    ) {
         TFileOutput output(fileName);
-        SaveQuantizedPool(pool, &output);
+        TQuantizedPoolWriter writer(&output, localExecutor);
+        writer.AddBlock(srcData);
+        writer.Finish();
+    }
+
+
+    // shared executor with all CPUs, repeated saves do not start new threads
+    static NPar::TLocalExecutor* GetSaveLocalExecutor() {
+        auto& localExecutor = NPar::LocalExecutor();
+        const int additionalThreadCount = NSystemInfo::CachedNumberOfCpus() - 1;
+        if (localExecutor.GetThreadCount() < additionalThreadCount) {
+            localExecutor.RunAdditionalThreads(additionalThreadCount - localExecutor.GetThreadCount());
+        }
+        return &localExecutor;
+    }
+
+
+    void SaveQuantizedPool(
+        const TSrcData& srcData,
+        TString fileName
+    ) {
+        SaveQuantizedPool(srcData, fileName, GetSaveLocalExecutor());
     }
 
 
@@ -1019,13 +1239,229 @@ namespace NCB {
 
 
     void SaveQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName) {
-        const auto threadCount = NSystemInfo::CachedNumberOfCpus();
-        NPar::TLocalExecutor localExecutor;
-        localExecutor.RunAdditionalThreads(threadCount);
+        auto* localExecutor = GetSaveLocalExecutor();
 
         TSrcData srcData;
-        BuildSrcDataFromDataProvider(dataProvider, &localExecutor, &srcData);
+        BuildSrcDataFromDataProvider(dataProvider, localExecutor, &srcData);
+
+        SaveQuantizedPool(srcData, fileName, localExecutor);
+    }
+
+
+    // processBlock(TDataProviderPtr block) returns false to stop reading
+    template <class TProcessBlock>
+    static void ProcessDsvPoolByBlocks(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<TString>& classNames,
+        ui32 blockSize,
+        NPar::TLocalExecutor* localExecutor,
+        TProcessBlock&& processBlock
+    ) {
+        auto datasetLoader = GetProcessor<IDatasetLoader>(
+            poolPath, // for choosing processor
+
+            // processor args
+            TDatasetLoaderPullArgs {
+                poolPath,
+
+                TDatasetLoaderCommonArgs {
+                    /*PairsFilePath=*/TPathWithScheme(),
+                    /*GroupWeightsFilePath=*/TPathWithScheme(),
+                    /*BaselineFilePath=*/TPathWithScheme(),
+                    classNames,
+                    dsvPoolFormatParams.Format,
+                    MakeCdProviderFromFile(dsvPoolFormatParams.CdFilePath),
+                    /*ignoredFeatures*/ {},
+                    EObjectsOrder::Undefined,
+                    blockSize,
+                    TDatasetSubset::MakeColumns(),
+                    localExecutor
+                }
+            }
+        );
+        auto* rawObjectsOrderDatasetLoader = dynamic_cast<IRawObjectsOrderDatasetLoader*>(datasetLoader.Get());
+        CB_ENSURE(rawObjectsOrderDatasetLoader, "Pool " << poolPath.Path << " can't be read by blocks");
+
+        THolder<IDataProviderBuilder> dataProviderBuilder = CreateDataProviderBuilder(
+            datasetLoader->GetVisitorType(),
+            TDataProviderBuilderOptions{},
+            TDatasetSubset::MakeColumns(),
+            localExecutor
+        );
+        CB_ENSURE_INTERNAL(
+            dataProviderBuilder,
+            "Failed to create data provider builder for visitor of type " << datasetLoader->GetVisitorType()
+        );
+        auto* visitor = dynamic_cast<IRawObjectsOrderDataVisitor*>(dataProviderBuilder.Get());
+        CB_ENSURE_INTERNAL(visitor, "failed cast of IDataProviderBuilder to IRawObjectsOrderDataVisitor");
+
+        while (rawObjectsOrderDatasetLoader->DoBlock(visitor)) {
+            if (!processBlock(dataProviderBuilder->GetResult())) {
+                return;
+            }
+        }
+        auto lastResult = dataProviderBuilder->GetLastResult();
+        if (lastResult) {
+            processBlock(std::move(lastResult));
+        }
+    }
+
+
+    void ConvertDsvPoolToQuantizedPool(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TMaybe<TString>& bordersFile,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        const TVector<TString>& classNames,
+        ui32 blockSize,
+        const TString& outputFileName,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.CpuCompatibleFormat = false; // features are saved as plain per-feature arrays
+        TRestorableFastRng64 rand(0);
+
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo;
+        TVector<TFloatFeatureIdx> featuresWithoutBorders;
+
+        // the first pass: uniform sample of objects of the whole pool (reservoir sampling)
+        //  for features without borders in bordersFile, the same sample size as in Quantize
+        const ui32 sampleSize = quantizationOptions.MaxSubsetSizeForSlowBuildBordersAlgorithms;
+        TVector<TVector<float>> sample; // [featureWithoutBordersIdx][sampleIdx]
+        ui64 objectCount = 0;
+
+        ProcessDsvPoolByBlocks(
+            poolPath,
+            dsvPoolFormatParams,
+            classNames,
+            blockSize,
+            localExecutor,
+            [&] (TDataProviderPtr block) {
+                if (!quantizedFeaturesInfo) {
+                    const auto& featuresLayout = *block->MetaInfo.FeaturesLayout;
+                    quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+                        featuresLayout,
+                        TConstArrayRef<ui32>(),
+                        binarizationOptions
+                    );
+                    if (bordersFile) {
+                        LoadBordersAndNanModesFromFromFileInMatrixnetFormat(
+                            *bordersFile,
+                            quantizedFeaturesInfo.Get()
+                        );
+                    }
+                    featuresLayout.IterateOverAvailableFeatures<EFeatureType::Float>(
+                        [&] (TFloatFeatureIdx floatFeatureIdx) {
+                            if (!quantizedFeaturesInfo->HasBorders(floatFeatureIdx)) {
+                                featuresWithoutBorders.push_back(floatFeatureIdx);
+                            }
+                        }
+                    );
+                    if (featuresWithoutBorders.empty()) {
+                        return false;
+                    }
+                    sample.resize(featuresWithoutBorders.size());
+                }
+
+                const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(block->ObjectsData.Get());
+                CB_ENSURE_INTERNAL(rawObjectsData, "Pool block is not raw");
+
+                TVector<TMaybeOwningArrayHolder<float>> blockValues;
+                for (auto floatFeatureIdx : featuresWithoutBorders) {
+                    blockValues.push_back(
+                        (*rawObjectsData->GetFloatFeature(*floatFeatureIdx))->ExtractValues(localExecutor)
+                    );
+                }
+
+                for (auto objectIdx : xrange(block->GetObjectCount())) {
+                    const ui64 sampleIdx = objectCount < sampleSize ? objectCount : rand.Uniform(objectCount + 1);
+                    ++objectCount;
+                    if (sampleIdx >= sampleSize) {
+                        continue;
+                    }
+                    for (auto i : xrange(featuresWithoutBorders.size())) {
+                        const float value = (*blockValues[i])[objectIdx];
+                        if (sampleIdx == sample[i].size()) {
+                            sample[i].push_back(value);
+                        } else {
+                            sample[i][sampleIdx] = value;
+                        }
+                    }
+                }
+                return true;
+            }
+        );
+        CB_ENSURE(quantizedFeaturesInfo, "Pool " << poolPath.Path << " is empty");
+
+        TVector<ENanMode> nanModes(featuresWithoutBorders.size());
+        TVector<TVector<float>> borders(featuresWithoutBorders.size());
+        const auto& featuresLayout = *quantizedFeaturesInfo->GetFeaturesLayout();
+        localExecutor->ExecRangeWithThrow(
+            [&] (int i) {
+                const ui32 featureId = featuresLayout.GetExternalFeatureIdx(
+                    *featuresWithoutBorders[i],
+                    EFeatureType::Float
+                );
+                TVector<float> nonNanValues;
+                nonNanValues.reserve(sample[i].size());
+                bool hasNans = false;
+                for (auto value : sample[i]) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        nonNanValues.push_back(value);
+                    }
+                }
+                TVector<float>().swap(sample[i]);
+
+                CalcBordersAndNanMode(
+                    quantizedFeaturesInfo->GetFloatFeatureBinarization(featureId),
+                    featureId,
+                    hasNans,
+                    &nonNanValues,
+                    &nanModes[i],
+                    &borders[i]
+                );
+            },
+            0,
+            SafeIntegerCast<int>(featuresWithoutBorders.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        for (auto i : xrange(featuresWithoutBorders.size())) {
+            quantizedFeaturesInfo->SetBorders(featuresWithoutBorders[i], std::move(borders[i]));
+            quantizedFeaturesInfo->SetNanMode(featuresWithoutBorders[i], nanModes[i]);
+        }
+
+        // the second pass: quantization of blocks with the borders of the whole pool
+        TFileOutput output(outputFileName);
+        TQuantizedPoolWriter writer(&output, localExecutor);
+
+        ProcessDsvPoolByBlocks(
+            poolPath,
+            dsvPoolFormatParams,
+            classNames,
+            blockSize,
+            localExecutor,
+            [&] (TDataProviderPtr block) {
+                TRawObjectsDataProviderPtr rawObjectsData(
+                    dynamic_cast<TRawObjectsDataProvider*>(block->ObjectsData.Get()));
+                CB_ENSURE_INTERNAL(rawObjectsData, "Pool block is not raw");
+                block->ObjectsData = Quantize(
+                    quantizationOptions,
+                    std::move(rawObjectsData),
+                    quantizedFeaturesInfo,
+                    &rand,
+                    localExecutor
+                );
+
+                TSrcData srcDataBlock;
+                BuildSrcDataFromDataProvider(block, localExecutor, &srcDataBlock);
+                writer.AddBlock(srcDataBlock);
+                return true;
+            }
+        );
 
-        SaveQuantizedPool(srcData, fileName);
+        writer.Finish();
     }
 }
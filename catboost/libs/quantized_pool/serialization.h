@@ -3,8 +3,14 @@
 #include <catboost/libs/data_new/loader.h>
 #include <catboost/libs/data_util/path_with_scheme.h>
 #include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/options/load_options.h>
+
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/fwd.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
 #include <util/stream/fwd.h>
 
 
@@ -70,6 +76,38 @@ namespace NCB {
     template<class T>
     TSrcColumn<T> GenerateSrcColumn(TConstArrayRef<T> data, EColumn columnType);
 
+    /* Writes quantized pool block by block: chunks of each block are serialized in parallel and
+     *  appended to output right away, pool metainfo and chunk offsets table are written by Finish.
+     * All blocks must have the same columns, column names and quantization schema are taken from the first block.
+     */
+    class TQuantizedPoolWriter : public TNonCopyable {
+    public:
+        TQuantizedPoolWriter(IOutputStream* output, NPar::TLocalExecutor* localExecutor);
+        ~TQuantizedPoolWriter();
+
+        void AddBlock(const TSrcData& srcDataBlock);
+        void Finish();
+
+    private:
+        class TImpl;
+        THolder<TImpl> Impl;
+    };
+
+    /* Converts DSV pool to quantized pool file without loading the whole pool: blocks of blockSize objects
+     *  are quantized and written by TQuantizedPoolWriter.
+     * Borders are taken from bordersFile if it is specified, borders of other features are calculated
+     *  with binarizationOptions on a uniform sample of objects of the whole pool read by a separate pass.
+     */
+    void ConvertDsvPoolToQuantizedPool(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TMaybe<TString>& bordersFile,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        const TVector<TString>& classNames,
+        ui32 blockSize,
+        const TString& outputFileName,
+        NPar::TLocalExecutor* localExecutor);
+
     struct TLoadQuantizedPoolParameters {
         bool LockMemory = true;
         bool Precharge = true;
@@ -9,6 +9,9 @@
 
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/data_new/borders_io.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/quantization.h>
 
 #include <util/folder/dirut.h>
 #include <util/folder/path.h>
@@ -16,6 +19,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
+#include <util/generic/xrange.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
@@ -23,6 +27,8 @@
 #include <util/stream/output.h>
 #include <util/system/fstat.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 using NCB::NIdl::TFeatureQuantizationSchema;
 using NCB::NIdl::TPoolQuantizationSchema;
 
@@ -134,6 +140,153 @@ static bool IsEqual(
     return differencer.Compare(lhs, rhs);
 }
 
+static NCB::TSrcData MakeSrcData(
+    TVector<TVector<ui8>> featureParts,
+    TVector<TVector<float>> targetParts) {
+
+    NCB::TSrcData srcData;
+    srcData.DocumentCount = 0;
+    for (const auto& targetPart : targetParts) {
+        srcData.DocumentCount += targetPart.size();
+    }
+    srcData.LocalIndexToColumnIndex = {0, 1};
+    srcData.PoolQuantizationSchema.FeatureIndices = {0};
+    srcData.PoolQuantizationSchema.Borders = {{0.25f, 0.5f, 0.75f}};
+    srcData.PoolQuantizationSchema.NanModes = {ENanMode::Forbidden};
+    srcData.ColumnNames = {"f0", "Target"};
+    srcData.FloatFeatures = {NCB::TSrcColumn<ui8>{EColumn::Num, std::move(featureParts)}};
+    srcData.Target = NCB::TSrcColumn<float>{EColumn::Label, std::move(targetParts)};
+    return srcData;
+}
+
+// feature 0 grows with object index, so that borders calculated on the first block only
+//  would not cover the rest of the pool
+static void WriteDsvPool(const TString& poolFileName, const TString& cdFileName) {
+    TFileOutput pool(poolFileName);
+    for (auto objectIdx : xrange(100)) {
+        pool << (objectIdx % 2) << '\t' << objectIdx << '\t';
+        if (objectIdx % 13 == 5) {
+            pool << "nan";
+        } else {
+            pool << (objectIdx * 37) % 100 * 0.01f;
+        }
+        pool << '\n';
+    }
+    TFileOutput cd(cdFileName);
+    cd << "0\tLabel\n1\tNum\n2\tNum\n";
+}
+
+static NCB::TDataProviderPtr ReadQuantizedPool(const TString& fileName) {
+    return NCB::ReadDataset(
+        NCB::TPathWithScheme(fileName, "quantized"),
+        NCB::TPathWithScheme(),
+        NCB::TPathWithScheme(),
+        NCB::TPathWithScheme(),
+        NCatboostOptions::TDsvPoolFormatParams(),
+        /*ignoredFeatures*/ {},
+        NCB::EObjectsOrder::Undefined,
+        /*threadCount*/ 2,
+        /*verbose*/ false);
+}
+
+static void AssertEqualQuantizedPools(const NCB::TDataProviderPtr& lhs, const NCB::TDataProviderPtr& rhs) {
+    UNIT_ASSERT_VALUES_EQUAL(lhs->GetObjectCount(), rhs->GetObjectCount());
+    UNIT_ASSERT_EQUAL(*lhs->RawTargetData.GetTarget(), *rhs->RawTargetData.GetTarget());
+
+    const auto& lhsObjects = dynamic_cast<const NCB::TQuantizedObjectsDataProvider&>(*lhs->ObjectsData);
+    const auto& rhsObjects = dynamic_cast<const NCB::TQuantizedObjectsDataProvider&>(*rhs->ObjectsData);
+    const auto& lhsInfo = *lhsObjects.GetQuantizedFeaturesInfo();
+    const auto& rhsInfo = *rhsObjects.GetQuantizedFeaturesInfo();
+    UNIT_ASSERT_VALUES_EQUAL(lhsObjects.GetFeaturesLayout()->GetFloatFeatureCount(), 2);
+    for (auto featureIdx : xrange(2)) {
+        const NCB::TFloatFeatureIdx floatFeatureIdx(featureIdx);
+        UNIT_ASSERT_VALUES_EQUAL(lhsInfo.GetBorders(floatFeatureIdx), rhsInfo.GetBorders(floatFeatureIdx));
+        UNIT_ASSERT_VALUES_EQUAL(lhsInfo.GetNanMode(floatFeatureIdx), rhsInfo.GetNanMode(floatFeatureIdx));
+
+        const auto lhsBins = (*lhsObjects.GetFloatFeature(featureIdx))->ExtractValues(&NPar::LocalExecutor());
+        const auto rhsBins = (*rhsObjects.GetFloatFeature(featureIdx))->ExtractValues(&NPar::LocalExecutor());
+        UNIT_ASSERT_VALUES_EQUAL(
+            TVector<ui8>((*lhsBins).begin(), (*lhsBins).end()),
+            TVector<ui8>((*rhsBins).begin(), (*rhsBins).end()));
+    }
+}
+
+// converts the pool by blocks and compares the result with the pool quantized as a whole and saved
+static void TestConvertDsvPool(const TMaybe<TString>& bordersFileData) {
+    const auto tmpDir = TFsPath(GetSystemTempDir());
+    const TString poolFileName = (tmpDir / "dsv_pool.tsv").GetPath();
+    const TString cdFileName = (tmpDir / "dsv_pool.cd").GetPath();
+    const TString bordersFileName = (tmpDir / "dsv_pool.borders").GetPath();
+    const TString convertedFileName = (tmpDir / "converted_pool.bin").GetPath();
+    const TString savedFileName = (tmpDir / "saved_pool.bin").GetPath();
+
+    WriteDsvPool(poolFileName, cdFileName);
+    TMaybe<TString> bordersFile;
+    if (bordersFileData) {
+        TFileOutput(bordersFileName).Write(*bordersFileData);
+        bordersFile = bordersFileName;
+    }
+
+    NCatboostOptions::TDsvPoolFormatParams dsvPoolFormatParams;
+    dsvPoolFormatParams.CdFilePath = NCB::TPathWithScheme(cdFileName, "file");
+    const NCatboostOptions::TBinarizationOptions binarizationOptions(
+        EBorderSelectionType::GreedyLogSum,
+        /*discretization*/ 8,
+        ENanMode::Min);
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(2);
+
+    NCB::ConvertDsvPoolToQuantizedPool(
+        NCB::TPathWithScheme(poolFileName, "dsv"),
+        dsvPoolFormatParams,
+        bordersFile,
+        binarizationOptions,
+        /*classNames*/ {},
+        /*blockSize*/ 7,
+        convertedFileName,
+        &localExecutor);
+
+    auto rawDataProvider = NCB::ReadDataset(
+        NCB::TPathWithScheme(poolFileName, "dsv"),
+        NCB::TPathWithScheme(),
+        NCB::TPathWithScheme(),
+        NCB::TPathWithScheme(),
+        dsvPoolFormatParams,
+        /*ignoredFeatures*/ {},
+        NCB::EObjectsOrder::Undefined,
+        /*threadCount*/ 2,
+        /*verbose*/ false)->CastMoveTo<NCB::TRawObjectsDataProvider>();
+    UNIT_ASSERT(rawDataProvider);
+
+    auto quantizedFeaturesInfo = MakeIntrusive<NCB::TQuantizedFeaturesInfo>(
+        *rawDataProvider->MetaInfo.FeaturesLayout,
+        TConstArrayRef<ui32>(),
+        binarizationOptions);
+    if (bordersFile) {
+        NCB::LoadBordersAndNanModesFromFromFileInMatrixnetFormat(*bordersFile, quantizedFeaturesInfo.Get());
+    }
+    NCB::TQuantizationOptions quantizationOptions;
+    quantizationOptions.CpuCompatibleFormat = false;
+    TRestorableFastRng64 rand(0);
+    NCB::TDataProviderPtr quantizedDataProvider = NCB::Quantize(
+        quantizationOptions,
+        std::move(rawDataProvider),
+        quantizedFeaturesInfo,
+        &rand,
+        &localExecutor)->CastMoveTo<NCB::TObjectsDataProvider>();
+    NCB::SaveQuantizedPool(quantizedDataProvider, savedFileName);
+
+    const auto convertedPool = ReadQuantizedPool(convertedFileName);
+    AssertEqualQuantizedPools(convertedPool, ReadQuantizedPool(savedFileName));
+
+    // borders are calculated on the whole pool, not on the first block
+    const auto& convertedObjects = dynamic_cast<const NCB::TQuantizedObjectsDataProvider&>(*convertedPool->ObjectsData);
+    const auto& borders = convertedObjects.GetQuantizedFeaturesInfo()->GetBorders(NCB::TFloatFeatureIdx(0));
+    UNIT_ASSERT(!borders.empty());
+    UNIT_ASSERT(borders.back() > 50.0f);
+}
+
 // TODO(yazevnul): compare schemas as C++ objects too
 
 Y_UNIT_TEST_SUITE(SerializationTests) {
@@ -169,6 +322,49 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         TString diff;
         UNIT_ASSERT_C(IsEqual(expectedQuantizationSchema, quantizationSchema, &diff), diff.data());
     }
+
+    Y_UNIT_TEST(TestWriteByBlocks) {
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+        const auto blocksPath = TFsPath(GetSystemTempDir()) / "quantized_pool_blocks.bin";
+
+        NCB::SaveQuantizedPool(MakeSrcData({{1, 3}, {0, 1, 2}}, {{0.12f, 0.0f}, {0.45f, 0.1f, 0.22f}}), path.GetPath());
+
+        {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(2);
+
+            TFileOutput output(blocksPath.GetPath());
+            NCB::TQuantizedPoolWriter writer(&output, &localExecutor);
+            writer.AddBlock(MakeSrcData({{1, 3}}, {{0.12f, 0.0f}}));
+            writer.AddBlock(MakeSrcData({{0, 1, 2}}, {{0.45f, 0.1f, 0.22f}}));
+            writer.Finish();
+        }
+
+        // single block with the same parts gives the same file
+        UNIT_ASSERT_VALUES_EQUAL(
+            TFileInput(blocksPath.GetPath()).ReadAll(),
+            TFileInput(path.GetPath()).ReadAll());
+
+        const auto loadedPool = NCB::LoadQuantizedPool(
+            NCB::TPathWithScheme(blocksPath.GetPath(), "quantized"),
+            {false, false, NCB::TDatasetSubset::MakeColumns()});
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.DocumentCount, 5);
+        for (const auto& chunks : loadedPool.Chunks) {
+            UNIT_ASSERT_VALUES_EQUAL(chunks.size(), 2);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[0].DocumentOffset, 0);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[1].DocumentOffset, 2);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[1].DocumentCount, 3);
+        }
+    }
+
+    Y_UNIT_TEST(TestConvertDsvPoolWithCalculatedBorders) {
+        TestConvertDsvPool(Nothing());
+    }
+
+    Y_UNIT_TEST(TestConvertDsvPoolWithBordersFile) {
+        // feature 1 is absent in borders file and gets borders calculated on the pool
+        TestConvertDsvPool(TString("0\t10.5\n0\t60.5\n0\t80.5\n"));
+    }
 }
 
 Y_UNIT_TEST_SUITE(DigestTests) {
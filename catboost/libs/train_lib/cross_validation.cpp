@@ -17,11 +17,13 @@
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/model/features.h>
 #include <catboost/libs/options/enum_helpers.h>
 #include <catboost/libs/options/plain_options_helper.h>
 
+#include <util/folder/path.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
@@ -365,6 +367,11 @@ void Train(
     };
     auto foldOutputOptions = foldContext->OutputOptions;
     foldOutputOptions.SetTrainDir(trainDir);
+    // trace of each fold model is written to its own train dir
+    const TString profileTracePath = foldOutputOptions.CreateProfileTraceFullPath();
+    if (!profileTracePath.empty()) {
+        foldOutputOptions.SetProfileTracePath(TFsPath(profileTracePath).GetName());
+    }
     if (foldContext->FullModel.Defined()) {
         // TrainModel saves model either to memory pointed by dstModel, or to ResultModelPath
         foldOutputOptions.ResultModelPath = NCatboostOptions::TOption<TString>("result_model_file", "model");
@@ -576,13 +583,26 @@ void CrossValidate(
     */
     UpdatePermutationBlockSize(taskType, foldsData, &catBoostOptions);
 
+    /* one trace for all folds: folds are trained by batches of iterations and a trace written by each
+     *  TrainModel call would be overwritten by the next batch or fold
+     */
+    THolder<TProfileTraceSink> profileTraceSink;
+    const TString profileTracePath = outputFileOptions.CreateProfileTraceFullPath();
+    if (!profileTracePath.empty() && outputFileOptions.AllowWriteFiles()) {
+        profileTraceSink = MakeHolder<TProfileTraceSink>(
+            profileTracePath,
+            outputFileOptions.CollectProfileHardwareCounters());
+    }
+    auto foldOutputFileOptions = outputFileOptions;
+    foldOutputFileOptions.SetProfileTracePath(TString());
+
     TVector<TFoldContext> foldContexts;
 
     for (auto foldIdx : xrange((size_t)cvParams.FoldCount)) {
         foldContexts.emplace_back(
             foldIdx,
             taskType,
-            outputFileOptions,
+            foldOutputFileOptions,
             std::move(foldsData[foldIdx]),
             catBoostOptions.RandomSeed);
     }
@@ -674,6 +694,8 @@ void CrossValidate(
 
         for (auto foldIdx : xrange(foldContexts.size())) {
             THPTimer timer;
+            TProfileTraceScope foldTrace("Fold", "cv");
+            foldTrace.AddArg("fold", foldIdx);
 
             TrainBatch(
                 catBoostOptions,
@@ -315,12 +315,12 @@ TIntrusivePtr<TTrainingDataProvider> MakeFeatureSubsetDataProvider(
 }
 
 
-static TVector<TTrainingDataProviders> UpdateIgnoredFeaturesInLearn(
+static TTrainingDataProviders MakeFeatureSubsetTrainingData(
     ETaskType taskType,
     const NCatboostOptions::TFeatureEvalOptions& options,
     ETrainingKind trainingKind,
     ui32 testedFeatureSetIdx,
-    const TVector<TTrainingDataProviders>& foldsData
+    const TTrainingDataProviders& foldData
 ) {
     TVector<ui32> ignoredFeatures;
     const auto& testedFeatures = options.FeaturesToEvaluate.Get();
@@ -350,39 +350,58 @@ static TVector<TTrainingDataProviders> UpdateIgnoredFeaturesInLearn(
                 featureSet.end());
         }
     }
-    TVector<TTrainingDataProviders> result;
-    result.reserve(foldsData.size());
+    TTrainingDataProviders result;
     if (taskType == ETaskType::CPU) {
-        for (const auto& foldData : foldsData) {
-            TTrainingDataProviders newTrainingData;
-            newTrainingData.Learn = MakeFeatureSubsetDataProvider<TQuantizedForCPUObjectsDataProvider>(
+        result.Learn = MakeFeatureSubsetDataProvider<TQuantizedForCPUObjectsDataProvider>(
+            ignoredFeatures,
+            foldData.Learn);
+        result.Test.push_back(
+            MakeFeatureSubsetDataProvider<TQuantizedForCPUObjectsDataProvider>(
                 ignoredFeatures,
-                foldData.Learn);
-            newTrainingData.Test.push_back(
-                MakeFeatureSubsetDataProvider<TQuantizedForCPUObjectsDataProvider>(
-                    ignoredFeatures,
-                    foldData.Test[0])
-            );
-            result.push_back(newTrainingData);
-        }
+                foldData.Test[0])
+        );
     } else {
-        for (const auto& foldData : foldsData) {
-            TTrainingDataProviders newTrainingData;
-            newTrainingData.Learn = MakeFeatureSubsetDataProvider<TQuantizedObjectsDataProvider>(
+        result.Learn = MakeFeatureSubsetDataProvider<TQuantizedObjectsDataProvider>(
+            ignoredFeatures,
+            foldData.Learn);
+        result.Test.push_back(
+            MakeFeatureSubsetDataProvider<TQuantizedObjectsDataProvider>(
                 ignoredFeatures,
-                foldData.Learn);
-            newTrainingData.Test.push_back(
-                MakeFeatureSubsetDataProvider<TQuantizedObjectsDataProvider>(
-                    ignoredFeatures,
-                    foldData.Test[0])
-            );
-            result.push_back(newTrainingData);
-        }
+                foldData.Test[0])
+        );
     }
     return result;
 }
 
 
+/*
+ * Learn features data of folds refers to the whole dataset, so each model trained on the fold gathers
+ *  its columns through the fold subset. Copy them once per fold, feature subsets of all models
+ *  trained on the fold share the copy.
+ */
+static void EnsureConsecutiveLearnFeaturesData(
+    TTrainingDataProviders* foldData,
+    NPar::TLocalExecutor* localExecutor
+) {
+    auto* learnObjectsData
+        = dynamic_cast<TQuantizedForCPUObjectsDataProvider*>(foldData->Learn->ObjectsData.Get());
+    CB_ENSURE_INTERNAL(learnObjectsData, "Learn objects data is not compatible with CPU task type");
+    learnObjectsData->EnsureConsecutiveIfDenseFeaturesData(localExecutor);
+}
+
+
+namespace {
+    // baseline or tested model trained on all folds
+    struct TEvaluatedModel {
+        ETrainingKind TrainingKind;
+        ui32 FeatureSetIdx;
+        TString TrainDirPrefix;
+        TVector<ui64> FoldRandomSeeds; // [foldIdx]
+        TVector<TFoldContext> FoldContexts; // [foldIdx], only metric values are kept after training
+    };
+}
+
+
 static void LoadOptions(
     const NJson::TJsonValue& plainJsonParams,
     NCatboostOptions::TCatBoostOptions* catBoostOptions,
@@ -407,67 +426,65 @@ static void LoadOptions(
 
 static void CalcMetricsForTest(
     const TVector<THolder<IMetric>>& metrics,
-    const TVector<TTrainingDataProviders>& quantizedData,
-    TVector<TFoldContext>* foldContexts
+    const TTrainingDataProviders& quantizedData,
+    TFoldContext* foldContext
 ) {
     const auto metricCount = metrics.size();
-    for (auto foldIdx : xrange(foldContexts->size())) {
-        THPTimer timer;
-        CB_ENSURE(
-            quantizedData[foldIdx].Test.size() == 1,
-            "Need exactly one test dataset in test fold " << (*foldContexts)[foldIdx].FoldIdx);
-        auto& metricValuesOnTest = (*foldContexts)[foldIdx].MetricValuesOnTest;
-        CB_ENSURE(
-            metricValuesOnTest.empty(),
-            "Fold " << (*foldContexts)[foldIdx].FoldIdx << " already has metric values");
-        const auto treeCount = (*foldContexts)[foldIdx].FullModel->GetTreeCount();
-        ResizeRank2(treeCount, metricCount, metricValuesOnTest);
-
-        const auto& testData = quantizedData[foldIdx].Test[0];
-        const auto classCount = testData->TargetData->GetTargetClassCount().GetOrElse(1);
-        const auto docCount = testData->GetObjectCount();
-        TVector<TVector<double>> approx;
-        ResizeRank2(classCount, docCount, approx);
-        TVector<TVector<double>> partialApprox;
-        ResizeRank2(classCount, docCount, partialApprox);
-        TVector<double> flatApproxBuffer;
-        flatApproxBuffer.yresize(docCount * classCount);
-
-        TModelCalcerOnPool modelCalcer(
-            (*foldContexts)[foldIdx].FullModel.GetRef(),
-            testData->ObjectsData,
-            &NPar::LocalExecutor());
-        for (auto treeIdx : xrange(treeCount)) {
-            // TODO(kirillovs):
-            //     apply (1) all models to the entire dataset on CPU or (2) GPU,
-            // TODO(espetrov):
-            //     calculate error for each model,
-            //     error on test fold idx = error on entire dataset for model idx - error on learn fold idx
-            //     refactor using the Visitor pattern
-            modelCalcer.ApplyModelMulti(
-                EPredictionType::RawFormulaVal,
-                treeIdx,
-                treeIdx + 1,
-                &flatApproxBuffer,
-                &partialApprox);
-            for (auto classIdx : xrange(classCount)) {
-                for (auto docIdx : xrange(docCount)) {
-                    approx[classIdx][docIdx] += partialApprox[classIdx][docIdx];
-                }
-            }
-            for (auto metricIdx : xrange(metricCount)) {
-                metricValuesOnTest[treeIdx][metricIdx] = CalcMetric(
-                    *metrics[metricIdx],
-                    testData->TargetData,
-                    approx,
-                    &NPar::LocalExecutor()
-                );
+    THPTimer timer;
+    CB_ENSURE(
+        quantizedData.Test.size() == 1,
+        "Need exactly one test dataset in test fold " << foldContext->FoldIdx);
+    auto& metricValuesOnTest = foldContext->MetricValuesOnTest;
+    CB_ENSURE(
+        metricValuesOnTest.empty(),
+        "Fold " << foldContext->FoldIdx << " already has metric values");
+    const auto treeCount = foldContext->FullModel->GetTreeCount();
+    ResizeRank2(treeCount, metricCount, metricValuesOnTest);
+
+    const auto& testData = quantizedData.Test[0];
+    const auto classCount = testData->TargetData->GetTargetClassCount().GetOrElse(1);
+    const auto docCount = testData->GetObjectCount();
+    TVector<TVector<double>> approx;
+    ResizeRank2(classCount, docCount, approx);
+    TVector<TVector<double>> partialApprox;
+    ResizeRank2(classCount, docCount, partialApprox);
+    TVector<double> flatApproxBuffer;
+    flatApproxBuffer.yresize(docCount * classCount);
+
+    TModelCalcerOnPool modelCalcer(
+        foldContext->FullModel.GetRef(),
+        testData->ObjectsData,
+        &NPar::LocalExecutor());
+    for (auto treeIdx : xrange(treeCount)) {
+        // TODO(kirillovs):
+        //     apply (1) all models to the entire dataset on CPU or (2) GPU,
+        // TODO(espetrov):
+        //     calculate error for each model,
+        //     error on test fold idx = error on entire dataset for model idx - error on learn fold idx
+        //     refactor using the Visitor pattern
+        modelCalcer.ApplyModelMulti(
+            EPredictionType::RawFormulaVal,
+            treeIdx,
+            treeIdx + 1,
+            &flatApproxBuffer,
+            &partialApprox);
+        for (auto classIdx : xrange(classCount)) {
+            for (auto docIdx : xrange(docCount)) {
+                approx[classIdx][docIdx] += partialApprox[classIdx][docIdx];
             }
         }
-        CATBOOST_INFO_LOG << "Fold "
-            << (*foldContexts)[foldIdx].FoldIdx << ": metrics calculated in "
-            << FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
+        for (auto metricIdx : xrange(metricCount)) {
+            metricValuesOnTest[treeIdx][metricIdx] = CalcMetric(
+                *metrics[metricIdx],
+                testData->TargetData,
+                approx,
+                &NPar::LocalExecutor()
+            );
+        }
     }
+    CATBOOST_INFO_LOG << "Fold "
+        << foldContext->FoldIdx << ": metrics calculated in "
+        << FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
 }
 
 
@@ -560,6 +577,7 @@ void EvaluateFeatures(
         &NPar::LocalExecutor()
     );
 
+    // before folds learn data is made consecutive, so permutations are the same as for non-consecutive data
     UpdatePermutationBlockSize(taskType, foldsData, &catBoostOptions);
 
     TVector<THolder<IMetric>> metrics = CreateMetrics(
@@ -573,100 +591,113 @@ void EvaluateFeatures(
     float bestPossibleValue;
     metrics.front()->GetBestValue(&bestValueType, &bestPossibleValue);
 
-    const auto trainFullModels = [&] (
-        const TString& trainDirPrefix,
-        TVector<TTrainingDataProviders>* foldsData,
-        TVector<TFoldContext>* foldContexts) {
-        Y_ASSERT(foldContexts->empty());
-        const ui32 offset = cvParams.Initialized() ? 0 : featureEvalOptions.Offset.Get();
-        for (auto foldIdx : xrange(foldCount)) {
-            foldContexts->emplace_back(
-                offset + foldIdx,
-                taskType,
-                outputFileOptions,
-                std::move((*foldsData)[foldIdx]),
-                rand.GenRand(),
-                /*hasFullModel*/true
-            );
-        }
-
-        const auto iterationCount = catBoostOptions.BoostingOptions->IterationCount.Get();
-        const auto topLevelTrainDir = outputFileOptions.GetTrainDir();
-        for (auto foldIdx : xrange(foldCount)) {
-            THPTimer timer;
-            TErrorTracker errorTracker = CreateErrorTracker(
-                overfittingDetectorOptions,
-                bestPossibleValue,
-                bestValueType,
-                /*hasTest*/(*foldsData)[foldIdx].Test.size());
-
-            const auto foldTrainDir = trainDirPrefix + "fold_" + ToString((*foldContexts)[foldIdx].FoldIdx);
-            Train(
-                catBoostOptions,
-                JoinFsPaths(topLevelTrainDir, foldTrainDir),
-                objectiveDescriptor,
-                evalMetricDescriptor,
-                labelConverter,
-                metrics,
-                errorTracker.IsActive(),
-                &(*foldContexts)[foldIdx],
-                modelTrainerHolder.Get(),
-                &NPar::LocalExecutor()
-            );
-            CB_ENSURE(
-                (*foldContexts)[foldIdx].FullModel.Defined(),
-                "Fold " << (*foldContexts)[foldIdx].FoldIdx << ": model is missing"
-            );
-            const auto treeCount = (*foldContexts)[foldIdx].FullModel->GetTreeCount();
-            CB_ENSURE(
-                iterationCount == treeCount,
-                "Fold " << (*foldContexts)[foldIdx].FoldIdx << ": model size (" << treeCount <<
-                ") differs from iteration count (" << iterationCount << ")"
-            );
-            CATBOOST_INFO_LOG << "Fold " << (*foldContexts)[foldIdx].FoldIdx << ": model built in " <<
-                FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
-        }
-
-        for (auto foldIdx : xrange(foldCount)) {
-            (*foldsData)[foldIdx] = std::move((*foldContexts)[foldIdx].TrainingData);
-        }
-
-        if (testFoldsData) {
-            CalcMetricsForTest(metrics, testFoldsData, foldContexts);
-        }
-    };
-
-    TVector<TFoldContext> baselineFoldContexts;
     // TODO(espetrov): support eval feature for folds specified by featureEvalOptions
     const auto useCommonBaseline = featureEvalOptions.FeatureEvalMode != NCB::EFeatureEvalMode::OneVsOthers;
+    TVector<TEvaluatedModel> models;
     for (ui32 featureSetIdx : xrange(featureEvalOptions.FeaturesToEvaluate->size())) {
         const auto haveBaseline = featureSetIdx > 0 && useCommonBaseline;
         if (!haveBaseline) {
-            auto newFoldsData = UpdateIgnoredFeaturesInLearn(
-                taskType,
-                featureEvalOptions,
-                ETrainingKind::Baseline,
-                featureSetIdx,
-                foldsData);
-            baselineFoldContexts.clear();
             auto baselineDirPrefix = TStringBuilder() << "Baseline_";
             if (!useCommonBaseline) {
                 baselineDirPrefix << "set_" << featureSetIdx << "_";
             }
-            trainFullModels(baselineDirPrefix, &newFoldsData, &baselineFoldContexts);
+            models.push_back({ETrainingKind::Baseline, featureSetIdx, baselineDirPrefix, {}, {}});
         }
-
-        TVector<TFoldContext> testedFoldContexts;
-        auto newFoldsData = UpdateIgnoredFeaturesInLearn(
-            taskType,
-            featureEvalOptions,
-            ETrainingKind::Testing,
-            featureSetIdx,
-            foldsData);
         const auto testingDirPrefix = TStringBuilder() << "Testing_set_" << featureSetIdx << "_";
-        trainFullModels(testingDirPrefix, &newFoldsData, &testedFoldContexts);
+        models.push_back({ETrainingKind::Testing, featureSetIdx, testingDirPrefix, {}, {}});
+    }
 
-        results->PushBackWxTestAndDelta(metrics, baselineFoldContexts, testedFoldContexts);
+    // seeds are generated model by model to get the same results as with training models one after another
+    const ui32 offset = cvParams.Initialized() ? 0 : featureEvalOptions.Offset.Get();
+    for (auto& model : models) {
+        model.FoldRandomSeeds.resize(foldCount);
+        for (auto& seed : model.FoldRandomSeeds) {
+            seed = rand.GenRand();
+        }
+    }
+
+    const auto iterationCount = catBoostOptions.BoostingOptions->IterationCount.Get();
+    const auto topLevelTrainDir = outputFileOptions.GetTrainDir();
+    const auto trainFoldModel = [&] (const TString& trainDirPrefix, TFoldContext* foldContext) {
+        THPTimer timer;
+        TErrorTracker errorTracker = CreateErrorTracker(
+            overfittingDetectorOptions,
+            bestPossibleValue,
+            bestValueType,
+            /*hasTest*/foldContext->TrainingData.Test.size());
+
+        const auto foldTrainDir = trainDirPrefix + "fold_" + ToString(foldContext->FoldIdx);
+        Train(
+            catBoostOptions,
+            JoinFsPaths(topLevelTrainDir, foldTrainDir),
+            objectiveDescriptor,
+            evalMetricDescriptor,
+            labelConverter,
+            metrics,
+            errorTracker.IsActive(),
+            foldContext,
+            modelTrainerHolder.Get(),
+            &NPar::LocalExecutor()
+        );
+        CB_ENSURE(
+            foldContext->FullModel.Defined(),
+            "Fold " << foldContext->FoldIdx << ": model is missing"
+        );
+        const auto treeCount = foldContext->FullModel->GetTreeCount();
+        CB_ENSURE(
+            iterationCount == treeCount,
+            "Fold " << foldContext->FoldIdx << ": model size (" << treeCount <<
+            ") differs from iteration count (" << iterationCount << ")"
+        );
+        CATBOOST_INFO_LOG << "Fold " << foldContext->FoldIdx << ": model built in " <<
+            FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
+    };
+
+    /*
+     * All models are trained on a fold before moving to the next one, so only the current fold's
+     *  learn features data is made consecutive and kept in RAM
+     */
+    for (auto foldIdx : xrange(foldCount)) {
+        if (taskType == ETaskType::CPU) {
+            EnsureConsecutiveLearnFeaturesData(&foldsData[foldIdx], &NPar::LocalExecutor());
+        }
+        for (auto& model : models) {
+            model.FoldContexts.emplace_back(
+                offset + foldIdx,
+                taskType,
+                outputFileOptions,
+                MakeFeatureSubsetTrainingData(
+                    taskType,
+                    featureEvalOptions,
+                    model.TrainingKind,
+                    model.FeatureSetIdx,
+                    foldsData[foldIdx]),
+                model.FoldRandomSeeds[foldIdx],
+                /*hasFullModel*/true
+            );
+            auto& foldContext = model.FoldContexts.back();
+            trainFoldModel(model.TrainDirPrefix, &foldContext);
+            if (testFoldsData) {
+                CalcMetricsForTest(metrics, testFoldsData[foldIdx], &foldContext);
+            }
+
+            // only metric values are used after training
+            foldContext.TrainingData = TTrainingDataProviders();
+            foldContext.LearnProgress.Destroy();
+            foldContext.FullModel.Clear();
+            foldContext.TempDir.Destroy();
+        }
+        foldsData[foldIdx] = TTrainingDataProviders();
+    }
+
+    const TVector<TFoldContext>* baselineFoldContexts = nullptr;
+    for (const auto& model : models) {
+        if (model.TrainingKind == ETrainingKind::Baseline) {
+            baselineFoldContexts = &model.FoldContexts;
+        } else {
+            Y_ASSERT(baselineFoldContexts);
+            results->PushBackWxTestAndDelta(metrics, *baselineFoldContexts, model.FoldContexts);
+        }
     }
 
     for (const auto& metric : metrics) {
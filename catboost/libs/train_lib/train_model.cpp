@@ -19,6 +19,7 @@
 #include <catboost/libs/fstr/output_fstr.h>
 #include <catboost/libs/helpers/int_cast.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/helpers/numa.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/vector_helpers.h>
@@ -26,6 +27,7 @@
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/libs/model/ctr_data.h>
 #include <catboost/libs/model/model_build_helper.h>
 #include <catboost/libs/options/catboost_options.h>
@@ -314,7 +316,10 @@ static void InitializeSamplingStructures(
         ctx->LearnProgress->Folds,
         isPairwiseScoring,
         defaultCalcStatsObjBlockSize,
-        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig),
+        /*partitionDocsByLeaves*/ ctx->Params.ObliviousTreeOptions->DevLeafwiseScoring.Get()
+            && IsPlainMode(ctx->Params.BoostingOptions->BoostingType)
+            && ctx->Params.SystemOptions->IsSingleHost()
     ); // TODO(espetrov): create only if sample rate < 1
 }
 
@@ -352,10 +357,25 @@ static void Train(
     bool continueTraining;
     ProcessHistoryMetrics(data, *ctx, onEndIterationCallback, &metricsData, &loggingData, &continueTraining);
 
+    // before sampling structures are created so that their arrays are first touched by pinned threads
+    THolder<TNumaPlacement> numaPlacement;
+    if (ctx->Params.SystemOptions->NumaMode.Get() && ctx->Params.SystemOptions->IsSingleHost()) {
+        numaPlacement = MakeHolder<TNumaPlacement>(ctx->LocalExecutor);
+        CATBOOST_INFO_LOG << "NUMA mode: " << numaPlacement->GetNodeCount() << " node(s)" << Endl;
+    }
+
     if (continueTraining) {
         InitializeSamplingStructures(data, ctx);
     }
 
+    THolder<TProfileTraceSink> profileTraceSink;
+    const TString profileTracePath = ctx->OutputOptions.CreateProfileTraceFullPath();
+    if (!profileTracePath.empty() && ctx->OutputOptions.AllowWriteFiles()) {
+        profileTraceSink = MakeHolder<TProfileTraceSink>(
+            profileTracePath,
+            ctx->OutputOptions.CollectProfileHardwareCounters());
+    }
+
     THPTimer timer;
 
     const bool useBestModel = ctx->OutputOptions.ShrinkModelToBestIteration();
@@ -373,6 +393,8 @@ static void Train(
         }
 
         profile.StartNextIteration();
+        TProfileTraceScope iterationTrace("Iteration");
+        iterationTrace.AddArg("iteration", iter);
 
         if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
             profile.AddOperation("Save snapshot");
@@ -382,7 +404,10 @@ static void Train(
 
         TrainOneIteration(data, ctx);
 
-        CalcErrors(data, metricsData, iter, ctx);
+        {
+            TProfileTraceScope calcErrorsTrace("Calc errors");
+            CalcErrors(data, metricsData, iter, ctx);
+        }
 
         profile.AddOperation("Calc errors");
 
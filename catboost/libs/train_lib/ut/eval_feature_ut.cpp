@@ -0,0 +1,114 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/options/cross_validation_params.h>
+#include <catboost/libs/options/feature_eval_options.h>
+#include <catboost/libs/train_lib/eval_feature.h>
+
+#include <library/json/json_value.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+static TDataProviderPtr RandomFloatPool(ui32 objectCount, ui32 featureCount) {
+    TFastRng64 rng(0);
+    TVector<TVector<float>> features(featureCount, TVector<float>(objectCount));
+    TVector<float> target(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        for (auto featureIdx : xrange(featureCount)) {
+            features[featureIdx][objectIdx] = rng.GenRandReal1();
+        }
+        target[objectIdx] = features[0][objectIdx] + 0.5f * features[1][objectIdx] + 0.1f * rng.GenRandReal1();
+    }
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(featureCount, TVector<ui32>{}, TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(featureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(features[featureIdx]))
+                );
+            }
+            visitor->AddTarget(target);
+            visitor->Finish();
+        }
+    );
+}
+
+static TFeatureEvaluationSummary EvaluateFeatureSets(
+    NCB::EFeatureEvalMode featureEvalMode,
+    const TVector<TVector<ui32>>& featureSets
+) {
+    TTempDir trainDir;
+
+    // models do not depend on random seeds, so that the models trained on the same features are equal
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("learning_rate", 0.3);
+    params.InsertValue("depth", 3);
+    params.InsertValue("loss_function", "RMSE");
+    params.InsertValue("boosting_type", "Plain");
+    params.InsertValue("bootstrap_type", "No");
+    params.InsertValue("random_strength", 0);
+    params.InsertValue("has_time", true);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+
+    NCatboostOptions::TFeatureEvalOptions featureEvalOptions;
+    featureEvalOptions.FeaturesToEvaluate = featureSets;
+    featureEvalOptions.FeatureEvalMode = featureEvalMode;
+    featureEvalOptions.FoldCount = 3;
+    featureEvalOptions.FoldSize = 50;
+
+    TFeatureEvaluationSummary summary;
+    EvaluateFeatures(
+        params,
+        featureEvalOptions,
+        /*objectiveDescriptor*/ Nothing(),
+        /*evalMetricDescriptor*/ Nothing(),
+        TCvDataPartitionParams(),
+        RandomFloatPool(/*objectCount*/ 200, /*featureCount*/ 4),
+        &summary
+    );
+    return summary;
+}
+
+
+Y_UNIT_TEST_SUITE(EvalFeature) {
+    Y_UNIT_TEST(TestDeterministic) {
+        const auto summary = EvaluateFeatureSets(NCB::EFeatureEvalMode::OneVsNone, {{0}, {1}, {2, 3}});
+        const auto otherSummary = EvaluateFeatureSets(NCB::EFeatureEvalMode::OneVsNone, {{0}, {1}, {2, 3}});
+        UNIT_ASSERT_VALUES_EQUAL(ToString(summary), ToString(otherSummary));
+        UNIT_ASSERT_VALUES_EQUAL(summary.WxTest.size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(summary.BestBaselineIterations.size(), 3);
+        for (const auto& bestIterations : summary.BestBaselineIterations) {
+            UNIT_ASSERT_VALUES_EQUAL(bestIterations.size(), 3);
+        }
+    }
+
+    // models of all feature sets are trained fold by fold on shared fold data, results must be the same
+    //  as for the same models trained in other feature sets
+    Y_UNIT_TEST(TestModelsOnSharedFoldsData) {
+        // baseline of set 0 equals tested model of set 1 and vice versa
+        const auto summary = EvaluateFeatureSets(NCB::EFeatureEvalMode::OneVsOthers, {{0}, {1}});
+        UNIT_ASSERT_VALUES_EQUAL(summary.MetricDelta.size(), 2);
+        for (auto metricIdx : xrange(summary.MetricDelta[0].size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(summary.MetricDelta[0][metricIdx], -summary.MetricDelta[1][metricIdx], 1e-12);
+        }
+        UNIT_ASSERT_DOUBLES_EQUAL(summary.WxTest[0], summary.WxTest[1], 1e-12);
+
+        // the only tested set is not ignored by the tested model, so it equals the baseline
+        const auto allSummary = EvaluateFeatureSets(NCB::EFeatureEvalMode::OneVsAll, {{0, 1}});
+        for (auto delta : allSummary.MetricDelta[0]) {
+            UNIT_ASSERT_DOUBLES_EQUAL(delta, 0.0, 1e-12);
+        }
+    }
+}
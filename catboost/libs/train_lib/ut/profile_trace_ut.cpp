@@ -0,0 +1,170 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/logging/profile_trace.h>
+#include <catboost/libs/options/cross_validation_params.h>
+#include <catboost/libs/train_lib/cross_validation.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/json/json_value.h>
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+
+#include <atomic>
+
+
+using namespace NCB;
+
+
+static TDataProviderPtr RandomFloatPool(ui32 objectCount, ui32 featureCount) {
+    TFastRng64 rng(0);
+    TVector<TVector<float>> features(featureCount, TVector<float>(objectCount));
+    TVector<float> target(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        for (auto featureIdx : xrange(featureCount)) {
+            features[featureIdx][objectIdx] = rng.GenRandReal1();
+        }
+        target[objectIdx] = features[0][objectIdx] + 0.1f * rng.GenRandReal1();
+    }
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(featureCount, TVector<ui32>{}, TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(featureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(features[featureIdx]))
+                );
+            }
+            visitor->AddTarget(target);
+            visitor->Finish();
+        }
+    );
+}
+
+static NJson::TJsonValue CreateParams(const TString& trainDir, ui32 iterationCount) {
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", iterationCount);
+    params.InsertValue("depth", 3);
+    params.InsertValue("loss_function", "RMSE");
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("thread_count", 2);
+    params.InsertValue("train_dir", trainDir);
+    params.InsertValue("profile_trace", "trace.json");
+    return params;
+}
+
+static size_t CountOccurrences(const TString& text, TStringBuf pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != TString::npos; pos = text.find(pattern, pos + pattern.size())) {
+        ++count;
+    }
+    return count;
+}
+
+static void TrainOnRandomPool(const NJson::TJsonValue& params) {
+    TDataProviders dataProviders;
+    dataProviders.Learn = RandomFloatPool(/*objectCount*/ 200, /*featureCount*/ 3);
+    TFullModel model;
+    TEvalResult evalResult;
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        std::move(dataProviders),
+        /*initModel*/ Nothing(),
+        /*initLearnProgress*/ nullptr,
+        "",
+        &model,
+        {&evalResult}
+    );
+}
+
+
+Y_UNIT_TEST_SUITE(ProfileTrace) {
+    Y_UNIT_TEST(TestOnlyOneSinkIsActive) {
+        TTempDir tempDir;
+        const auto path = TFsPath(tempDir.Name());
+        {
+            TProfileTraceSink sink((path / "first.json").GetPath(), /*collectHardwareCounters*/ false);
+            UNIT_ASSERT(sink.IsActive());
+            UNIT_ASSERT(IsProfileTraceEnabled());
+
+            TProfileTraceSink otherSink((path / "second.json").GetPath(), /*collectHardwareCounters*/ false);
+            UNIT_ASSERT(!otherSink.IsActive());
+            UNIT_ASSERT(IsProfileTraceEnabled());
+        }
+        UNIT_ASSERT(!IsProfileTraceEnabled());
+        UNIT_ASSERT(!(path / "second.json").Exists());
+
+        TProfileTraceSink sink((path / "third.json").GetPath(), /*collectHardwareCounters*/ false);
+        UNIT_ASSERT(sink.IsActive());
+    }
+
+    Y_UNIT_TEST(TestTrainingTrace) {
+        TTempDir trainDir;
+        TrainOnRandomPool(CreateParams(trainDir.Name(), /*iterationCount*/ 5));
+
+        const TString trace = TFileInput(JoinFsPaths(trainDir.Name(), "trace.json")).ReadAll();
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(trace, "\"Iteration\""), 5);
+        UNIT_ASSERT(!IsProfileTraceEnabled());
+    }
+
+    Y_UNIT_TEST(TestTrainingsInParallelThreads) {
+        TTempDir trainDir;
+        const auto path = TFsPath(trainDir.Name());
+        std::atomic<bool> failed{false};
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        localExecutor.ExecRange(
+            [&] (int trainingIdx) {
+                try {
+                    TrainOnRandomPool(CreateParams((path / ToString(trainingIdx)).GetPath(), /*iterationCount*/ 20));
+                } catch (...) {
+                    failed.store(true);
+                }
+            },
+            0,
+            2,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        UNIT_ASSERT(!failed.load());
+        UNIT_ASSERT((path / "0" / "trace.json").Exists() || (path / "1" / "trace.json").Exists());
+        UNIT_ASSERT(!IsProfileTraceEnabled());
+    }
+
+    Y_UNIT_TEST(TestCrossValidationTrace) {
+        TTempDir trainDir;
+
+        TCrossValidationParams cvParams;
+        cvParams.FoldCount = 3;
+        cvParams.DevMaxIterationsBatchSize = 2; // several batches of iterations for each fold
+
+        TVector<TCVResult> results;
+        CrossValidate(
+            CreateParams(trainDir.Name(), /*iterationCount*/ 6),
+            /*quantizedFeaturesInfo*/ nullptr,
+            /*objectiveDescriptor*/ Nothing(),
+            /*evalMetricDescriptor*/ Nothing(),
+            RandomFloatPool(/*objectCount*/ 300, /*featureCount*/ 3),
+            cvParams,
+            &results
+        );
+
+        // all iterations of all folds are in the same trace
+        const TString trace = TFileInput(JoinFsPaths(trainDir.Name(), "trace.json")).ReadAll();
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(trace, "\"Iteration\""), 3 * 6);
+        UNIT_ASSERT(CountOccurrences(trace, "\"Fold\"") >= 3);
+    }
+}
@@ -811,6 +811,26 @@ cdef extern from "catboost/libs/algo/apply.h":
         int threadCount
     )  nogil except +ProcessException
 
+cdef extern from "catboost/libs/algo/apply.h" namespace "NCB":
+    cdef cppclass TDenseMatrixRef[T]:
+        TConstArrayRef[T] Data
+        size_t ObjectCount
+        size_t FeatureCount
+        bool_t IsColumnMajor
+
+cdef extern from "catboost/libs/algo/apply.h":
+    cdef void ApplyModelToDenseMatrix(
+        const TFullModel& model,
+        const TDenseMatrixRef[float]& floatFeatures,
+        const TDenseMatrixRef[int]& hashedCatFeatures,
+        bool_t verbose,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount,
+        TArrayRef[double] results
+    ) nogil except +ProcessException
+
 cdef extern from "catboost/libs/algo/helpers.h":
     cdef void ConfigureMalloc() nogil except *
 
@@ -2893,6 +2913,50 @@ cdef class _CatBoost:
         return _vector_of_double_to_np_array(pred)
 
 
+    cpdef _base_predict_dense(self, np.ndarray float_features, np.ndarray hashed_cat_features, str prediction_type,
+                              int ntree_start, int ntree_end, int thread_count, bool_t verbose):
+        """
+        float_features : 2D np.float32 array (object x float feature), C- or F-contiguous
+        hashed_cat_features : 2D np.int32 array (object x cat feature) of hashed values in the same memory order or None
+        """
+        cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
+        cdef TDenseMatrixRef[float] float_matrix
+        cdef TDenseMatrixRef[int] cat_matrix
+        thread_count = UpdateThreadCount(thread_count);
+
+        float_matrix.ObjectCount = <size_t>float_features.shape[0]
+        float_matrix.FeatureCount = <size_t>float_features.shape[1]
+        float_matrix.IsColumnMajor = not float_features.flags.c_contiguous
+        float_matrix.Data = TConstArrayRef[float](
+            <float*>np.PyArray_DATA(float_features),
+            float_matrix.ObjectCount * float_matrix.FeatureCount
+        )
+        if hashed_cat_features is not None:
+            cat_matrix.ObjectCount = <size_t>hashed_cat_features.shape[0]
+            cat_matrix.FeatureCount = <size_t>hashed_cat_features.shape[1]
+            cat_matrix.IsColumnMajor = not hashed_cat_features.flags.c_contiguous
+            cat_matrix.Data = TConstArrayRef[int](
+                <int*>np.PyArray_DATA(hashed_cat_features),
+                cat_matrix.ObjectCount * cat_matrix.FeatureCount
+            )
+
+        result_dimension = 1 if prediction_type == 'Class' else self.__model.GetDimensionsCount()
+        result = np.empty([float_matrix.ObjectCount, result_dimension], dtype=_npfloat64)
+        cdef TArrayRef[double] result_ref = TArrayRef[double](<double*>np.PyArray_DATA(result), result.size)
+        with nogil:
+            ApplyModelToDenseMatrix(
+                dereference(self.__model),
+                float_matrix,
+                cat_matrix,
+                verbose,
+                predictionType,
+                ntree_start,
+                ntree_end,
+                thread_count,
+                result_ref
+            )
+        return result
+
     cpdef _base_predict_multi(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end,
                               int thread_count, bool_t verbose):
         cdef TVector[TVector[double]] pred
@@ -1140,6 +1140,9 @@ class _CatBoostBase(object):
     def _base_predict_multi(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict_multi(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_dense(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose):
+        return self._object._base_predict_dense(data, None, prediction_type, ntree_start, ntree_end, thread_count, verbose)
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -1661,11 +1664,19 @@ class CatBoost(_CatBoostBase):
                          column_description, verbose_eval, metric_period, silent, early_stopping_rounds,
                          save_snapshot, snapshot_file, snapshot_interval, init_model)
 
-    def _process_predict_input_data(self, data, parent_method_name, label=None):
+    def _process_predict_input_data(self, data, parent_method_name, label=None, allow_dense_matrix=False):
+        """
+        If allow_dense_matrix is True, numeric 2D numpy.ndarray without label is returned as float32 matrix
+        (C- or F-contiguous as the input) to be applied without Pool creation.
+        """
         if not self.is_fitted() or self.tree_count_ is None:
             raise CatBoostError(("There is no trained model to use {}(). "
                                  "Use fit() to train model. Then use this method.").format(parent_method_name))
         is_single_object = _is_data_single_object(data)
+        if allow_dense_matrix and label is None and self._is_dense_matrix(data):
+            if data.flags.f_contiguous and not data.flags.c_contiguous:
+                return np.asfortranarray(data, dtype=np.float32), False
+            return np.ascontiguousarray(data, dtype=np.float32), False
         if not isinstance(data, Pool):
             data = Pool(
                 data=[data] if is_single_object else data,
@@ -1674,6 +1685,12 @@ class CatBoost(_CatBoostBase):
             )
         return data, is_single_object
 
+    def _is_dense_matrix(self, data):
+        return (
+            isinstance(data, np.ndarray) and data.ndim == 2 and data.dtype.kind in 'fiu'
+            and len(self._get_cat_feature_indices()) == 0
+        )
+
     def _validate_prediction_type(self, prediction_type):
         if not isinstance(prediction_type, STRING_TYPES):
             raise CatBoostError("Invalid prediction_type type={}: must be str().".format(type(prediction_type)))
@@ -1684,15 +1701,24 @@ class CatBoost(_CatBoostBase):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
             verbose = False
-        data, data_is_single_object = self._process_predict_input_data(data, parent_method_name)
         self._validate_prediction_type(prediction_type)
-
         loss_function_type = _get_loss_function_for_predict(self._get_params())
+        is_multiclass = loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll')
+
+        # dense matrices are applied without Pool creation for raw values and probabilities of one-dimensional models
+        data, data_is_single_object = self._process_predict_input_data(
+            data,
+            parent_method_name,
+            allow_dense_matrix=not is_multiclass and prediction_type != 'Class'
+        )
 
         # TODO(kirillovs): very bad solution. user should be able to use custom multiclass losses
-        if loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll'):
+        if is_multiclass:
             return np.transpose(self._base_predict_multi(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
-        predictions = np.array(self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
+        if isinstance(data, np.ndarray):
+            predictions = self._base_predict_dense(data, prediction_type, ntree_start, ntree_end, thread_count, verbose)[:, 0]
+        else:
+            predictions = np.array(self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
         if prediction_type == 'Probability':
             predictions = np.transpose([1 - predictions, predictions])
         return predictions[0] if data_is_single_object else predictions
@@ -3267,6 +3293,11 @@ class CatBoostClassifier(CatBoost):
     used_ram_limit : string or number, [default=None]
         Set a limit on memory consumption (value like '1.2gb' or 1.2e9).
         WARNING: Currently this option affects CTR memory usage only.
+    profile_trace : string, [default=None]
+        CPU only. File in train_dir to write the trace of training phases to, in Chrome trace format.
+        Only one trace is written at a time in a process, the trace of a concurrent training is skipped.
+    profile_hardware_counters : bool, [default=False]
+        Add cycles and LLC misses to the events of profile_trace (Linux only).
     gpu_ram_part : float, [default=0.95]
         Fraction of the GPU RAM to use for training, a value from (0, 1].
     pinned_memory_size: int [default=None]
@@ -3326,6 +3357,21 @@ class CatBoostClassifier(CatBoost):
         Used only for learning speed tuning.
         Changing this parameter can affect results due to numerical accuracy differences
 
+    dev_leafwise_scoring : bool, [default=False]
+        CPU only. Keep documents ordered by tree leaves in score calculation.
+        Used only for learning speed tuning, applicable only for Plain boosting without groups and pairwise losses.
+        Changing this parameter can affect results due to numerical accuracy differences
+
+    dev_leaf_quantile_precision : float, [default=0]
+        CPU only. Estimate leaf quantiles for Exact leaf estimation method from per-leaf residual histograms
+        with this relative bin width instead of sorting residuals. 0 means exact quantiles,
+        other values should be in [1e-4, 1).
+        Used only for learning speed tuning on large datasets.
+
+    dev_numa_mode : bool, [default=False]
+        CPU only. Pin worker threads to NUMA nodes and process documents on the nodes that own their memory.
+        Used only for learning speed tuning on multi-socket hosts.
+
     dev_efb_max_buckets : int, [default=1024]
         CPU only. Maximum bucket count in exclusive features bundle. Should be in an integer between 0 and 65536.
         Used only for learning speed tuning.
@@ -3448,6 +3494,8 @@ class CatBoostClassifier(CatBoost):
         snapshot_interval=None,
         fold_len_multiplier=None,
         used_ram_limit=None,
+        profile_trace=None,
+        profile_hardware_counters=None,
         gpu_ram_part=None,
         pinned_memory_size=None,
         allow_writing_files=None,
@@ -3467,6 +3515,9 @@ class CatBoostClassifier(CatBoost):
         sampling_unit=None,
         sampling_frequency=None,
         dev_score_calc_obj_block_size=None,
+        dev_leafwise_scoring=None,
+        dev_leaf_quantile_precision=None,
+        dev_numa_mode=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
         max_depth=None,
@@ -3890,6 +3941,8 @@ class CatBoostRegressor(CatBoost):
         snapshot_interval=None,
         fold_len_multiplier=None,
         used_ram_limit=None,
+        profile_trace=None,
+        profile_hardware_counters=None,
         gpu_ram_part=None,
         pinned_memory_size=None,
         allow_writing_files=None,
@@ -3909,6 +3962,9 @@ class CatBoostRegressor(CatBoost):
         sampling_frequency=None,
         sampling_unit=None,
         dev_score_calc_obj_block_size=None,
+        dev_leafwise_scoring=None,
+        dev_leaf_quantile_precision=None,
+        dev_numa_mode=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
         max_depth=None,
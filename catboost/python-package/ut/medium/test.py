@@ -683,6 +683,28 @@ def test_predict_and_predict_proba_on_single_object(problem):
             assert np.array_equal(pred_probabilities[test_object_idx], model.predict_proba(test_data.values[test_object_idx]))
 
 
+@pytest.mark.parametrize('problem', ['Classifier', 'Regressor'])
+def test_predict_on_dense_matrix_equals_predict_on_pool(problem):
+    np.random.seed(0)
+    train_data = np.random.rand(200, 10)
+    train_label = np.random.randint(0, 2, size=200)
+    test_data = np.random.rand(300, 10)
+    if problem == 'Classifier':
+        model = CatBoostClassifier(iterations=10, thread_count=4)
+        prediction_types = ['RawFormulaVal', 'Probability', 'Class']
+    else:
+        model = CatBoostRegressor(iterations=10, thread_count=4)
+        prediction_types = ['RawFormulaVal']
+    model.fit(train_data, train_label)
+
+    test_pool = Pool(test_data)
+    for prediction_type in prediction_types:
+        pool_pred = model.predict(test_pool, prediction_type=prediction_type)
+        for data in [test_data, np.asfortranarray(test_data), test_data.astype(np.float32)]:
+            pred = model.predict(data, prediction_type=prediction_type)
+            assert np.allclose(pred, pool_pred, rtol=1.e-6)
+
+
 def test_model_pickling(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
@@ -5276,3 +5298,19 @@ def test_save_quantized_pool():
     predictions2 = model_fitted_with_load_quantized_pool.predict(test_pool)
 
     assert all(predictions1 == predictions2)
+
+
+def test_profile_trace():
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    train_dir = test_output_path('profile_trace_train_dir')
+    model = CatBoostRegressor(iterations=5, depth=4, train_dir=train_dir, profile_trace='trace.json')
+    model.fit(train_pool)
+    with open(os.path.join(train_dir, 'trace.json')) as trace:
+        assert trace.read().count('"Iteration"') == 5
+
+    # all folds are written to the same trace
+    cv_train_dir = test_output_path('profile_trace_cv_train_dir')
+    params = {'iterations': 5, 'depth': 4, 'loss_function': 'RMSE', 'train_dir': cv_train_dir, 'profile_trace': 'trace.json'}
+    cv(train_pool, params, fold_count=3)
+    with open(os.path.join(cv_train_dir, 'trace.json')) as trace:
+        assert trace.read().count('"Iteration"') == 3 * 5
@@ -155,6 +155,9 @@ int DoMain(int argc, char** argv) {
     parser.AddLongOption("repetitions")
         .StoreResult(&options.RepetitionCount)
         .Optional();
+    parser.AddLongOption("compiled-model-path", "shared object built from the model exported in CppCompiled format")
+        .StoreResult(&CompiledModelLibraryPath)
+        .Optional();
     NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
     TFullModel model = ReadModel(options.ModelPath);
     NCatboostOptions::TDsvPoolFormatParams dsvPoolFormatParams;
@@ -29,3 +29,6 @@ protected:
 };
 
 using TPerftestModuleFactory = NObjectFactory::TParametrizedObjectFactory<IPerftestModule, TString, const TFullModel&>;
+
+/// shared object built from the model exported in CppCompiled format, empty if not specified
+extern TString CompiledModelLibraryPath;
@@ -68,6 +68,19 @@ public:
 
 TPerftestModuleFactory::TRegistrator<TCPUCatboostAsymmetryModule> CPUCatboostAsymmetryModuleRegistar("CPUCatboostAsymmetry");
 
+TString CompiledModelLibraryPath;
+
+class TCompiledCatboostModule : public TBaseCatboostModule {
+public:
+    TCompiledCatboostModule(const TFullModel& model) {
+        CB_ENSURE(!CompiledModelLibraryPath.empty(), "compiled model library is not specified");
+        ModelEvaluator = NCB::NModelEvaluation::CreateCompiledEvaluator(model, CompiledModelLibraryPath);
+        BaseName = "catboost compiled";
+    }
+};
+
+TPerftestModuleFactory::TRegistrator<TCompiledCatboostModule> CompiledCatboostModuleRegistar("CompiledCatboost");
+
 class TGPUCatboostModule : public TBaseCatboostModule {
 public:
     TGPUCatboostModule(const TFullModel& model) {
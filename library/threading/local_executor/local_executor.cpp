@@ -3,6 +3,7 @@
 #include <library/threading/future/future.h>
 
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/system/atomic.h>
 #include <util/system/event.h>
 #include <util/system/thread.h>
@@ -10,6 +11,7 @@
 #include <util/system/yield.h>
 #include <util/thread/lfqueue.h>
 
+#include <atomic>
 #include <utility>
 
 #ifdef _win_
@@ -122,6 +124,117 @@ namespace {
         }
     };
 
+    class TWorkStealingRangeExecutor: public NPar::ILocallyExecutable {
+        // [Begin, End) of task ids relative to FirstId packed into one word, so the owner (takes
+        // tasks from the front) and thieves (take tasks from the back) synchronize with a single CAS
+        struct TPart {
+            std::atomic<ui64> Range{0};
+            char Padding[64 - sizeof(std::atomic<ui64>)]; // avoid false sharing between parts
+        };
+
+        NPar::TLocallyExecutableFunction Exec;
+        int FirstId;
+        TVector<TPart> Parts;
+        TAtomic ParticipantCount;
+        TAtomic RemainingCount;
+
+        static ui64 Pack(ui32 begin, ui32 end) {
+            return (ui64(end) << 32) | begin;
+        }
+        static ui32 GetBegin(ui64 range) {
+            return ui32(range);
+        }
+        static ui32 GetEnd(ui64 range) {
+            return ui32(range >> 32);
+        }
+
+        bool TakeFront(int partIdx, ui32* id) {
+            auto& range = Parts[partIdx].Range;
+            ui64 packed = range.load(std::memory_order_acquire);
+            for (;;) {
+                const ui32 begin = GetBegin(packed);
+                const ui32 end = GetEnd(packed);
+                if (begin >= end) {
+                    return false;
+                }
+                if (range.compare_exchange_weak(packed, Pack(begin + 1, end), std::memory_order_acq_rel)) {
+                    *id = begin;
+                    return true;
+                }
+            }
+        }
+
+        // only the owner makes its empty part non-empty again, thieves only shrink non-empty parts
+        bool Steal(int partIdx) {
+            for (;;) {
+                int victimIdx = -1;
+                ui64 victimRange = 0;
+                ui32 maxSize = 0;
+                for (auto i : xrange(Parts.ysize())) {
+                    const ui64 packed = Parts[i].Range.load(std::memory_order_acquire);
+                    const ui32 size = (GetEnd(packed) > GetBegin(packed)) ? (GetEnd(packed) - GetBegin(packed)) : 0;
+                    if ((i != partIdx) && (size > maxSize)) {
+                        victimIdx = i;
+                        victimRange = packed;
+                        maxSize = size;
+                    }
+                }
+                if (victimIdx == -1) {
+                    return false;
+                }
+                const ui32 begin = GetBegin(victimRange);
+                const ui32 end = GetEnd(victimRange);
+                const ui32 mid = begin + maxSize / 2;
+                if (Parts[victimIdx].Range.compare_exchange_strong(victimRange, Pack(begin, mid), std::memory_order_acq_rel)) {
+                    Parts[partIdx].Range.store(Pack(mid, end), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+
+        void LocalExec(int) override {
+            const int partIdx = AtomicAdd(ParticipantCount, 1) - 1;
+            Y_ASSERT(partIdx < Parts.ysize());
+            Participate(partIdx);
+        }
+
+    public:
+        TWorkStealingRangeExecutor(NPar::TLocallyExecutableFunction exec, int firstId, int lastId, int partCount)
+            : Exec(std::move(exec))
+            , FirstId(firstId)
+            , Parts(partCount)
+            , ParticipantCount(0)
+            , RemainingCount(lastId - firstId)
+        {
+            const ui64 rangeSize = lastId - firstId;
+            for (auto i : xrange(partCount)) {
+                Parts[i].Range.store(
+                    Pack(ui32(rangeSize * i / partCount), ui32(rangeSize * (i + 1) / partCount)),
+                    std::memory_order_relaxed);
+            }
+        }
+
+        void Participate(int partIdx) {
+            do {
+                ui32 id;
+                while (TakeFront(partIdx, &id)) {
+                    Exec(FirstId + (int)id);
+                    AtomicDecrement(RemainingCount);
+                }
+            } while (Steal(partIdx));
+        }
+
+        // the last part is owned by the calling thread, other parts by enqueued jobs
+        int GetCallerPartIdx() const {
+            return Parts.ysize() - 1;
+        }
+
+        void WaitComplete() {
+            while (AtomicGet(RemainingCount) > 0)
+                RegularYield();
+        }
+    };
+
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -148,6 +261,8 @@ public:
     void RunNewThread();
     void LaunchRange(TIntrusivePtr<TLocalRangeExecutor> execRange, int queueSizeLimit,
                      TAtomic* queueSize, TLockFreeQueue<TSingleJob>* jobQueue);
+    void LaunchJobs(TIntrusivePtr<ILocallyExecutable> exec, int count, int queueSizeLimit,
+                    TAtomic* queueSize, TLockFreeQueue<TSingleJob>* jobQueue);
 
     TImpl() = default;
     ~TImpl();
@@ -227,12 +342,20 @@ void NPar::TLocalExecutor::TImpl::LaunchRange(TIntrusivePtr<TLocalRangeExecutor>
                                               TAtomic* queueSize,
                                               TLockFreeQueue<TSingleJob>* jobQueue) {
     int count = Min<int>(ThreadCount + 1, rangeExec->GetRangeSize());
+    LaunchJobs(std::move(rangeExec), count, queueSizeLimit, queueSize, jobQueue);
+}
+
+void NPar::TLocalExecutor::TImpl::LaunchJobs(TIntrusivePtr<ILocallyExecutable> exec,
+                                             int count,
+                                             int queueSizeLimit,
+                                             TAtomic* queueSize,
+                                             TLockFreeQueue<TSingleJob>* jobQueue) {
     if (queueSizeLimit >= 0 && AtomicGet(*queueSize) >= queueSizeLimit) {
         return;
     }
     AtomicAdd(*queueSize, count);
     for (int i = 0; i < count; ++i) {
-        jobQueue->Enqueue(TSingleJob(rangeExec, 0));
+        jobQueue->Enqueue(TSingleJob(exec, 0));
     }
     HasJob.Signal();
 }
@@ -323,6 +446,48 @@ void NPar::TLocalExecutor::ExecRangeWithThrow(TLocallyExecutableFunction exec, i
     }
 }
 
+void NPar::TLocalExecutor::ExecRangeWithWorkStealing(TLocallyExecutableFunction exec, int firstId, int lastId, int flags) {
+    Y_ASSERT(lastId >= firstId);
+    if (firstId >= lastId) {
+        return;
+    }
+    const bool waitComplete = (flags & WAIT_COMPLETE) != 0;
+    if (waitComplete && (lastId - firstId) == 1) {
+        exec(firstId);
+        return;
+    }
+    const int partCount = Max(1, Min<int>(GetThreadCount() + (waitComplete ? 1 : 0), lastId - firstId));
+    auto rangeExec = MakeIntrusive<TWorkStealingRangeExecutor>(std::move(exec), firstId, lastId, partCount);
+
+    // if jobs are not enqueued because of queue size limit their parts are stolen by the calling thread
+    const int jobCount = waitComplete ? (partCount - 1) : partCount;
+    int queueSizeLimit = waitComplete ? 10000 : -1;
+    int prior = Max<int>(Impl_->CurrentTaskPriority, flags & PRIORITY_MASK);
+    if (jobCount > 0) {
+        switch (prior) {
+            case HIGH_PRIORITY:
+                Impl_->LaunchJobs(rangeExec, jobCount, queueSizeLimit, &Impl_->QueueSize, &Impl_->JobQueue);
+                break;
+            case MED_PRIORITY:
+                Impl_->LaunchJobs(rangeExec, jobCount, queueSizeLimit, &Impl_->MPQueueSize, &Impl_->MedJobQueue);
+                break;
+            case LOW_PRIORITY:
+                Impl_->LaunchJobs(rangeExec, jobCount, queueSizeLimit, &Impl_->LPQueueSize, &Impl_->LowJobQueue);
+                break;
+            default:
+                Y_ASSERT(0);
+                break;
+        }
+    }
+    if (waitComplete) {
+        int keepPrior = Impl_->CurrentTaskPriority;
+        Impl_->CurrentTaskPriority = prior;
+        rangeExec->Participate(rangeExec->GetCallerPartIdx());
+        Impl_->CurrentTaskPriority = keepPrior;
+        rangeExec->WaitComplete();
+    }
+}
+
 TVector<NThreading::TFuture<void>>
 NPar::TLocalExecutor::ExecRangeWithFutures(TLocallyExecutableFunction exec, int firstId, int lastId, int flags) {
     TFunctionWrapperWithPromise* execWrapper = new TFunctionWrapperWithPromise(exec, firstId, lastId);
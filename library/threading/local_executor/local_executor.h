@@ -163,6 +163,20 @@ namespace NPar {
         //
         TVector<NThreading::TFuture<void>> ExecRangeWithFutures(TLocallyExecutableFunction exec, int firstId, int lastId, int flags);
 
+        // Version of `ExecRange` with work stealing. Range is split into contiguous parts, one for
+        // each of `GetThreadCount() + 1` participants, and each participant takes tasks from the
+        // front of its own part. Participant that has exhausted its part steals the back half of
+        // the remaining tasks of the most loaded part, so tasks of very different cost are balanced
+        // without choosing the block size, and threads don't contend on a single shared counter.
+        //
+        // Tasks can call `ExecRangeWithWorkStealing` themselves (e.g. candidates x document blocks):
+        // the calling thread participates in the nested range and steals within it while waiting.
+        //
+        // @param exec                      Task description.
+        // @param firstId, lastId           Task arguments [firstId, lastId)
+        // @param flags                     Same as for `Exec`.
+        void ExecRangeWithWorkStealing(TLocallyExecutableFunction exec, int firstId, int lastId, int flags);
+
         template <typename TBody>
         static inline auto BlockedLoopBody(const TLocalExecutor::TExecRangeParams& params, const TBody& body) {
             return [=](int blockId) {
@@ -0,0 +1,113 @@
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NPar;
+
+namespace {
+    // skewed tasks similar to split candidates scoring: few candidates (e.g. CTRs of high cardinality
+    // or wide exclusive bundles) are much more expensive than the rest
+    struct TSkewedWork {
+        static constexpr int CandidateCount = 512;
+        static constexpr int DocBlockCount = 64;
+
+        TVector<int> CandidateCost;
+
+        TSkewedWork() {
+            TFastRng32 rng(17, 0);
+            CandidateCost.resize(CandidateCount);
+            for (auto& cost : CandidateCost) {
+                cost = (rng.Uniform(16) == 0) ? 2000 : 50;
+            }
+        }
+
+        static ui64 DoWork(int cost, ui64 seed) {
+            ui64 value = seed;
+            for (int i = 0; i < cost; ++i) {
+                value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+            }
+            return value;
+        }
+    };
+
+    template <int ThreadCount>
+    TLocalExecutor& GetExecutor() {
+        static TLocalExecutor executor;
+        static const bool started = (executor.RunAdditionalThreads(ThreadCount - 1), true);
+        Y_UNUSED(started);
+        return executor;
+    }
+
+    // candidates x document blocks, blocks of one candidate are processed by a nested range
+    template <int ThreadCount, bool UseWorkStealing>
+    void RunNestedCandidatesAndBlocks(const NBench::NCpu::TParams& iface) {
+        static const TSkewedWork work;
+        auto& executor = GetExecutor<ThreadCount>();
+        TVector<ui64> results(TSkewedWork::CandidateCount * TSkewedWork::DocBlockCount);
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+            const auto candidateBody = [&](int candidateIdx) {
+                const auto blockBody = [&](int blockIdx) {
+                    results[candidateIdx * TSkewedWork::DocBlockCount + blockIdx]
+                        = TSkewedWork::DoWork(work.CandidateCost[candidateIdx], blockIdx);
+                };
+                if (UseWorkStealing) {
+                    executor.ExecRangeWithWorkStealing(blockBody, 0, TSkewedWork::DocBlockCount, TLocalExecutor::WAIT_COMPLETE);
+                } else {
+                    executor.ExecRange(blockBody, 0, TSkewedWork::DocBlockCount, TLocalExecutor::WAIT_COMPLETE);
+                }
+            };
+            if (UseWorkStealing) {
+                executor.ExecRangeWithWorkStealing(candidateBody, 0, TSkewedWork::CandidateCount, TLocalExecutor::WAIT_COMPLETE);
+            } else {
+                executor.ExecRange(candidateBody, 0, TSkewedWork::CandidateCount, TLocalExecutor::WAIT_COMPLETE);
+            }
+            Y_DO_NOT_OPTIMIZE_AWAY(results.data());
+        }
+    }
+
+    // flat range of skewed tasks with static partition into thread count blocks (as in GetBlockParams)
+    template <int ThreadCount, bool UseWorkStealing>
+    void RunFlatSkewedRange(const NBench::NCpu::TParams& iface) {
+        static const TSkewedWork work;
+        auto& executor = GetExecutor<ThreadCount>();
+        TVector<ui64> results(TSkewedWork::CandidateCount);
+        for (const auto it : xrange(iface.Iterations())) {
+            Y_UNUSED(it);
+            const auto body = [&](int candidateIdx) {
+                results[candidateIdx] = TSkewedWork::DoWork(work.CandidateCost[candidateIdx] * TSkewedWork::DocBlockCount, candidateIdx);
+            };
+            if (UseWorkStealing) {
+                executor.ExecRangeWithWorkStealing(body, 0, TSkewedWork::CandidateCount, TLocalExecutor::WAIT_COMPLETE);
+            } else {
+                TLocalExecutor::TExecRangeParams params(0, TSkewedWork::CandidateCount);
+                params.SetBlockCount(ThreadCount);
+                executor.ExecRange(body, params, TLocalExecutor::WAIT_COMPLETE);
+            }
+            Y_DO_NOT_OPTIMIZE_AWAY(results.data());
+        }
+    }
+}
+
+#define DEFINE_BENCHMARKS(threadCount)                                             \
+    Y_CPU_BENCHMARK(NestedExecRange_##threadCount, iface) {                         \
+        RunNestedCandidatesAndBlocks<threadCount, false>(iface);                   \
+    }                                                                              \
+    Y_CPU_BENCHMARK(NestedWorkStealing_##threadCount, iface) {                      \
+        RunNestedCandidatesAndBlocks<threadCount, true>(iface);                    \
+    }                                                                              \
+    Y_CPU_BENCHMARK(FlatStaticBlocks_##threadCount, iface) {                        \
+        RunFlatSkewedRange<threadCount, false>(iface);                             \
+    }                                                                              \
+    Y_CPU_BENCHMARK(FlatWorkStealing_##threadCount, iface) {                        \
+        RunFlatSkewedRange<threadCount, true>(iface);                              \
+    }
+
+DEFINE_BENCHMARKS(8)
+DEFINE_BENCHMARKS(16)
+DEFINE_BENCHMARKS(32)
+DEFINE_BENCHMARKS(64)
+DEFINE_BENCHMARKS(128)
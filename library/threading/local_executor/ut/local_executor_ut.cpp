@@ -4,6 +4,7 @@
 #include <library/unittest/registar.h>
 #include <util/system/mutex.h>
 #include <util/system/rwlock.h>
+#include <util/system/yield.h>
 #include <util/generic/algorithm.h>
 
 using namespace NPar;
@@ -324,3 +325,77 @@ Y_UNIT_TEST(NestedParallelExceptionsDoNotLeak) {
 }
 }
 ;
+
+Y_UNIT_TEST_SUITE(ExecRangeWithWorkStealing) {
+    void RunSkewedRangeAndCheckEachTaskExecutedOnce(int rangeStart, int rangeSize, int threadsCount) {
+        TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(threadsCount);
+        TVector<TAtomic> executed(rangeSize, 0);
+        localExecutor.ExecRangeWithWorkStealing([&executed, rangeStart](int i) {
+            // first tasks are much heavier than the rest
+            if (i - rangeStart < 8) {
+                for (volatile int j = 0; j < 1000000; ++j) {
+                }
+            }
+            AtomicAdd(executed[i - rangeStart], 1);
+        },
+                                                rangeStart, rangeStart + rangeSize, TLocalExecutor::EFlags::WAIT_COMPLETE);
+        for (const auto& counter : executed) {
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(counter), 1);
+        }
+    }
+
+    Y_UNIT_TEST(RunSkewedRange) {
+        RunSkewedRangeAndCheckEachTaskExecutedOnce(10, DefaultRangeSize, DefaultThreadsCount);
+    }
+
+    Y_UNIT_TEST(RunSkewedRangeOneExtraThread) {
+        RunSkewedRangeAndCheckEachTaskExecutedOnce(0, DefaultRangeSize, 1);
+    }
+
+    Y_UNIT_TEST(RunSkewedRangeZeroExtraThreads) {
+        RunSkewedRangeAndCheckEachTaskExecutedOnce(0, DefaultRangeSize, 0);
+    }
+
+    Y_UNIT_TEST(RunOneTask) {
+        RunSkewedRangeAndCheckEachTaskExecutedOnce(0, 1, DefaultThreadsCount);
+    }
+
+    Y_UNIT_TEST(RunRangeSmallerThanThreadCount) {
+        RunSkewedRangeAndCheckEachTaskExecutedOnce(0, 3, DefaultThreadsCount);
+    }
+
+    Y_UNIT_TEST(RunNested) {
+        TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(DefaultThreadsCount);
+        const int outerSize = 17;
+        const int innerSize = 101;
+        TVector<TAtomic> executed(outerSize * innerSize, 0);
+        localExecutor.ExecRangeWithWorkStealing([&](int i) {
+            localExecutor.ExecRangeWithWorkStealing([&](int j) {
+                AtomicAdd(executed[i * innerSize + j], 1);
+            },
+                                                    0, (i % 2) ? innerSize : innerSize / 10 + 1, TLocalExecutor::EFlags::WAIT_COMPLETE);
+        },
+                                                0, outerSize, TLocalExecutor::EFlags::WAIT_COMPLETE);
+        for (int i = 0; i < outerSize; ++i) {
+            for (int j = 0; j < innerSize; ++j) {
+                UNIT_ASSERT_VALUES_EQUAL(AtomicGet(executed[i * innerSize + j]), (j < ((i % 2) ? innerSize : innerSize / 10 + 1)) ? 1 : 0);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(RunAsync) {
+        TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(DefaultThreadsCount);
+        TAtomic processed = 0;
+        localExecutor.ExecRangeWithWorkStealing([&processed](int) {
+            AtomicAdd(processed, 1);
+        },
+                                                0, DefaultRangeSize, TLocalExecutor::EFlags::HIGH_PRIORITY);
+        while (AtomicGet(processed) < DefaultRangeSize) {
+            ThreadYield();
+        }
+        UNIT_ASSERT_VALUES_EQUAL(AtomicGet(processed), DefaultRangeSize);
+    }
+}